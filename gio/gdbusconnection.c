@@ -129,7 +129,8 @@
    G_DBUS_CONNECTION_FLAGS_MESSAGE_BUS_CONNECTION |           \
    G_DBUS_CONNECTION_FLAGS_DELAY_MESSAGE_PROCESSING |         \
    G_DBUS_CONNECTION_FLAGS_AUTHENTICATION_REQUIRE_SAME_USER | \
-   G_DBUS_CONNECTION_FLAGS_CROSS_NAMESPACE)
+   G_DBUS_CONNECTION_FLAGS_CROSS_NAMESPACE |                  \
+   G_DBUS_CONNECTION_FLAGS_LAZY_MESSAGE_BODY)
 
 /**
  * GDBusConnection:
@@ -360,6 +361,10 @@ struct SignalData
   GDBusSignalFlags flags;
   GPtrArray *subscribers;  /* (owned) (element-type SignalSubscriber) */
 
+  /* Order in which this was added to the connection, so that signals are
+   * delivered to subscriptions in the order they were made */
+  guint64 serial;
+
   /*
    * If the sender is a well-known name, this is an unowned SignalData
    * representing the NameOwnerChanged signal that tracks its owner.
@@ -435,6 +440,432 @@ signal_data_free (SignalData *signal_data)
 
 /* ---------------------------------------------------------------------------------------------------- */
 
+/*
+ * Signal subscriptions are indexed so that distributing a signal only
+ * looks at the SignalData which match it, rather than at every
+ * subscription on the connection.
+ *
+ * There is one SignalDataIndex per unique sender name (see
+ * map_sender_unique_name_to_signal_data_index). Within it, SignalData are
+ * grouped into buckets by their (interface, member, path) triple, where
+ * each field may be a wildcard, so a signal needs at most one lookup per
+ * combination of wildcards that is in use. Within a bucket, SignalData are
+ * indexed by how they match arg0:
+ *
+ *  - exact matches, looked up by arg0;
+ *  - arg0namespace matches, looked up by each namespace that contains arg0;
+ *  - arg0path matches, looked up by arg0 and by each of its prefixes that
+ *    ends in '/'. A rule which extends arg0 matches too if arg0 ends in '/',
+ *    so rules are also listed under each of their own prefixes which end
+ *    in '/'.
+ */
+typedef struct
+{
+  /* Each of these is NULL if the SignalData in this bucket accept any value */
+  gchar *interface_name;
+  gchar *member;
+  gchar *object_path;
+
+  GPtrArray *any_arg0;                /* (owned) (nullable) (element-type SignalData) */
+  GHashTable *arg0;                   /* (owned) (nullable) arg0 (gchar*) -> GPtrArray* of SignalData */
+  GHashTable *arg0_namespace;         /* (owned) (nullable) namespace (gchar*) -> GPtrArray* of SignalData */
+  GHashTable *arg0_path;              /* (owned) (nullable) path (gchar*) -> GPtrArray* of SignalData */
+  GHashTable *arg0_path_descendants;  /* (owned) (nullable) path prefix (gchar*) -> GPtrArray* of SignalData */
+  guint n_signal_data;
+} SignalDataBucket;
+
+#define SIGNAL_DATA_BUCKET_HAS_INTERFACE (1 << 0)
+#define SIGNAL_DATA_BUCKET_HAS_MEMBER    (1 << 1)
+#define SIGNAL_DATA_BUCKET_HAS_PATH      (1 << 2)
+#define SIGNAL_DATA_BUCKET_N_KINDS       (1 << 3)
+
+typedef struct
+{
+  GHashTable *buckets;  /* (owned) (element-type SignalDataBucket) set of buckets */
+  guint n_buckets_by_kind[SIGNAL_DATA_BUCKET_N_KINDS];
+  guint n_signal_data;
+} SignalDataIndex;
+
+static guint
+signal_data_bucket_kind (const SignalDataBucket *bucket)
+{
+  guint kind = 0;
+
+  if (bucket->interface_name != NULL)
+    kind |= SIGNAL_DATA_BUCKET_HAS_INTERFACE;
+  if (bucket->member != NULL)
+    kind |= SIGNAL_DATA_BUCKET_HAS_MEMBER;
+  if (bucket->object_path != NULL)
+    kind |= SIGNAL_DATA_BUCKET_HAS_PATH;
+
+  return kind;
+}
+
+static guint
+signal_data_bucket_hash (gconstpointer key)
+{
+  const SignalDataBucket *bucket = key;
+  guint hash = 0;
+
+  if (bucket->interface_name != NULL)
+    hash = g_str_hash (bucket->interface_name);
+  hash *= 31;
+  if (bucket->member != NULL)
+    hash ^= g_str_hash (bucket->member);
+  hash *= 31;
+  if (bucket->object_path != NULL)
+    hash ^= g_str_hash (bucket->object_path);
+
+  return hash;
+}
+
+static gboolean
+signal_data_bucket_equal (gconstpointer a,
+                          gconstpointer b)
+{
+  const SignalDataBucket *bucket_a = a;
+  const SignalDataBucket *bucket_b = b;
+
+  return g_strcmp0 (bucket_a->interface_name, bucket_b->interface_name) == 0 &&
+         g_strcmp0 (bucket_a->member, bucket_b->member) == 0 &&
+         g_strcmp0 (bucket_a->object_path, bucket_b->object_path) == 0;
+}
+
+static void
+signal_data_bucket_free (SignalDataBucket *bucket)
+{
+  /* The bucket should not be freed while it still holds SignalData */
+  g_assert (bucket->n_signal_data == 0);
+
+  g_free (bucket->interface_name);
+  g_free (bucket->member);
+  g_free (bucket->object_path);
+  g_clear_pointer (&bucket->any_arg0, g_ptr_array_unref);
+  g_clear_pointer (&bucket->arg0, g_hash_table_unref);
+  g_clear_pointer (&bucket->arg0_namespace, g_hash_table_unref);
+  g_clear_pointer (&bucket->arg0_path, g_hash_table_unref);
+  g_clear_pointer (&bucket->arg0_path_descendants, g_hash_table_unref);
+
+  g_free (bucket);
+}
+
+static void
+signal_data_table_add (GHashTable **table,
+                       const gchar *key,
+                       gsize        key_len,
+                       SignalData  *signal_data)
+{
+  GPtrArray *signal_data_array;
+  gchar *owned_key;
+
+  if (*table == NULL)
+    *table = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                    g_free, (GDestroyNotify) g_ptr_array_unref);
+
+  owned_key = g_strndup (key, key_len);
+  signal_data_array = g_hash_table_lookup (*table, owned_key);
+  if (signal_data_array == NULL)
+    {
+      signal_data_array = g_ptr_array_new ();
+      g_hash_table_insert (*table, g_steal_pointer (&owned_key), signal_data_array);
+    }
+  g_ptr_array_add (signal_data_array, signal_data);
+
+  g_free (owned_key);
+}
+
+static void
+signal_data_table_remove (GHashTable  *table,
+                          const gchar *key,
+                          gsize        key_len,
+                          SignalData  *signal_data)
+{
+  GPtrArray *signal_data_array;
+  gchar *owned_key;
+
+  g_return_if_fail (table != NULL);
+
+  owned_key = g_strndup (key, key_len);
+  signal_data_array = g_hash_table_lookup (table, owned_key);
+  g_warn_if_fail (signal_data_array != NULL);
+
+  if (signal_data_array != NULL)
+    {
+      g_warn_if_fail (g_ptr_array_remove (signal_data_array, signal_data));
+      if (signal_data_array->len == 0)
+        g_hash_table_remove (table, owned_key);
+    }
+
+  g_free (owned_key);
+}
+
+static void
+signal_data_table_collect (GHashTable  *table,
+                           const gchar *key,
+                           GPtrArray   *out_signal_data)
+{
+  GPtrArray *signal_data_array;
+
+  signal_data_array = g_hash_table_lookup (table, key);
+  if (signal_data_array != NULL)
+    g_ptr_array_extend (out_signal_data, signal_data_array, NULL, NULL);
+}
+
+static SignalDataIndex *
+signal_data_index_new (void)
+{
+  SignalDataIndex *index = g_new0 (SignalDataIndex, 1);
+
+  index->buckets = g_hash_table_new_full (signal_data_bucket_hash,
+                                          signal_data_bucket_equal,
+                                          (GDestroyNotify) signal_data_bucket_free,
+                                          NULL);
+  return g_steal_pointer (&index);
+}
+
+static void
+signal_data_index_free (SignalDataIndex *index)
+{
+  g_hash_table_unref (index->buckets);
+  g_free (index);
+}
+
+static void
+signal_data_index_add (SignalDataIndex *index,
+                       SignalData      *signal_data)
+{
+  SignalDataBucket key = { NULL, };
+  SignalDataBucket *bucket;
+  const gchar *arg0 = signal_data->arg0;
+
+  key.interface_name = signal_data->interface_name;
+  key.member = signal_data->member;
+  key.object_path = signal_data->object_path;
+  bucket = g_hash_table_lookup (index->buckets, &key);
+  if (bucket == NULL)
+    {
+      bucket = g_new0 (SignalDataBucket, 1);
+      bucket->interface_name = g_strdup (signal_data->interface_name);
+      bucket->member = g_strdup (signal_data->member);
+      bucket->object_path = g_strdup (signal_data->object_path);
+      g_hash_table_add (index->buckets, bucket);
+      index->n_buckets_by_kind[signal_data_bucket_kind (bucket)]++;
+    }
+
+  if (arg0 == NULL)
+    {
+      if (bucket->any_arg0 == NULL)
+        bucket->any_arg0 = g_ptr_array_new ();
+      g_ptr_array_add (bucket->any_arg0, signal_data);
+    }
+  else if (signal_data->flags & G_DBUS_SIGNAL_FLAGS_MATCH_ARG0_NAMESPACE)
+    {
+      signal_data_table_add (&bucket->arg0_namespace, arg0, strlen (arg0), signal_data);
+    }
+  else if (signal_data->flags & G_DBUS_SIGNAL_FLAGS_MATCH_ARG0_PATH)
+    {
+      size_t len = strlen (arg0);
+      size_t i;
+
+      signal_data_table_add (&bucket->arg0_path, arg0, len, signal_data);
+
+      for (i = 0; i + 1 < len; i++)
+        {
+          if (arg0[i] == '/')
+            signal_data_table_add (&bucket->arg0_path_descendants, arg0, i + 1, signal_data);
+        }
+    }
+  else
+    {
+      signal_data_table_add (&bucket->arg0, arg0, strlen (arg0), signal_data);
+    }
+
+  bucket->n_signal_data++;
+  index->n_signal_data++;
+}
+
+/* Returns TRUE if @index is now empty */
+static gboolean
+signal_data_index_remove (SignalDataIndex *index,
+                          SignalData      *signal_data)
+{
+  SignalDataBucket key = { NULL, };
+  SignalDataBucket *bucket;
+  const gchar *arg0 = signal_data->arg0;
+
+  key.interface_name = signal_data->interface_name;
+  key.member = signal_data->member;
+  key.object_path = signal_data->object_path;
+  bucket = g_hash_table_lookup (index->buckets, &key);
+  g_return_val_if_fail (bucket != NULL, index->n_signal_data == 0);
+
+  if (arg0 == NULL)
+    {
+      g_warn_if_fail (g_ptr_array_remove (bucket->any_arg0, signal_data));
+    }
+  else if (signal_data->flags & G_DBUS_SIGNAL_FLAGS_MATCH_ARG0_NAMESPACE)
+    {
+      signal_data_table_remove (bucket->arg0_namespace, arg0, strlen (arg0), signal_data);
+    }
+  else if (signal_data->flags & G_DBUS_SIGNAL_FLAGS_MATCH_ARG0_PATH)
+    {
+      size_t len = strlen (arg0);
+      size_t i;
+
+      signal_data_table_remove (bucket->arg0_path, arg0, len, signal_data);
+
+      for (i = 0; i + 1 < len; i++)
+        {
+          if (arg0[i] == '/')
+            signal_data_table_remove (bucket->arg0_path_descendants, arg0, i + 1, signal_data);
+        }
+    }
+  else
+    {
+      signal_data_table_remove (bucket->arg0, arg0, strlen (arg0), signal_data);
+    }
+
+  bucket->n_signal_data--;
+  index->n_signal_data--;
+
+  if (bucket->n_signal_data == 0)
+    {
+      index->n_buckets_by_kind[signal_data_bucket_kind (bucket)]--;
+      g_hash_table_remove (index->buckets, bucket);
+    }
+
+  return index->n_signal_data == 0;
+}
+
+/* Adds the SignalData in @bucket whose arg0path rule matches @path */
+static void
+signal_data_collect_arg0_path (SignalDataBucket *bucket,
+                               const gchar      *path,
+                               GPtrArray        *out_signal_data)
+{
+  size_t len = strlen (path);
+  gchar *prefix;
+  size_t i;
+
+  if (bucket->arg0_path != NULL)
+    {
+      /* Rules which are equal to @path, or which are a prefix of it
+       * ending in '/' */
+      signal_data_table_collect (bucket->arg0_path, path, out_signal_data);
+
+      prefix = g_strdup (path);
+      for (i = 0; i + 1 < len; i++)
+        {
+          if (path[i] == '/')
+            {
+              prefix[i + 1] = '\0';
+              signal_data_table_collect (bucket->arg0_path, prefix, out_signal_data);
+              prefix[i + 1] = path[i + 1];
+            }
+        }
+      g_free (prefix);
+    }
+
+  /* Rules which extend @path, if it ends in '/' */
+  if (bucket->arg0_path_descendants != NULL && len > 0 && path[len - 1] == '/')
+    signal_data_table_collect (bucket->arg0_path_descendants, path, out_signal_data);
+}
+
+static gint
+signal_data_compare_serial (gconstpointer a,
+                            gconstpointer b)
+{
+  const SignalData *signal_data_a = *(SignalData * const *) a;
+  const SignalData *signal_data_b = *(SignalData * const *) b;
+
+  if (signal_data_a->serial < signal_data_b->serial)
+    return -1;
+  else if (signal_data_a->serial > signal_data_b->serial)
+    return 1;
+  else
+    return 0;
+}
+
+/*
+ * Adds the SignalData in @index which match the given signal to
+ * @out_signal_data, in the order in which they were added to the connection.
+ * The sender is not checked.
+ */
+static void
+signal_data_index_collect (SignalDataIndex *index,
+                           const gchar     *interface,
+                           const gchar     *member,
+                           const gchar     *path,
+                           const gchar     *arg0,
+                           const gchar     *arg0_path,
+                           GPtrArray       *out_signal_data)
+{
+  guint kind;
+  guint first = out_signal_data->len;
+
+  for (kind = 0; kind < SIGNAL_DATA_BUCKET_N_KINDS; kind++)
+    {
+      SignalDataBucket key = { NULL, };
+      SignalDataBucket *bucket;
+
+      if (index->n_buckets_by_kind[kind] == 0)
+        continue;
+
+      if (kind & SIGNAL_DATA_BUCKET_HAS_INTERFACE)
+        key.interface_name = (gchar *) interface;
+      if (kind & SIGNAL_DATA_BUCKET_HAS_MEMBER)
+        key.member = (gchar *) member;
+      if (kind & SIGNAL_DATA_BUCKET_HAS_PATH)
+        key.object_path = (gchar *) path;
+
+      bucket = g_hash_table_lookup (index->buckets, &key);
+      if (bucket == NULL)
+        continue;
+
+      if (bucket->any_arg0 != NULL)
+        g_ptr_array_extend (out_signal_data, bucket->any_arg0, NULL, NULL);
+
+      if (arg0 != NULL && bucket->arg0 != NULL)
+        signal_data_table_collect (bucket->arg0, arg0, out_signal_data);
+
+      if (arg0 != NULL && bucket->arg0_namespace != NULL)
+        {
+          gchar *namespace;
+          gchar *dot;
+
+          /* Rules which are equal to @arg0, or which are a prefix of it
+           * followed by '.' */
+          signal_data_table_collect (bucket->arg0_namespace, arg0, out_signal_data);
+
+          namespace = g_strdup (arg0);
+          for (dot = strchr (namespace, '.'); dot != NULL; dot = strchr (dot + 1, '.'))
+            {
+              *dot = '\0';
+              signal_data_table_collect (bucket->arg0_namespace, namespace, out_signal_data);
+              *dot = '.';
+            }
+          g_free (namespace);
+        }
+
+      if (arg0 != NULL)
+        signal_data_collect_arg0_path (bucket, arg0, out_signal_data);
+      else if (arg0_path != NULL)
+        signal_data_collect_arg0_path (bucket, arg0_path, out_signal_data);
+    }
+
+  if (out_signal_data->len - first > 1)
+    {
+      /* Sort only the SignalData added by this call */
+      g_sort_array (out_signal_data->pdata + first,
+                    out_signal_data->len - first,
+                    sizeof (gpointer),
+                    (GCompareDataFunc) signal_data_compare_serial,
+                    NULL);
+    }
+}
+
+/* ---------------------------------------------------------------------------------------------------- */
+
 #ifdef G_OS_WIN32
 #define CONNECTION_ENSURE_LOCK(obj) do { ; } while (FALSE)
 #else
@@ -558,7 +989,8 @@ struct _GDBusConnection
   /* Maps used for managing signal subscription, protected by @lock */
   GHashTable *map_rule_to_signal_data;                      /* match rule (gchar*)    -> SignalData */
   GHashTable *map_id_to_signal_data;                        /* id (guint)             -> SignalData */
-  GHashTable *map_sender_unique_name_to_signal_data_array;  /* unique sender (gchar*) -> GPtrArray* of SignalData */
+  GHashTable *map_sender_unique_name_to_signal_data_index;  /* unique sender (gchar*) -> SignalDataIndex* */
+  guint64 last_signal_data_serial;
 
   /* Maps used for managing exported objects and subtrees,
    * protected by @lock
@@ -806,7 +1238,7 @@ g_dbus_connection_finalize (GObject *object)
 
   g_hash_table_unref (connection->map_rule_to_signal_data);
   g_hash_table_unref (connection->map_id_to_signal_data);
-  g_hash_table_unref (connection->map_sender_unique_name_to_signal_data_array);
+  g_hash_table_unref (connection->map_sender_unique_name_to_signal_data_index);
 
   g_hash_table_unref (connection->map_id_to_ei);
   g_hash_table_unref (connection->map_object_path_to_eo);
@@ -1195,10 +1627,10 @@ g_dbus_connection_init (GDBusConnection *connection)
                                                           g_str_equal);
   connection->map_id_to_signal_data = g_hash_table_new (g_direct_hash,
                                                         g_direct_equal);
-  connection->map_sender_unique_name_to_signal_data_array = g_hash_table_new_full (g_str_hash,
+  connection->map_sender_unique_name_to_signal_data_index = g_hash_table_new_full (g_str_hash,
                                                                                    g_str_equal,
                                                                                    g_free,
-                                                                                   (GDestroyNotify) g_ptr_array_unref);
+                                                                                   (GDestroyNotify) signal_data_index_free);
 
   connection->map_object_path_to_eo = g_hash_table_new_full (g_str_hash,
                                                              g_str_equal,
@@ -1721,6 +2153,46 @@ g_dbus_connection_get_last_serial (GDBusConnection *connection)
   return ret;
 }
 
+/**
+ * g_dbus_connection_get_write_statistics:
+ * @connection: a #GDBusConnection
+ * @out_n_messages: (out) (optional): return location for the number of
+ *     messages written so far
+ * @out_n_writes: (out) (optional): return location for the number of
+ *     writes they were written with
+ *
+ * Retrieves statistics about how messages have been written to the
+ * underlying stream of @connection.
+ *
+ * Messages which are queued for sending at the same time are written out
+ * together, with a single vectored write (a single `sendmsg()` call, for
+ * sockets). The ratio of @out_n_messages to @out_n_writes shows how
+ * effective this batching is: when emitting bursts of signals, for
+ * example, it should be well above 1. Writes which only wrote part of
+ * their data are counted individually.
+ *
+ * This is intended for diagnostics and performance tuning.
+ *
+ * Since: 2.86
+ */
+void
+g_dbus_connection_get_write_statistics (GDBusConnection *connection,
+                                        guint64         *out_n_messages,
+                                        guint64         *out_n_writes)
+{
+  guint64 n_messages = 0, n_writes = 0;
+
+  g_return_if_fail (G_IS_DBUS_CONNECTION (connection));
+  g_return_if_fail (check_initialized (connection));
+
+  _g_dbus_worker_get_write_statistics (connection->worker, &n_messages, &n_writes);
+
+  if (out_n_messages != NULL)
+    *out_n_messages = n_messages;
+  if (out_n_writes != NULL)
+    *out_n_writes = n_writes;
+}
+
 /* ---------------------------------------------------------------------------------------------------- */
 
 /* Can be called by any thread, with the connection lock held */
@@ -2969,6 +3441,7 @@ initable_init (GInitable     *initable,
   connection->worker = _g_dbus_worker_new (connection->stream,
                                            connection->capabilities,
                                            ((connection->flags & G_DBUS_CONNECTION_FLAGS_DELAY_MESSAGE_PROCESSING) != 0),
+                                           ((connection->flags & G_DBUS_CONNECTION_FLAGS_LAZY_MESSAGE_BODY) != 0),
                                            on_worker_message_received,
                                            on_worker_message_about_to_be_sent,
                                            on_worker_closed,
@@ -3747,11 +4220,12 @@ add_signal_data (GDBusConnection *connection,
                  SignalData      *signal_data,
                  const char      *sender_unique_name)
 {
-  GPtrArray *signal_data_array;
+  SignalDataIndex *signal_data_index;
 
   g_hash_table_insert (connection->map_rule_to_signal_data,
                        signal_data->rule,
                        signal_data);
+  signal_data->serial = ++connection->last_signal_data_serial;
 
   /* Add the match rule to the bus...
    *
@@ -3764,16 +4238,16 @@ add_signal_data (GDBusConnection *connection,
         add_match_rule (connection, signal_data->rule);
     }
 
-  signal_data_array = g_hash_table_lookup (connection->map_sender_unique_name_to_signal_data_array,
+  signal_data_index = g_hash_table_lookup (connection->map_sender_unique_name_to_signal_data_index,
                                            sender_unique_name);
-  if (signal_data_array == NULL)
+  if (signal_data_index == NULL)
     {
-      signal_data_array = g_ptr_array_new ();
-      g_hash_table_insert (connection->map_sender_unique_name_to_signal_data_array,
+      signal_data_index = signal_data_index_new ();
+      g_hash_table_insert (connection->map_sender_unique_name_to_signal_data_index,
                            g_strdup (sender_unique_name),
-                           signal_data_array);
+                           signal_data_index);
     }
-  g_ptr_array_add (signal_data_array, signal_data);
+  signal_data_index_add (signal_data_index, signal_data);
 }
 
 /* ---------------------------------------------------------------------------------------------------- */
@@ -4010,7 +4484,7 @@ remove_signal_data_if_unused (GDBusConnection *connection,
                               SignalData *signal_data)
 {
   const gchar *sender_unique_name;
-  GPtrArray *signal_data_array;
+  SignalDataIndex *signal_data_index;
 
   /* Cannot remove while there are still subscribers */
   if (signal_data->subscribers->len != 0)
@@ -4030,14 +4504,14 @@ remove_signal_data_if_unused (GDBusConnection *connection,
 
   g_warn_if_fail (g_hash_table_remove (connection->map_rule_to_signal_data, signal_data->rule));
 
-  signal_data_array = g_hash_table_lookup (connection->map_sender_unique_name_to_signal_data_array,
+  signal_data_index = g_hash_table_lookup (connection->map_sender_unique_name_to_signal_data_index,
                                            sender_unique_name);
-  g_warn_if_fail (signal_data_array != NULL);
-  g_warn_if_fail (g_ptr_array_remove (signal_data_array, signal_data));
+  g_warn_if_fail (signal_data_index != NULL);
 
-  if (signal_data_array->len == 0)
+  if (signal_data_index != NULL &&
+      signal_data_index_remove (signal_data_index, signal_data))
     {
-      g_warn_if_fail (g_hash_table_remove (connection->map_sender_unique_name_to_signal_data_array,
+      g_warn_if_fail (g_hash_table_remove (connection->map_sender_unique_name_to_signal_data_index,
                                            sender_unique_name));
     }
 
@@ -4226,52 +4700,16 @@ signal_instance_free (SignalInstance *signal_instance)
   g_free (signal_instance);
 }
 
-static gboolean
-namespace_rule_matches (const gchar *namespace,
-                        const gchar *name)
-{
-  size_t len_namespace;
-  size_t len_name;
-
-  len_namespace = strlen (namespace);
-  len_name = strlen (name);
-
-  if (len_name < len_namespace)
-    return FALSE;
-
-  if (memcmp (namespace, name, len_namespace) != 0)
-    return FALSE;
-
-  return len_namespace == len_name || name[len_namespace] == '.';
-}
-
-static gboolean
-path_rule_matches (const gchar *path_a,
-                   const gchar *path_b)
-{
-  size_t len_a, len_b;
-
-  len_a = strlen (path_a);
-  len_b = strlen (path_b);
-
-  if (len_a < len_b && (len_a == 0 || path_a[len_a - 1] != '/'))
-    return FALSE;
-
-  if (len_b < len_a && (len_b == 0 || path_b[len_b - 1] != '/'))
-    return FALSE;
-
-  return memcmp (path_a, path_b, MIN (len_a, len_b)) == 0;
-}
-
 /* called in GDBusWorker thread WITH lock held
  *
  * @sender is (nullable) for peer-to-peer connections */
 static void
 schedule_callbacks (GDBusConnection *connection,
-                    GPtrArray       *signal_data_array,
+                    SignalDataIndex *signal_data_index,
                     GDBusMessage    *message,
                     const gchar     *sender)
 {
+  GPtrArray *signal_data_array;
   guint n, m;
   const gchar *interface;
   const gchar *member;
@@ -4308,29 +4746,23 @@ schedule_callbacks (GDBusConnection *connection,
            arg0);
 #endif
 
-  /* TODO: if this is slow, then we can change signal_data_array into
-   *       map_object_path_to_signal_data_array or something.
-   */
+  /* The index has already matched the interface, member, path and arg0,
+   * so only the sender remains to be checked */
+  signal_data_array = g_ptr_array_new ();
+  signal_data_index_collect (signal_data_index, interface, member, path,
+                             arg0, arg0_path, signal_data_array);
+
   for (n = 0; n < signal_data_array->len; n++)
     {
       SignalData *signal_data = signal_data_array->pdata[n];
 
-      if (signal_data->interface_name != NULL && g_strcmp0 (signal_data->interface_name, interface) != 0)
-        continue;
-
-      if (signal_data->member != NULL && g_strcmp0 (signal_data->member, member) != 0)
-        continue;
-
-      if (signal_data->object_path != NULL && g_strcmp0 (signal_data->object_path, path) != 0)
-        continue;
-
       if (signal_data->shared_name_watcher != NULL)
         {
           /* We want signals from a specified well-known name, which means
            * the signal's sender needs to be the unique name that currently
            * owns that well-known name, and we will have found this
            * SignalData in
-           * connection->map_sender_unique_name_to_signal_data_array[""]. */
+           * connection->map_sender_unique_name_to_signal_data_index[""]. */
           const WatchedName *watched_name;
           const char *current_owner;
 
@@ -4357,30 +4789,13 @@ schedule_callbacks (GDBusConnection *connection,
                     || g_str_equal (signal_data->sender, DBUS_SERVICE_DBUS));
 
           /* ... which means we must have found this SignalData in
-           * connection->map_sender_unique_name_to_signal_data_array[signal_data->sender],
+           * connection->map_sender_unique_name_to_signal_data_index[signal_data->sender],
            * therefore we would only have found it if the signal's
            * actual sender matches the required signal_data->sender */
           g_assert (g_strcmp0 (signal_data->sender, sender) == 0);
         }
       /* else the sender is unspecified and we will accept anything */
 
-      if (signal_data->arg0 != NULL)
-        {
-          if (signal_data->flags & G_DBUS_SIGNAL_FLAGS_MATCH_ARG0_NAMESPACE)
-            {
-              if (arg0 == NULL || !namespace_rule_matches (signal_data->arg0, arg0))
-                continue;
-            }
-          else if (signal_data->flags & G_DBUS_SIGNAL_FLAGS_MATCH_ARG0_PATH)
-            {
-              if ((arg0 == NULL || !path_rule_matches (signal_data->arg0, arg0)) &&
-                  (arg0_path == NULL || !path_rule_matches (signal_data->arg0, arg0_path)))
-                continue;
-            }
-          else if (arg0 == NULL || !g_str_equal (signal_data->arg0, arg0))
-            continue;
-        }
-
       if (signal_data->watched_name != NULL)
         {
           /* Invariant: SignalData should only have a watched_name if it
@@ -4418,6 +4833,8 @@ schedule_callbacks (GDBusConnection *connection,
           g_source_unref (idle_source);
         }
     }
+
+  g_ptr_array_unref (signal_data_array);
 }
 
 /* called in GDBusWorker thread with lock held */
@@ -4425,7 +4842,7 @@ static void
 distribute_signals (GDBusConnection *connection,
                     GDBusMessage    *message)
 {
-  GPtrArray *signal_data_array;
+  SignalDataIndex *signal_data_index;
   const gchar *sender, *interface, *member, *path;
 
   g_assert (g_dbus_message_get_message_type (message) == G_DBUS_MESSAGE_TYPE_SIGNAL);
@@ -4458,15 +4875,15 @@ distribute_signals (GDBusConnection *connection,
   /* collect subscribers that match on sender */
   if (sender != NULL)
     {
-      signal_data_array = g_hash_table_lookup (connection->map_sender_unique_name_to_signal_data_array, sender);
-      if (signal_data_array != NULL)
-        schedule_callbacks (connection, signal_data_array, message, sender);
+      signal_data_index = g_hash_table_lookup (connection->map_sender_unique_name_to_signal_data_index, sender);
+      if (signal_data_index != NULL)
+        schedule_callbacks (connection, signal_data_index, message, sender);
     }
 
   /* collect subscribers not matching on sender, or matching a well-known name */
-  signal_data_array = g_hash_table_lookup (connection->map_sender_unique_name_to_signal_data_array, "");
-  if (signal_data_array != NULL)
-    schedule_callbacks (connection, signal_data_array, message, sender);
+  signal_data_index = g_hash_table_lookup (connection->map_sender_unique_name_to_signal_data_index, "");
+  if (signal_data_index != NULL)
+    schedule_callbacks (connection, signal_data_index, message, sender);
 }
 
 /* ---------------------------------------------------------------------------------------------------- */
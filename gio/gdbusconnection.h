@@ -108,6 +108,10 @@ GCredentials    *g_dbus_connection_get_peer_credentials       (GDBusConnection
 
 GIO_AVAILABLE_IN_2_34
 guint32          g_dbus_connection_get_last_serial            (GDBusConnection    *connection);
+GIO_AVAILABLE_IN_2_86
+void             g_dbus_connection_get_write_statistics       (GDBusConnection    *connection,
+                                                               guint64            *out_n_messages,
+                                                               guint64            *out_n_writes);
 
 GIO_AVAILABLE_IN_ALL
 gboolean         g_dbus_connection_get_exit_on_close          (GDBusConnection    *connection);
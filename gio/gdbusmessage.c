@@ -499,6 +499,12 @@ struct _GDBusMessage
   GHashTable *headers;
   GVariant *body;
   GVariant *arg0_cache;  /* (nullable) (owned) */
+  /* Set if the message was created by g_dbus_message_new_from_bytes() and
+   * its body has not been deserialised yet. Both are protected by
+   * @lazy_body_lock; once @lazy_body is cleared, @body and @arg0_cache can
+   * be read without it. */
+  GBytes *lazy_body;  /* (nullable) (owned) (atomic) */
+  GVariantType *lazy_body_type;  /* (nullable) (owned) */
 #ifdef G_OS_UNIX
   GUnixFDList *fd_list;
 #endif
@@ -512,6 +518,11 @@ enum
 
 G_DEFINE_TYPE (GDBusMessage, g_dbus_message, G_TYPE_OBJECT)
 
+/* Only taken while deserialising or copying a lazily deserialised body */
+G_LOCK_DEFINE_STATIC (lazy_body_lock);
+
+static void g_dbus_message_ensure_body (GDBusMessage *message);
+
 static void
 g_dbus_message_finalize (GObject *object)
 {
@@ -522,6 +533,8 @@ g_dbus_message_finalize (GObject *object)
   if (message->body != NULL)
     g_variant_unref (message->body);
   g_clear_pointer (&message->arg0_cache, g_variant_unref);
+  g_clear_pointer (&message->lazy_body, g_bytes_unref);
+  g_clear_pointer (&message->lazy_body_type, g_variant_type_free);
 #ifdef G_OS_UNIX
   if (message->fd_list != NULL)
     g_object_unref (message->fd_list);
@@ -866,6 +879,9 @@ g_dbus_message_set_byte_order (GDBusMessage          *message,
       return;
     }
 
+  /* A body which has not been deserialised yet is in the old byte order */
+  g_dbus_message_ensure_body (message);
+
   message->byte_order = byte_order;
 }
 
@@ -1131,6 +1147,7 @@ GVariant *
 g_dbus_message_get_body (GDBusMessage  *message)
 {
   g_return_val_if_fail (G_IS_DBUS_MESSAGE (message), NULL);
+  g_dbus_message_ensure_body (message);
   return message->body;
 }
 
@@ -1164,6 +1181,8 @@ g_dbus_message_set_body (GDBusMessage  *message,
     g_variant_unref (message->body);
 
   g_clear_pointer (&message->arg0_cache, g_variant_unref);
+  g_clear_pointer (&message->lazy_body, g_bytes_unref);
+  g_clear_pointer (&message->lazy_body_type, g_variant_type_free);
 
   if (body == NULL)
     {
@@ -2321,6 +2340,12 @@ g_dbus_message_bytes_needed (guchar  *blob,
 
 /* ---------------------------------------------------------------------------------------------------- */
 
+static GDBusMessage *g_dbus_message_new_from_blob_internal (guchar                *blob,
+                                                           gsize                  blob_len,
+                                                           GBytes                *bytes,
+                                                           GDBusCapabilityFlags   capabilities,
+                                                           GError               **error);
+
 /**
  * g_dbus_message_new_from_blob:
  * @blob: (array length=blob_len) (element-type guint8): A blob representing a binary D-Bus message.
@@ -2345,6 +2370,64 @@ g_dbus_message_new_from_blob (guchar                *blob,
                               gsize                  blob_len,
                               GDBusCapabilityFlags   capabilities,
                               GError               **error)
+{
+  g_return_val_if_fail (blob != NULL, NULL);
+  g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+  return g_dbus_message_new_from_blob_internal (blob, blob_len, NULL, capabilities, error);
+}
+
+/**
+ * g_dbus_message_new_from_bytes:
+ * @bytes: A #GBytes containing a binary D-Bus message.
+ * @capabilities: A #GDBusCapabilityFlags describing what protocol features are supported.
+ * @error: Return location for error or %NULL.
+ *
+ * Creates a new #GDBusMessage from the data stored in @bytes, like
+ * g_dbus_message_new_from_blob().
+ *
+ * Unlike g_dbus_message_new_from_blob(), only the message header is
+ * deserialised and validated straight away. The message keeps a reference
+ * to the part of @bytes holding the body, which is only deserialised, and
+ * validated, the first time it is needed, for example by
+ * g_dbus_message_get_body() or g_dbus_message_get_arg0(). This makes
+ * receiving a message whose body is never looked at cheap, and avoids
+ * copying the body out of @bytes.
+ *
+ * As a consequence, a message with an invalid body is not rejected by this
+ * function. Instead, g_dbus_message_get_body() returns %NULL for it, as
+ * for a message without a body.
+ *
+ * Returns: A new #GDBusMessage or %NULL if @error is set. Free with
+ * g_object_unref().
+ *
+ * Since: 2.86
+ */
+GDBusMessage *
+g_dbus_message_new_from_bytes (GBytes                *bytes,
+                               GDBusCapabilityFlags   capabilities,
+                               GError               **error)
+{
+  gconstpointer data;
+  gsize size;
+
+  g_return_val_if_fail (bytes != NULL, NULL);
+  g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+  data = g_bytes_get_data (bytes, &size);
+
+  /* The blob is only read from */
+  return g_dbus_message_new_from_blob_internal ((guchar *) data, size, bytes, capabilities, error);
+}
+
+/* Deserialises a message. If @bytes is non-%NULL, it must contain @blob,
+ * and the body is deserialised lazily, by g_dbus_message_ensure_body(). */
+static GDBusMessage *
+g_dbus_message_new_from_blob_internal (guchar                *blob,
+                                       gsize                  blob_len,
+                                       GBytes                *bytes,
+                                       GDBusCapabilityFlags   capabilities,
+                                       GError               **error)
 {
   GError *local_error = NULL;
   GMemoryBuffer mbuf;
@@ -2359,9 +2442,6 @@ g_dbus_message_new_from_blob (guchar                *blob,
 
   /* TODO: check against @capabilities */
 
-  g_return_val_if_fail (blob != NULL, NULL);
-  g_return_val_if_fail (error == NULL || *error == NULL, NULL);
-
   message = g_dbus_message_new ();
 
   memset (&mbuf, 0, sizeof (mbuf));
@@ -2498,26 +2578,54 @@ g_dbus_message_new_from_blob (guchar                *blob,
 
           variant_type = g_variant_type_new (tupled_signature_str);
           g_free (tupled_signature_str);
+
+          if (bytes != NULL)
+            {
+              /* The body starts at the next 8-byte boundary after the
+               * header fields */
+              gsize body_offset = 8 * ((mbuf.pos + 7) / 8);
+
+              if (body_offset > blob_len || blob_len - body_offset < message_body_len)
+                {
+                  /* G_GUINT32_FORMAT doesn't work with gettext, just use %u */
+                  g_set_error (&local_error,
+                               G_IO_ERROR,
+                               G_IO_ERROR_INVALID_ARGUMENT,
+                               g_dngettext (GETTEXT_PACKAGE,
+                                            "Message body of %u byte is truncated",
+                                            "Message body of %u bytes is truncated",
+                                            message_body_len),
+                               message_body_len);
+                  g_variant_type_free (variant_type);
+                  goto fail;
+                }
+
+              message->lazy_body = g_bytes_new_from_bytes (bytes, body_offset, message_body_len);
+              message->lazy_body_type = variant_type;
+            }
+          else
+            {
 #ifdef DEBUG_SERIALIZER
-          g_print ("Parsing body (blob_len = 0x%04x bytes)\n", (gint) blob_len);
+              g_print ("Parsing body (blob_len = 0x%04x bytes)\n", (gint) blob_len);
 #endif /* DEBUG_SERIALIZER */
-          message->body = parse_value_from_blob (&mbuf,
-                                                 variant_type,
-                                                 G_DBUS_MAX_TYPE_DEPTH + 1 /* for the surrounding tuple */,
-                                                 FALSE,
-                                                 2,
-                                                 &local_error);
-          g_variant_type_free (variant_type);
-
-          if (message->body != NULL &&
-              g_variant_is_of_type (message->body, G_VARIANT_TYPE_TUPLE) &&
-              g_variant_n_children (message->body) > 0)
-            message->arg0_cache = g_variant_get_child_value (message->body, 0);
-          else
-            message->arg0_cache = NULL;
+              message->body = parse_value_from_blob (&mbuf,
+                                                     variant_type,
+                                                     G_DBUS_MAX_TYPE_DEPTH + 1 /* for the surrounding tuple */,
+                                                     FALSE,
+                                                     2,
+                                                     &local_error);
+              g_variant_type_free (variant_type);
 
-          if (message->body == NULL)
-            goto fail;
+              if (message->body != NULL &&
+                  g_variant_is_of_type (message->body, G_VARIANT_TYPE_TUPLE) &&
+                  g_variant_n_children (message->body) > 0)
+                message->arg0_cache = g_variant_get_child_value (message->body, 0);
+              else
+                message->arg0_cache = NULL;
+
+              if (message->body == NULL)
+                goto fail;
+            }
         }
     }
   else
@@ -2552,6 +2660,60 @@ fail:
   return NULL;
 }
 
+/* Deserialises the body of a message created by
+ * g_dbus_message_new_from_bytes(), if that has not happened yet. This may
+ * be called from several threads at once, as received messages are shared
+ * between threads once they are locked. */
+static void
+g_dbus_message_ensure_body (GDBusMessage *message)
+{
+  GMemoryBuffer mbuf;
+  GError *local_error = NULL;
+  GVariant *body;
+
+  if (G_LIKELY (g_atomic_pointer_get (&message->lazy_body) == NULL))
+    return;
+
+  G_LOCK (lazy_body_lock);
+
+  if (message->lazy_body == NULL)
+    {
+      G_UNLOCK (lazy_body_lock);
+      return;
+    }
+
+  memset (&mbuf, 0, sizeof (mbuf));
+  mbuf.data = (gchar *) g_bytes_get_data (message->lazy_body, &mbuf.len);
+  mbuf.valid_len = mbuf.len;
+  mbuf.byte_order = (message->byte_order == G_DBUS_MESSAGE_BYTE_ORDER_BIG_ENDIAN) ?
+                    G_DATA_STREAM_BYTE_ORDER_BIG_ENDIAN : G_DATA_STREAM_BYTE_ORDER_LITTLE_ENDIAN;
+
+  /* The body is 8-byte aligned in the original message, so alignment
+   * relative to the start of @mbuf is the same. */
+  body = parse_value_from_blob (&mbuf,
+                                message->lazy_body_type,
+                                G_DBUS_MAX_TYPE_DEPTH + 1 /* for the surrounding tuple */,
+                                FALSE,
+                                2,
+                                &local_error);
+  if (body == NULL)
+    {
+      g_debug ("Cannot deserialize message body: %s", local_error->message);
+      g_clear_error (&local_error);
+    }
+  else if (g_variant_is_of_type (body, G_VARIANT_TYPE_TUPLE) &&
+           g_variant_n_children (body) > 0)
+    {
+      message->arg0_cache = g_variant_get_child_value (body, 0);
+    }
+
+  message->body = body;
+  g_clear_pointer (&message->lazy_body_type, g_variant_type_free);
+  g_bytes_unref (g_atomic_pointer_exchange (&message->lazy_body, NULL));
+
+  G_UNLOCK (lazy_body_lock);
+}
+
 /* ---------------------------------------------------------------------------------------------------- */
 
 static gsize
@@ -2987,6 +3149,8 @@ g_dbus_message_to_blob (GDBusMessage          *message,
   g_return_val_if_fail (out_size != NULL, NULL);
   g_return_val_if_fail (error == NULL || *error == NULL, NULL);
 
+  g_dbus_message_ensure_body (message);
+
   memset (&mbuf, 0, sizeof (mbuf));
   mbuf.len = MIN_ARRAY_SIZE;
   mbuf.data = g_malloc (mbuf.len);
@@ -3560,6 +3724,8 @@ g_dbus_message_get_arg0 (GDBusMessage  *message)
 {
   g_return_val_if_fail (G_IS_DBUS_MESSAGE (message), NULL);
 
+  g_dbus_message_ensure_body (message);
+
   if (message->arg0_cache != NULL &&
       g_variant_is_of_type (message->arg0_cache, G_VARIANT_TYPE_STRING))
     return g_variant_get_string (message->arg0_cache, NULL);
@@ -3585,6 +3751,8 @@ g_dbus_message_get_arg0_path (GDBusMessage  *message)
 {
   g_return_val_if_fail (G_IS_DBUS_MESSAGE (message), NULL);
 
+  g_dbus_message_ensure_body (message);
+
   if (message->arg0_cache != NULL &&
       g_variant_is_of_type (message->arg0_cache, G_VARIANT_TYPE_OBJECT_PATH))
     return g_variant_get_string (message->arg0_cache, NULL);
@@ -3850,6 +4018,7 @@ g_dbus_message_print (GDBusMessage *message,
     }
   g_list_free (keys);
   g_string_append_printf (str, "%*sBody: ", indent, "");
+  g_dbus_message_ensure_body (message);
   if (message->body != NULL)
     {
       g_variant_print_string (message->body,
@@ -4031,8 +4200,15 @@ g_dbus_message_copy (GDBusMessage  *message,
   /* see https://bugzilla.gnome.org/show_bug.cgi?id=624546#c8 for why it's fine
    * to just ref (as opposed to deep-copying) the GVariant instances
    */
+  G_LOCK (lazy_body_lock);
   ret->body = message->body != NULL ? g_variant_ref (message->body) : NULL;
   ret->arg0_cache = message->arg0_cache != NULL ? g_variant_ref (message->arg0_cache) : NULL;
+  if (message->lazy_body != NULL)
+    {
+      ret->lazy_body = g_bytes_ref (message->lazy_body);
+      ret->lazy_body_type = g_variant_type_copy (message->lazy_body_type);
+    }
+  G_UNLOCK (lazy_body_lock);
   g_hash_table_iter_init (&iter, message->headers);
   while (g_hash_table_iter_next (&iter, &header_key, (gpointer) &header_value))
     g_hash_table_insert (ret->headers, header_key, g_variant_ref (header_value));
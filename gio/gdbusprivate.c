@@ -358,6 +358,10 @@ struct GDBusWorker
   GDBusCapabilityFlags                capabilities;
   GQueue                             *received_messages_while_frozen;
 
+  /* if set, received messages take over the read buffer and their bodies
+   * are deserialised lazily (G_DBUS_CONNECTION_FLAGS_LAZY_MESSAGE_BODY) */
+  gboolean                            lazy_message_body;
+
   GIOStream                          *stream;
   GCancellable                       *cancellable;
   GDBusWorkerMessageReceivedCallback  message_received_callback;
@@ -390,6 +394,12 @@ struct GDBusWorker
   GQueue                             *write_queue;
   /* protected by write_lock */
   guint64                             write_num_messages_written;
+  /* number of writes (system calls, for sockets) that the messages were
+   * written with; protected by write_lock */
+  guint64                             write_num_writes;
+  /* number of messages being written while output_pending is
+   * PENDING_WRITE; protected by write_lock */
+  guint                               write_num_messages_in_flight;
   /* number of messages we'd written out last time we flushed;
    * protected by write_lock
    */
@@ -417,14 +427,18 @@ typedef struct
 
 struct _MessageToWriteData ;
 typedef struct _MessageToWriteData MessageToWriteData;
+struct _MessagesToWriteData ;
+typedef struct _MessagesToWriteData MessagesToWriteData;
 
 static void message_to_write_data_free (MessageToWriteData *data);
 
 static void read_message_print_transport_debug (gssize bytes_read,
                                                 GDBusWorker *worker);
 
-static void write_message_print_transport_debug (gssize bytes_written,
-                                                 MessageToWriteData *data);
+static void write_messages_print_transport_debug (gsize                bytes_written,
+                                                  MessagesToWriteData *data,
+                                                  guint                first,
+                                                  guint                n_vectors);
 
 typedef struct {
     GDBusWorker *worker;
@@ -745,18 +759,40 @@ _g_dbus_worker_do_read_cb (GInputStream  *input_stream,
       else
         {
           GDBusMessage *message;
+          GBytes *blob_bytes = NULL;
+          const gchar *blob;
           error = NULL;
 
           /* TODO: use connection->priv->auth to decode the message */
 
-          message = g_dbus_message_new_from_blob ((guchar *) worker->read_buffer,
-                                                  worker->read_buffer_cur_size,
-                                                  worker->capabilities,
-                                                  &error);
+          if (worker->lazy_message_body)
+            {
+              /* Hand the read buffer over to the message rather than
+               * copying the body out of it; a new one is allocated for the
+               * next message. Shrinking is normally done in place. */
+              blob_bytes = g_bytes_new_take (g_realloc (g_steal_pointer (&worker->read_buffer),
+                                                        worker->read_buffer_cur_size),
+                                             worker->read_buffer_cur_size);
+              worker->read_buffer_allocated_size = 0;
+              blob = g_bytes_get_data (blob_bytes, NULL);
+
+              message = g_dbus_message_new_from_bytes (blob_bytes,
+                                                       worker->capabilities,
+                                                       &error);
+            }
+          else
+            {
+              blob = worker->read_buffer;
+              message = g_dbus_message_new_from_blob ((guchar *) worker->read_buffer,
+                                                      worker->read_buffer_cur_size,
+                                                      worker->capabilities,
+                                                      &error);
+            }
+
           if (message == NULL)
             {
               gchar *s;
-              s = _g_dbus_hexdump (worker->read_buffer, worker->read_buffer_cur_size, 2);
+              s = _g_dbus_hexdump (blob, worker->read_buffer_cur_size, 2);
               g_warning ("Error decoding D-Bus message of %" G_GSIZE_FORMAT " bytes\n"
                          "The error is: %s\n"
                          "The payload is as follows:\n"
@@ -765,6 +801,7 @@ _g_dbus_worker_do_read_cb (GInputStream  *input_stream,
                          error->message,
                          s);
               g_free (s);
+              g_clear_pointer (&blob_bytes, g_bytes_unref);
               _g_dbus_worker_emit_disconnected (worker, FALSE, error);
               g_error_free (error);
               goto out;
@@ -792,13 +829,15 @@ _g_dbus_worker_do_read_cb (GInputStream  *input_stream,
               g_free (s);
               if (G_UNLIKELY (_g_dbus_debug_payload ()))
                 {
-                  s = _g_dbus_hexdump (worker->read_buffer, worker->read_buffer_cur_size, 2);
+                  s = _g_dbus_hexdump (blob, worker->read_buffer_cur_size, 2);
                   g_print ("%s\n", s);
                   g_free (s);
                 }
               _g_dbus_debug_print_unlock ();
             }
 
+          g_clear_pointer (&blob_bytes, g_bytes_unref);
+
           /* yay, got a message, go deliver it */
           _g_dbus_worker_queue_or_deliver_received_message (worker, g_steal_pointer (&message));
 
@@ -890,9 +929,6 @@ struct _MessageToWriteData
   GDBusMessage *message;  /* (owned) */
   gchar        *blob;
   gsize         blob_size;
-
-  gsize         total_written;
-  GTask        *task;  /* (owned) and (nullable) before writing starts and after g_task_return_*() is called */
 };
 
 static void
@@ -902,30 +938,142 @@ message_to_write_data_free (MessageToWriteData *data)
   g_clear_object (&data->message);
   g_free (data->blob);
 
+  g_slice_free (MessageToWriteData, data);
+}
+
+/* ---------------------------------------------------------------------------------------------------- */
+
+/* Consecutive messages in the write queue are written out together, with
+ * one vectored write per batch rather than one write per message. These
+ * bound the size of a batch. */
+#define MAX_MESSAGES_PER_WRITE 64
+#define MAX_BYTES_PER_WRITE (128 * 1024)
+
+struct _MessagesToWriteData
+{
+  GDBusWorker        *worker;
+  MessageToWriteData *messages[MAX_MESSAGES_PER_WRITE];  /* (owned) */
+  guint               n_messages;
+  gsize               total_size;
+
+  gsize               total_written;
+  guint               n_writes;
+  /* the part of the batch being written by the current write */
+  GOutputVector       vectors[MAX_MESSAGES_PER_WRITE];
+  GTask              *task;  /* (owned) and (nullable) before writing starts and after g_task_return_*() is called */
+};
+
+static void
+messages_to_write_data_free (MessagesToWriteData *data)
+{
+  guint i;
+
+  for (i = 0; i < data->n_messages; i++)
+    message_to_write_data_free (data->messages[i]);
+  _g_dbus_worker_unref (data->worker);
+
   /* The task must either not have been created, or have been created, returned
    * and finalised by now. */
   g_assert (data->task == NULL);
 
-  g_slice_free (MessageToWriteData, data);
+  g_free (data);
 }
 
-/* ---------------------------------------------------------------------------------------------------- */
+static gboolean
+message_to_write_data_has_fd_list (MessageToWriteData *data)
+{
+#ifdef G_OS_UNIX
+  return g_dbus_message_get_unix_fd_list (data->message) != NULL;
+#else
+  return FALSE;
+#endif
+}
+
+/*
+ * Fills @data->vectors with the unwritten part of the batch, up to the
+ * next message which carries file descriptors: those have to be attached
+ * to the first byte of their own message, so they always start a new
+ * write.
+ *
+ * Returns: the number of vectors; @out_first is set to the index of the
+ * message the write starts in, and @out_offset to the offset into it.
+ */
+static guint
+write_messages_prepare_vectors (MessagesToWriteData *data,
+                                guint               *out_first,
+                                gsize               *out_offset)
+{
+  gsize offset = data->total_written;
+  guint first, i, n_vectors;
+
+  for (first = 0; offset >= data->messages[first]->blob_size; first++)
+    offset -= data->messages[first]->blob_size;
 
-static void write_message_continue_writing (MessageToWriteData *data);
+  data->vectors[0].buffer = data->messages[first]->blob + offset;
+  data->vectors[0].size = data->messages[first]->blob_size - offset;
+  n_vectors = 1;
+
+  for (i = first + 1; i < data->n_messages; i++)
+    {
+      if (message_to_write_data_has_fd_list (data->messages[i]))
+        break;
+
+      data->vectors[n_vectors].buffer = data->messages[i]->blob;
+      data->vectors[n_vectors].size = data->messages[i]->blob_size;
+      n_vectors++;
+    }
+
+  *out_first = first;
+  *out_offset = offset;
+
+  return n_vectors;
+}
+
+static void write_messages_continue_writing (MessagesToWriteData *data);
 
 /* called in private thread shared by all GDBusConnection instances
  *
  * write-lock is not held on entry
  * output_pending is PENDING_WRITE on entry
- * @user_data is (transfer full)
  */
 static void
-write_message_async_cb (GObject      *source_object,
-                        GAsyncResult *res,
-                        gpointer      user_data)
+write_messages_written (MessagesToWriteData *data,
+                        gsize                bytes_written,
+                        guint                first,
+                        guint                n_vectors)
 {
-  MessageToWriteData *data = g_steal_pointer (&user_data);
-  gssize bytes_written;
+  write_messages_print_transport_debug (bytes_written, data, first, n_vectors);
+
+  data->n_writes++;
+  data->total_written += bytes_written;
+  g_assert (data->total_written <= data->total_size);
+  if (data->total_written == data->total_size)
+    {
+      GTask *task = g_steal_pointer (&data->task);
+      g_task_return_boolean (task, TRUE);
+      g_clear_object (&task);
+      return;
+    }
+
+  write_messages_continue_writing (g_steal_pointer (&data));
+}
+
+/* called in private thread shared by all GDBusConnection instances
+ *
+ * write-lock is not held on entry
+ * output_pending is PENDING_WRITE on entry
+ * @user_data is (transfer full)
+ */
+static void
+write_messages_async_cb (GObject      *source_object,
+                         GAsyncResult *res,
+                         gpointer      user_data)
+{
+  MessagesToWriteData *data = g_steal_pointer (&user_data);
+  gsize bytes_written;
+  guint first;
+  gsize offset;
+  guint n_vectors;
   GError *error;
 
   /* The ownership of @data is a bit odd in this function: it’s (transfer full)
@@ -935,34 +1083,22 @@ write_message_async_cb (GObject      *source_object,
    * like @data is not always freed on every code path in this function. */
 
   error = NULL;
-  bytes_written = g_output_stream_write_finish (G_OUTPUT_STREAM (source_object),
-                                                res,
-                                                &error);
-  if (bytes_written == -1)
+  if (!g_output_stream_writev_finish (G_OUTPUT_STREAM (source_object),
+                                      res,
+                                      &bytes_written,
+                                      &error))
     {
       GTask *task = g_steal_pointer (&data->task);
       g_task_return_error (task, error);
       g_clear_object (&task);
-      goto out;
+      return;
     }
   g_assert (bytes_written > 0); /* zero is never returned */
 
-  write_message_print_transport_debug (bytes_written, data);
-
-  data->total_written += bytes_written;
-  g_assert (data->total_written <= data->blob_size);
-  if (data->total_written == data->blob_size)
-    {
-      GTask *task = g_steal_pointer (&data->task);
-      g_task_return_boolean (task, TRUE);
-      g_clear_object (&task);
-      goto out;
-    }
-
-  write_message_continue_writing (g_steal_pointer (&data));
+  /* recompute which messages the write covered, for the debug output */
+  n_vectors = write_messages_prepare_vectors (data, &first, &offset);
 
- out:
-  ;
+  write_messages_written (g_steal_pointer (&data), bytes_written, first, n_vectors);
 }
 
 /* called in private thread shared by all GDBusConnection instances
@@ -976,8 +1112,8 @@ on_socket_ready (GSocket      *socket,
                  GIOCondition  condition,
                  gpointer      user_data)
 {
-  MessageToWriteData *data = g_steal_pointer (&user_data);
-  write_message_continue_writing (g_steal_pointer (&data));
+  MessagesToWriteData *data = g_steal_pointer (&user_data);
+  write_messages_continue_writing (g_steal_pointer (&data));
   return G_SOURCE_REMOVE;
 }
 #endif
@@ -989,9 +1125,12 @@ on_socket_ready (GSocket      *socket,
  * @data is (transfer full)
  */
 static void
-write_message_continue_writing (MessageToWriteData *data)
+write_messages_continue_writing (MessagesToWriteData *data)
 {
   GOutputStream *ostream;
+  guint first;
+  gsize offset;
+  guint n_vectors;
 #ifdef G_OS_UNIX
   GUnixFDList *fd_list;
 #endif
@@ -1003,27 +1142,29 @@ write_message_continue_writing (MessageToWriteData *data)
    * like @data is not always freed on every code path in this function. */
 
   ostream = g_io_stream_get_output_stream (data->worker->stream);
-#ifdef G_OS_UNIX
-  fd_list = g_dbus_message_get_unix_fd_list (data->message);
-#endif
 
   g_assert (!g_output_stream_has_pending (ostream));
-  g_assert_cmpint (data->total_written, <, data->blob_size);
+  g_assert_cmpint (data->total_written, <, data->total_size);
+
+  n_vectors = write_messages_prepare_vectors (data, &first, &offset);
+
+#ifdef G_OS_UNIX
+  /* The fd list has to be attached to byte 0 of its message */
+  fd_list = NULL;
+  if (offset == 0)
+    fd_list = g_dbus_message_get_unix_fd_list (data->messages[first]->message);
+#endif
 
   if (FALSE)
     {
     }
 #ifdef G_OS_UNIX
-  else if (G_IS_SOCKET_OUTPUT_STREAM (ostream) && data->total_written == 0)
+  else if (G_IS_SOCKET_OUTPUT_STREAM (ostream))
     {
-      GOutputVector vector;
       GSocketControlMessage *control_message;
       gssize bytes_written;
       GError *error;
 
-      vector.buffer = data->blob;
-      vector.size = data->blob_size;
-
       control_message = NULL;
       if (fd_list != NULL && g_unix_fd_list_get_length (fd_list) > 0)
         {
@@ -1045,8 +1186,8 @@ write_message_continue_writing (MessageToWriteData *data)
       error = NULL;
       bytes_written = g_socket_send_message (data->worker->socket,
                                              NULL, /* address */
-                                             &vector,
-                                             1,
+                                             data->vectors,
+                                             n_vectors,
                                              control_message != NULL ? &control_message : NULL,
                                              control_message != NULL ? 1 : 0,
                                              G_SOCKET_MSG_NONE,
@@ -1083,25 +1224,13 @@ write_message_continue_writing (MessageToWriteData *data)
         }
       g_assert (bytes_written > 0); /* zero is never returned */
 
-      write_message_print_transport_debug (bytes_written, data);
-
-      data->total_written += bytes_written;
-      g_assert (data->total_written <= data->blob_size);
-      if (data->total_written == data->blob_size)
-        {
-          GTask *task = g_steal_pointer (&data->task);
-          g_task_return_boolean (task, TRUE);
-          g_clear_object (&task);
-          goto out;
-        }
-
-      write_message_continue_writing (g_steal_pointer (&data));
+      write_messages_written (g_steal_pointer (&data), bytes_written, first, n_vectors);
     }
 #endif
   else
     {
 #ifdef G_OS_UNIX
-      if (data->total_written == 0 && fd_list != NULL)
+      if (fd_list != NULL)
         {
           /* We were trying to write byte 0 of the message, which needs
            * the fd list to be attached to it, but this connection doesn't
@@ -1117,13 +1246,13 @@ write_message_continue_writing (MessageToWriteData *data)
         }
 #endif
 
-      g_output_stream_write_async (ostream,
-                                   (const gchar *) data->blob + data->total_written,
-                                   data->blob_size - data->total_written,
-                                   G_PRIORITY_DEFAULT,
-                                   data->worker->cancellable,
-                                   write_message_async_cb,
-                                   data);  /* steal @data */
+      g_output_stream_writev_async (ostream,
+                                    data->vectors,
+                                    n_vectors,
+                                    G_PRIORITY_DEFAULT,
+                                    data->worker->cancellable,
+                                    write_messages_async_cb,
+                                    data);  /* steal @data */
     }
 #ifdef G_OS_UNIX
  out:
@@ -1137,22 +1266,22 @@ write_message_continue_writing (MessageToWriteData *data)
  * output_pending is PENDING_WRITE on entry
  */
 static void
-write_message_async (GDBusWorker         *worker,
-                     MessageToWriteData  *data,
-                     GAsyncReadyCallback  callback,
-                     gpointer             user_data)
+write_messages_async (GDBusWorker         *worker,
+                      MessagesToWriteData *data,
+                      GAsyncReadyCallback  callback,
+                      gpointer             user_data)
 {
   data->task = g_task_new (NULL, NULL, callback, user_data);
-  g_task_set_source_tag (data->task, write_message_async);
-  g_task_set_name (data->task, "[gio] D-Bus write message");
+  g_task_set_source_tag (data->task, write_messages_async);
+  g_task_set_name (data->task, "[gio] D-Bus write messages");
   data->total_written = 0;
-  write_message_continue_writing (g_steal_pointer (&data));
+  write_messages_continue_writing (g_steal_pointer (&data));
 }
 
 /* called in private thread shared by all GDBusConnection instances (with write-lock held) */
 static gboolean
-write_message_finish (GAsyncResult   *res,
-                      GError        **error)
+write_messages_finish (GAsyncResult   *res,
+                       GError        **error)
 {
   g_return_val_if_fail (g_task_is_valid (res, NULL), FALSE);
 
@@ -1338,19 +1467,21 @@ prepare_flush_unlocked (GDBusWorker *worker)
  * @user_data is (transfer full)
  */
 static void
-write_message_cb (GObject       *source_object,
-                  GAsyncResult  *res,
-                  gpointer       user_data)
+write_messages_cb (GObject       *source_object,
+                   GAsyncResult  *res,
+                   gpointer       user_data)
 {
-  MessageToWriteData *data = user_data;
+  MessagesToWriteData *data = user_data;
   GError *error;
+  guint i;
 
   g_mutex_lock (&data->worker->write_lock);
   g_assert (data->worker->output_pending == PENDING_WRITE);
   data->worker->output_pending = PENDING_NONE;
+  data->worker->write_num_messages_in_flight = 0;
 
   error = NULL;
-  if (!write_message_finish (res, &error))
+  if (!write_messages_finish (res, &error))
     {
       g_mutex_unlock (&data->worker->write_lock);
 
@@ -1361,13 +1492,15 @@ write_message_cb (GObject       *source_object,
       g_mutex_lock (&data->worker->write_lock);
     }
 
-  message_written_unlocked (data->worker, data);
+  for (i = 0; i < data->n_messages; i++)
+    message_written_unlocked (data->worker, data->messages[i]);
+  data->worker->write_num_writes += data->n_writes;
 
   g_mutex_unlock (&data->worker->write_lock);
 
   continue_writing (data->worker);
 
-  message_to_write_data_free (data);
+  messages_to_write_data_free (data);
 }
 
 /* called in private thread shared by all GDBusConnection instances
@@ -1439,6 +1572,130 @@ iostream_close_cb (GObject      *source_object,
   _g_dbus_worker_unref (worker);
 }
 
+/* called in private thread shared by all GDBusConnection instances
+ *
+ * write-lock is held on entry
+ * output_pending is PENDING_NONE on entry
+ *
+ * Returns: (nullable): the next messages to write, setting @output_pending
+ */
+static MessagesToWriteData *
+pop_messages_to_write_unlocked (GDBusWorker *worker)
+{
+  MessagesToWriteData *data;
+  MessageToWriteData *message_data;
+  guint64 max_messages = MAX_MESSAGES_PER_WRITE;
+  GList *l;
+
+  message_data = g_queue_pop_head (worker->write_queue);
+  if (message_data == NULL)
+    return NULL;
+
+  /* Pending flushes wait for a given number of messages to have been
+   * written, so a batch must not go past that */
+  for (l = worker->write_pending_flushes; l != NULL; l = l->next)
+    {
+      FlushData *f = l->data;
+
+      if (f->number_to_wait_for > worker->write_num_messages_written)
+        max_messages = MIN (max_messages, f->number_to_wait_for - worker->write_num_messages_written);
+    }
+
+  data = g_new0 (MessagesToWriteData, 1);
+  data->worker = _g_dbus_worker_ref (worker);
+
+  do
+    {
+      data->messages[data->n_messages++] = message_data;
+      data->total_size += message_data->blob_size;
+
+      message_data = g_queue_peek_head (worker->write_queue);
+      if (message_data == NULL ||
+          data->n_messages >= max_messages ||
+          data->total_size + message_data->blob_size > MAX_BYTES_PER_WRITE)
+        break;
+
+      g_queue_pop_head (worker->write_queue);
+    }
+  while (TRUE);
+
+  worker->output_pending = PENDING_WRITE;
+  worker->write_num_messages_in_flight = data->n_messages;
+
+  return data;
+}
+
+/* called in private thread shared by all GDBusConnection instances
+ *
+ * write-lock is not held on entry
+ * output_pending is PENDING_WRITE on entry
+ *
+ * Runs the filters on the messages in @data, in order, dropping or
+ * re-encoding them as needed. Returns the number of messages left.
+ */
+static guint
+filter_messages_to_write (GDBusWorker         *worker,
+                          MessagesToWriteData *data)
+{
+  guint i, n_kept;
+
+  data->total_size = 0;
+
+  for (i = 0, n_kept = 0; i < data->n_messages; i++)
+    {
+      MessageToWriteData *message_data = data->messages[i];
+      GDBusMessage *old_message;
+      guchar *new_blob;
+      gsize new_blob_size;
+      GError *error;
+
+      old_message = message_data->message;
+      message_data->message = _g_dbus_worker_emit_message_about_to_be_sent (worker, message_data->message);
+      if (message_data->message == old_message)
+        {
+          /* filters had no effect - do nothing */
+        }
+      else if (message_data->message == NULL)
+        {
+          /* filters dropped message */
+          message_to_write_data_free (message_data);
+          continue;
+        }
+      else
+        {
+          /* filters altered the message -> re-encode */
+          error = NULL;
+          new_blob = g_dbus_message_to_blob (message_data->message,
+                                             &new_blob_size,
+                                             worker->capabilities,
+                                             &error);
+          if (new_blob == NULL)
+            {
+              /* if filter make the GDBusMessage unencodeable, just complain on stderr and send
+               * the old message instead
+               */
+              g_warning ("Error encoding GDBusMessage with serial %d altered by filter function: %s",
+                         g_dbus_message_get_serial (message_data->message),
+                         error->message);
+              g_error_free (error);
+            }
+          else
+            {
+              g_free (message_data->blob);
+              message_data->blob = (gchar *) new_blob;
+              message_data->blob_size = new_blob_size;
+            }
+        }
+
+      data->messages[n_kept++] = message_data;
+      data->total_size += message_data->blob_size;
+    }
+
+  data->n_messages = n_kept;
+
+  return n_kept;
+}
+
 /* called in private thread shared by all GDBusConnection instances
  *
  * write-lock is not held on entry
@@ -1447,8 +1704,9 @@ iostream_close_cb (GObject      *source_object,
 static void
 continue_writing (GDBusWorker *worker)
 {
-  MessageToWriteData *data;
+  MessagesToWriteData *data;
   FlushAsyncData *flush_async_data;
+  guint n_popped;
 
  write_next:
   /* we mustn't try to write two things at once */
@@ -1479,12 +1737,7 @@ continue_writing (GDBusWorker *worker)
       flush_async_data = prepare_flush_unlocked (worker);
 
       if (flush_async_data == NULL)
-        {
-          data = g_queue_pop_head (worker->write_queue);
-
-          if (data != NULL)
-            worker->output_pending = PENDING_WRITE;
-        }
+        data = pop_messages_to_write_unlocked (worker);
     }
 
   g_mutex_unlock (&worker->write_lock);
@@ -1505,56 +1758,28 @@ continue_writing (GDBusWorker *worker)
     }
   else if (data != NULL)
     {
-      GDBusMessage *old_message;
-      guchar *new_blob;
-      gsize new_blob_size;
-      GError *error;
+      n_popped = data->n_messages;
 
-      old_message = data->message;
-      data->message = _g_dbus_worker_emit_message_about_to_be_sent (worker, data->message);
-      if (data->message == old_message)
+      if (filter_messages_to_write (worker, data) != n_popped)
         {
-          /* filters had no effect - do nothing */
-        }
-      else if (data->message == NULL)
-        {
-          /* filters dropped message */
           g_mutex_lock (&worker->write_lock);
-          worker->output_pending = PENDING_NONE;
+          worker->write_num_messages_in_flight = data->n_messages;
+          if (data->n_messages == 0)
+            worker->output_pending = PENDING_NONE;
           g_mutex_unlock (&worker->write_lock);
-          message_to_write_data_free (data);
-          goto write_next;
-        }
-      else
-        {
-          /* filters altered the message -> re-encode */
-          error = NULL;
-          new_blob = g_dbus_message_to_blob (data->message,
-                                             &new_blob_size,
-                                             worker->capabilities,
-                                             &error);
-          if (new_blob == NULL)
-            {
-              /* if filter make the GDBusMessage unencodeable, just complain on stderr and send
-               * the old message instead
-               */
-              g_warning ("Error encoding GDBusMessage with serial %d altered by filter function: %s",
-                         g_dbus_message_get_serial (data->message),
-                         error->message);
-              g_error_free (error);
-            }
-          else
+
+          if (data->n_messages == 0)
             {
-              g_free (data->blob);
-              data->blob = (gchar *) new_blob;
-              data->blob_size = new_blob_size;
+              /* filters dropped all messages */
+              messages_to_write_data_free (data);
+              goto write_next;
             }
         }
 
-      write_message_async (worker,
-                           data,
-                           write_message_cb,
-                           data);  /* takes ownership of @data as user_data */
+      write_messages_async (worker,
+                            data,
+                            write_messages_cb,
+                            data);  /* takes ownership of @data as user_data */
     }
 }
 
@@ -1664,12 +1889,28 @@ _g_dbus_worker_send_message (GDBusWorker    *worker,
   g_mutex_unlock (&worker->write_lock);
 }
 
+/* can be called from any thread
+ *
+ * write_lock is not held on entry
+ */
+void
+_g_dbus_worker_get_write_statistics (GDBusWorker *worker,
+                                     guint64     *out_n_messages,
+                                     guint64     *out_n_writes)
+{
+  g_mutex_lock (&worker->write_lock);
+  *out_n_messages = worker->write_num_messages_written;
+  *out_n_writes = worker->write_num_writes;
+  g_mutex_unlock (&worker->write_lock);
+}
+
 /* ---------------------------------------------------------------------------------------------------- */
 
 GDBusWorker *
 _g_dbus_worker_new (GIOStream                              *stream,
                     GDBusCapabilityFlags                    capabilities,
                     gboolean                                initially_frozen,
+                    gboolean                                lazy_message_body,
                     GDBusWorkerMessageReceivedCallback      message_received_callback,
                     GDBusWorkerMessageAboutToBeSentCallback message_about_to_be_sent_callback,
                     GDBusWorkerDisconnectedCallback         disconnected_callback,
@@ -1697,6 +1938,7 @@ _g_dbus_worker_new (GIOStream                              *stream,
   worker->output_pending = PENDING_NONE;
 
   worker->frozen = initially_frozen;
+  worker->lazy_message_body = lazy_message_body;
   worker->received_messages_while_frozen = g_queue_new ();
 
   g_mutex_init (&worker->write_lock);
@@ -1803,7 +2045,7 @@ _g_dbus_worker_flush_sync (GDBusWorker    *worker,
    * flush operation that follows it
    */
   if (worker->output_pending == PENDING_WRITE)
-    pending_writes += 1;
+    pending_writes += worker->write_num_messages_in_flight;
 
   if (pending_writes > 0 ||
       worker->write_num_messages_written != worker->write_num_messages_flushed)
@@ -2524,8 +2766,10 @@ _g_dbus_enum_to_string (GType enum_type, gint value)
 /* ---------------------------------------------------------------------------------------------------- */
 
 static void
-write_message_print_transport_debug (gssize bytes_written,
-                                     MessageToWriteData *data)
+write_messages_print_transport_debug (gsize                bytes_written,
+                                      MessagesToWriteData *data,
+                                      guint                first,
+                                      guint                n_vectors)
 {
   if (G_LIKELY (!_g_dbus_debug_transport ()))
     goto out;
@@ -2533,11 +2777,12 @@ write_message_print_transport_debug (gssize bytes_written,
   _g_dbus_debug_print_lock ();
   g_print ("========================================================================\n"
            "GDBus-debug:Transport:\n"
-           "  >>>> WROTE %" G_GSSIZE_FORMAT " bytes of message with serial %d and\n"
-           "       size %" G_GSIZE_FORMAT " from offset %" G_GSIZE_FORMAT " on a %s\n",
+           "  >>>> WROTE %" G_GSIZE_FORMAT " bytes of %u message(s) starting with serial %d and\n"
+           "       total size %" G_GSIZE_FORMAT " from offset %" G_GSIZE_FORMAT " on a %s\n",
            bytes_written,
-           g_dbus_message_get_serial (data->message),
-           data->blob_size,
+           n_vectors,
+           g_dbus_message_get_serial (data->messages[first]->message),
+           data->total_size,
            data->total_written,
            g_type_name (G_TYPE_FROM_INSTANCE (g_io_stream_get_output_stream (data->worker->stream))));
   _g_dbus_debug_print_unlock ();
@@ -91,6 +91,7 @@ typedef void (*GDBusWorkerDisconnectedCallback)    (GDBusWorker   *worker,
 GDBusWorker *_g_dbus_worker_new          (GIOStream                          *stream,
                                           GDBusCapabilityFlags                capabilities,
                                           gboolean                            initially_frozen,
+                                          gboolean                            lazy_message_body,
                                           GDBusWorkerMessageReceivedCallback  message_received_callback,
                                           GDBusWorkerMessageAboutToBeSentCallback message_about_to_be_sent_callback,
                                           GDBusWorkerDisconnectedCallback     disconnected_callback,
@@ -105,6 +106,11 @@ void         _g_dbus_worker_send_message (GDBusWorker    *worker,
 /* can be called from any thread */
 void         _g_dbus_worker_stop         (GDBusWorker    *worker);
 
+/* can be called from any thread */
+void         _g_dbus_worker_get_write_statistics (GDBusWorker *worker,
+                                                  guint64     *out_n_messages,
+                                                  guint64     *out_n_writes);
+
 /* can be called from any thread */
 void         _g_dbus_worker_unfreeze     (GDBusWorker    *worker);
 
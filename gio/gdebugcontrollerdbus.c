@@ -76,6 +76,16 @@
  * except root. It will not prevent the `DebugEnabled` property from being read,
  * as it’s accessed through the `org.freedesktop.DBus.Properties` interface.
  *
+ * While debug output is enabled, dispatch statistics are also collected for
+ * the sources of the global-default [struct@GLib.MainContext], unless the
+ * process already collects them itself, in which case disabling debug output
+ * leaves them alone. Remote processes can read them with
+ * `org.gtk.Debugging.GetMainContextStats()`, which returns the result of
+ * [method@GLib.MainContext.get_source_stats] (since 2.86). Calls to it are
+ * authorized in the same way as calls to `SetDebugEnabled()`, and restricting
+ * access to the whole `org.gtk.Debugging` interface, as above, restricts this
+ * method too.
+ *
  * Another option is to use polkit to allow or deny requests on a case-by-case
  * basis, allowing for the possibility of dynamic authorisation. To do this,
  * connect to the [signal@Gio.DebugControllerDBus::authorize] signal and query
@@ -154,6 +164,9 @@ static const gchar org_gtk_Debugging_xml[] =
       "<method name='SetDebugEnabled'>"
         "<arg type='b' name='debug-enabled' direction='in'/>"
       "</method>"
+      "<method name='GetMainContextStats'>"
+        "<arg type='a{sa{sv}}' name='stats' direction='out'/>"
+      "</method>"
     "</interface>"
   "</node>";
 
@@ -192,6 +205,7 @@ typedef struct
   GPtrArray *pending_authorize_tasks;  /* (element-type GWeakRef) (owned) (nullable) */
 
   gboolean debug_enabled;
+  gboolean enabled_source_stats;  /* whether debug_enabled turned them on */
 } GDebugControllerDBusPrivate;
 
 G_DEFINE_TYPE_WITH_CODE (GDebugControllerDBus, g_debug_controller_dbus, G_TYPE_OBJECT,
@@ -232,6 +246,19 @@ set_debug_enabled (GDebugControllerDBus *self,
       /* Change the default log writer’s behaviour in GLib. */
       g_log_set_debug_enabled (debug_enabled);
 
+      /* Find out which sources keep the main loop busy, but only turn that
+       * off again if it was us who turned it on. */
+      if (debug_enabled && !g_main_context_get_source_stats_enabled (NULL))
+        {
+          g_main_context_set_source_stats_enabled (NULL, TRUE);
+          priv->enabled_source_stats = TRUE;
+        }
+      else if (!debug_enabled && priv->enabled_source_stats)
+        {
+          g_main_context_set_source_stats_enabled (NULL, FALSE);
+          priv->enabled_source_stats = FALSE;
+        }
+
       /* Notify internally and externally of the property change. */
       g_object_notify (G_OBJECT (self), "debug-enabled");
 
@@ -349,6 +376,7 @@ authorize_cb (GObject      *object,
   GTask *task = G_TASK (result);
   GDBusMethodInvocation *invocation = g_task_get_task_data (task);
   GVariant *parameters = g_dbus_method_invocation_get_parameters (invocation);
+  const gchar *method_name = g_dbus_method_invocation_get_method_name (invocation);
   gboolean enabled = FALSE;
   gboolean authorized;
 
@@ -357,10 +385,20 @@ authorize_cb (GObject      *object,
 
   if (!authorized)
     {
-      GError *local_error = g_error_new (G_DBUS_ERROR, G_DBUS_ERROR_ACCESS_DENIED,
-                                         _("Not authorized to change debug settings"));
+      GError *local_error = g_error_new_literal (G_DBUS_ERROR, G_DBUS_ERROR_ACCESS_DENIED,
+                                                 g_str_equal (method_name, "GetMainContextStats") ?
+                                                 _("Not authorized to read debug statistics") :
+                                                 _("Not authorized to change debug settings"));
       g_dbus_method_invocation_take_error (invocation, g_steal_pointer (&local_error));
     }
+  else if (g_str_equal (method_name, "GetMainContextStats"))
+    {
+      GVariant *stats = g_main_context_get_source_stats (NULL);
+
+      g_dbus_method_invocation_return_value (invocation,
+                                             g_variant_new_tuple (&stats, 1));
+      g_variant_unref (stats);
+    }
   else
     {
       /* Update the property value. */
@@ -392,7 +430,8 @@ dbus_method_call (GDBusConnection       *connection,
   GDebugControllerDBusClass *klass = G_DEBUG_CONTROLLER_DBUS_GET_CLASS (self);
 
   /* Only on the org.gtk.Debugging interface */
-  if (g_str_equal (method_name, "SetDebugEnabled"))
+  if (g_str_equal (method_name, "SetDebugEnabled") ||
+      g_str_equal (method_name, "GetMainContextStats"))
     {
       GTask *task = NULL;
 
@@ -410,7 +449,8 @@ dbus_method_call (GDBusConnection       *connection,
       /* Take the opportunity to clean up a bit. */
       garbage_collect_weak_refs (self);
 
-      /* Check the calling peer is authorised to change the debug mode. So that
+      /* Check the calling peer is authorised to change the debug mode, or to
+       * read the statistics collected while it is enabled. So that
        * the signal handler can block on checking polkit authorisation (which
        * definitely involves D-Bus calls, and might involve user interaction),
        * emit the #GDebugControllerDBus::authorize signal in a worker thread, so
@@ -579,6 +619,10 @@ g_debug_controller_dbus_class_init (GDebugControllerDBusClass *klass)
    * Emitted when a D-Bus peer is trying to change the debug settings and used
    * to determine if that is authorized.
    *
+   * Since 2.86, it is also emitted when a peer is trying to read the main
+   * context statistics, which can be told apart by the method name of
+   * @invocation.
+   *
    * This signal is emitted in a dedicated worker thread, so handlers are
    * allowed to perform blocking I/O. This means that, for example, it is
    * appropriate to call `polkit_authority_check_authorization_sync()` to check
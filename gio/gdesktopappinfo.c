@@ -152,6 +152,9 @@ typedef struct
   GHashTable                 *mime_tweaks;
   GHashTable                 *memory_index;
   GHashTable                 *memory_implementations;
+  GVariant                   *cache;  /* (nullable) (owned) */
+  GVariant                   *scanned_dirs;  /* (nullable) (owned) */
+  gboolean                    cache_is_current;
 } DesktopFileDir;
 
 static GPtrArray      *desktop_file_dirs = NULL;
@@ -766,19 +769,55 @@ merge_directory_results (void)
 }
 
 /* Support for unindexed DesktopFileDirs {{{2 */
+static gint64
+get_stat_mtime (const GStatBuf *buf)
+{
+#if defined (HAVE_STRUCT_STAT_ST_MTIM_TV_NSEC)
+  return (gint64) buf->st_mtim.tv_sec * G_USEC_PER_SEC + buf->st_mtim.tv_nsec / 1000;
+#elif defined (HAVE_STRUCT_STAT_ST_MTIMENSEC)
+  return (gint64) buf->st_mtime * G_USEC_PER_SEC + buf->st_mtimensec / 1000;
+#else
+  return (gint64) buf->st_mtime * G_USEC_PER_SEC;
+#endif
+}
+
+static gint64
+get_stat_ctime (const GStatBuf *buf)
+{
+#if defined (HAVE_STRUCT_STAT_ST_CTIM_TV_NSEC)
+  return (gint64) buf->st_ctim.tv_sec * G_USEC_PER_SEC + buf->st_ctim.tv_nsec / 1000;
+#elif defined (HAVE_STRUCT_STAT_ST_CTIMENSEC)
+  return (gint64) buf->st_ctime * G_USEC_PER_SEC + buf->st_ctimensec / 1000;
+#else
+  return (gint64) buf->st_ctime * G_USEC_PER_SEC;
+#endif
+}
+
+/* Adds the desktop files in @dirname and its subdirectories to @apps, and
+ * each directory listed, with its modification time, to @dirs, of type
+ * `a(sx)`. */
 static void
-get_apps_from_dir (GHashTable **apps,
-                   const char  *dirname,
-                   const char  *prefix)
+get_apps_from_dir (GHashTable      **apps,
+                   const char       *dirname,
+                   const char       *prefix,
+                   GVariantBuilder  *dirs)
 {
   const char *basename;
+  GStatBuf buf;
   GDir *dir;
 
+  /* Take the modification time before listing, so that any later change
+   * to the directory invalidates the cache */
+  if (g_stat (dirname, &buf) != 0)
+    return;
+
   dir = g_dir_open (dirname, 0, NULL);
 
   if (dir == NULL)
     return;
 
+  g_variant_builder_add (dirs, "(sx)", dirname, get_stat_mtime (&buf));
+
   while ((basename = g_dir_read_name (dir)) != NULL)
     {
       gchar *filename;
@@ -801,7 +840,7 @@ get_apps_from_dir (GHashTable **apps,
           gchar *subprefix;
 
           subprefix = g_strconcat (prefix, basename, "-", NULL);
-          get_apps_from_dir (apps, filename, subprefix);
+          get_apps_from_dir (apps, filename, subprefix, dirs);
           g_free (subprefix);
         }
 
@@ -811,6 +850,158 @@ get_apps_from_dir (GHashTable **apps,
   g_dir_close (dir);
 }
 
+/* The app list and search index of each DesktopFileDir are cached in the
+ * user's cache directory, so that each process does not have to list the
+ * directory and parse every desktop file in it again. The cache is a
+ * serialised GVariant holding:
+ *
+ *  - the format version;
+ *  - the language names the search index was built for;
+ *  - the directories listed for the app list, with their modification times;
+ *  - the app list, as (desktop ID, filename) pairs;
+ *  - the search index entries, as (desktop ID, file size, file modification
+ *    time, (token, match category, token position) list, Implements= list).
+ *
+ * The app list is only used if none of the directories have been modified
+ * since, and each index entry only if its desktop file has not been.
+ */
+#define DESKTOP_FILE_DIR_CACHE_VERSION 2
+#define DESKTOP_FILE_DIR_CACHE_ENTRY_TYPE "(sttxxa(syu)as)"
+#define DESKTOP_FILE_DIR_CACHE_TYPE "(usa(sx)a(ss)a" DESKTOP_FILE_DIR_CACHE_ENTRY_TYPE ")"
+
+static gchar *
+desktop_file_dir_get_cache_filename (DesktopFileDir *dir)
+{
+  gchar *checksum;
+  gchar *basename;
+  gchar *filename;
+
+  checksum = g_compute_checksum_for_string (G_CHECKSUM_SHA256, dir->path, -1);
+  basename = g_strconcat (checksum, ".cache", NULL);
+  filename = g_build_filename (g_get_user_cache_dir (), "glib-2.0",
+                               "desktop-app-info", basename, NULL);
+  g_free (basename);
+  g_free (checksum);
+
+  return filename;
+}
+
+static void
+desktop_file_dir_load_cache (DesktopFileDir *dir)
+{
+  GMappedFile *mapped_file;
+  GBytes *bytes;
+  GVariant *cache;
+  guint32 version;
+  gchar *filename;
+
+  filename = desktop_file_dir_get_cache_filename (dir);
+  mapped_file = g_mapped_file_new (filename, FALSE, NULL);
+  g_free (filename);
+
+  if (mapped_file == NULL)
+    return;
+
+  bytes = g_mapped_file_get_bytes (mapped_file);
+  g_mapped_file_unref (mapped_file);
+
+  /* The cache is not trusted, so its contents are checked as they are read */
+  cache = g_variant_new_from_bytes (G_VARIANT_TYPE (DESKTOP_FILE_DIR_CACHE_TYPE), bytes, FALSE);
+  g_variant_ref_sink (cache);
+  g_bytes_unref (bytes);
+
+  /* This also rejects caches written with the other byte order */
+  g_variant_get_child (cache, 0, "u", &version);
+
+  if (version != DESKTOP_FILE_DIR_CACHE_VERSION)
+    {
+      g_variant_unref (cache);
+      return;
+    }
+
+  dir->cache = cache;
+}
+
+static gboolean
+desktop_file_dir_cache_is_current (GVariant *scanned_dirs)
+{
+  GVariantIter iter;
+  const gchar *dirname;
+  gint64 mtime;
+
+  if (g_variant_n_children (scanned_dirs) == 0)
+    return FALSE;
+
+  g_variant_iter_init (&iter, scanned_dirs);
+  while (g_variant_iter_next (&iter, "(&sx)", &dirname, &mtime))
+    {
+      GStatBuf buf;
+
+      if (g_stat (dirname, &buf) != 0 || get_stat_mtime (&buf) != mtime)
+        return FALSE;
+    }
+
+  return TRUE;
+}
+
+static void
+desktop_file_dir_read_cached_apps (DesktopFileDir *dir)
+{
+  GVariant *apps;
+  GVariantIter iter;
+  const gchar *app_name;
+  const gchar *filename;
+
+  apps = g_variant_get_child_value (dir->cache, 3);
+
+  g_variant_iter_init (&iter, apps);
+  while (g_variant_iter_next (&iter, "(&s&s)", &app_name, &filename))
+    {
+      if (dir->app_names == NULL)
+        dir->app_names = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+
+      g_hash_table_insert (dir->app_names, g_strdup (app_name), g_strdup (filename));
+    }
+
+  g_variant_unref (apps);
+}
+
+static void
+desktop_file_dir_write_cache (DesktopFileDir *dir,
+                              const gchar    *languages,
+                              GVariant       *entries)
+{
+  GVariantBuilder apps;
+  GHashTableIter iter;
+  gpointer app, path;
+  GVariant *cache;
+  gchar *filename;
+  gchar *dirname;
+
+  g_variant_builder_init_static (&apps, G_VARIANT_TYPE ("a(ss)"));
+
+  g_hash_table_iter_init (&iter, dir->app_names);
+  while (g_hash_table_iter_next (&iter, &app, &path))
+    g_variant_builder_add (&apps, "(ss)", app, path);
+
+  cache = g_variant_new ("(us@a(sx)@a(ss)@a" DESKTOP_FILE_DIR_CACHE_ENTRY_TYPE ")",
+                         DESKTOP_FILE_DIR_CACHE_VERSION, languages,
+                         dir->scanned_dirs, g_variant_builder_end (&apps), entries);
+  g_variant_ref_sink (cache);
+
+  filename = desktop_file_dir_get_cache_filename (dir);
+  dirname = g_path_get_dirname (filename);
+
+  /* Failing to write the cache is not an error: it will be rebuilt next time */
+  if (g_mkdir_with_parents (dirname, 0700) == 0)
+    g_file_set_contents_full (filename, g_variant_get_data (cache), g_variant_get_size (cache),
+                              G_FILE_SET_CONTENTS_CONSISTENT, 0600, NULL);
+
+  g_free (dirname);
+  g_free (filename);
+  g_variant_unref (cache);
+}
+
 typedef struct
 {
   gchar **additions;
@@ -1046,7 +1237,32 @@ static void
 desktop_file_dir_unindexed_init (DesktopFileDir *dir)
 {
   if (!dir->is_config)
-    get_apps_from_dir (&dir->app_names, dir->path, "");
+    {
+      desktop_file_dir_load_cache (dir);
+
+      if (dir->cache != NULL)
+        {
+          GVariant *scanned_dirs = g_variant_get_child_value (dir->cache, 2);
+
+          if (desktop_file_dir_cache_is_current (scanned_dirs))
+            {
+              desktop_file_dir_read_cached_apps (dir);
+              dir->scanned_dirs = g_steal_pointer (&scanned_dirs);
+              dir->cache_is_current = TRUE;
+            }
+
+          g_clear_pointer (&scanned_dirs, g_variant_unref);
+        }
+
+      if (!dir->cache_is_current)
+        {
+          GVariantBuilder dirs;
+
+          g_variant_builder_init_static (&dirs, G_VARIANT_TYPE ("a(sx)"));
+          get_apps_from_dir (&dir->app_names, dir->path, "", &dirs);
+          dir->scanned_dirs = g_variant_ref_sink (g_variant_builder_end (&dirs));
+        }
+    }
 
   desktop_file_dir_unindexed_read_mimeapps_lists (dir);
 }
@@ -1152,11 +1368,14 @@ memory_index_add_token (MemoryIndex *mi,
     }
 }
 
+/* Adds the tokens of @string to @mi, and to @cached_tokens, of type
+ * `a(syu)` */
 static void
-memory_index_add_string (MemoryIndex *mi,
-                         const gchar *string,
-                         gint         match_category,
-                         const gchar *app_name)
+memory_index_add_string (MemoryIndex     *mi,
+                         const gchar     *string,
+                         gint             match_category,
+                         const gchar     *app_name,
+                         GVariantBuilder *cached_tokens)
 {
   gchar **tokens, **alternates;
   gint i, n;
@@ -1164,11 +1383,17 @@ memory_index_add_string (MemoryIndex *mi,
   tokens = g_str_tokenize_and_fold (string, NULL, &alternates);
 
   for (i = 0; tokens[i]; i++)
-    memory_index_add_token (mi, tokens[i], match_category, i, app_name);
+    {
+      memory_index_add_token (mi, tokens[i], match_category, i, app_name);
+      g_variant_builder_add (cached_tokens, "(syu)", tokens[i], (guchar) match_category, (guint32) i);
+    }
 
   n = i;
   for (i = 0; alternates[i]; i++)
-    memory_index_add_token (mi, alternates[i], match_category, n + i, app_name);
+    {
+      memory_index_add_token (mi, alternates[i], match_category, n + i, app_name);
+      g_variant_builder_add (cached_tokens, "(syu)", alternates[i], (guchar) match_category, (guint32) (n + i));
+    }
 
   g_strfreev (alternates);
   g_strfreev (tokens);
@@ -1180,11 +1405,133 @@ memory_index_new (void)
   return g_hash_table_new_full (g_str_hash, g_str_equal, g_free, memory_index_entry_free);
 }
 
+/* Indexes the desktop file of @app, at @path, and returns its cache entry */
+static GVariant *
+desktop_file_dir_unindexed_index_app (DesktopFileDir *dir,
+                                      const gchar    *app,
+                                      const gchar    *path,
+                                      const GStatBuf *buf)
+{
+  GVariantBuilder tokens;
+  gchar **implements = NULL;
+  GKeyFile *key_file;
+  GVariant *entry;
+
+  g_variant_builder_init_static (&tokens, G_VARIANT_TYPE ("a(syu)"));
+
+  key_file = g_key_file_new ();
+
+  if (g_key_file_load_from_file (key_file, path, G_KEY_FILE_READ_ONLY, NULL) &&
+      !g_key_file_get_boolean (key_file, "Desktop Entry", "Hidden", NULL))
+    {
+      /* Index the interesting keys... */
+      gsize i;
+
+      for (i = 0; i < G_N_ELEMENTS (desktop_key_match_category); i++)
+        {
+          const gchar *value;
+          gchar *raw;
+
+          if (!desktop_key_match_category[i])
+            continue;
+
+          raw = g_key_file_get_locale_string (key_file, "Desktop Entry", desktop_key_get_name (i), NULL, NULL);
+          value = raw;
+
+          if (i == DESKTOP_KEY_Exec && raw != NULL)
+            {
+              /* Special handling: only match basename of first field */
+              gchar *space;
+              gchar *slash;
+
+              /* Remove extra arguments, if any */
+              space = raw + strcspn (raw, " \t\n"); /* IFS */
+              *space = '\0';
+
+              /* Skip the pathname, if any */
+              if ((slash = strrchr (raw, '/')))
+                value = slash + 1;
+
+              /* Don't match on blocklisted binaries like interpreters */
+              if (g_strv_contains (exec_key_match_blocklist, value))
+                value = NULL;
+            }
+
+          if (value)
+            memory_index_add_string (dir->memory_index, value, desktop_key_match_category[i], app, &tokens);
+
+          g_free (raw);
+        }
+
+      /* Make note of the Implements= line */
+      implements = g_key_file_get_string_list (key_file, "Desktop Entry", "Implements", NULL, NULL);
+      for (i = 0; implements && implements[i]; i++)
+        memory_index_add_token (dir->memory_implementations, implements[i], i, 0, app);
+    }
+
+  g_key_file_free (key_file);
+
+  /* Files which cannot be loaded, or are hidden, get an empty entry, so
+   * that they are not loaded again until they change */
+  entry = g_variant_new ("(sttxx@a(syu)@as)", app, (guint64) buf->st_size, (guint64) buf->st_ino,
+                         get_stat_mtime (buf), get_stat_ctime (buf),
+                         g_variant_builder_end (&tokens),
+                         g_variant_new_strv ((const gchar * const *) implements, implements ? -1 : 0));
+  g_strfreev (implements);
+
+  return entry;
+}
+
+static gboolean
+desktop_file_dir_cache_entry_is_current (GVariant       *entry,
+                                         const GStatBuf *buf)
+{
+  guint64 size, inode;
+  gint64 mtime, change_time;
+
+  g_variant_get (entry, DESKTOP_FILE_DIR_CACHE_ENTRY_TYPE, NULL, &size, &inode, &mtime, &change_time, NULL, NULL);
+
+  /* The change time can't be set back like the modification time can, and
+   * replacing the file by renaming another over it changes the inode */
+  return size == (guint64) buf->st_size &&
+         inode == (guint64) buf->st_ino &&
+         mtime == get_stat_mtime (buf) &&
+         change_time == get_stat_ctime (buf);
+}
+
+static void
+desktop_file_dir_unindexed_index_cached_app (DesktopFileDir *dir,
+                                             const gchar    *app,
+                                             GVariant       *entry)
+{
+  GVariantIter *tokens;
+  GVariantIter *implements;
+  const gchar *token;
+  guchar match_category;
+  guint32 token_pos;
+  gint i;
+
+  g_variant_get (entry, DESKTOP_FILE_DIR_CACHE_ENTRY_TYPE, NULL, NULL, NULL, NULL, NULL, &tokens, &implements);
+
+  while (g_variant_iter_next (tokens, "(&syu)", &token, &match_category, &token_pos))
+    memory_index_add_token (dir->memory_index, token, match_category, token_pos, app);
+
+  for (i = 0; g_variant_iter_next (implements, "&s", &token); i++)
+    memory_index_add_token (dir->memory_implementations, token, i, 0, app);
+
+  g_variant_iter_free (implements);
+  g_variant_iter_free (tokens);
+}
+
 static void
 desktop_file_dir_unindexed_setup_search (DesktopFileDir *dir)
 {
   GHashTableIter iter;
   gpointer app, path;
+  GHashTable *cached_entries = NULL;  /* (element-type utf8 GVariant) */
+  GVariantBuilder entries;
+  gboolean cache_changed;
+  gchar *languages;
 
   dir->memory_index = memory_index_new ();
   dir->memory_implementations = memory_index_new ();
@@ -1193,68 +1540,86 @@ desktop_file_dir_unindexed_setup_search (DesktopFileDir *dir)
   if (dir->app_names == NULL)
     return;
 
-  g_hash_table_iter_init (&iter, dir->app_names);
-  while (g_hash_table_iter_next (&iter, &app, &path))
-    {
-      GKeyFile *key_file;
+  /* The translated keys are indexed in the current languages */
+  languages = g_strjoinv (":", (gchar **) g_get_language_names ());
 
-      if (desktop_file_dir_app_name_is_masked (dir, app))
-        continue;
+  if (dir->cache != NULL)
+    {
+      const gchar *cached_languages;
 
-      key_file = g_key_file_new ();
+      g_variant_get_child (dir->cache, 1, "&s", &cached_languages);
 
-      if (g_key_file_load_from_file (key_file, path, G_KEY_FILE_NONE, NULL) &&
-          !g_key_file_get_boolean (key_file, "Desktop Entry", "Hidden", NULL))
+      if (g_str_equal (cached_languages, languages))
         {
-          /* Index the interesting keys... */
-          gchar **implements;
-          gsize i;
+          GVariant *cached;
+          GVariant *entry;
+          GVariantIter entry_iter;
 
-          for (i = 0; i < G_N_ELEMENTS (desktop_key_match_category); i++)
-            {
-              const gchar *value;
-              gchar *raw;
+          cached_entries = g_hash_table_new_full (g_str_hash, g_str_equal, NULL,
+                                                  (GDestroyNotify) g_variant_unref);
 
-              if (!desktop_key_match_category[i])
-                continue;
+          cached = g_variant_get_child_value (dir->cache, 4);
+          g_variant_iter_init (&entry_iter, cached);
+          while ((entry = g_variant_iter_next_value (&entry_iter)))
+            {
+              const gchar *cached_app;
 
-              raw = g_key_file_get_locale_string (key_file, "Desktop Entry", desktop_key_get_name (i), NULL, NULL);
-              value = raw;
+              /* The key points into the entry, so replace it with the value */
+              g_variant_get_child (entry, 0, "&s", &cached_app);
+              g_hash_table_replace (cached_entries, (gpointer) cached_app, entry);
+            }
+          g_variant_unref (cached);
+        }
+    }
 
-              if (i == DESKTOP_KEY_Exec && raw != NULL)
-                {
-                  /* Special handling: only match basename of first field */
-                  gchar *space;
-                  gchar *slash;
+  /* The cache is rewritten if its app list was out of date, or if any
+   * index entry is added or updated */
+  cache_changed = !dir->cache_is_current || cached_entries == NULL;
 
-                  /* Remove extra arguments, if any */
-                  space = raw + strcspn (raw, " \t\n"); /* IFS */
-                  *space = '\0';
+  g_variant_builder_init_static (&entries, G_VARIANT_TYPE ("a" DESKTOP_FILE_DIR_CACHE_ENTRY_TYPE));
 
-                  /* Skip the pathname, if any */
-                  if ((slash = strrchr (raw, '/')))
-                    value = slash + 1;
+  g_hash_table_iter_init (&iter, dir->app_names);
+  while (g_hash_table_iter_next (&iter, &app, &path))
+    {
+      GVariant *entry = NULL;
+      GStatBuf buf;
 
-                  /* Don't match on blocklisted binaries like interpreters */
-                  if (g_strv_contains (exec_key_match_blocklist, value))
-		    value = NULL;
-                }
+      if (cached_entries != NULL)
+        entry = g_hash_table_lookup (cached_entries, app);
 
-              if (value)
-                memory_index_add_string (dir->memory_index, value, desktop_key_match_category[i], app);
+      /* Keep the entries of masked apps, in case they are unmasked later */
+      if (desktop_file_dir_app_name_is_masked (dir, app))
+        {
+          if (entry != NULL)
+            g_variant_builder_add_value (&entries, entry);
+          continue;
+        }
 
-              g_free (raw);
-            }
+      if (g_stat (path, &buf) != 0)
+        continue;
 
-          /* Make note of the Implements= line */
-          implements = g_key_file_get_string_list (key_file, "Desktop Entry", "Implements", NULL, NULL);
-          for (i = 0; implements && implements[i]; i++)
-            memory_index_add_token (dir->memory_implementations, implements[i], i, 0, app);
-          g_strfreev (implements);
+      if (entry != NULL && desktop_file_dir_cache_entry_is_current (entry, &buf))
+        {
+          desktop_file_dir_unindexed_index_cached_app (dir, app, entry);
+        }
+      else
+        {
+          entry = desktop_file_dir_unindexed_index_app (dir, app, path, &buf);
+          cache_changed = TRUE;
         }
 
-      g_key_file_free (key_file);
+      g_variant_builder_add_value (&entries, entry);
     }
+
+  if (cache_changed)
+    desktop_file_dir_write_cache (dir, languages, g_variant_builder_end (&entries));
+  else
+    g_variant_builder_clear (&entries);
+
+  /* Everything needed from the cache has been read now */
+  g_clear_pointer (&cached_entries, g_hash_table_unref);
+  g_clear_pointer (&dir->cache, g_variant_unref);
+  g_free (languages);
 }
 
 static void
@@ -1471,6 +1836,10 @@ desktop_file_dir_reset (DesktopFileDir *dir)
       dir->memory_implementations = NULL;
     }
 
+  g_clear_pointer (&dir->cache, g_variant_unref);
+  g_clear_pointer (&dir->scanned_dirs, g_variant_unref);
+  dir->cache_is_current = FALSE;
+
   dir->is_setup = FALSE;
 }
 
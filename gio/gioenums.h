@@ -1238,6 +1238,13 @@ typedef enum
  *  affects client-side `EXTERNAL` authentication, for which this flag makes
  *  connections to a server in another user namespace succeed, but causes
  *  a deadlock when connecting to a GDBus server older than 2.73.3. Since: 2.74
+ * @G_DBUS_CONNECTION_FLAGS_LAZY_MESSAGE_BODY: Deserialise the bodies of
+ *  received messages lazily, as with g_dbus_message_new_from_bytes(), rather
+ *  than as soon as they are received. This makes receiving messages whose
+ *  bodies are never looked at, such as signals without a matching
+ *  subscription, cheaper; but a message with an invalid body no longer
+ *  causes the connection to be closed, and is delivered with a %NULL body
+ *  instead. Since: 2.86
  *
  * Flags used when creating a new #GDBusConnection.
  *
@@ -1251,7 +1258,8 @@ typedef enum {
   G_DBUS_CONNECTION_FLAGS_MESSAGE_BUS_CONNECTION = (1<<3),
   G_DBUS_CONNECTION_FLAGS_DELAY_MESSAGE_PROCESSING = (1<<4),
   G_DBUS_CONNECTION_FLAGS_AUTHENTICATION_REQUIRE_SAME_USER GIO_AVAILABLE_ENUMERATOR_IN_2_68 = (1<<5),
-  G_DBUS_CONNECTION_FLAGS_CROSS_NAMESPACE GIO_AVAILABLE_ENUMERATOR_IN_2_74 = (1<<6)
+  G_DBUS_CONNECTION_FLAGS_CROSS_NAMESPACE GIO_AVAILABLE_ENUMERATOR_IN_2_74 = (1<<6),
+  G_DBUS_CONNECTION_FLAGS_LAZY_MESSAGE_BODY GIO_AVAILABLE_ENUMERATOR_IN_2_86 = (1<<7)
 } GDBusConnectionFlags;
 
 /**
@@ -45,6 +45,27 @@
 #include <dirent.h>
 #include <errno.h>
 
+#if defined (__linux__) && defined (HAVE_STRUCT_DIRENT_D_TYPE)
+#include <sys/syscall.h>
+#include <unistd.h>
+#ifdef SYS_getdents64
+/* On Linux, read the directory with getdents64() directly, so that large
+ * directories can be listed with far fewer system calls than readdir()
+ * makes with its small buffer */
+#define USE_GETDENTS64
+#define GETDENTS_BUFFER_SIZE (128 * 1024)
+
+/* The kernel's struct linux_dirent64 */
+typedef struct {
+  guint64 d_ino;
+  gint64 d_off;
+  unsigned short d_reclen;
+  unsigned char d_type;
+  char d_name[];
+} LinuxDirent64;
+#endif
+#endif
+
 typedef struct {
   char *name;
   long inode;
@@ -73,6 +94,11 @@ struct _GLocalFileEnumerator
   DirEntry *entries;
   int entries_pos;
   gboolean at_end;
+#ifdef USE_GETDENTS64
+  char *dirents;
+  gsize dirents_len;
+  gsize dirents_pos;
+#endif
 #endif
   
   gboolean follow_symlinks;
@@ -128,6 +154,9 @@ g_local_file_enumerator_finalize (GObject *object)
     }
 
   free_entries (local);
+#ifdef USE_GETDENTS64
+  g_free (local->dirents);
+#endif
 
   G_OBJECT_CLASS (g_local_file_enumerator_parent_class)->finalize (object);
 }
@@ -302,10 +331,80 @@ file_type_from_dirent (char d_type)
 }
 #endif
 
+/* Reads the next directory entry, skipping `.` and `..`. Returns FALSE at
+ * the end of the directory or on error, as readdir() does. */
+static gboolean
+read_next_entry (GLocalFileEnumerator *local,
+                 const char          **name,
+                 guint64              *inode,
+                 unsigned char        *type)
+{
+#ifdef USE_GETDENTS64
+  while (TRUE)
+    {
+      LinuxDirent64 *entry;
+
+      if (local->dirents_pos >= local->dirents_len)
+        {
+          long res;
+
+          if (local->dirents == NULL)
+            local->dirents = g_malloc (GETDENTS_BUFFER_SIZE);
+
+          res = syscall (SYS_getdents64, dirfd (local->dir),
+                         local->dirents, GETDENTS_BUFFER_SIZE);
+          if (res <= 0)
+            {
+              /* Don't keep the buffer around until the enumerator is freed */
+              g_clear_pointer (&local->dirents, g_free);
+              local->dirents_len = local->dirents_pos = 0;
+              return FALSE;
+            }
+
+          local->dirents_len = res;
+          local->dirents_pos = 0;
+        }
+
+      entry = (LinuxDirent64 *) (local->dirents + local->dirents_pos);
+      local->dirents_pos += entry->d_reclen;
+
+      if (strcmp (entry->d_name, ".") == 0 ||
+          strcmp (entry->d_name, "..") == 0)
+        continue;
+
+      *name = entry->d_name;
+      *inode = entry->d_ino;
+      *type = entry->d_type;
+
+      return TRUE;
+    }
+#else
+  struct dirent *entry;
+
+  do
+    entry = readdir (local->dir);
+  while (entry != NULL &&
+         (strcmp (entry->d_name, ".") == 0 ||
+          strcmp (entry->d_name, "..") == 0));
+
+  if (entry == NULL)
+    return FALSE;
+
+  *name = entry->d_name;
+  *inode = entry->d_ino;
+#ifdef HAVE_STRUCT_DIRENT_D_TYPE
+  *type = entry->d_type;
+#else
+  *type = 0;
+#endif
+
+  return TRUE;
+#endif
+}
+
 static const char *
 next_file_helper (GLocalFileEnumerator *local, GFileType *file_type)
 {
-  struct dirent *entry;
   const char *filename;
   int i;
 
@@ -326,24 +425,20 @@ next_file_helper (GLocalFileEnumerator *local, GFileType *file_type)
       
       for (i = 0; i < CHUNK_SIZE; i++)
 	{
-	  entry = readdir (local->dir);
-	  while (entry 
-		 && (0 == strcmp (entry->d_name, ".") ||
-		     0 == strcmp (entry->d_name, "..")))
-	    entry = readdir (local->dir);
-
-	  if (entry)
-	    {
-	      local->entries[i].name = g_strdup (entry->d_name);
-	      local->entries[i].inode = entry->d_ino;
+	  const char *name;
+	  guint64 inode;
+	  unsigned char d_type;
+
+	  if (!read_next_entry (local, &name, &inode, &d_type))
+	    break;
+
+	  local->entries[i].name = g_strdup (name);
+	  local->entries[i].inode = inode;
 #if HAVE_STRUCT_DIRENT_D_TYPE
-              local->entries[i].type = file_type_from_dirent (entry->d_type);
+	  local->entries[i].type = file_type_from_dirent (d_type);
 #else
-              local->entries[i].type = G_FILE_TYPE_UNKNOWN;
+	  local->entries[i].type = G_FILE_TYPE_UNKNOWN;
 #endif
-	    }
-	  else
-	    break;
 	}
       local->entries[i].name = NULL;
       local->entries_pos = 0;
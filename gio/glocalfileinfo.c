@@ -1891,6 +1891,26 @@ get_icon (const char *path,
   return icon;
 }
 
+/* Only asks for the access and creation times when they are wanted, as
+ * they can be expensive to get on some file systems */
+static GLocalFileStatField
+get_stat_mask (GFileAttributeMatcher *attribute_matcher)
+{
+  GLocalFileStatField mask = G_LOCAL_FILE_STAT_FIELD_BASIC_STATS;
+
+  if (!_g_file_attribute_matcher_matches_id (attribute_matcher, G_FILE_ATTRIBUTE_ID_TIME_ACCESS) &&
+      !_g_file_attribute_matcher_matches_id (attribute_matcher, G_FILE_ATTRIBUTE_ID_TIME_ACCESS_USEC) &&
+      !_g_file_attribute_matcher_matches_id (attribute_matcher, G_FILE_ATTRIBUTE_ID_TIME_ACCESS_NSEC))
+    mask &= ~G_LOCAL_FILE_STAT_FIELD_ATIME;
+
+  if (_g_file_attribute_matcher_matches_id (attribute_matcher, G_FILE_ATTRIBUTE_ID_TIME_CREATED) ||
+      _g_file_attribute_matcher_matches_id (attribute_matcher, G_FILE_ATTRIBUTE_ID_TIME_CREATED_USEC) ||
+      _g_file_attribute_matcher_matches_id (attribute_matcher, G_FILE_ATTRIBUTE_ID_TIME_CREATED_NSEC))
+    mask |= G_LOCAL_FILE_STAT_FIELD_BTIME;
+
+  return mask;
+}
+
 GFileInfo *
 _g_local_file_info_get (const char             *basename,
 			const char             *path,
@@ -1902,6 +1922,7 @@ _g_local_file_info_get (const char             *basename,
   GFileInfo *info;
   GLocalFileStat statbuf;
   GLocalFileStat statbuf2;
+  GLocalFileStatField stat_mask;
   int res;
   gboolean stat_ok;
   gboolean is_symlink, symlink_broken;
@@ -1923,8 +1944,9 @@ _g_local_file_info_get (const char             *basename,
       return info;
     }
 
+  stat_mask = get_stat_mask (attribute_matcher);
   res = g_local_file_lstat (path,
-                            G_LOCAL_FILE_STAT_FIELD_BASIC_STATS | G_LOCAL_FILE_STAT_FIELD_BTIME,
+                            stat_mask,
                             G_LOCAL_FILE_STAT_FIELD_ALL & (~G_LOCAL_FILE_STAT_FIELD_BTIME) & (~G_LOCAL_FILE_STAT_FIELD_ATIME),
                             &statbuf);
 
@@ -1974,7 +1996,7 @@ _g_local_file_info_get (const char             *basename,
       if (!(flags & G_FILE_QUERY_INFO_NOFOLLOW_SYMLINKS))
 	{
           res = g_local_file_stat (path,
-                                   G_LOCAL_FILE_STAT_FIELD_BASIC_STATS | G_LOCAL_FILE_STAT_FIELD_BTIME,
+                                   stat_mask,
                                    G_LOCAL_FILE_STAT_FIELD_ALL & (~G_LOCAL_FILE_STAT_FIELD_BTIME) & (~G_LOCAL_FILE_STAT_FIELD_ATIME),
                                    &statbuf2);
 
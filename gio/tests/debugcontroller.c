@@ -383,6 +383,152 @@ test_dbus_properties (void)
   g_clear_object (&bus);
 }
 
+static gboolean
+stats_idle_cb (gpointer user_data)
+{
+  guint *dispatch_count_out = user_data;
+
+  *dispatch_count_out = *dispatch_count_out + 1;
+
+  return G_SOURCE_REMOVE;
+}
+
+static GVariant *
+get_main_context_stats (GDBusConnection  *remote_connection,
+                        GDBusConnection  *controller_connection,
+                        GError          **error)
+{
+  GAsyncResult *result = NULL;
+  GVariant *reply;
+
+  g_dbus_connection_call (remote_connection,
+                          g_dbus_connection_get_unique_name (controller_connection),
+                          "/org/gtk/Debugging",
+                          "org.gtk.Debugging",
+                          "GetMainContextStats",
+                          NULL,
+                          G_VARIANT_TYPE ("(a{sa{sv}})"),
+                          G_DBUS_CALL_FLAGS_NONE,
+                          -1,
+                          NULL,
+                          async_result_cb,
+                          &result);
+
+  while (result == NULL)
+    g_main_context_iteration (NULL, TRUE);
+
+  reply = g_dbus_connection_call_finish (remote_connection, result, error);
+  g_clear_object (&result);
+
+  return reply;
+}
+
+static void
+test_dbus_main_context_stats (void)
+{
+  GTestDBus *bus;
+  GDBusConnection *controller_connection = NULL;
+  GDBusConnection *remote_connection = NULL;
+  GDebugControllerDBus *controller = NULL;
+  gboolean old_value;
+  GVariant *reply = NULL;
+  GVariant *stats = NULL;
+  GVariant *entry = NULL;
+  GSource *source;
+  guint dispatch_count = 0;
+  guint64 remote_dispatch_count = 0;
+  gulong handler_id;
+  GError *local_error = NULL;
+
+  g_test_summary ("Test reading main context statistics from a #GDebugControllerDBus.");
+
+  bus = g_test_dbus_new (G_TEST_DBUS_NONE);
+  g_test_dbus_up (bus);
+
+  controller_connection = g_bus_get_sync (G_BUS_TYPE_SESSION, NULL, &local_error);
+  g_assert_no_error (local_error);
+
+  remote_connection = g_dbus_connection_new_for_address_sync (g_test_dbus_get_bus_address (bus),
+                                                              G_DBUS_CONNECTION_FLAGS_AUTHENTICATION_CLIENT |
+                                                              G_DBUS_CONNECTION_FLAGS_MESSAGE_BUS_CONNECTION,
+                                                              NULL,
+                                                              NULL,
+                                                              &local_error);
+  g_assert_no_error (local_error);
+
+  controller = g_debug_controller_dbus_new (controller_connection, NULL, &local_error);
+  g_assert_no_error (local_error);
+  g_assert_nonnull (controller);
+
+  /* Statistics follow the debug status. */
+  old_value = g_debug_controller_get_debug_enabled (G_DEBUG_CONTROLLER (controller));
+
+  g_debug_controller_set_debug_enabled (G_DEBUG_CONTROLLER (controller), FALSE);
+  g_assert_false (g_main_context_get_source_stats_enabled (NULL));
+  g_debug_controller_set_debug_enabled (G_DEBUG_CONTROLLER (controller), TRUE);
+  g_assert_true (g_main_context_get_source_stats_enabled (NULL));
+
+  source = g_idle_source_new ();
+  g_source_set_name (source, "debug-controller-stats");
+  g_source_set_callback (source, stats_idle_cb, &dispatch_count, NULL);
+  g_source_attach (source, NULL);
+  g_source_unref (source);
+
+  while (dispatch_count == 0)
+    g_main_context_iteration (NULL, TRUE);
+
+  /* Reading them remotely needs authorisation, like changing the debug
+   * status does. */
+  reply = get_main_context_stats (remote_connection, controller_connection, &local_error);
+  g_assert_error (local_error, G_DBUS_ERROR, G_DBUS_ERROR_ACCESS_DENIED);
+  g_assert_null (reply);
+  g_clear_error (&local_error);
+
+  handler_id = g_signal_connect (controller, "authorize", G_CALLBACK (authorize_false_cb), NULL);
+  reply = get_main_context_stats (remote_connection, controller_connection, &local_error);
+  g_assert_error (local_error, G_DBUS_ERROR, G_DBUS_ERROR_ACCESS_DENIED);
+  g_assert_null (reply);
+  g_clear_error (&local_error);
+  g_signal_handler_disconnect (controller, handler_id);
+
+  handler_id = g_signal_connect (controller, "authorize", G_CALLBACK (authorize_true_cb), NULL);
+  reply = get_main_context_stats (remote_connection, controller_connection, &local_error);
+  g_assert_no_error (local_error);
+  g_signal_handler_disconnect (controller, handler_id);
+
+  g_variant_get (reply, "(@a{sa{sv}})", &stats);
+  entry = g_variant_lookup_value (stats, "debug-controller-stats", G_VARIANT_TYPE_VARDICT);
+  g_assert_nonnull (entry);
+  g_assert_true (g_variant_lookup (entry, "dispatch-count", "t", &remote_dispatch_count));
+  g_assert_cmpuint (remote_dispatch_count, ==, 1);
+  g_clear_pointer (&entry, g_variant_unref);
+  g_clear_pointer (&stats, g_variant_unref);
+  g_clear_pointer (&reply, g_variant_unref);
+
+  /* Disabling debug output only stops the collection the controller
+   * started, not one the process started itself. */
+  g_debug_controller_set_debug_enabled (G_DEBUG_CONTROLLER (controller), FALSE);
+  g_assert_false (g_main_context_get_source_stats_enabled (NULL));
+
+  g_main_context_set_source_stats_enabled (NULL, TRUE);
+  g_debug_controller_set_debug_enabled (G_DEBUG_CONTROLLER (controller), TRUE);
+  g_debug_controller_set_debug_enabled (G_DEBUG_CONTROLLER (controller), FALSE);
+  g_assert_true (g_main_context_get_source_stats_enabled (NULL));
+  g_main_context_set_source_stats_enabled (NULL, FALSE);
+
+  g_debug_controller_set_debug_enabled (G_DEBUG_CONTROLLER (controller), old_value);
+  g_main_context_reset_source_stats (NULL);
+
+  g_debug_controller_dbus_stop (controller);
+  while (g_main_context_iteration (NULL, FALSE));
+  g_assert_finalize_object (controller);
+  g_clear_object (&controller_connection);
+  g_clear_object (&remote_connection);
+
+  g_test_dbus_down (bus);
+  g_clear_object (&bus);
+}
+
 static GLogWriterOutput
 noop_log_writer_cb (GLogLevelFlags   log_level,
                     const GLogField *fields,
@@ -406,6 +552,7 @@ main (int   argc,
   g_test_add_func ("/debug-controller/dbus/basic", test_dbus_basic);
   g_test_add_func ("/debug-controller/dbus/duplicate", test_dbus_duplicate);
   g_test_add_func ("/debug-controller/dbus/properties", test_dbus_properties);
+  g_test_add_func ("/debug-controller/dbus/main-context-stats", test_dbus_main_context_stats);
 
   return g_test_run ();
 }
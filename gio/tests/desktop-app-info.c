@@ -1045,6 +1045,172 @@ assert_shown (const gchar *desktop_id,
   g_free (result);
 }
 
+static gboolean
+search_finds (const gchar *search_string,
+              const gchar *desktop_id)
+{
+  gchar ***results;
+  gboolean found = FALSE;
+  gsize i;
+
+  results = g_desktop_app_info_search (search_string);
+
+  for (i = 0; results[i] != NULL; i++)
+    {
+      found = found || g_strv_contains ((const gchar * const *) results[i], desktop_id);
+      g_strfreev (results[i]);
+    }
+  g_free (results);
+
+  return found;
+}
+
+static void
+app_info_changed_cb (GAppInfoMonitor *monitor,
+                     gpointer         user_data)
+{
+  gboolean *changed = user_data;
+
+  *changed = TRUE;
+}
+
+static gboolean
+app_info_changed_timeout_cb (gpointer user_data)
+{
+  gboolean *timed_out = user_data;
+
+  *timed_out = TRUE;
+  g_main_context_wakeup (NULL);
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+write_desktop_file_and_wait (GAppInfoMonitor *monitor,
+                             const gchar     *path,
+                             const gchar     *contents)
+{
+  gboolean changed = FALSE;
+  gboolean timed_out = FALSE;
+  GSource *timeout_source;
+  gulong handler_id;
+  GError *error = NULL;
+
+  handler_id = g_signal_connect (monitor, "changed", G_CALLBACK (app_info_changed_cb), &changed);
+  timeout_source = g_timeout_source_new_seconds (10);
+  g_source_set_callback (timeout_source, app_info_changed_timeout_cb, &timed_out, NULL);
+  g_source_attach (timeout_source, NULL);
+
+  g_file_set_contents (path, contents, -1, &error);
+  g_assert_no_error (error);
+
+  while (!changed && !timed_out)
+    g_main_context_iteration (NULL, TRUE);
+
+  g_assert_true (changed);
+
+  g_source_destroy (timeout_source);
+  g_source_unref (timeout_source);
+  g_signal_handler_disconnect (monitor, handler_id);
+}
+
+static void
+set_desktop_file_mtime (const gchar *path,
+                        guint64      mtime)
+{
+  GFile *file = g_file_new_for_path (path);
+  GError *error = NULL;
+
+  g_file_set_attribute_uint64 (file, G_FILE_ATTRIBUTE_TIME_MODIFIED, mtime,
+                               G_FILE_QUERY_INFO_NONE, NULL, &error);
+  g_assert_no_error (error);
+  g_object_unref (file);
+}
+
+static void
+test_search_cache (void)
+{
+  GAppInfoMonitor *monitor;
+  gchar *apps_dir;
+  gchar *app_path;
+  gchar *other_path;
+  gchar *cache_dir;
+  GDir *dir;
+  GError *error = NULL;
+
+  g_test_summary ("Test that the search index cache is written, reused, and "
+                  "updated when desktop files change");
+
+  apps_dir = g_build_filename (g_get_user_data_dir (), "applications", NULL);
+  g_assert_no_errno (g_mkdir_with_parents (apps_dir, 0700));
+  app_path = g_build_filename (apps_dir, "cache-test.desktop", NULL);
+  other_path = g_build_filename (apps_dir, "other.desktop", NULL);
+
+  g_file_set_contents (app_path,
+                       "[Desktop Entry]\n"
+                       "Type=Application\n"
+                       "Name=Frobulator\n"
+                       "Exec=true\n", -1, &error);
+  g_assert_no_error (error);
+
+  /* Building the search index writes the cache */
+  g_assert_true (search_finds ("frobul", "cache-test.desktop"));
+
+  cache_dir = g_build_filename (g_get_user_cache_dir (), "glib-2.0", "desktop-app-info", NULL);
+  dir = g_dir_open (cache_dir, 0, NULL);
+  g_assert_nonnull (dir);
+  g_assert_nonnull (g_dir_read_name (dir));
+  g_dir_close (dir);
+
+  monitor = g_app_info_monitor_get ();
+
+  /* A changed desktop file must be indexed again */
+  write_desktop_file_and_wait (monitor, app_path,
+                               "[Desktop Entry]\n"
+                               "Type=Application\n"
+                               "Name=Wibbulator\n"
+                               "Exec=true\n");
+  g_assert_true (search_finds ("wibbul", "cache-test.desktop"));
+  g_assert_false (search_finds ("frobul", "cache-test.desktop"));
+
+  /* Adding another desktop file invalidates the cached app list, but the
+   * unchanged desktop file is indexed from the cache */
+  write_desktop_file_and_wait (monitor, other_path,
+                               "[Desktop Entry]\n"
+                               "Type=Application\n"
+                               "Name=Other\n"
+                               "Exec=true\n");
+  g_assert_true (search_finds ("wibbul", "cache-test.desktop"));
+  g_assert_true (search_finds ("other", "other.desktop"));
+
+  /* A desktop file replaced by one of the same size, with its modification
+   * time set back to that of the old one, must be indexed again too */
+  write_desktop_file_and_wait (monitor, app_path,
+                               "[Desktop Entry]\n"
+                               "Type=Application\n"
+                               "Name=Wubbulator\n"
+                               "Exec=true\n");
+  set_desktop_file_mtime (app_path, 1000000000);
+  g_assert_true (search_finds ("wubbul", "cache-test.desktop"));
+
+  write_desktop_file_and_wait (monitor, app_path,
+                               "[Desktop Entry]\n"
+                               "Type=Application\n"
+                               "Name=Wobbulator\n"
+                               "Exec=true\n");
+  set_desktop_file_mtime (app_path, 1000000000);
+  g_assert_true (search_finds ("wobbul", "cache-test.desktop"));
+  g_assert_false (search_finds ("wubbul", "cache-test.desktop"));
+
+  g_object_unref (monitor);
+  g_remove (other_path);
+  g_remove (app_path);
+  g_free (cache_dir);
+  g_free (other_path);
+  g_free (app_path);
+  g_free (apps_dir);
+}
+
 static void
 test_show_in (void)
 {
@@ -1969,6 +2135,7 @@ main (int   argc,
   g_test_add_func ("/desktop-app-info/actions", test_actions);
   g_test_add_func ("/desktop-app-info/search", test_search);
   g_test_add_func ("/desktop-app-info/implements", test_implements);
+  g_test_add_func ("/desktop-app-info/search-cache", test_search_cache);
   g_test_add_func ("/desktop-app-info/show-in", test_show_in);
   g_test_add_func ("/desktop-app-info/app-path", test_app_path);
   g_test_add_func ("/desktop-app-info/app-path/wrong", test_app_path_wrong);
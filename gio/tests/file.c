@@ -4325,6 +4325,82 @@ test_enumerator_cancellation (void)
   g_object_unref (dir);
 }
 
+static void
+test_enumerator_large_directory (void)
+{
+  const guint n_files = 5000;
+  const char *attributes[] = {
+    G_FILE_ATTRIBUTE_STANDARD_NAME "," G_FILE_ATTRIBUTE_STANDARD_TYPE,
+    G_FILE_ATTRIBUTE_STANDARD_NAME "," G_FILE_ATTRIBUTE_STANDARD_SIZE,
+  };
+  GFile *dir;
+  char *dir_path;
+  GError *error = NULL;
+  gsize i;
+
+  g_test_summary ("Test that directories spanning several reads are fully enumerated");
+
+  dir_path = g_dir_make_tmp ("g_file_enumerate_XXXXXX", &error);
+  g_assert_no_error (error);
+  dir = g_file_new_for_path (dir_path);
+
+  /* Long names, so the entries don't fit in one buffer */
+  for (i = 0; i < n_files; i++)
+    {
+      char *path = g_strdup_printf ("%s/a-rather-long-file-name-to-fill-the-buffer-%04" G_GSIZE_FORMAT,
+                                    dir_path, i);
+      g_file_set_contents (path, "x", i % 2, &error);
+      g_assert_no_error (error);
+      g_free (path);
+    }
+
+  for (i = 0; i < G_N_ELEMENTS (attributes); i++)
+    {
+      GFileEnumerator *enumerator;
+      GHashTable *seen;
+      GFileInfo *info;
+
+      enumerator = g_file_enumerate_children (dir, attributes[i],
+                                              G_FILE_QUERY_INFO_NONE,
+                                              NULL, &error);
+      g_assert_no_error (error);
+
+      seen = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+
+      while ((info = g_file_enumerator_next_file (enumerator, NULL, &error)) != NULL)
+        {
+          const char *name = g_file_info_get_name (info);
+
+          g_assert_true (g_str_has_prefix (name, "a-rather-long-file-name"));
+          g_assert_true (g_hash_table_add (seen, g_strdup (name)));
+
+          if (g_file_info_has_attribute (info, G_FILE_ATTRIBUTE_STANDARD_TYPE))
+            g_assert_cmpint (g_file_info_get_file_type (info), ==, G_FILE_TYPE_REGULAR);
+          if (g_file_info_has_attribute (info, G_FILE_ATTRIBUTE_STANDARD_SIZE))
+            g_assert_cmpint (g_file_info_get_size (info), ==, g_ascii_strtoull (name + strlen (name) - 4, NULL, 10) % 2);
+
+          g_object_unref (info);
+        }
+      g_assert_no_error (error);
+      g_assert_cmpuint (g_hash_table_size (seen), ==, n_files);
+
+      g_hash_table_unref (seen);
+      g_object_unref (enumerator);
+    }
+
+  for (i = 0; i < n_files; i++)
+    {
+      char *path = g_strdup_printf ("%s/a-rather-long-file-name-to-fill-the-buffer-%04" G_GSIZE_FORMAT,
+                                    dir_path, i);
+      g_remove (path);
+      g_free (path);
+    }
+  g_rmdir (dir_path);
+
+  g_object_unref (dir);
+  g_free (dir_path);
+}
+
 static void
 test_path_from_uri_helper (const gchar *uri,
 			   const gchar *expected_path)
@@ -4424,6 +4500,7 @@ main (int argc, char *argv[])
   g_test_add_func ("/file/query-default-handler-uri", test_query_default_handler_uri);
   g_test_add_func ("/file/query-default-handler-uri-async", test_query_default_handler_uri_async);
   g_test_add_func ("/file/enumerator-cancellation", test_enumerator_cancellation);
+  g_test_add_func ("/file/enumerator-large-directory", test_enumerator_large_directory);
   g_test_add_func ("/file/from-uri/ignores-query-string", test_from_uri_ignores_query_string);
   g_test_add_func ("/file/from-uri/ignores-fragment", test_from_uri_ignores_fragment);
 
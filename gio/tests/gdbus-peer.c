@@ -1431,6 +1431,528 @@ test_peer_signals (void)
   g_free (test_guid);
 }
 
+typedef struct
+{
+  const gchar *interface_name;
+  const gchar *member;
+  const gchar *object_path;
+  const gchar *arg0;
+  GDBusSignalFlags flags;
+  guint n_expected;
+} MatchIndexSubscription;
+
+static const MatchIndexSubscription match_index_subscriptions[] =
+{
+  { "org.gtk.GDBus.A", NULL, NULL, NULL, G_DBUS_SIGNAL_FLAGS_NONE, 2 },
+  { NULL, "Changed", NULL, NULL, G_DBUS_SIGNAL_FLAGS_NONE, 2 },
+  { "org.gtk.GDBus.A", "Changed", "/a", NULL, G_DBUS_SIGNAL_FLAGS_NONE, 1 },
+  /* The same rule again, sharing its SignalData with the previous one */
+  { "org.gtk.GDBus.A", "Changed", "/a", NULL, G_DBUS_SIGNAL_FLAGS_NONE, 1 },
+  { NULL, NULL, "/a", NULL, G_DBUS_SIGNAL_FLAGS_NONE, 1 },
+  { NULL, NULL, NULL, "foo", G_DBUS_SIGNAL_FLAGS_NONE, 1 },
+  { NULL, NULL, NULL, "org.gtk", G_DBUS_SIGNAL_FLAGS_MATCH_ARG0_NAMESPACE, 1 },
+  { NULL, NULL, NULL, "/a/", G_DBUS_SIGNAL_FLAGS_MATCH_ARG0_PATH, 3 },
+  { NULL, NULL, NULL, "/a/b", G_DBUS_SIGNAL_FLAGS_MATCH_ARG0_PATH, 3 },
+  { "org.gtk.GDBus.B", NULL, NULL, "/a/b/c", G_DBUS_SIGNAL_FLAGS_MATCH_ARG0_PATH, 2 },
+  /* Everything, including the final Done signal */
+  { NULL, NULL, NULL, NULL, G_DBUS_SIGNAL_FLAGS_NONE, 7 },
+};
+
+typedef struct
+{
+  guint n_received[G_N_ELEMENTS (match_index_subscriptions)];
+  GArray *order;  /* indexes of the subscriptions which received "foo" */
+  gboolean done;
+} MatchIndexData;
+
+static MatchIndexData match_index_data;
+
+static void
+on_match_index_signal (GDBusConnection *connection,
+                       const gchar     *sender_name,
+                       const gchar     *object_path,
+                       const gchar     *interface_name,
+                       const gchar     *signal_name,
+                       GVariant        *parameters,
+                       gpointer         user_data)
+{
+  guint i = GPOINTER_TO_UINT (user_data);
+  const gchar *arg0 = NULL;
+
+  match_index_data.n_received[i]++;
+
+  if (g_variant_check_format_string (parameters, "(&s)", FALSE))
+    g_variant_get (parameters, "(&s)", &arg0);
+  if (g_strcmp0 (arg0, "foo") == 0)
+    g_array_append_val (match_index_data.order, i);
+}
+
+static void
+on_match_index_done (GDBusConnection *connection,
+                     const gchar     *sender_name,
+                     const gchar     *object_path,
+                     const gchar     *interface_name,
+                     const gchar     *signal_name,
+                     GVariant        *parameters,
+                     gpointer         user_data)
+{
+  match_index_data.done = TRUE;
+  g_main_loop_quit (loop);
+}
+
+static void
+test_peer_signal_match_index (void)
+{
+  GDBusConnection *c;
+  GDBusConnection *server_connection;
+  GError *error = NULL;
+  PeerData data;
+  GThread *service_thread;
+  guint subscription_ids[G_N_ELEMENTS (match_index_subscriptions)];
+  guint done_id;
+  const guint expected_order[] = { 0, 1, 2, 3, 4, 5, 10 };
+  const struct
+    {
+      const gchar *interface_name;
+      const gchar *member;
+      const gchar *object_path;
+      const gchar *parameters;
+    }
+  signals[] =
+    {
+      { "org.gtk.GDBus.A", "Changed", "/a", "('foo',)" },
+      { "org.gtk.GDBus.B", "Changed", "/b", "('org.gtk.GDBus',)" },
+      { "org.gtk.GDBus.A", "Other", "/a/b", "(objectpath '/a/b',)" },
+      { "org.gtk.GDBus.B", "Other", "/c", "('/a/',)" },
+      { "org.gtk.GDBus.B", "Other", "/c", "('/',)" },
+      { "org.gtk.GDBus.B", "Other", "/c", "('org.gtkmm',)" },
+    };
+  gsize i;
+
+  g_test_summary ("Test that signal subscriptions are matched correctly, "
+                  "and receive signals in the order they were made");
+
+  test_guid = g_dbus_generate_guid ();
+  loop = g_main_loop_new (NULL, FALSE);
+
+  setup_test_address ();
+  memset (&data, '\0', sizeof (PeerData));
+  data.current_connections = g_ptr_array_new_with_free_func (g_object_unref);
+
+  service_thread = g_thread_new ("test_peer",
+                                 service_thread_func,
+                                 &data);
+  await_service_loop ();
+  g_assert_nonnull (server);
+
+  data.accept_connection = TRUE;
+  c = g_dbus_connection_new_for_address_sync (g_dbus_server_get_client_address (server),
+                                              G_DBUS_CONNECTION_FLAGS_AUTHENTICATION_CLIENT,
+                                              NULL, /* GDBusAuthObserver */
+                                              NULL, /* cancellable */
+                                              &error);
+  g_assert_no_error (error);
+  g_assert_nonnull (c);
+  while (data.current_connections->len < 1)
+    g_main_loop_run (loop);
+  server_connection = data.current_connections->pdata[0];
+
+  memset (&match_index_data, 0, sizeof (match_index_data));
+  match_index_data.order = g_array_new (FALSE, FALSE, sizeof (guint));
+
+  for (i = 0; i < G_N_ELEMENTS (match_index_subscriptions); i++)
+    {
+      const MatchIndexSubscription *s = &match_index_subscriptions[i];
+
+      subscription_ids[i] = g_dbus_connection_signal_subscribe (server_connection,
+                                                                NULL, /* sender */
+                                                                s->interface_name,
+                                                                s->member,
+                                                                s->object_path,
+                                                                s->arg0,
+                                                                s->flags,
+                                                                on_match_index_signal,
+                                                                GUINT_TO_POINTER (i),
+                                                                NULL);
+      g_assert_cmpuint (subscription_ids[i], !=, 0);
+    }
+  done_id = g_dbus_connection_signal_subscribe (server_connection,
+                                                NULL, /* sender */
+                                                "org.gtk.GDBus.Done",
+                                                "Done",
+                                                "/done",
+                                                NULL, /* arg0 */
+                                                G_DBUS_SIGNAL_FLAGS_NONE,
+                                                on_match_index_done,
+                                                NULL,
+                                                NULL);
+
+  for (i = 0; i < G_N_ELEMENTS (signals); i++)
+    {
+      g_dbus_connection_emit_signal (c,
+                                     NULL, /* destination */
+                                     signals[i].object_path,
+                                     signals[i].interface_name,
+                                     signals[i].member,
+                                     g_variant_new_parsed (signals[i].parameters),
+                                     &error);
+      g_assert_no_error (error);
+    }
+
+  /* Signals are delivered in order, so everything else has arrived by the
+   * time this one does */
+  g_dbus_connection_emit_signal (c, NULL, "/done", "org.gtk.GDBus.Done", "Done", NULL, &error);
+  g_assert_no_error (error);
+
+  while (!match_index_data.done)
+    g_main_loop_run (loop);
+
+  for (i = 0; i < G_N_ELEMENTS (match_index_subscriptions); i++)
+    {
+      g_test_message ("Subscription %" G_GSIZE_FORMAT " received %u signals",
+                      i, match_index_data.n_received[i]);
+      g_assert_cmpuint (match_index_data.n_received[i], ==, match_index_subscriptions[i].n_expected);
+    }
+
+  g_assert_cmpmem (match_index_data.order->data, match_index_data.order->len * sizeof (guint),
+                   expected_order, sizeof (expected_order));
+
+  for (i = 0; i < G_N_ELEMENTS (match_index_subscriptions); i++)
+    g_dbus_connection_signal_unsubscribe (server_connection, subscription_ids[i]);
+  g_dbus_connection_signal_unsubscribe (server_connection, done_id);
+  g_array_unref (match_index_data.order);
+
+  g_dbus_server_stop (server);
+  g_clear_object (&server);
+
+  g_object_unref (c);
+  g_ptr_array_unref (data.current_connections);
+
+  g_main_loop_quit (service_loop);
+  g_thread_join (service_thread);
+
+  teardown_test_address ();
+
+  g_main_loop_unref (loop);
+  g_free (test_guid);
+}
+
+/* ---------------------------------------------------------------------------------------------------- */
+
+#define N_BURST_SIGNALS 2000
+
+static void
+on_burst_signal (GDBusConnection *connection,
+                 const gchar     *sender_name,
+                 const gchar     *object_path,
+                 const gchar     *interface_name,
+                 const gchar     *signal_name,
+                 GVariant        *parameters,
+                 gpointer         user_data)
+{
+  guint *n_received = user_data;
+  guint32 n;
+
+  /* Signals must arrive in order, and none may be lost or duplicated */
+  g_variant_get (parameters, "(u)", &n);
+  g_assert_cmpuint (n, ==, *n_received);
+  *n_received += 1;
+
+  if (*n_received == N_BURST_SIGNALS)
+    g_main_loop_quit (loop);
+}
+
+typedef struct
+{
+  GMutex mutex;
+  GCond cond;
+  gboolean entered;
+  gboolean released;
+} BurstGate;
+
+/* Holds up the worker thread on the first outgoing message, so that the
+ * rest of the burst is queued behind it by the time it gets written */
+static GDBusMessage *
+burst_gate_filter (GDBusConnection *connection,
+                   GDBusMessage    *message,
+                   gboolean         incoming,
+                   gpointer         user_data)
+{
+  BurstGate *gate = user_data;
+
+  if (incoming)
+    return message;
+
+  g_mutex_lock (&gate->mutex);
+  if (!gate->entered)
+    {
+      gate->entered = TRUE;
+      g_cond_broadcast (&gate->cond);
+      while (!gate->released)
+        g_cond_wait (&gate->cond, &gate->mutex);
+    }
+  g_mutex_unlock (&gate->mutex);
+
+  return message;
+}
+
+static void
+test_peer_signal_burst (void)
+{
+  GDBusConnection *c;
+  GDBusConnection *server_connection;
+  GError *error = NULL;
+  PeerData data;
+  GThread *service_thread;
+  guint subscription_id;
+  guint filter_id;
+  guint n_received = 0;
+  guint64 n_messages_before = 0, n_writes_before = 0;
+  guint64 n_messages = 0, n_writes = 0;
+  BurstGate gate = { 0, };
+  guint i;
+
+  g_test_summary ("Test that a burst of signals is delivered in order, "
+                  "and that the messages are written out in batches");
+
+  test_guid = g_dbus_generate_guid ();
+  loop = g_main_loop_new (NULL, FALSE);
+
+  setup_test_address ();
+  memset (&data, '\0', sizeof (PeerData));
+  data.current_connections = g_ptr_array_new_with_free_func (g_object_unref);
+
+  service_thread = g_thread_new ("test_peer",
+                                 service_thread_func,
+                                 &data);
+  await_service_loop ();
+  g_assert_nonnull (server);
+
+  data.accept_connection = TRUE;
+  c = g_dbus_connection_new_for_address_sync (g_dbus_server_get_client_address (server),
+                                              G_DBUS_CONNECTION_FLAGS_AUTHENTICATION_CLIENT,
+                                              NULL, /* GDBusAuthObserver */
+                                              NULL, /* cancellable */
+                                              &error);
+  g_assert_no_error (error);
+  g_assert_nonnull (c);
+  while (data.current_connections->len < 1)
+    g_main_loop_run (loop);
+  server_connection = data.current_connections->pdata[0];
+
+  subscription_id = g_dbus_connection_signal_subscribe (server_connection,
+                                                        NULL, /* sender */
+                                                        "org.gtk.GDBus.BurstInterface",
+                                                        "Burst",
+                                                        "/org/gtk/GDBus/BurstObject",
+                                                        NULL, /* arg0 */
+                                                        G_DBUS_SIGNAL_FLAGS_NONE,
+                                                        on_burst_signal,
+                                                        &n_received,
+                                                        NULL);
+
+  g_mutex_init (&gate.mutex);
+  g_cond_init (&gate.cond);
+  filter_id = g_dbus_connection_add_filter (c, burst_gate_filter, &gate, NULL);
+  g_dbus_connection_get_write_statistics (c, &n_messages_before, &n_writes_before);
+
+  for (i = 0; i < N_BURST_SIGNALS; i++)
+    {
+      g_dbus_connection_emit_signal (c,
+                                     NULL, /* destination */
+                                     "/org/gtk/GDBus/BurstObject",
+                                     "org.gtk.GDBus.BurstInterface",
+                                     "Burst",
+                                     g_variant_new ("(u)", i),
+                                     &error);
+      g_assert_no_error (error);
+
+      /* Queue the rest while the worker is held up writing the first one */
+      if (i == 0)
+        {
+          g_mutex_lock (&gate.mutex);
+          while (!gate.entered)
+            g_cond_wait (&gate.cond, &gate.mutex);
+          g_mutex_unlock (&gate.mutex);
+        }
+    }
+
+  g_mutex_lock (&gate.mutex);
+  gate.released = TRUE;
+  g_cond_broadcast (&gate.cond);
+  g_mutex_unlock (&gate.mutex);
+
+  g_dbus_connection_flush_sync (c, NULL, &error);
+  g_assert_no_error (error);
+
+  while (n_received < N_BURST_SIGNALS)
+    g_main_loop_run (loop);
+
+  /* The first message goes out on its own, and the rest in full batches
+   * of at most 64 messages each */
+  g_dbus_connection_get_write_statistics (c, &n_messages, &n_writes);
+  n_messages -= n_messages_before;
+  n_writes -= n_writes_before;
+  g_test_message ("Wrote %" G_GUINT64_FORMAT " messages in %" G_GUINT64_FORMAT " writes",
+                  n_messages, n_writes);
+  g_assert_cmpuint (n_messages, ==, N_BURST_SIGNALS);
+  g_assert_cmpuint (n_writes, <=, 1 + (N_BURST_SIGNALS - 1 + 63) / 64);
+
+  g_dbus_connection_remove_filter (c, filter_id);
+  g_mutex_clear (&gate.mutex);
+  g_cond_clear (&gate.cond);
+  g_dbus_connection_signal_unsubscribe (server_connection, subscription_id);
+
+  g_dbus_server_stop (server);
+  g_clear_object (&server);
+
+  g_object_unref (c);
+  g_ptr_array_unref (data.current_connections);
+
+  g_main_loop_quit (service_loop);
+  g_thread_join (service_thread);
+
+  teardown_test_address ();
+
+  g_main_loop_unref (loop);
+  g_free (test_guid);
+}
+
+/* ---------------------------------------------------------------------------------------------------- */
+
+static void
+on_lazy_body_signal (GDBusConnection *connection,
+                     const gchar     *sender_name,
+                     const gchar     *object_path,
+                     const gchar     *interface_name,
+                     const gchar     *signal_name,
+                     GVariant        *parameters,
+                     gpointer         user_data)
+{
+  guint *n_received = user_data;
+  const gchar *arg0;
+
+  /* Only the signal matching the arg0 filter may get here */
+  g_variant_get (parameters, "(&s)", &arg0);
+  g_assert_cmpstr (arg0, ==, "wanted");
+  *n_received += 1;
+
+  g_main_loop_quit (loop);
+}
+
+static void
+test_peer_lazy_message_body (void)
+{
+  GDBusConnection *c;
+  GDBusConnection *server_connection;
+  GError *error = NULL;
+  PeerData data;
+  GThread *service_thread;
+  GVariant *result;
+  const gchar *s;
+  guint subscription_id;
+  guint n_received = 0;
+  guint i;
+
+  g_test_summary ("Test that a connection deserialising message bodies "
+                  "lazily receives method replies and signals correctly");
+
+  test_guid = g_dbus_generate_guid ();
+  loop = g_main_loop_new (NULL, FALSE);
+
+  setup_test_address ();
+  memset (&data, '\0', sizeof (PeerData));
+  data.current_connections = g_ptr_array_new_with_free_func (g_object_unref);
+
+  service_thread = g_thread_new ("test_peer",
+                                 service_thread_func,
+                                 &data);
+  await_service_loop ();
+  g_assert_nonnull (server);
+
+  data.accept_connection = TRUE;
+  c = g_dbus_connection_new_for_address_sync (g_dbus_server_get_client_address (server),
+                                              G_DBUS_CONNECTION_FLAGS_AUTHENTICATION_CLIENT |
+                                              G_DBUS_CONNECTION_FLAGS_LAZY_MESSAGE_BODY,
+                                              NULL, /* GDBusAuthObserver */
+                                              NULL, /* cancellable */
+                                              &error);
+  g_assert_no_error (error);
+  g_assert_nonnull (c);
+  while (data.current_connections->len < 1)
+    g_main_loop_run (loop);
+  server_connection = data.current_connections->pdata[0];
+
+  /* Replies are parsed the first time their body is looked at */
+  for (i = 0; i < 3; i++)
+    {
+      result = g_dbus_connection_call_sync (c,
+                                            NULL, /* bus_name */
+                                            "/org/gtk/GDBus/PeerTestObject",
+                                            "org.gtk.GDBus.PeerTestInterface",
+                                            "HelloPeer",
+                                            g_variant_new ("(s)", "Hey Peer!"),
+                                            G_VARIANT_TYPE ("(s)"),
+                                            G_DBUS_CALL_FLAGS_NONE,
+                                            -1,
+                                            NULL, /* cancellable */
+                                            &error);
+      g_assert_no_error (error);
+      g_variant_get (result, "(&s)", &s);
+      g_assert_cmpstr (s, ==, "You greeted me with 'Hey Peer!'.");
+      g_variant_unref (result);
+    }
+
+  /* Matching on arg0 needs the body of every signal */
+  subscription_id = g_dbus_connection_signal_subscribe (c,
+                                                        NULL, /* sender */
+                                                        "org.gtk.GDBus.LazyInterface",
+                                                        "Lazy",
+                                                        "/org/gtk/GDBus/LazyObject",
+                                                        "wanted",
+                                                        G_DBUS_SIGNAL_FLAGS_NONE,
+                                                        on_lazy_body_signal,
+                                                        &n_received,
+                                                        NULL);
+
+  g_dbus_connection_emit_signal (server_connection,
+                                 NULL, /* destination */
+                                 "/org/gtk/GDBus/LazyObject",
+                                 "org.gtk.GDBus.LazyInterface",
+                                 "Lazy",
+                                 g_variant_new ("(s)", "unwanted"),
+                                 &error);
+  g_assert_no_error (error);
+  g_dbus_connection_emit_signal (server_connection,
+                                 NULL, /* destination */
+                                 "/org/gtk/GDBus/LazyObject",
+                                 "org.gtk.GDBus.LazyInterface",
+                                 "Lazy",
+                                 g_variant_new ("(s)", "wanted"),
+                                 &error);
+  g_assert_no_error (error);
+
+  while (n_received < 1)
+    g_main_loop_run (loop);
+  g_assert_cmpuint (n_received, ==, 1);
+
+  g_dbus_connection_signal_unsubscribe (c, subscription_id);
+
+  g_dbus_server_stop (server);
+  g_clear_object (&server);
+
+  g_object_unref (c);
+  g_ptr_array_unref (data.current_connections);
+
+  g_main_loop_quit (service_loop);
+  g_thread_join (service_thread);
+
+  teardown_test_address ();
+
+  g_main_loop_unref (loop);
+  g_free (test_guid);
+}
+
 /* ---------------------------------------------------------------------------------------------------- */
 
 typedef struct
@@ -2252,6 +2774,9 @@ main (int   argc,
   g_test_add_func ("/gdbus/peer-to-peer/invalid/conn/addr/sync",
                    test_peer_invalid_conn_addr_sync);
   g_test_add_func ("/gdbus/peer-to-peer/signals", test_peer_signals);
+  g_test_add_func ("/gdbus/peer-to-peer/signal-burst", test_peer_signal_burst);
+  g_test_add_func ("/gdbus/peer-to-peer/signal-match-index", test_peer_signal_match_index);
+  g_test_add_func ("/gdbus/peer-to-peer/lazy-message-body", test_peer_lazy_message_body);
   g_test_add_func ("/gdbus/delayed-message-processing", delayed_message_processing);
   g_test_add_func ("/gdbus/nonce-tcp", test_nonce_tcp);
 
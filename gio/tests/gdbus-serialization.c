@@ -524,6 +524,7 @@ get_and_check_serialization (GVariant *value)
   DBusMessage *dbus_1_message;
   GDBusMessage *message;
   GDBusMessage *recovered_message;
+  GBytes *bytes;
   GError *error;
   DBusError dbus_error;
   gchar *last_serialization = NULL;
@@ -619,6 +620,22 @@ get_and_check_serialization (GVariant *value)
           g_assert_cmpvariant (g_dbus_message_get_body (recovered_message), value);
         }
       g_object_unref (recovered_message);
+
+      /* And the same with a lazily deserialised body */
+      bytes = g_bytes_new_static (blob, blob_size);
+      recovered_message = g_dbus_message_new_from_bytes (bytes,
+                                                         G_DBUS_CAPABILITY_FLAGS_NONE,
+                                                         &error);
+      g_assert_no_error (error);
+      g_assert (recovered_message != NULL);
+      g_bytes_unref (bytes);
+
+      if (value == NULL)
+        g_assert_null (g_dbus_message_get_body (recovered_message));
+      else
+        g_assert_cmpvariant (g_dbus_message_get_body (recovered_message), value);
+      g_object_unref (recovered_message);
+
       g_free (blob);
 
       if (last_serialization != NULL)
@@ -1612,6 +1629,7 @@ test_message_parse_deep_body_nesting (void)
   };
   gsize size = sizeof (data);
   GDBusMessage *message = NULL;
+  GBytes *bytes = NULL;
   GError *local_error = NULL;
 
   message = g_dbus_message_new_from_blob ((guchar *) data, size,
@@ -1621,6 +1639,19 @@ test_message_parse_deep_body_nesting (void)
   g_assert_null (message);
 
   g_clear_error (&local_error);
+
+  /* A lazily deserialised body is only found to be invalid when it is used */
+  bytes = g_bytes_new_static (data, size);
+  message = g_dbus_message_new_from_bytes (bytes, G_DBUS_CAPABILITY_FLAGS_NONE,
+                                           &local_error);
+  g_assert_no_error (local_error);
+  g_assert_nonnull (message);
+  g_assert_cmpstr (g_dbus_message_get_signature (message), ==, "v");
+  g_assert_null (g_dbus_message_get_body (message));
+  g_assert_null (g_dbus_message_get_arg0 (message));
+
+  g_object_unref (message);
+  g_bytes_unref (bytes);
 }
 
 /* ---------------------------------------------------------------------------------------------------- */
@@ -1668,10 +1699,20 @@ test_message_parse_truncated (void)
   /* Try parsing all possible prefixes of the full @blob. */
   for (gsize i = 0; i < size; i++)
     {
+      GBytes *bytes;
+
       message2 = g_dbus_message_new_from_blob (blob, i, G_DBUS_CAPABILITY_FLAGS_NONE, &error);
       g_assert_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT);
       g_assert_null (message2);
       g_clear_error (&error);
+
+      /* The body length is checked even if the body is not parsed yet */
+      bytes = g_bytes_new_static (blob, i);
+      message2 = g_dbus_message_new_from_bytes (bytes, G_DBUS_CAPABILITY_FLAGS_NONE, &error);
+      g_assert_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT);
+      g_assert_null (message2);
+      g_clear_error (&error);
+      g_bytes_unref (bytes);
     }
 
   message2 = g_dbus_message_new_from_blob (blob, size, G_DBUS_CAPABILITY_FLAGS_NONE, &error);
@@ -1682,6 +1723,60 @@ test_message_parse_truncated (void)
   g_free (blob);
 }
 
+static void
+test_message_parse_lazy_body (void)
+{
+  GDBusMessage *message = NULL;
+  GDBusMessage *lazy = NULL;
+  GDBusMessage *copy = NULL;
+  GBytes *bytes = NULL;
+  guchar *blob = NULL;
+  guchar *blob2 = NULL;
+  gsize size = 0, size2 = 0;
+  GError *error = NULL;
+
+  g_test_summary ("Test that messages created with g_dbus_message_new_from_bytes() "
+                  "deserialise their body on demand.");
+
+  message = g_dbus_message_new_signal ("/foo/bar", "org.example.Iface", "Changed");
+  g_dbus_message_set_byte_order (message, G_DBUS_MESSAGE_BYTE_ORDER_BIG_ENDIAN);
+  g_dbus_message_set_body (message, g_variant_new ("(sa{sv}as)", "org.example.Prop",
+                                                   NULL, NULL));
+  blob = g_dbus_message_to_blob (message, &size, G_DBUS_CAPABILITY_FLAGS_NONE, &error);
+  g_assert_no_error (error);
+
+  bytes = g_bytes_new_take (g_steal_pointer (&blob), size);
+  lazy = g_dbus_message_new_from_bytes (bytes, G_DBUS_CAPABILITY_FLAGS_NONE, &error);
+  g_assert_no_error (error);
+  g_bytes_unref (bytes);
+
+  g_assert_cmpint (g_dbus_message_get_byte_order (lazy), ==, G_DBUS_MESSAGE_BYTE_ORDER_BIG_ENDIAN);
+  g_assert_cmpstr (g_dbus_message_get_member (lazy), ==, "Changed");
+  g_assert_cmpstr (g_dbus_message_get_signature (lazy), ==, "sa{sv}as");
+
+  /* A copy made before the body is deserialised gets its own */
+  copy = g_dbus_message_copy (lazy, &error);
+  g_assert_no_error (error);
+  g_assert_cmpstr (g_dbus_message_get_arg0 (copy), ==, "org.example.Prop");
+  g_assert_cmpvariant (g_dbus_message_get_body (copy), g_dbus_message_get_body (message));
+
+  /* Changing the byte order must not confuse deserialisation */
+  g_dbus_message_set_byte_order (lazy, G_DBUS_MESSAGE_BYTE_ORDER_LITTLE_ENDIAN);
+  g_assert_cmpstr (g_dbus_message_get_arg0 (lazy), ==, "org.example.Prop");
+  g_assert_null (g_dbus_message_get_arg0_path (lazy));
+  g_assert_cmpvariant (g_dbus_message_get_body (lazy), g_dbus_message_get_body (message));
+
+  blob2 = g_dbus_message_to_blob (lazy, &size2, G_DBUS_CAPABILITY_FLAGS_NONE, &error);
+  g_assert_no_error (error);
+  g_assert_cmpint (blob2[0], ==, 'l');
+  g_assert_cmpuint (size2, ==, size);
+
+  g_free (blob2);
+  g_clear_object (&copy);
+  g_clear_object (&lazy);
+  g_clear_object (&message);
+}
+
 static void
 test_message_parse_empty_structure (void)
 {
@@ -1929,6 +2024,8 @@ main (int   argc,
                    test_message_parse_deep_body_nesting);
   g_test_add_func ("/gdbus/message-parse/truncated",
                    test_message_parse_truncated);
+  g_test_add_func ("/gdbus/message-parse/lazy-body",
+                   test_message_parse_lazy_body);
   g_test_add_func ("/gdbus/message-parse/empty-structure",
                    test_message_parse_empty_structure);
   g_test_add_func ("/gdbus/message-parse/missing-header",
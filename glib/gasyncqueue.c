@@ -37,6 +37,50 @@
 #include "gthread.h"
 #include "deprecated/gthread.h"
 
+/* Lock-free queues keep their producer and consumer positions on separate
+ * cache lines, so that producers and consumers do not keep stealing the
+ * line from each other. */
+#define CACHE_LINE_SIZE 64
+
+/* A slot of a bounded queue. See
+ * https://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+ * for the algorithm: @sequence tells producers and consumers which lap of
+ * the ring the slot is ready for. */
+typedef struct
+{
+  gsize sequence;  /* (atomic) */
+  gpointer data;
+} GAsyncQueueCell;
+
+typedef struct
+{
+  gsize enqueue_pos;  /* (atomic) */
+  gchar padding1[CACHE_LINE_SIZE - sizeof (gsize)];
+  gsize dequeue_pos;  /* (atomic) */
+  gchar padding2[CACHE_LINE_SIZE - sizeof (gsize)];
+  gsize mask;
+  GAsyncQueueCell cells[];  /* (array length=mask+1) */
+} GAsyncQueueRing;
+
+/* A node of a single-consumer queue. See
+ * https://www.1024cores.net/home/lock-free-algorithms/queues/non-intrusive-mpsc-node-based-queue
+ * for the algorithm. */
+typedef struct _GAsyncQueueNode GAsyncQueueNode;
+
+struct _GAsyncQueueNode
+{
+  GAsyncQueueNode *next;  /* (atomic) (nullable) */
+  gpointer data;
+};
+
+typedef struct
+{
+  GAsyncQueueNode *head;  /* (atomic) (owned), written by producers */
+  gchar padding[CACHE_LINE_SIZE - sizeof (gpointer)];
+  GAsyncQueueNode *tail;  /* (owned), only touched by the consumer */
+  gint length;  /* (atomic) */
+} GAsyncQueueMpsc;
+
 /**
  * GAsyncQueue: (copy-func g_async_queue_ref) (free-func g_async_queue_unref)
  *
@@ -52,8 +96,20 @@ struct _GAsyncQueue
   GDestroyNotify item_free_func;
   guint waiting_threads;
   gint ref_count;
+
+  /* Lock-free queues only (see g_async_queue_new_bounded() and
+   * g_async_queue_new_single_consumer()). Items are stored in @ring or
+   * @mpsc instead of @queue, and @mutex and @cond are only used to sleep
+   * when the queue is empty, or when @ring is full. */
+  GAsyncQueueRing *ring;  /* (nullable) (owned) */
+  GAsyncQueueMpsc *mpsc;  /* (nullable) (owned) */
+  GCond not_full_cond;
+  gint n_waiting_pop;  /* (atomic) */
+  gint n_waiting_push;  /* (atomic) */
 };
 
+#define G_ASYNC_QUEUE_IS_LOCK_FREE(queue) ((queue)->ring != NULL || (queue)->mpsc != NULL)
+
 typedef struct
 {
   GCompareDataFunc func;
@@ -97,10 +153,325 @@ g_async_queue_new_full (GDestroyNotify item_free_func)
   queue->waiting_threads = 0;
   queue->ref_count = 1;
   queue->item_free_func = item_free_func;
+  queue->ring = NULL;
+  queue->mpsc = NULL;
+  g_cond_init (&queue->not_full_cond);
+  queue->n_waiting_pop = 0;
+  queue->n_waiting_push = 0;
 
   return queue;
 }
 
+/**
+ * g_async_queue_new_bounded: (constructor)
+ * @capacity: the maximum number of items in the queue, greater than 0
+ * @item_free_func: (nullable): function to free queue elements
+ *
+ * Creates a new asynchronous queue which can hold at most @capacity
+ * items, and which pushes and pops items without taking a lock.
+ *
+ * Any number of threads may push to and pop from the queue concurrently.
+ * Threads only block, and only take a lock, when they pop from an empty
+ * queue or push to a full one: g_async_queue_push() waits for room in
+ * the queue rather than growing it. @capacity is rounded up to the next
+ * power of two, and to at least 2.
+ *
+ * Items are popped in the order in which they were pushed. The
+ * g_async_queue_lock() and `g_async_queue_*_unlocked()` functions, and
+ * the functions which reorder the queue (such as g_async_queue_sort(),
+ * g_async_queue_push_front() or g_async_queue_remove()), are not
+ * supported on such a queue.
+ *
+ * Returns: (transfer full): a new #GAsyncQueue. Free with g_async_queue_unref()
+ *
+ * Since: 2.86
+ */
+GAsyncQueue *
+g_async_queue_new_bounded (guint          capacity,
+                           GDestroyNotify item_free_func)
+{
+  GAsyncQueue *queue;
+  GAsyncQueueRing *ring;
+  gsize n_cells = 2, i;
+
+  g_return_val_if_fail (capacity > 0, NULL);
+  g_return_val_if_fail (capacity <= G_MAXUINT / 2 + 1, NULL);
+
+  while (n_cells < capacity)
+    n_cells <<= 1;
+
+  ring = g_aligned_alloc (1, sizeof (GAsyncQueueRing) + n_cells * sizeof (GAsyncQueueCell),
+                          CACHE_LINE_SIZE);
+  ring->enqueue_pos = 0;
+  ring->dequeue_pos = 0;
+  ring->mask = n_cells - 1;
+  for (i = 0; i < n_cells; i++)
+    {
+      ring->cells[i].sequence = i;
+      ring->cells[i].data = NULL;
+    }
+
+  queue = g_async_queue_new_full (item_free_func);
+  queue->ring = ring;
+
+  return queue;
+}
+
+/**
+ * g_async_queue_new_single_consumer: (constructor)
+ * @item_free_func: (nullable): function to free queue elements
+ *
+ * Creates a new unbounded asynchronous queue which pushes and pops items
+ * without taking a lock, for use by any number of producer threads but
+ * only a single consumer thread.
+ *
+ * Only one thread at a time may pop from the queue; it is a programmer
+ * error to call g_async_queue_pop(), g_async_queue_try_pop() or
+ * g_async_queue_timeout_pop() from several threads concurrently. Any
+ * number of threads may push to it. The consumer only blocks, and only
+ * takes a lock, when the queue is empty.
+ *
+ * Items are popped in the order in which they were pushed. The
+ * g_async_queue_lock() and `g_async_queue_*_unlocked()` functions, and
+ * the functions which reorder the queue (such as g_async_queue_sort(),
+ * g_async_queue_push_front() or g_async_queue_remove()), are not
+ * supported on such a queue.
+ *
+ * Returns: (transfer full): a new #GAsyncQueue. Free with g_async_queue_unref()
+ *
+ * Since: 2.86
+ */
+GAsyncQueue *
+g_async_queue_new_single_consumer (GDestroyNotify item_free_func)
+{
+  GAsyncQueue *queue;
+  GAsyncQueueMpsc *mpsc;
+
+  mpsc = g_aligned_alloc0 (1, sizeof (GAsyncQueueMpsc), CACHE_LINE_SIZE);
+  /* The tail always points to a consumed (or dummy) node. */
+  mpsc->head = mpsc->tail = g_new0 (GAsyncQueueNode, 1);
+  mpsc->length = 0;
+
+  queue = g_async_queue_new_full (item_free_func);
+  queue->mpsc = mpsc;
+
+  return queue;
+}
+
+static gboolean
+g_async_queue_ring_try_push (GAsyncQueueRing *ring,
+                             gpointer         data)
+{
+  GAsyncQueueCell *cell;
+  gsize pos;
+
+  pos = (gsize) g_atomic_pointer_get (&ring->enqueue_pos);
+
+  while (TRUE)
+    {
+      gssize dif;
+
+      cell = &ring->cells[pos & ring->mask];
+      dif = (gssize) ((gsize) g_atomic_pointer_get (&cell->sequence) - pos);
+
+      if (dif == 0)
+        {
+          gsize old_pos;
+
+          if (g_atomic_pointer_compare_and_exchange_full (&ring->enqueue_pos,
+                                                          pos, pos + 1,
+                                                          &old_pos))
+            break;
+          pos = old_pos;
+        }
+      else if (dif < 0)
+        {
+          /* The slot still holds an item from the previous lap. */
+          return FALSE;
+        }
+      else
+        pos = (gsize) g_atomic_pointer_get (&ring->enqueue_pos);
+    }
+
+  cell->data = data;
+  g_atomic_pointer_set (&cell->sequence, pos + 1);
+
+  return TRUE;
+}
+
+static gpointer
+g_async_queue_ring_try_pop (GAsyncQueueRing *ring)
+{
+  GAsyncQueueCell *cell;
+  gpointer data;
+  gsize pos;
+
+  pos = (gsize) g_atomic_pointer_get (&ring->dequeue_pos);
+
+  while (TRUE)
+    {
+      gssize dif;
+
+      cell = &ring->cells[pos & ring->mask];
+      dif = (gssize) ((gsize) g_atomic_pointer_get (&cell->sequence) - (pos + 1));
+
+      if (dif == 0)
+        {
+          gsize old_pos;
+
+          if (g_atomic_pointer_compare_and_exchange_full (&ring->dequeue_pos,
+                                                          pos, pos + 1,
+                                                          &old_pos))
+            break;
+          pos = old_pos;
+        }
+      else if (dif < 0)
+        {
+          /* The slot has not been filled for this lap yet. */
+          return NULL;
+        }
+      else
+        pos = (gsize) g_atomic_pointer_get (&ring->dequeue_pos);
+    }
+
+  data = cell->data;
+  g_atomic_pointer_set (&cell->sequence, pos + ring->mask + 1);
+
+  return data;
+}
+
+static void
+g_async_queue_mpsc_push (GAsyncQueueMpsc *mpsc,
+                         gpointer         data)
+{
+  GAsyncQueueNode *node, *prev;
+
+  node = g_new (GAsyncQueueNode, 1);
+  node->next = NULL;
+  node->data = data;
+
+  g_atomic_int_inc (&mpsc->length);
+  prev = g_atomic_pointer_exchange (&mpsc->head, node);
+  /* Until this store, the consumer sees the queue as ending at @prev. */
+  g_atomic_pointer_set (&prev->next, node);
+}
+
+static gpointer
+g_async_queue_mpsc_try_pop (GAsyncQueueMpsc *mpsc)
+{
+  GAsyncQueueNode *tail = mpsc->tail;
+  GAsyncQueueNode *next;
+  gpointer data;
+
+  next = g_atomic_pointer_get (&tail->next);
+  if (next == NULL)
+    return NULL;
+
+  /* @next becomes the new dummy node. */
+  data = g_steal_pointer (&next->data);
+  mpsc->tail = next;
+  g_free (tail);
+  g_atomic_int_add (&mpsc->length, -1);
+
+  return data;
+}
+
+static gpointer
+g_async_queue_lock_free_try_pop (GAsyncQueue *queue)
+{
+  if (queue->ring != NULL)
+    return g_async_queue_ring_try_pop (queue->ring);
+  else
+    return g_async_queue_mpsc_try_pop (queue->mpsc);
+}
+
+/* The slow paths below rely on the waiter raising its counter before
+ * checking the queue again with @mutex held, and on the other side
+ * updating the queue before reading the counter: so either the waiter
+ * sees the update, or the other side sees the waiter and signals it,
+ * which it can only do once the waiter is sleeping on the condition. */
+static void
+g_async_queue_lock_free_push (GAsyncQueue *queue,
+                              gpointer     data)
+{
+  if (queue->ring != NULL)
+    {
+      if (!g_async_queue_ring_try_push (queue->ring, data))
+        {
+          g_atomic_int_inc (&queue->n_waiting_push);
+          g_mutex_lock (&queue->mutex);
+          while (!g_async_queue_ring_try_push (queue->ring, data))
+            g_cond_wait (&queue->not_full_cond, &queue->mutex);
+          g_mutex_unlock (&queue->mutex);
+          g_atomic_int_add (&queue->n_waiting_push, -1);
+        }
+    }
+  else
+    g_async_queue_mpsc_push (queue->mpsc, data);
+
+  if (g_atomic_int_get (&queue->n_waiting_pop) > 0)
+    {
+      g_mutex_lock (&queue->mutex);
+      g_cond_signal (&queue->cond);
+      g_mutex_unlock (&queue->mutex);
+    }
+}
+
+static gpointer
+g_async_queue_lock_free_pop (GAsyncQueue *queue,
+                             gboolean     wait,
+                             gint64       end_time)
+{
+  gpointer retval;
+
+  retval = g_async_queue_lock_free_try_pop (queue);
+
+  if (retval == NULL && wait)
+    {
+      g_atomic_int_inc (&queue->n_waiting_pop);
+      g_mutex_lock (&queue->mutex);
+      while ((retval = g_async_queue_lock_free_try_pop (queue)) == NULL)
+        {
+          if (end_time == -1)
+            g_cond_wait (&queue->cond, &queue->mutex);
+          else if (!g_cond_wait_until (&queue->cond, &queue->mutex, end_time))
+            {
+              retval = g_async_queue_lock_free_try_pop (queue);
+              break;
+            }
+        }
+      g_mutex_unlock (&queue->mutex);
+      g_atomic_int_add (&queue->n_waiting_pop, -1);
+    }
+
+  if (retval != NULL && g_atomic_int_get (&queue->n_waiting_push) > 0)
+    {
+      g_mutex_lock (&queue->mutex);
+      g_cond_signal (&queue->not_full_cond);
+      g_mutex_unlock (&queue->mutex);
+    }
+
+  return retval;
+}
+
+static gint
+g_async_queue_lock_free_length (GAsyncQueue *queue)
+{
+  gint length;
+
+  if (queue->ring != NULL)
+    {
+      gsize dequeue_pos = (gsize) g_atomic_pointer_get (&queue->ring->dequeue_pos);
+      gsize enqueue_pos = (gsize) g_atomic_pointer_get (&queue->ring->enqueue_pos);
+
+      length = (gint) MAX ((gssize) (enqueue_pos - dequeue_pos), 0);
+    }
+  else
+    length = MAX (g_atomic_int_get (&queue->mpsc->length), 0);
+
+  return length - g_atomic_int_get (&queue->n_waiting_pop);
+}
+
 /**
  * g_async_queue_ref:
  * @queue: a #GAsyncQueue
@@ -181,9 +552,27 @@ g_async_queue_unref (GAsyncQueue *queue)
       g_return_if_fail (queue->waiting_threads == 0);
       g_mutex_clear (&queue->mutex);
       g_cond_clear (&queue->cond);
+      g_cond_clear (&queue->not_full_cond);
       if (queue->item_free_func)
         g_queue_foreach (&queue->queue, (GFunc) queue->item_free_func, NULL);
       g_queue_clear (&queue->queue);
+
+      if (G_ASYNC_QUEUE_IS_LOCK_FREE (queue))
+        {
+          gpointer item;
+
+          while ((item = g_async_queue_lock_free_try_pop (queue)) != NULL)
+            {
+              if (queue->item_free_func)
+                queue->item_free_func (item);
+            }
+
+          if (queue->mpsc != NULL)
+            g_free (queue->mpsc->tail);
+          g_aligned_free (queue->mpsc);
+          g_aligned_free (queue->ring);
+        }
+
       g_free (queue);
     }
 }
@@ -206,6 +595,7 @@ void
 g_async_queue_lock (GAsyncQueue *queue)
 {
   g_return_if_fail (queue);
+  g_return_if_fail (!G_ASYNC_QUEUE_IS_LOCK_FREE (queue));
 
   g_mutex_lock (&queue->mutex);
 }
@@ -224,6 +614,7 @@ void
 g_async_queue_unlock (GAsyncQueue *queue)
 {
   g_return_if_fail (queue);
+  g_return_if_fail (!G_ASYNC_QUEUE_IS_LOCK_FREE (queue));
 
   g_mutex_unlock (&queue->mutex);
 }
@@ -236,6 +627,9 @@ g_async_queue_unlock (GAsyncQueue *queue)
  * Pushes the @data into the @queue.
  *
  * The @data parameter must not be %NULL.
+ *
+ * If @queue was created with g_async_queue_new_bounded() and is full,
+ * this function blocks until an item is popped from it.
  */
 void
 g_async_queue_push (GAsyncQueue *queue,
@@ -244,6 +638,12 @@ g_async_queue_push (GAsyncQueue *queue,
   g_return_if_fail (queue);
   g_return_if_fail (data);
 
+  if (G_ASYNC_QUEUE_IS_LOCK_FREE (queue))
+    {
+      g_async_queue_lock_free_push (queue, data);
+      return;
+    }
+
   g_mutex_lock (&queue->mutex);
   g_async_queue_push_unlocked (queue, data);
   g_mutex_unlock (&queue->mutex);
@@ -266,6 +666,7 @@ g_async_queue_push_unlocked (GAsyncQueue *queue,
 {
   g_return_if_fail (queue);
   g_return_if_fail (data);
+  g_return_if_fail (!G_ASYNC_QUEUE_IS_LOCK_FREE (queue));
 
   g_queue_push_head (&queue->queue, data);
   if (queue->waiting_threads > 0)
@@ -299,6 +700,7 @@ g_async_queue_push_sorted (GAsyncQueue      *queue,
                            gpointer          user_data)
 {
   g_return_if_fail (queue != NULL);
+  g_return_if_fail (!G_ASYNC_QUEUE_IS_LOCK_FREE (queue));
 
   g_mutex_lock (&queue->mutex);
   g_async_queue_push_sorted_unlocked (queue, data, func, user_data);
@@ -348,6 +750,7 @@ g_async_queue_push_sorted_unlocked (GAsyncQueue      *queue,
 
   g_return_if_fail (queue != NULL);
   g_return_if_fail (data != NULL);
+  g_return_if_fail (!G_ASYNC_QUEUE_IS_LOCK_FREE (queue));
 
   sd.func = func;
   sd.user_data = user_data;
@@ -406,6 +809,9 @@ g_async_queue_pop (GAsyncQueue *queue)
 
   g_return_val_if_fail (queue, NULL);
 
+  if (G_ASYNC_QUEUE_IS_LOCK_FREE (queue))
+    return g_async_queue_lock_free_pop (queue, TRUE, -1);
+
   g_mutex_lock (&queue->mutex);
   retval = g_async_queue_pop_intern_unlocked (queue, TRUE, -1);
   g_mutex_unlock (&queue->mutex);
@@ -428,6 +834,7 @@ gpointer
 g_async_queue_pop_unlocked (GAsyncQueue *queue)
 {
   g_return_val_if_fail (queue, NULL);
+  g_return_val_if_fail (!G_ASYNC_QUEUE_IS_LOCK_FREE (queue), NULL);
 
   return g_async_queue_pop_intern_unlocked (queue, TRUE, -1);
 }
@@ -449,6 +856,9 @@ g_async_queue_try_pop (GAsyncQueue *queue)
 
   g_return_val_if_fail (queue, NULL);
 
+  if (G_ASYNC_QUEUE_IS_LOCK_FREE (queue))
+    return g_async_queue_lock_free_pop (queue, FALSE, -1);
+
   g_mutex_lock (&queue->mutex);
   retval = g_async_queue_pop_intern_unlocked (queue, FALSE, -1);
   g_mutex_unlock (&queue->mutex);
@@ -472,6 +882,7 @@ gpointer
 g_async_queue_try_pop_unlocked (GAsyncQueue *queue)
 {
   g_return_val_if_fail (queue, NULL);
+  g_return_val_if_fail (!G_ASYNC_QUEUE_IS_LOCK_FREE (queue), NULL);
 
   return g_async_queue_pop_intern_unlocked (queue, FALSE, -1);
 }
@@ -498,6 +909,9 @@ g_async_queue_timeout_pop (GAsyncQueue *queue,
 
   g_return_val_if_fail (queue != NULL, NULL);
 
+  if (G_ASYNC_QUEUE_IS_LOCK_FREE (queue))
+    return g_async_queue_lock_free_pop (queue, TRUE, end_time);
+
   g_mutex_lock (&queue->mutex);
   retval = g_async_queue_pop_intern_unlocked (queue, TRUE, end_time);
   g_mutex_unlock (&queue->mutex);
@@ -527,6 +941,7 @@ g_async_queue_timeout_pop_unlocked (GAsyncQueue *queue,
   gint64 end_time = g_get_monotonic_time () + timeout;
 
   g_return_val_if_fail (queue != NULL, NULL);
+  g_return_val_if_fail (!G_ASYNC_QUEUE_IS_LOCK_FREE (queue), NULL);
 
   return g_async_queue_pop_intern_unlocked (queue, TRUE, end_time);
 }
@@ -567,6 +982,9 @@ g_async_queue_timed_pop (GAsyncQueue *queue,
   else
     m_end_time = -1;
 
+  if (G_ASYNC_QUEUE_IS_LOCK_FREE (queue))
+    return g_async_queue_lock_free_pop (queue, TRUE, m_end_time);
+
   g_mutex_lock (&queue->mutex);
   retval = g_async_queue_pop_intern_unlocked (queue, TRUE, m_end_time);
   g_mutex_unlock (&queue->mutex);
@@ -603,6 +1021,7 @@ g_async_queue_timed_pop_unlocked (GAsyncQueue *queue,
   gint64 m_end_time;
 
   g_return_val_if_fail (queue, NULL);
+  g_return_val_if_fail (!G_ASYNC_QUEUE_IS_LOCK_FREE (queue), NULL);
 
   if (end_time != NULL)
     {
@@ -638,6 +1057,9 @@ g_async_queue_length (GAsyncQueue *queue)
 
   g_return_val_if_fail (queue, 0);
 
+  if (G_ASYNC_QUEUE_IS_LOCK_FREE (queue))
+    return g_async_queue_lock_free_length (queue);
+
   g_mutex_lock (&queue->mutex);
   retval = queue->queue.length - queue->waiting_threads;
   g_mutex_unlock (&queue->mutex);
@@ -666,6 +1088,7 @@ gint
 g_async_queue_length_unlocked (GAsyncQueue *queue)
 {
   g_return_val_if_fail (queue, 0);
+  g_return_val_if_fail (!G_ASYNC_QUEUE_IS_LOCK_FREE (queue), 0);
 
   return queue->queue.length - queue->waiting_threads;
 }
@@ -708,6 +1131,7 @@ g_async_queue_sort (GAsyncQueue      *queue,
 {
   g_return_if_fail (queue != NULL);
   g_return_if_fail (func != NULL);
+  g_return_if_fail (!G_ASYNC_QUEUE_IS_LOCK_FREE (queue));
 
   g_mutex_lock (&queue->mutex);
   g_async_queue_sort_unlocked (queue, func, user_data);
@@ -741,6 +1165,7 @@ g_async_queue_sort_unlocked (GAsyncQueue      *queue,
 
   g_return_if_fail (queue != NULL);
   g_return_if_fail (func != NULL);
+  g_return_if_fail (!G_ASYNC_QUEUE_IS_LOCK_FREE (queue));
 
   sd.func = func;
   sd.user_data = user_data;
@@ -769,6 +1194,7 @@ g_async_queue_remove (GAsyncQueue *queue,
 
   g_return_val_if_fail (queue != NULL, FALSE);
   g_return_val_if_fail (item != NULL, FALSE);
+  g_return_val_if_fail (!G_ASYNC_QUEUE_IS_LOCK_FREE (queue), FALSE);
 
   g_mutex_lock (&queue->mutex);
   ret = g_async_queue_remove_unlocked (queue, item);
@@ -796,6 +1222,7 @@ g_async_queue_remove_unlocked (GAsyncQueue *queue,
 {
   g_return_val_if_fail (queue != NULL, FALSE);
   g_return_val_if_fail (item != NULL, FALSE);
+  g_return_val_if_fail (!G_ASYNC_QUEUE_IS_LOCK_FREE (queue), FALSE);
 
   return g_queue_remove (&queue->queue, item);
 }
@@ -818,6 +1245,7 @@ g_async_queue_push_front (GAsyncQueue *queue,
 {
   g_return_if_fail (queue != NULL);
   g_return_if_fail (item != NULL);
+  g_return_if_fail (!G_ASYNC_QUEUE_IS_LOCK_FREE (queue));
 
   g_mutex_lock (&queue->mutex);
   g_async_queue_push_front_unlocked (queue, item);
@@ -844,6 +1272,7 @@ g_async_queue_push_front_unlocked (GAsyncQueue *queue,
 {
   g_return_if_fail (queue != NULL);
   g_return_if_fail (item != NULL);
+  g_return_if_fail (!G_ASYNC_QUEUE_IS_LOCK_FREE (queue));
 
   g_queue_push_tail (&queue->queue, item);
   if (queue->waiting_threads > 0)
@@ -858,6 +1287,7 @@ GMutex *
 _g_async_queue_get_mutex (GAsyncQueue *queue)
 {
   g_return_val_if_fail (queue, NULL);
+  g_return_val_if_fail (!G_ASYNC_QUEUE_IS_LOCK_FREE (queue), NULL);
 
   return &queue->mutex;
 }
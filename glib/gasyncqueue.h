@@ -41,6 +41,11 @@ GLIB_AVAILABLE_IN_ALL
 GAsyncQueue *g_async_queue_new                  (void);
 GLIB_AVAILABLE_IN_ALL
 GAsyncQueue *g_async_queue_new_full             (GDestroyNotify item_free_func);
+GLIB_AVAILABLE_IN_2_86
+GAsyncQueue *g_async_queue_new_bounded          (guint          capacity,
+                                                 GDestroyNotify item_free_func);
+GLIB_AVAILABLE_IN_2_86
+GAsyncQueue *g_async_queue_new_single_consumer  (GDestroyNotify item_free_func);
 GLIB_AVAILABLE_IN_ALL
 void         g_async_queue_lock                 (GAsyncQueue      *queue);
 GLIB_AVAILABLE_IN_ALL
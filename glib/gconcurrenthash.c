@@ -0,0 +1,1036 @@
+/* GLIB - Library of useful routines for C programming
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * MT safe
+ */
+
+#include "config.h"
+
+#include "gconcurrenthash.h"
+
+#include "gatomic.h"
+#include "gmem.h"
+#include "gmessages.h"
+#include "grefcount.h"
+#include "gthread.h"
+
+/**
+ * GConcurrentHashTable:
+ *
+ * A `GConcurrentHashTable` is a hash table which can be used from several
+ * threads at once without any external locking.
+ *
+ * It is meant for read-mostly data, such as caches shared between
+ * threads. Lookups never take a lock and never write to memory shared
+ * with other readers, so they scale with the number of threads. Writers
+ * take one of several locks, depending on the key, so writers touching
+ * different keys rarely contend with each other either.
+ *
+ * Keys and values are hashed, compared and freed with the same functions as
+ * in a [struct@GLib.HashTable]. Because a concurrent lookup may still be
+ * looking at an entry which is being removed or replaced, the destroy
+ * functions are not called straight away: they are called later, once no
+ * lookup can see the entry any more, from whichever thread is modifying the
+ * table at that point. All pending destroy functions are called by
+ * [method@GLib.ConcurrentHashTable.remove_all] and when the last reference
+ * to the table is dropped.
+ *
+ * For the same reason, a value returned by
+ * [method@GLib.ConcurrentHashTable.lookup] is only guaranteed to remain
+ * valid for as long as its entry is not removed or replaced. If that can
+ * happen concurrently, use [method@GLib.ConcurrentHashTable.lookup_copy] to
+ * take a reference on the value while it is still guaranteed to be valid.
+ *
+ * Callbacks invoked by a `GConcurrentHashTable` (the hash, equality and copy
+ * functions, and the function passed to
+ * [method@GLib.ConcurrentHashTable.foreach]) must not modify the table.
+ *
+ * Since: 2.86
+ */
+
+/* Lookups use a form of read-copy-update. Entries are immutable once
+ * published: inserting links a new node at the head of its bucket's chain,
+ * replacing links a new node in place of the old one, and growing the
+ * table copies all the nodes into a new bucket array which is then
+ * published as a whole. Unlinked nodes and bucket arrays are *retired*,
+ * and only freed after a *grace period*: once every lookup which might
+ * have seen them has finished.
+ *
+ * Lookups announce themselves by incrementing one of two counters in a
+ * reader slot; the thread's slot is picked once per thread, so threads
+ * normally do not share cache lines. Which of the two counters is used
+ * depends on the parity of the table's epoch. To wait for a grace period,
+ * the epoch is flipped, so that new lookups use the other counter, and the
+ * old counters are waited on until they drain; that is done twice, so that
+ * both counters have been seen drained after the nodes were retired. All
+ * of this relies on GLib's atomic operations being sequentially
+ * consistent.
+ *
+ * Writers hash the key to one of the lock stripes. The number of buckets is
+ * always a multiple of the number of stripes, and both are powers of two,
+ * so all nodes of a given chain are protected by the same lock. Growing and
+ * clearing the table take all of the locks.
+ */
+
+#define CACHE_LINE_SIZE 64
+
+#define MAX_STRIPES 64
+#define MAX_READER_SLOTS 64
+#define MIN_BUCKETS 16
+
+/* Retired nodes are batched, so that a grace period does not have to be
+ * waited for by every removal. */
+#define RECLAIM_THRESHOLD 64
+
+typedef struct _GConcurrentHashNode GConcurrentHashNode;
+typedef struct _GConcurrentHashData GConcurrentHashData;
+
+struct _GConcurrentHashNode
+{
+  GConcurrentHashNode *next;  /* (atomic) */
+  guint hash;
+  gpointer key;
+  gpointer value;
+
+  /* Only used once the node has been retired */
+  GConcurrentHashNode *retired_next;
+  guint free_key : 1;
+  guint free_value : 1;
+};
+
+struct _GConcurrentHashData
+{
+  gsize mask;
+  GConcurrentHashNode **buckets;  /* (array length=mask+1) (atomic) elements */
+
+  GConcurrentHashData *retired_next;
+};
+
+typedef union
+{
+  gint counts[2];  /* (atomic) */
+  char padding[CACHE_LINE_SIZE];
+} GConcurrentHashReaderSlot;
+
+typedef union
+{
+  GMutex mutex;
+  char padding[CACHE_LINE_SIZE];
+} GConcurrentHashStripe;
+
+struct _GConcurrentHashTable
+{
+  GConcurrentHashData *data;  /* (atomic) */
+  gint nnodes;  /* (atomic) */
+
+  GHashFunc hash_func;
+  GEqualFunc key_equal_func;
+  GDestroyNotify key_destroy_func;
+  GDestroyNotify value_destroy_func;
+  gatomicrefcount ref_count;
+
+  GConcurrentHashStripe *stripes;
+  guint n_stripes;
+
+  GConcurrentHashReaderSlot *readers;
+  guint n_readers;
+  gint epoch;  /* (atomic) */
+
+  GMutex grace_mutex;  /* serialises grace periods */
+
+  GMutex retire_mutex;  /* protects the fields below */
+  GConcurrentHashNode *retired_nodes;
+  GConcurrentHashData *retired_data;
+  guint n_retired;
+};
+
+/* The index of the calling thread, which picks its reader slot in every
+ * table. Stored plus one, so that zero means unset. */
+static GPrivate reader_index;
+static gint next_reader_index = 0;  /* (atomic) */
+
+static guint
+g_concurrent_hash_round_up_to_power_of_two (guint n,
+                                            guint max)
+{
+  guint result = 1;
+
+  while (result < n && result < max)
+    result <<= 1;
+
+  return result;
+}
+
+/* See g_hash_table_mix_hash(): the low bits pick the bucket and the lock
+ * stripe, so they need to depend on all bits of the user's hash. */
+static inline guint
+g_concurrent_hash_mix (guint hash)
+{
+  hash ^= hash >> 16;
+  hash *= 0x85ebca6bU;
+  hash ^= hash >> 13;
+  hash *= 0xc2b2ae35U;
+  hash ^= hash >> 16;
+
+  return hash;
+}
+
+static GConcurrentHashData *
+g_concurrent_hash_data_new (gsize n_buckets)
+{
+  GConcurrentHashData *data;
+
+  data = g_new0 (GConcurrentHashData, 1);
+  data->mask = n_buckets - 1;
+  data->buckets = g_new0 (GConcurrentHashNode *, n_buckets);
+
+  return data;
+}
+
+static void
+g_concurrent_hash_data_free (GConcurrentHashData *data)
+{
+  g_free (data->buckets);
+  g_free (data);
+}
+
+static inline gint *
+g_concurrent_hash_table_read_begin (GConcurrentHashTable *hash_table)
+{
+  guint index = GPOINTER_TO_UINT (g_private_get (&reader_index));
+  GConcurrentHashReaderSlot *slot;
+  gint *counter;
+
+  if (G_UNLIKELY (index == 0))
+    {
+      index = ((guint) g_atomic_int_add (&next_reader_index, 1) % MAX_READER_SLOTS) + 1;
+      g_private_set (&reader_index, GUINT_TO_POINTER (index));
+    }
+
+  slot = &hash_table->readers[(index - 1) & (hash_table->n_readers - 1)];
+  counter = &slot->counts[g_atomic_int_get (&hash_table->epoch) & 1];
+  g_atomic_int_inc (counter);
+
+  return counter;
+}
+
+static inline void
+g_concurrent_hash_table_read_end (gint *counter)
+{
+  g_atomic_int_add (counter, -1);
+}
+
+/* Waits until no lookup which started before this call is still running. */
+static void
+g_concurrent_hash_table_synchronize (GConcurrentHashTable *hash_table)
+{
+  guint i, j;
+
+  g_mutex_lock (&hash_table->grace_mutex);
+
+  for (i = 0; i < 2; i++)
+    {
+      gint old_epoch = g_atomic_int_add (&hash_table->epoch, 1) & 1;
+
+      for (j = 0; j < hash_table->n_readers; j++)
+        while (g_atomic_int_get (&hash_table->readers[j].counts[old_epoch]) != 0)
+          g_thread_yield ();
+    }
+
+  g_mutex_unlock (&hash_table->grace_mutex);
+}
+
+static void
+g_concurrent_hash_table_free_retired (GConcurrentHashTable *hash_table,
+                                      GConcurrentHashNode  *nodes,
+                                      GConcurrentHashData  *data)
+{
+  while (nodes != NULL)
+    {
+      GConcurrentHashNode *next = nodes->retired_next;
+
+      if (nodes->free_key && hash_table->key_destroy_func != NULL)
+        hash_table->key_destroy_func (nodes->key);
+      if (nodes->free_value && hash_table->value_destroy_func != NULL)
+        hash_table->value_destroy_func (nodes->value);
+
+      g_free (nodes);
+      nodes = next;
+    }
+
+  while (data != NULL)
+    {
+      GConcurrentHashData *next = data->retired_next;
+
+      g_concurrent_hash_data_free (data);
+      data = next;
+    }
+}
+
+/* Frees everything retired so far, after waiting for a grace period. */
+static void
+g_concurrent_hash_table_reclaim (GConcurrentHashTable *hash_table)
+{
+  GConcurrentHashNode *nodes;
+  GConcurrentHashData *data;
+
+  g_mutex_lock (&hash_table->retire_mutex);
+  nodes = g_steal_pointer (&hash_table->retired_nodes);
+  data = g_steal_pointer (&hash_table->retired_data);
+  hash_table->n_retired = 0;
+  g_mutex_unlock (&hash_table->retire_mutex);
+
+  if (nodes == NULL && data == NULL)
+    return;
+
+  g_concurrent_hash_table_synchronize (hash_table);
+  g_concurrent_hash_table_free_retired (hash_table, nodes, data);
+}
+
+/*
+ * g_concurrent_hash_table_retire:
+ * @hash_table: a #GConcurrentHashTable
+ * @first: (nullable): the first of a list of unlinked nodes, chained
+ *   through their retired_next field
+ * @last: (nullable): the last node of that list
+ * @n_nodes: the length of the list
+ * @data: (nullable): an unpublished bucket array
+ *
+ * Hands nodes and bucket arrays which no new lookup can see any more over
+ * to be freed after a grace period. The caller must not hold any locks.
+ */
+static void
+g_concurrent_hash_table_retire (GConcurrentHashTable *hash_table,
+                                GConcurrentHashNode  *first,
+                                GConcurrentHashNode  *last,
+                                guint                 n_nodes,
+                                GConcurrentHashData  *data)
+{
+  gboolean reclaim;
+
+  g_mutex_lock (&hash_table->retire_mutex);
+
+  if (first != NULL)
+    {
+      last->retired_next = hash_table->retired_nodes;
+      hash_table->retired_nodes = first;
+      hash_table->n_retired += n_nodes;
+    }
+
+  if (data != NULL)
+    {
+      data->retired_next = hash_table->retired_data;
+      hash_table->retired_data = data;
+      hash_table->n_retired++;
+    }
+
+  reclaim = hash_table->n_retired >= RECLAIM_THRESHOLD;
+
+  g_mutex_unlock (&hash_table->retire_mutex);
+
+  if (reclaim)
+    g_concurrent_hash_table_reclaim (hash_table);
+}
+
+static void
+g_concurrent_hash_table_lock_all (GConcurrentHashTable *hash_table)
+{
+  guint i;
+
+  for (i = 0; i < hash_table->n_stripes; i++)
+    g_mutex_lock (&hash_table->stripes[i].mutex);
+}
+
+static void
+g_concurrent_hash_table_unlock_all (GConcurrentHashTable *hash_table)
+{
+  guint i;
+
+  for (i = hash_table->n_stripes; i > 0; i--)
+    g_mutex_unlock (&hash_table->stripes[i - 1].mutex);
+}
+
+static inline GMutex *
+g_concurrent_hash_table_get_stripe (GConcurrentHashTable *hash_table,
+                                    guint                 mixed_hash)
+{
+  return &hash_table->stripes[mixed_hash & (hash_table->n_stripes - 1)].mutex;
+}
+
+static inline gboolean
+g_concurrent_hash_table_node_matches (GConcurrentHashTable *hash_table,
+                                      GConcurrentHashNode  *node,
+                                      guint                 hash,
+                                      gconstpointer         key)
+{
+  if (node->hash != hash)
+    return FALSE;
+
+  if (hash_table->key_equal_func != NULL)
+    return hash_table->key_equal_func (node->key, key);
+
+  return node->key == key;
+}
+
+static GConcurrentHashNode *
+g_concurrent_hash_table_lookup_node (GConcurrentHashTable *hash_table,
+                                     guint                 hash,
+                                     gconstpointer         key)
+{
+  GConcurrentHashData *data = g_atomic_pointer_get (&hash_table->data);
+  GConcurrentHashNode *node;
+
+  for (node = g_atomic_pointer_get (&data->buckets[g_concurrent_hash_mix (hash) & data->mask]);
+       node != NULL;
+       node = g_atomic_pointer_get (&node->next))
+    {
+      if (g_concurrent_hash_table_node_matches (hash_table, node, hash, key))
+        return node;
+    }
+
+  return NULL;
+}
+
+/* Grows the table, if it has become too full, to a load factor of at
+ * most one half. */
+static void
+g_concurrent_hash_table_maybe_grow (GConcurrentHashTable *hash_table)
+{
+  GConcurrentHashData *old_data;
+  GConcurrentHashData *new_data;
+  GConcurrentHashNode *retired_first = NULL;
+  GConcurrentHashNode *retired_last = NULL;
+  guint n_retired = 0;
+  gsize n_buckets, i;
+  guint nnodes;
+
+  old_data = g_atomic_pointer_get (&hash_table->data);
+  if ((gsize) g_atomic_int_get (&hash_table->nnodes) <= old_data->mask + 1)
+    return;
+
+  g_concurrent_hash_table_lock_all (hash_table);
+
+  /* Someone else may have grown the table in the meantime */
+  old_data = g_atomic_pointer_get (&hash_table->data);
+  nnodes = (guint) g_atomic_int_get (&hash_table->nnodes);
+  if (nnodes <= old_data->mask + 1)
+    {
+      g_concurrent_hash_table_unlock_all (hash_table);
+      return;
+    }
+
+  n_buckets = (old_data->mask + 1) * 2;
+  while (n_buckets < (gsize) nnodes * 2)
+    n_buckets *= 2;
+
+  new_data = g_concurrent_hash_data_new (n_buckets);
+
+  /* Concurrent lookups may still be walking the old chains, so they are
+   * left intact, and the new table gets copies of the nodes. */
+  for (i = 0; i <= old_data->mask; i++)
+    {
+      GConcurrentHashNode *node;
+
+      for (node = old_data->buckets[i]; node != NULL; node = node->next)
+        {
+          GConcurrentHashNode *copy = g_new (GConcurrentHashNode, 1);
+          gsize index = g_concurrent_hash_mix (node->hash) & new_data->mask;
+
+          copy->hash = node->hash;
+          copy->key = node->key;
+          copy->value = node->value;
+          copy->next = new_data->buckets[index];
+          new_data->buckets[index] = copy;
+
+          /* The copy now owns the key and value */
+          node->free_key = FALSE;
+          node->free_value = FALSE;
+          node->retired_next = retired_first;
+          retired_first = node;
+          if (retired_last == NULL)
+            retired_last = node;
+          n_retired++;
+        }
+    }
+
+  g_atomic_pointer_set (&hash_table->data, new_data);
+
+  g_concurrent_hash_table_unlock_all (hash_table);
+
+  g_concurrent_hash_table_retire (hash_table, retired_first, retired_last, n_retired, old_data);
+}
+
+static gboolean
+g_concurrent_hash_table_insert_internal (GConcurrentHashTable *hash_table,
+                                         gpointer              key,
+                                         gpointer              value,
+                                         gboolean              keep_new_key)
+{
+  GConcurrentHashData *data;
+  GConcurrentHashNode **link;
+  GConcurrentHashNode *node;
+  GConcurrentHashNode *new_node;
+  GMutex *stripe;
+  guint hash, mixed;
+
+  hash = hash_table->hash_func (key);
+  mixed = g_concurrent_hash_mix (hash);
+  stripe = g_concurrent_hash_table_get_stripe (hash_table, mixed);
+
+  new_node = g_new (GConcurrentHashNode, 1);
+  new_node->hash = hash;
+  new_node->value = value;
+
+  g_mutex_lock (stripe);
+
+  /* The bucket array cannot be swapped while we hold a stripe lock, and
+   * no other writer can modify the chain, so it can be walked with plain
+   * loads. */
+  data = g_atomic_pointer_get (&hash_table->data);
+  link = &data->buckets[mixed & data->mask];
+
+  for (node = *link; node != NULL; node = node->next)
+    {
+      if (g_concurrent_hash_table_node_matches (hash_table, node, hash, key))
+        break;
+      link = &node->next;
+    }
+
+  if (node != NULL)
+    {
+      new_node->key = keep_new_key ? key : node->key;
+      new_node->next = node->next;
+      g_atomic_pointer_set (link, new_node);
+
+      g_mutex_unlock (stripe);
+
+      /* The new key was never visible to lookups */
+      if (!keep_new_key && hash_table->key_destroy_func != NULL)
+        hash_table->key_destroy_func (key);
+
+      node->free_key = keep_new_key;
+      node->free_value = TRUE;
+      g_concurrent_hash_table_retire (hash_table, node, node, 1, NULL);
+
+      return FALSE;
+    }
+
+  new_node->key = key;
+  new_node->next = data->buckets[mixed & data->mask];
+  g_atomic_pointer_set (&data->buckets[mixed & data->mask], new_node);
+  g_atomic_int_inc (&hash_table->nnodes);
+
+  g_mutex_unlock (stripe);
+
+  g_concurrent_hash_table_maybe_grow (hash_table);
+
+  return TRUE;
+}
+
+/**
+ * g_concurrent_hash_table_new:
+ * @hash_func: a function to create a hash value from a key
+ * @key_equal_func: (nullable): a function to check two keys for equality
+ *
+ * Creates a new [struct@GLib.ConcurrentHashTable] with a reference count
+ * of 1.
+ *
+ * The hash and equality functions behave as in g_hash_table_new(); they
+ * may be called from several threads at once.
+ *
+ * Returns: (transfer full): a new #GConcurrentHashTable
+ *
+ * Since: 2.86
+ */
+GConcurrentHashTable *
+g_concurrent_hash_table_new (GHashFunc  hash_func,
+                             GEqualFunc key_equal_func)
+{
+  return g_concurrent_hash_table_new_full (hash_func, key_equal_func, NULL, NULL);
+}
+
+/**
+ * g_concurrent_hash_table_new_full:
+ * @hash_func: a function to create a hash value from a key
+ * @key_equal_func: (nullable): a function to check two keys for equality
+ * @key_destroy_func: (nullable): a function to free the memory allocated
+ *   for the key when its entry is removed, or %NULL
+ * @value_destroy_func: (nullable): a function to free the memory allocated
+ *   for the value when its entry is removed, or %NULL
+ *
+ * Creates a new [struct@GLib.ConcurrentHashTable] like
+ * g_concurrent_hash_table_new(), with functions to free the keys and
+ * values of removed entries.
+ *
+ * The destroy functions may be called some time after the entry was
+ * removed, and from any thread which modifies the table; see
+ * [struct@GLib.ConcurrentHashTable].
+ *
+ * Returns: (transfer full): a new #GConcurrentHashTable
+ *
+ * Since: 2.86
+ */
+GConcurrentHashTable *
+g_concurrent_hash_table_new_full (GHashFunc      hash_func,
+                                  GEqualFunc     key_equal_func,
+                                  GDestroyNotify key_destroy_func,
+                                  GDestroyNotify value_destroy_func)
+{
+  GConcurrentHashTable *hash_table;
+  guint n_processors = g_get_num_processors ();
+  guint i;
+
+  hash_table = g_new0 (GConcurrentHashTable, 1);
+  g_atomic_ref_count_init (&hash_table->ref_count);
+  hash_table->hash_func = hash_func ? hash_func : g_direct_hash;
+  hash_table->key_equal_func = key_equal_func;
+  hash_table->key_destroy_func = key_destroy_func;
+  hash_table->value_destroy_func = value_destroy_func;
+
+  hash_table->n_stripes = g_concurrent_hash_round_up_to_power_of_two (n_processors * 4, MAX_STRIPES);
+  hash_table->stripes = g_aligned_alloc0 (hash_table->n_stripes, sizeof (GConcurrentHashStripe), CACHE_LINE_SIZE);
+  for (i = 0; i < hash_table->n_stripes; i++)
+    g_mutex_init (&hash_table->stripes[i].mutex);
+
+  hash_table->n_readers = g_concurrent_hash_round_up_to_power_of_two (n_processors, MAX_READER_SLOTS);
+  hash_table->readers = g_aligned_alloc0 (hash_table->n_readers, sizeof (GConcurrentHashReaderSlot), CACHE_LINE_SIZE);
+
+  g_mutex_init (&hash_table->grace_mutex);
+  g_mutex_init (&hash_table->retire_mutex);
+
+  hash_table->data = g_concurrent_hash_data_new (MAX (MIN_BUCKETS, hash_table->n_stripes));
+
+  return hash_table;
+}
+
+/**
+ * g_concurrent_hash_table_ref:
+ * @hash_table: a #GConcurrentHashTable
+ *
+ * Atomically increments the reference count of @hash_table by one.
+ * This function is MT-safe and may be called from any thread.
+ *
+ * Returns: (transfer full): the passed in #GConcurrentHashTable
+ *
+ * Since: 2.86
+ */
+GConcurrentHashTable *
+g_concurrent_hash_table_ref (GConcurrentHashTable *hash_table)
+{
+  g_return_val_if_fail (hash_table != NULL, NULL);
+
+  g_atomic_ref_count_inc (&hash_table->ref_count);
+
+  return hash_table;
+}
+
+/**
+ * g_concurrent_hash_table_unref:
+ * @hash_table: (transfer full): a #GConcurrentHashTable
+ *
+ * Atomically decrements the reference count of @hash_table by one.
+ * If the reference count drops to 0, all keys and values will be
+ * destroyed, and all memory allocated by the hash table is released.
+ * This function is MT-safe and may be called from any thread.
+ *
+ * Since: 2.86
+ */
+void
+g_concurrent_hash_table_unref (GConcurrentHashTable *hash_table)
+{
+  GConcurrentHashData *data;
+  gsize i;
+  guint j;
+
+  g_return_if_fail (hash_table != NULL);
+
+  if (!g_atomic_ref_count_dec (&hash_table->ref_count))
+    return;
+
+  /* Nobody else can be using the table any more, so there is no need to
+   * wait for a grace period. */
+  g_concurrent_hash_table_free_retired (hash_table,
+                                        g_steal_pointer (&hash_table->retired_nodes),
+                                        g_steal_pointer (&hash_table->retired_data));
+
+  data = hash_table->data;
+  for (i = 0; i <= data->mask; i++)
+    {
+      GConcurrentHashNode *node = data->buckets[i];
+
+      while (node != NULL)
+        {
+          GConcurrentHashNode *next = node->next;
+
+          if (hash_table->key_destroy_func != NULL)
+            hash_table->key_destroy_func (node->key);
+          if (hash_table->value_destroy_func != NULL)
+            hash_table->value_destroy_func (node->value);
+
+          g_free (node);
+          node = next;
+        }
+    }
+  g_concurrent_hash_data_free (data);
+
+  for (j = 0; j < hash_table->n_stripes; j++)
+    g_mutex_clear (&hash_table->stripes[j].mutex);
+  g_aligned_free (hash_table->stripes);
+  g_aligned_free (hash_table->readers);
+  g_mutex_clear (&hash_table->grace_mutex);
+  g_mutex_clear (&hash_table->retire_mutex);
+
+  g_free (hash_table);
+}
+
+/**
+ * g_concurrent_hash_table_insert:
+ * @hash_table: a #GConcurrentHashTable
+ * @key: a key to insert
+ * @value: the value to associate with the key
+ *
+ * Inserts a new key and value into a #GConcurrentHashTable.
+ *
+ * As with g_hash_table_insert(), if the key already exists its current
+ * value is replaced with the new value, and the passed key is freed using
+ * the key destroy function, if any. The old value is freed later; see
+ * [struct@GLib.ConcurrentHashTable].
+ *
+ * Returns: %TRUE if the key did not exist yet
+ *
+ * Since: 2.86
+ */
+gboolean
+g_concurrent_hash_table_insert (GConcurrentHashTable *hash_table,
+                                gpointer              key,
+                                gpointer              value)
+{
+  g_return_val_if_fail (hash_table != NULL, FALSE);
+
+  return g_concurrent_hash_table_insert_internal (hash_table, key, value, FALSE);
+}
+
+/**
+ * g_concurrent_hash_table_replace:
+ * @hash_table: a #GConcurrentHashTable
+ * @key: a key to insert
+ * @value: the value to associate with the key
+ *
+ * Inserts a new key and value into a #GConcurrentHashTable similar to
+ * g_concurrent_hash_table_insert(). The difference is that if the key
+ * already exists, the old key is replaced by the new one, as with
+ * g_hash_table_replace(). The old key and value are freed later; see
+ * [struct@GLib.ConcurrentHashTable].
+ *
+ * Returns: %TRUE if the key did not exist yet
+ *
+ * Since: 2.86
+ */
+gboolean
+g_concurrent_hash_table_replace (GConcurrentHashTable *hash_table,
+                                 gpointer              key,
+                                 gpointer              value)
+{
+  g_return_val_if_fail (hash_table != NULL, FALSE);
+
+  return g_concurrent_hash_table_insert_internal (hash_table, key, value, TRUE);
+}
+
+/**
+ * g_concurrent_hash_table_remove:
+ * @hash_table: a #GConcurrentHashTable
+ * @key: the key to remove
+ *
+ * Removes a key and its associated value from a #GConcurrentHashTable.
+ *
+ * The key and value are freed using the destroy functions passed to
+ * g_concurrent_hash_table_new_full(), once no concurrent lookup can be
+ * using them any more; see [struct@GLib.ConcurrentHashTable].
+ *
+ * Returns: %TRUE if the key was found and removed
+ *
+ * Since: 2.86
+ */
+gboolean
+g_concurrent_hash_table_remove (GConcurrentHashTable *hash_table,
+                                gconstpointer         key)
+{
+  GConcurrentHashData *data;
+  GConcurrentHashNode **link;
+  GConcurrentHashNode *node;
+  GMutex *stripe;
+  guint hash, mixed;
+
+  g_return_val_if_fail (hash_table != NULL, FALSE);
+
+  hash = hash_table->hash_func (key);
+  mixed = g_concurrent_hash_mix (hash);
+  stripe = g_concurrent_hash_table_get_stripe (hash_table, mixed);
+
+  g_mutex_lock (stripe);
+
+  data = g_atomic_pointer_get (&hash_table->data);
+  link = &data->buckets[mixed & data->mask];
+
+  for (node = *link; node != NULL; node = node->next)
+    {
+      if (g_concurrent_hash_table_node_matches (hash_table, node, hash, key))
+        break;
+      link = &node->next;
+    }
+
+  if (node == NULL)
+    {
+      g_mutex_unlock (stripe);
+      return FALSE;
+    }
+
+  /* Lookups which are currently at @node can still follow its next
+   * pointer, which is left alone. */
+  g_atomic_pointer_set (link, node->next);
+  g_atomic_int_add (&hash_table->nnodes, -1);
+
+  g_mutex_unlock (stripe);
+
+  node->free_key = TRUE;
+  node->free_value = TRUE;
+  g_concurrent_hash_table_retire (hash_table, node, node, 1, NULL);
+
+  return TRUE;
+}
+
+/**
+ * g_concurrent_hash_table_remove_all:
+ * @hash_table: a #GConcurrentHashTable
+ *
+ * Removes all keys and their associated values from a
+ * #GConcurrentHashTable.
+ *
+ * This waits until no concurrent lookup can see the removed entries any
+ * more, and then calls the destroy functions for them, as well as for any
+ * entries which were removed or replaced earlier and whose destroy
+ * functions are still pending.
+ *
+ * Since: 2.86
+ */
+void
+g_concurrent_hash_table_remove_all (GConcurrentHashTable *hash_table)
+{
+  GConcurrentHashData *old_data;
+  GConcurrentHashNode *retired_first = NULL;
+  GConcurrentHashNode *retired_last = NULL;
+  guint n_retired = 0;
+  gsize i;
+
+  g_return_if_fail (hash_table != NULL);
+
+  g_concurrent_hash_table_lock_all (hash_table);
+
+  old_data = g_atomic_pointer_get (&hash_table->data);
+  g_atomic_pointer_set (&hash_table->data,
+                        g_concurrent_hash_data_new (MAX (MIN_BUCKETS, hash_table->n_stripes)));
+  g_atomic_int_set (&hash_table->nnodes, 0);
+
+  g_concurrent_hash_table_unlock_all (hash_table);
+
+  /* No writer can reach the old nodes any more */
+  for (i = 0; i <= old_data->mask; i++)
+    {
+      GConcurrentHashNode *node;
+
+      for (node = old_data->buckets[i]; node != NULL; node = node->next)
+        {
+          node->free_key = TRUE;
+          node->free_value = TRUE;
+          node->retired_next = retired_first;
+          retired_first = node;
+          if (retired_last == NULL)
+            retired_last = node;
+          n_retired++;
+        }
+    }
+
+  g_concurrent_hash_table_retire (hash_table, retired_first, retired_last, n_retired, old_data);
+  g_concurrent_hash_table_reclaim (hash_table);
+}
+
+/**
+ * g_concurrent_hash_table_lookup:
+ * @hash_table: a #GConcurrentHashTable
+ * @key: the key to look up
+ *
+ * Looks up a key in a #GConcurrentHashTable. This never blocks.
+ *
+ * The returned value is only guaranteed to remain valid until its entry
+ * is removed or replaced, which may happen concurrently in another thread.
+ * Use g_concurrent_hash_table_lookup_copy() if that is a concern.
+ *
+ * Returns: (nullable) (transfer none): the associated value, or %NULL if
+ *   the key is not found
+ *
+ * Since: 2.86
+ */
+gpointer
+g_concurrent_hash_table_lookup (GConcurrentHashTable *hash_table,
+                                gconstpointer         key)
+{
+  GConcurrentHashNode *node;
+  gpointer value = NULL;
+  gint *reader;
+  guint hash;
+
+  g_return_val_if_fail (hash_table != NULL, NULL);
+
+  hash = hash_table->hash_func (key);
+
+  reader = g_concurrent_hash_table_read_begin (hash_table);
+  node = g_concurrent_hash_table_lookup_node (hash_table, hash, key);
+  if (node != NULL)
+    value = node->value;
+  g_concurrent_hash_table_read_end (reader);
+
+  return value;
+}
+
+/**
+ * g_concurrent_hash_table_lookup_copy:
+ * @hash_table: a #GConcurrentHashTable
+ * @key: the key to look up
+ * @value_copy_func: (nullable) (scope call): a function to copy the value
+ *   with, or %NULL to return it as is
+ * @user_data: user data to pass to @value_copy_func
+ * @value: (out) (optional) (nullable): return location for the copied value
+ *
+ * Looks up a key in a #GConcurrentHashTable, and copies its value while it
+ * is guaranteed not to be freed, even if the entry is concurrently removed
+ * or replaced.
+ *
+ * @value_copy_func is typically used to take a reference on the value,
+ * for example with g_object_ref() or g_bytes_ref(). It must not modify
+ * @hash_table.
+ *
+ * Returns: %TRUE if the key was found
+ *
+ * Since: 2.86
+ */
+gboolean
+g_concurrent_hash_table_lookup_copy (GConcurrentHashTable *hash_table,
+                                     gconstpointer         key,
+                                     GCopyFunc             value_copy_func,
+                                     gpointer              user_data,
+                                     gpointer             *value)
+{
+  GConcurrentHashNode *node;
+  gint *reader;
+  guint hash;
+
+  g_return_val_if_fail (hash_table != NULL, FALSE);
+
+  hash = hash_table->hash_func (key);
+
+  reader = g_concurrent_hash_table_read_begin (hash_table);
+  node = g_concurrent_hash_table_lookup_node (hash_table, hash, key);
+  if (node != NULL && value != NULL)
+    *value = value_copy_func ? value_copy_func (node->value, user_data) : node->value;
+  g_concurrent_hash_table_read_end (reader);
+
+  return node != NULL;
+}
+
+/**
+ * g_concurrent_hash_table_contains:
+ * @hash_table: a #GConcurrentHashTable
+ * @key: the key to check
+ *
+ * Checks if @key is in @hash_table. This never blocks.
+ *
+ * Returns: %TRUE if @key is in @hash_table, %FALSE otherwise.
+ *
+ * Since: 2.86
+ */
+gboolean
+g_concurrent_hash_table_contains (GConcurrentHashTable *hash_table,
+                                  gconstpointer         key)
+{
+  g_return_val_if_fail (hash_table != NULL, FALSE);
+
+  return g_concurrent_hash_table_lookup_copy (hash_table, key, NULL, NULL, NULL);
+}
+
+/**
+ * g_concurrent_hash_table_size:
+ * @hash_table: a #GConcurrentHashTable
+ *
+ * Returns the number of elements contained in the #GConcurrentHashTable.
+ * If the table is being modified concurrently, this is only a snapshot.
+ *
+ * Returns: the number of key/value pairs in the #GConcurrentHashTable.
+ *
+ * Since: 2.86
+ */
+guint
+g_concurrent_hash_table_size (GConcurrentHashTable *hash_table)
+{
+  g_return_val_if_fail (hash_table != NULL, 0);
+
+  return (guint) g_atomic_int_get (&hash_table->nnodes);
+}
+
+/**
+ * g_concurrent_hash_table_foreach:
+ * @hash_table: a #GConcurrentHashTable
+ * @func: (scope call): the function to call for each key/value pair
+ * @user_data: user data to pass to the function
+ *
+ * Calls the given function for each of the key/value pairs in the
+ * #GConcurrentHashTable, without blocking concurrent writers.
+ *
+ * Entries which are inserted or removed concurrently may or may not be
+ * visited. @func must not modify @hash_table, and should return quickly,
+ * as freeing removed entries is delayed until it has returned.
+ *
+ * Since: 2.86
+ */
+void
+g_concurrent_hash_table_foreach (GConcurrentHashTable *hash_table,
+                                 GHFunc                func,
+                                 gpointer              user_data)
+{
+  GConcurrentHashData *data;
+  gint *reader;
+  gsize i;
+
+  g_return_if_fail (hash_table != NULL);
+  g_return_if_fail (func != NULL);
+
+  reader = g_concurrent_hash_table_read_begin (hash_table);
+
+  data = g_atomic_pointer_get (&hash_table->data);
+  for (i = 0; i <= data->mask; i++)
+    {
+      GConcurrentHashNode *node;
+
+      for (node = g_atomic_pointer_get (&data->buckets[i]);
+           node != NULL;
+           node = g_atomic_pointer_get (&node->next))
+        func (node->key, node->value, user_data);
+    }
+
+  g_concurrent_hash_table_read_end (reader);
+}
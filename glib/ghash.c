@@ -42,6 +42,11 @@
 #include "grefcount.h"
 #include "gvalgrind.h"
 
+#if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define USE_SSE2_GROUPS
+#endif
+
 /* The following #pragma is here so we can do this...
  *
  *   #ifndef USE_SMALL_ARRAYS
@@ -189,6 +194,26 @@
 #define HASH_IS_TOMBSTONE(h_) ((h_) == TOMBSTONE_HASH_VALUE)
 #define HASH_IS_REAL(h_) ((h_) >= 2)
 
+/* Tables created with %G_HASH_TABLE_FLAGS_GROUP_PROBING additionally keep
+ * one control byte per bucket. It is either CTRL_EMPTY, CTRL_DELETED or,
+ * for an occupied bucket, a 7-bit tag taken from the (mixed) hash value.
+ * Buckets are probed a whole group at a time by matching the tag against
+ * all of the group's control bytes at once: with SSE2 when available, and
+ * otherwise with 64-bit arithmetic ("SIMD within a register"). The
+ * control bytes are kept in sync with @hashes, so everything which only
+ * iterates over the table works unchanged. */
+#ifdef USE_SSE2_GROUPS
+#define GROUP_SHIFT 4  /* 16 buckets per group */
+#else
+#define GROUP_SHIFT 3  /* 8 buckets per group */
+#endif
+#define GROUP_WIDTH (1 << GROUP_SHIFT)
+
+#define CTRL_EMPTY ((guint8) 0x80)
+#define CTRL_DELETED ((guint8) 0xFE)
+#define CTRL_TAG(mixed_) ((guint8) ((mixed_) & 0x7F))
+#define CTRL_IS_FULL(c_) ((c_) < 0x80)
+
 /* If int is smaller than void * on our arch, we start out with
  * int-sized keys and values and resize to pointer-sized entries as
  * needed. This saves a good amount of memory when the HT is being
@@ -212,10 +237,12 @@ struct _GHashTable
 
   guint            have_big_keys : 1;
   guint            have_big_values : 1;
+  guint            use_groups : 1;
 
   gpointer         keys;
   guint           *hashes;
   gpointer         values;
+  guint8          *ctrl;  /* only if use_groups */
 
   GHashFunc        hash_func;
   GEqualFunc       key_equal_func;
@@ -311,13 +338,20 @@ g_hash_table_find_closest_shift (gint n)
   return i;
 }
 
+static inline gint
+g_hash_table_get_min_shift (GHashTable *hash_table)
+{
+  /* A grouped table always holds at least one full group. */
+  return hash_table->use_groups ? MAX (GROUP_SHIFT, HASH_TABLE_MIN_SHIFT) : HASH_TABLE_MIN_SHIFT;
+}
+
 static void
 g_hash_table_set_shift_from_size (GHashTable *hash_table, gint size)
 {
   gint shift;
 
   shift = g_hash_table_find_closest_shift (size);
-  shift = MAX (shift, HASH_TABLE_MIN_SHIFT);
+  shift = MAX (shift, g_hash_table_get_min_shift (hash_table));
 
   g_hash_table_set_shift (hash_table, shift);
 }
@@ -383,6 +417,196 @@ g_hash_table_hash_to_index (GHashTable *hash_table, guint hash)
   return (hash * 11) % hash_table->mod;
 }
 
+/* The prime modulo in g_hash_table_hash_to_index() is of no use for
+ * grouped tables, which need the high and the low bits of the hash to be
+ * independent of each other: the low 7 bits become the tag, and the rest
+ * selects the first group to probe. This is the finalizer of MurmurHash3. */
+static inline guint
+g_hash_table_mix_hash (guint hash)
+{
+  hash ^= hash >> 16;
+  hash *= 0x85ebca6bU;
+  hash ^= hash >> 13;
+  hash *= 0xc2b2ae35U;
+  hash ^= hash >> 16;
+
+  return hash;
+}
+
+/* Each of the following returns a mask with one bit per bucket of the
+ * group starting at @ctrl; g_hash_table_group_first() turns the lowest set
+ * bit back into an offset within the group. */
+#ifdef USE_SSE2_GROUPS
+
+static inline guint64
+g_hash_table_group_match (const guint8 *ctrl, guint8 tag)
+{
+  __m128i group = _mm_loadu_si128 ((const __m128i *) ctrl);
+
+  return (guint) _mm_movemask_epi8 (_mm_cmpeq_epi8 (group, _mm_set1_epi8 ((char) tag)));
+}
+
+static inline guint64
+g_hash_table_group_match_empty (const guint8 *ctrl)
+{
+  return g_hash_table_group_match (ctrl, CTRL_EMPTY);
+}
+
+static inline guint64
+g_hash_table_group_match_empty_or_deleted (const guint8 *ctrl)
+{
+  /* Occupied buckets are the only ones with the top bit clear */
+  return (guint) _mm_movemask_epi8 (_mm_loadu_si128 ((const __m128i *) ctrl));
+}
+
+#define GROUP_MATCH_IS_EXACT 1
+#define GROUP_MASK_SHIFT 0
+
+#else /* !USE_SSE2_GROUPS */
+
+#define GROUP_LSBS G_GUINT64_CONSTANT (0x0101010101010101)
+#define GROUP_MSBS G_GUINT64_CONSTANT (0x8080808080808080)
+
+static inline guint64
+g_hash_table_group_load (const guint8 *ctrl)
+{
+  guint64 group;
+
+  memcpy (&group, ctrl, sizeof (group));
+
+  return GUINT64_FROM_LE (group);
+}
+
+static inline guint64
+g_hash_table_group_match (const guint8 *ctrl, guint8 tag)
+{
+  guint64 x = g_hash_table_group_load (ctrl) ^ (GROUP_LSBS * tag);
+
+  /* Sets the top bit of each byte of @x which is zero. This may give
+   * false positives for bytes above a true match, so callers must check
+   * the control byte again. */
+  return (x - GROUP_LSBS) & ~x & GROUP_MSBS;
+}
+
+static inline guint64
+g_hash_table_group_match_empty (const guint8 *ctrl)
+{
+  guint64 group = g_hash_table_group_load (ctrl);
+
+  /* CTRL_EMPTY is the only value with the top bit set and bit 1 clear */
+  return group & ~(group << 6) & GROUP_MSBS;
+}
+
+static inline guint64
+g_hash_table_group_match_empty_or_deleted (const guint8 *ctrl)
+{
+  return g_hash_table_group_load (ctrl) & GROUP_MSBS;
+}
+
+#define GROUP_MATCH_IS_EXACT 0
+#define GROUP_MASK_SHIFT 3
+
+#endif /* !USE_SSE2_GROUPS */
+
+static inline guint
+g_hash_table_group_first (guint64 mask)
+{
+#if defined (__GNUC__) || defined (__clang__)
+  return (guint) __builtin_ctzll (mask) >> GROUP_MASK_SHIFT;
+#else
+  guint i = 0;
+
+  while ((mask & 1) == 0)
+    {
+      mask >>= 1;
+      i++;
+    }
+
+  return i >> GROUP_MASK_SHIFT;
+#endif
+}
+
+/*
+ * g_hash_table_lookup_node_grouped:
+ * @hash_table: our #GHashTable, which must use groups
+ * @key: the key to look up against
+ * @hash_value: the hash value of @key, as stored in @hashes
+ *
+ * The grouped equivalent of g_hash_table_lookup_node(). Groups are
+ * probed triangularly, which visits every group exactly once because the
+ * number of groups is a power of two. Probing stops at the first group
+ * which contains an empty bucket; the table is always kept from filling
+ * up, so there is one.
+ *
+ * Returns: index of the described node
+ */
+static inline guint
+g_hash_table_lookup_node_grouped (GHashTable    *hash_table,
+                                  gconstpointer  key,
+                                  guint          hash_value)
+{
+  guint mixed = g_hash_table_mix_hash (hash_value);
+  guint8 tag = CTRL_TAG (mixed);
+  guint group_mask = hash_table->mask >> GROUP_SHIFT;
+  guint group = (mixed >> 7) & group_mask;
+  guint insert_index = 0;
+  gboolean have_insert_index = FALSE;
+  guint step = 0;
+
+  for (;;)
+    {
+      guint base = group << GROUP_SHIFT;
+      const guint8 *ctrl = hash_table->ctrl + base;
+      guint64 match;
+
+#if defined (__GNUC__) || defined (__clang__)
+      /* Finding the matching bucket depends on loading the control bytes,
+       * so without this, a lookup in a large table would wait for two
+       * cache misses in a row instead of overlapping them. */
+      __builtin_prefetch ((const gpointer *) hash_table->keys + base);
+      __builtin_prefetch ((const gpointer *) hash_table->keys + base + GROUP_WIDTH - 1);
+#endif
+
+      for (match = g_hash_table_group_match (ctrl, tag); match != 0; match &= match - 1)
+        {
+          guint node_index = base + g_hash_table_group_first (match);
+          gpointer node_key;
+
+          if (!GROUP_MATCH_IS_EXACT && hash_table->ctrl[node_index] != tag)
+            continue;
+
+          node_key = g_hash_table_fetch_key_or_value (hash_table->keys, node_index, hash_table->have_big_keys);
+
+          if (hash_table->key_equal_func)
+            {
+              if (hash_table->key_equal_func (node_key, key))
+                return node_index;
+            }
+          else if (node_key == key)
+            {
+              return node_index;
+            }
+        }
+
+      /* Remember the first free bucket, in case we need to insert */
+      if (!have_insert_index)
+        {
+          match = g_hash_table_group_match_empty_or_deleted (ctrl);
+          if (match != 0)
+            {
+              insert_index = base + g_hash_table_group_first (match);
+              have_insert_index = TRUE;
+            }
+        }
+
+      if (g_hash_table_group_match_empty (ctrl) != 0)
+        return insert_index;
+
+      step++;
+      group = (group + step) & group_mask;
+    }
+}
+
 /*
  * g_hash_table_lookup_node:
  * @hash_table: our #GHashTable
@@ -424,6 +648,9 @@ g_hash_table_lookup_node (GHashTable    *hash_table,
 
   *hash_return = hash_value;
 
+  if (hash_table->use_groups)
+    return g_hash_table_lookup_node_grouped (hash_table, key, hash_value);
+
   node_index = g_hash_table_hash_to_index (hash_table, hash_value);
   node_hash = hash_table->hashes[node_index];
 
@@ -465,6 +692,19 @@ g_hash_table_lookup_node (GHashTable    *hash_table,
   return node_index;
 }
 
+/* Whether the node returned by g_hash_table_lookup_node() holds an entry.
+ * For grouped tables this checks the control byte, which the lookup has
+ * just brought into the cache, instead of touching the hashes array. */
+static inline gboolean
+g_hash_table_node_is_real (GHashTable *hash_table,
+                           guint       node_index)
+{
+  if (hash_table->use_groups)
+    return CTRL_IS_FULL (hash_table->ctrl[node_index]);
+
+  return HASH_IS_REAL (hash_table->hashes[node_index]);
+}
+
 /*
  * g_hash_table_remove_node:
  * @hash_table: our #GHashTable
@@ -472,7 +712,8 @@ g_hash_table_lookup_node (GHashTable    *hash_table,
  * @notify: %TRUE if the destroy notify handlers are to be called
  *
  * Removes a node from the hash table and updates the node count.
- * The node is replaced by a tombstone. No table resize is performed.
+ * The node is replaced by a tombstone, unless the table uses groups and
+ * the node can simply be emptied. No table resize is performed.
  *
  * If @notify is %TRUE then the destroy notify functions are called
  * for the key and value of the hash node.
@@ -488,8 +729,23 @@ g_hash_table_remove_node (GHashTable   *hash_table,
   key = g_hash_table_fetch_key_or_value (hash_table->keys, i, hash_table->have_big_keys);
   value = g_hash_table_fetch_key_or_value (hash_table->values, i, hash_table->have_big_values);
 
-  /* Erect tombstone */
-  hash_table->hashes[i] = TOMBSTONE_HASH_VALUE;
+  if (hash_table->use_groups &&
+      g_hash_table_group_match_empty (hash_table->ctrl + (i & ~(GROUP_WIDTH - 1))) != 0)
+    {
+      /* A probe sequence stops at the first group with an empty bucket,
+       * so none can pass through this group and it does not need a
+       * tombstone. */
+      hash_table->ctrl[i] = CTRL_EMPTY;
+      hash_table->hashes[i] = UNUSED_HASH_VALUE;
+      hash_table->noccupied--;
+    }
+  else
+    {
+      /* Erect tombstone */
+      if (hash_table->use_groups)
+        hash_table->ctrl[i] = CTRL_DELETED;
+      hash_table->hashes[i] = TOMBSTONE_HASH_VALUE;
+    }
 
   /* Be GC friendly */
   g_hash_table_assign_key_or_value (hash_table->keys, i, hash_table->have_big_keys, NULL);
@@ -531,7 +787,7 @@ g_hash_table_setup_storage (GHashTable *hash_table)
 # endif
 #endif
 
-  g_hash_table_set_shift (hash_table, HASH_TABLE_MIN_SHIFT);
+  g_hash_table_set_shift (hash_table, g_hash_table_get_min_shift (hash_table));
 
   hash_table->have_big_keys = !small;
   hash_table->have_big_values = !small;
@@ -539,6 +795,14 @@ g_hash_table_setup_storage (GHashTable *hash_table)
   hash_table->keys   = g_hash_table_realloc_key_or_value_array (NULL, hash_table->size, hash_table->have_big_keys);
   hash_table->values = hash_table->keys;
   hash_table->hashes = g_new0 (guint, hash_table->size);
+
+  if (hash_table->use_groups)
+    {
+      hash_table->ctrl = g_malloc (hash_table->size);
+      memset (hash_table->ctrl, CTRL_EMPTY, hash_table->size);
+    }
+  else
+    hash_table->ctrl = NULL;
 }
 
 /*
@@ -571,6 +835,7 @@ g_hash_table_remove_all_nodes (GHashTable *hash_table,
   gpointer *old_keys;
   gpointer *old_values;
   guint    *old_hashes;
+  guint8   *old_ctrl;
   gboolean  old_have_big_keys;
   gboolean  old_have_big_values;
 
@@ -589,6 +854,8 @@ g_hash_table_remove_all_nodes (GHashTable *hash_table,
       if (!destruction)
         {
           memset (hash_table->hashes, 0, hash_table->size * sizeof (guint));
+          if (hash_table->use_groups)
+            memset (hash_table->ctrl, CTRL_EMPTY, hash_table->size);
 
 #ifdef USE_SMALL_ARRAYS
           memset (hash_table->keys, 0, hash_table->size * (hash_table->have_big_keys ? BIG_ENTRY_SIZE : SMALL_ENTRY_SIZE));
@@ -628,6 +895,7 @@ g_hash_table_remove_all_nodes (GHashTable *hash_table,
   old_keys   = g_steal_pointer (&hash_table->keys);
   old_values = g_steal_pointer (&hash_table->values);
   old_hashes = g_steal_pointer (&hash_table->hashes);
+  old_ctrl   = g_steal_pointer (&hash_table->ctrl);
 
   if (!destruction)
     /* Any accesses will see an empty table */
@@ -663,6 +931,7 @@ g_hash_table_remove_all_nodes (GHashTable *hash_table,
 
   g_free (old_keys);
   g_free (old_hashes);
+  g_free (old_ctrl);
 }
 
 static void
@@ -845,6 +1114,85 @@ g_hash_table_resize (GHashTable *hash_table)
   hash_table->noccupied = hash_table->nnodes;
 }
 
+/*
+ * g_hash_table_resize_grouped:
+ * @hash_table: our #GHashTable, which must use groups
+ *
+ * The grouped equivalent of g_hash_table_resize(). The in-place
+ * algorithm used there relies on every bucket having a single home
+ * position, so grouped tables are rebuilt into freshly allocated arrays
+ * instead. The stored hash values are reused, so the user's hash
+ * function is not called again.
+ */
+static void
+g_hash_table_resize_grouped (GHashTable *hash_table)
+{
+  gsize old_size;
+  gboolean is_a_set;
+  gpointer old_keys;
+  gpointer old_values;
+  guint *old_hashes;
+  guint8 *old_ctrl;
+  guint group_mask;
+  gsize i;
+
+  old_size = hash_table->size;
+  is_a_set = hash_table->keys == hash_table->values;
+  old_keys = hash_table->keys;
+  old_values = hash_table->values;
+  old_hashes = hash_table->hashes;
+  old_ctrl = hash_table->ctrl;
+
+  g_hash_table_set_shift_from_size (hash_table, (gint) (hash_table->nnodes * 1.333));
+  group_mask = hash_table->mask >> GROUP_SHIFT;
+
+  hash_table->hashes = g_new0 (guint, hash_table->size);
+  hash_table->ctrl = g_malloc (hash_table->size);
+  memset (hash_table->ctrl, CTRL_EMPTY, hash_table->size);
+  hash_table->keys = g_hash_table_realloc_key_or_value_array (NULL, hash_table->size, hash_table->have_big_keys);
+  if (is_a_set)
+    hash_table->values = hash_table->keys;
+  else
+    hash_table->values = g_hash_table_realloc_key_or_value_array (NULL, hash_table->size, hash_table->have_big_values);
+
+  for (i = 0; i < old_size; i++)
+    {
+      guint node_hash = old_hashes[i];
+      guint mixed, group, node_index;
+      guint step = 0;
+      guint64 match;
+
+      if (!HASH_IS_REAL (node_hash))
+        continue;
+
+      /* There are no deleted buckets in the new arrays yet */
+      mixed = g_hash_table_mix_hash (node_hash);
+      group = (mixed >> 7) & group_mask;
+      while ((match = g_hash_table_group_match_empty (hash_table->ctrl + (group << GROUP_SHIFT))) == 0)
+        {
+          step++;
+          group = (group + step) & group_mask;
+        }
+      node_index = (group << GROUP_SHIFT) + g_hash_table_group_first (match);
+
+      hash_table->ctrl[node_index] = CTRL_TAG (mixed);
+      hash_table->hashes[node_index] = node_hash;
+      g_hash_table_assign_key_or_value (hash_table->keys, node_index, hash_table->have_big_keys,
+                                        g_hash_table_fetch_key_or_value (old_keys, i, hash_table->have_big_keys));
+      if (!is_a_set)
+        g_hash_table_assign_key_or_value (hash_table->values, node_index, hash_table->have_big_values,
+                                          g_hash_table_fetch_key_or_value (old_values, i, hash_table->have_big_values));
+    }
+
+  if (old_keys != old_values)
+    g_free (old_values);
+  g_free (old_keys);
+  g_free (old_hashes);
+  g_free (old_ctrl);
+
+  hash_table->noccupied = hash_table->nnodes;
+}
+
 /*
  * g_hash_table_maybe_resize:
  * @hash_table: our #GHashTable
@@ -859,9 +1207,18 @@ g_hash_table_maybe_resize (GHashTable *hash_table)
 {
   gsize noccupied = hash_table->noccupied;
   gsize size = hash_table->size;
+  gsize min_size = (gsize) 1 << g_hash_table_get_min_shift (hash_table);
 
-  if ((size > hash_table->nnodes * 4 && size > 1 << HASH_TABLE_MIN_SHIFT) ||
-      (size <= noccupied + (noccupied / 16)))
+  if (hash_table->use_groups)
+    {
+      /* Probing whole groups degrades faster as the table fills up, so
+       * keep at least an eighth of the buckets empty. */
+      if ((size > hash_table->nnodes * 4 && size > min_size) ||
+          (noccupied >= size - (size / 8)))
+        g_hash_table_resize_grouped (hash_table);
+    }
+  else if ((size > hash_table->nnodes * 4 && size > min_size) ||
+           (size <= noccupied + (noccupied / 16)))
     g_hash_table_resize (hash_table);
 }
 
@@ -1015,6 +1372,44 @@ g_hash_table_new_full (GHashFunc      hash_func,
                        GEqualFunc     key_equal_func,
                        GDestroyNotify key_destroy_func,
                        GDestroyNotify value_destroy_func)
+{
+  return g_hash_table_new_with_flags (hash_func, key_equal_func,
+                                      key_destroy_func, value_destroy_func,
+                                      G_HASH_TABLE_FLAGS_NONE);
+}
+
+/**
+ * g_hash_table_new_with_flags:
+ * @hash_func: a function to create a hash value from a key
+ * @key_equal_func: a function to check two keys for equality
+ * @key_destroy_func: (nullable): a function to free the memory allocated for the key
+ *     used when removing the entry from the #GHashTable, or %NULL
+ *     if you don't want to supply such a function.
+ * @value_destroy_func: (nullable): a function to free the memory allocated for the
+ *     value used when removing the entry from the #GHashTable, or %NULL
+ *     if you don't want to supply such a function.
+ * @flags: flags selecting the layout of the table
+ *
+ * Creates a new #GHashTable like g_hash_table_new_full(), additionally
+ * allowing to choose how the table is laid out in memory.
+ *
+ * With %G_HASH_TABLE_FLAGS_GROUP_PROBING, lookups compare a small tag
+ * derived from the hash value against a whole group of buckets at once,
+ * rather than comparing full hash values one bucket at a time. This mostly
+ * pays off for large tables with expensive key comparisons, such as
+ * string-keyed caches. The behaviour of all other #GHashTable functions,
+ * including iteration and the (undefined) iteration order, is unaffected.
+ *
+ * Returns: (transfer full): a new #GHashTable
+ *
+ * Since: 2.86
+ */
+GHashTable *
+g_hash_table_new_with_flags (GHashFunc       hash_func,
+                             GEqualFunc      key_equal_func,
+                             GDestroyNotify  key_destroy_func,
+                             GDestroyNotify  value_destroy_func,
+                             GHashTableFlags flags)
 {
   GHashTable *hash_table;
 
@@ -1029,6 +1424,7 @@ g_hash_table_new_full (GHashFunc      hash_func,
 #endif
   hash_table->key_destroy_func   = key_destroy_func;
   hash_table->value_destroy_func = value_destroy_func;
+  hash_table->use_groups         = (flags & G_HASH_TABLE_FLAGS_GROUP_PROBING) != 0;
 
   g_hash_table_setup_storage (hash_table);
 
@@ -1043,7 +1439,8 @@ g_hash_table_new_full (GHashFunc      hash_func,
  * count of 1.
  *
  * It inherits the hash function, the key equal function, the key destroy function,
- * as well as the value destroy function, from @other_hash_table.
+ * as well as the value destroy function, from @other_hash_table. Since 2.86,
+ * it also inherits the layout chosen with g_hash_table_new_with_flags().
  *
  * The returned hash table will be empty; it will not contain the keys
  * or values from @other_hash_table.
@@ -1056,10 +1453,13 @@ g_hash_table_new_similar (GHashTable *other_hash_table)
 {
   g_return_val_if_fail (other_hash_table, NULL);
 
-  return g_hash_table_new_full (other_hash_table->hash_func,
-                                other_hash_table->key_equal_func,
-                                other_hash_table->key_destroy_func,
-                                other_hash_table->value_destroy_func);
+  return g_hash_table_new_with_flags (other_hash_table->hash_func,
+                                      other_hash_table->key_equal_func,
+                                      other_hash_table->key_destroy_func,
+                                      other_hash_table->value_destroy_func,
+                                      other_hash_table->use_groups ?
+                                        G_HASH_TABLE_FLAGS_GROUP_PROBING :
+                                        G_HASH_TABLE_FLAGS_NONE);
 }
 
 /**
@@ -1248,13 +1648,25 @@ g_hash_table_insert_node (GHashTable *hash_table,
                           gboolean    reusing_key)
 {
   gboolean already_exists;
-  guint old_hash;
+  gboolean was_unused;
   gpointer key_to_free = NULL;
   gpointer key_to_keep = NULL;
   gpointer value_to_free = NULL;
 
-  old_hash = hash_table->hashes[node_index];
-  already_exists = HASH_IS_REAL (old_hash);
+  if (hash_table->use_groups)
+    {
+      guint8 old_ctrl = hash_table->ctrl[node_index];
+
+      already_exists = CTRL_IS_FULL (old_ctrl);
+      was_unused = old_ctrl == CTRL_EMPTY;
+    }
+  else
+    {
+      guint old_hash = hash_table->hashes[node_index];
+
+      already_exists = HASH_IS_REAL (old_hash);
+      was_unused = HASH_IS_UNUSED (old_hash);
+    }
 
   /* Proceed in three steps.  First, deal with the key because it is the
    * most complicated.  Then consider if we need to split the table in
@@ -1296,6 +1708,8 @@ g_hash_table_insert_node (GHashTable *hash_table,
   else
     {
       hash_table->hashes[node_index] = key_hash;
+      if (hash_table->use_groups)
+        hash_table->ctrl[node_index] = CTRL_TAG (g_hash_table_mix_hash (key_hash));
       key_to_keep = new_key;
     }
 
@@ -1311,7 +1725,7 @@ g_hash_table_insert_node (GHashTable *hash_table,
     {
       hash_table->nnodes++;
 
-      if (HASH_IS_UNUSED (old_hash))
+      if (was_unused)
         {
           /* We replaced an empty node, and not a tombstone */
           hash_table->noccupied++;
@@ -1440,6 +1854,7 @@ g_hash_table_unref (GHashTable *hash_table)
         g_free (hash_table->values);
       g_free (hash_table->keys);
       g_free (hash_table->hashes);
+      g_free (hash_table->ctrl);
       g_slice_free (GHashTable, hash_table);
     }
 }
@@ -1487,7 +1902,7 @@ g_hash_table_lookup (GHashTable    *hash_table,
 
   node_index = g_hash_table_lookup_node (hash_table, key, &node_hash);
 
-  return HASH_IS_REAL (hash_table->hashes[node_index])
+  return g_hash_table_node_is_real (hash_table, node_index)
     ? g_hash_table_fetch_key_or_value (hash_table->values, node_index, hash_table->have_big_values)
     : NULL;
 }
@@ -1524,7 +1939,7 @@ g_hash_table_lookup_extended (GHashTable    *hash_table,
 
   node_index = g_hash_table_lookup_node (hash_table, lookup_key, &node_hash);
 
-  if (!HASH_IS_REAL (hash_table->hashes[node_index]))
+  if (!g_hash_table_node_is_real (hash_table, node_index))
     {
       if (orig_key != NULL)
         *orig_key = NULL;
@@ -1688,7 +2103,7 @@ g_hash_table_contains (GHashTable    *hash_table,
 
   node_index = g_hash_table_lookup_node (hash_table, key, &node_hash);
 
-  return HASH_IS_REAL (hash_table->hashes[node_index]);
+  return g_hash_table_node_is_real (hash_table, node_index);
 }
 
 /*
@@ -1716,7 +2131,7 @@ g_hash_table_remove_internal (GHashTable    *hash_table,
 
   node_index = g_hash_table_lookup_node (hash_table, key, &node_hash);
 
-  if (!HASH_IS_REAL (hash_table->hashes[node_index]))
+  if (!g_hash_table_node_is_real (hash_table, node_index))
     return FALSE;
 
   g_hash_table_remove_node (hash_table, node_index, notify);
@@ -1810,7 +2225,7 @@ g_hash_table_steal_extended (GHashTable    *hash_table,
 
   node_index = g_hash_table_lookup_node (hash_table, lookup_key, &node_hash);
 
-  if (!HASH_IS_REAL (hash_table->hashes[node_index]))
+  if (!g_hash_table_node_is_real (hash_table, node_index))
     {
       if (stolen_key != NULL)
         *stolen_key = NULL;
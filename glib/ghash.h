@@ -45,6 +45,26 @@ typedef gboolean  (*GHRFunc)  (gpointer  key,
 
 typedef struct _GHashTableIter GHashTableIter;
 
+/**
+ * GHashTableFlags:
+ * @G_HASH_TABLE_FLAGS_NONE: Default layout.
+ * @G_HASH_TABLE_FLAGS_GROUP_PROBING: Keep a byte of metadata per bucket
+ *   and probe a group of 8 or 16 buckets at a time, using SIMD
+ *   instructions where available. This speeds up lookups in large tables,
+ *   at the cost of slightly more memory.
+ *
+ * Flags to pass to [func@GLib.HashTable.new_with_flags] which affect the
+ * layout of a [struct@GLib.HashTable].
+ *
+ * Since: 2.86
+ */
+GLIB_AVAILABLE_TYPE_IN_2_86
+typedef enum /*< flags >*/
+{
+  G_HASH_TABLE_FLAGS_NONE = 0,
+  G_HASH_TABLE_FLAGS_GROUP_PROBING = 1 << 0
+} GHashTableFlags;
+
 struct _GHashTableIter
 {
   /*< private >*/
@@ -64,6 +84,14 @@ GHashTable* g_hash_table_new_full          (GHashFunc       hash_func,
                                             GEqualFunc      key_equal_func,
                                             GDestroyNotify  key_destroy_func,
                                             GDestroyNotify  value_destroy_func);
+G_GNUC_BEGIN_IGNORE_DEPRECATIONS
+GLIB_AVAILABLE_IN_2_86
+GHashTable *g_hash_table_new_with_flags    (GHashFunc       hash_func,
+                                            GEqualFunc      key_equal_func,
+                                            GDestroyNotify  key_destroy_func,
+                                            GDestroyNotify  value_destroy_func,
+                                            GHashTableFlags flags);
+G_GNUC_END_IGNORE_DEPRECATIONS
 GLIB_AVAILABLE_IN_2_72
 GHashTable *g_hash_table_new_similar       (GHashTable     *other_hash_table);
 GLIB_AVAILABLE_IN_ALL
@@ -245,6 +245,10 @@
  *   (possibly modified) contents of the key file back to a file;
  *   otherwise only the translations for the current language will be
  *   written back.
+ * @G_KEY_FILE_READ_ONLY: Load the key file for reading only. Keys and values
+ *   are kept in a single copy of the loaded data instead of being allocated
+ *   one by one, which makes loading faster. Functions which modify the key
+ *   file must not be called on it. (Since: 2.86)
  *
  * Flags which influence the parsing.
  */
@@ -502,6 +506,7 @@
  */
 
 typedef struct _GKeyFileGroup GKeyFileGroup;
+typedef struct _GKeyFileLine GKeyFileLine;
 
 struct _GKeyFile
 {
@@ -511,8 +516,6 @@ struct _GKeyFile
   GKeyFileGroup *start_group;
   GKeyFileGroup *current_group;
 
-  GString *parse_buffer; /* Holds up to one line of not-yet-parsed data */
-
   gchar list_separator;
 
   GKeyFileFlags flags;
@@ -521,6 +524,14 @@ struct _GKeyFile
   gchar **locales;  /* (nullable) */
 
   gint ref_count;  /* (atomic) */
+
+  /* With G_KEY_FILE_READ_ONLY, the keys and values point into a copy of the
+   * loaded data, and the pairs and their list links come from one array
+   * with room for a pair per line. */
+  gchar *read_only_data;  /* (nullable) (owned) */
+  GKeyFileLine *read_only_lines;  /* (nullable) (owned) */
+  gsize n_read_only_lines;
+  gsize n_read_only_lines_used;
 };
 
 typedef struct _GKeyFileKeyValuePair GKeyFileKeyValuePair;
@@ -543,6 +554,12 @@ struct _GKeyFileKeyValuePair
   gchar *value;
 };
 
+struct _GKeyFileLine
+{
+  GList link;
+  GKeyFileKeyValuePair pair;
+};
+
 static gint                  find_file_in_data_dirs            (const gchar            *file,
 								const gchar           **data_dirs,
 								gchar                 **output_file,
@@ -626,12 +643,10 @@ static void                  g_key_file_parse_group            (GKeyFile
 								GError                **error);
 static const gchar          *key_get_locale                    (const gchar            *key,
                                                                 gsize                  *len_out);
-static void                  g_key_file_parse_data             (GKeyFile               *key_file,
-								const gchar            *data,
+static gboolean              g_key_file_parse_owned_data       (GKeyFile               *key_file,
+								gchar                  *data,
 								gsize                   length,
 								GError                **error);
-static void                  g_key_file_flush_parse_buffer     (GKeyFile               *key_file,
-								GError                **error);
 
 G_DEFINE_QUARK (g-key-file-error-quark, g_key_file_error)
 
@@ -642,7 +657,6 @@ g_key_file_init (GKeyFile *key_file)
   key_file->groups = g_list_prepend (NULL, key_file->current_group);
   key_file->group_hash = NULL;
   key_file->start_group = NULL;
-  key_file->parse_buffer = NULL;
   key_file->list_separator = ';';
   key_file->flags = 0;
 }
@@ -659,10 +673,11 @@ g_key_file_clear (GKeyFile *key_file)
     }
   key_file->checked_locales = FALSE;
 
-  if (key_file->parse_buffer)
+  if (key_file->read_only_lines != NULL)
     {
-      g_string_free (key_file->parse_buffer, TRUE);
-      key_file->parse_buffer = NULL;
+      /* The pairs and their links are all part of the line storage */
+      for (tmp = key_file->groups; tmp != NULL; tmp = tmp->next)
+        ((GKeyFileGroup *) tmp->data)->key_value_pairs = NULL;
     }
 
   tmp = key_file->groups;
@@ -679,6 +694,11 @@ g_key_file_clear (GKeyFile *key_file)
       key_file->group_hash = NULL;
     }
 
+  g_clear_pointer (&key_file->read_only_data, g_free);
+  g_clear_pointer (&key_file->read_only_lines, g_free);
+  key_file->n_read_only_lines = 0;
+  key_file->n_read_only_lines_used = 0;
+
   g_warn_if_fail (key_file->groups == NULL);
 }
 
@@ -818,10 +838,10 @@ g_key_file_load_from_fd (GKeyFile       *key_file,
 			 GKeyFileFlags   flags,
 			 GError        **error)
 {
-  GError *key_file_error = NULL;
   gssize bytes_read;
   struct stat stat_buf;
-  gchar read_buf[4096];
+  gchar *contents;
+  gsize length, alloc;
   gchar list_separator;
 
   if (fstat (fd, &stat_buf) < 0)
@@ -847,11 +867,25 @@ g_key_file_load_from_fd (GKeyFile       *key_file,
   key_file->list_separator = list_separator;
   key_file->flags = flags;
 
-  do
+  /* Read the whole file at once, so that it can be parsed in a single pass.
+   * The size is only a hint, as the file may change while we read it. */
+  alloc = (stat_buf.st_size > 0 && (guint64) stat_buf.st_size < G_MAXSIZE - 1) ?
+          (gsize) stat_buf.st_size + 1 : 4096;
+  contents = g_malloc (alloc);
+  length = 0;
+
+  while (TRUE)
     {
       int errsv;
 
-      bytes_read = read (fd, read_buf, 4096);
+      if (alloc - length < 2)
+        {
+          alloc *= 2;
+          contents = g_realloc (contents, alloc);
+        }
+
+      /* Leave room for the terminating nul */
+      bytes_read = read (fd, contents + length, alloc - length - 1);
       errsv = errno;
 
       if (bytes_read == 0)  /* End of File */
@@ -865,30 +899,16 @@ g_key_file_load_from_fd (GKeyFile       *key_file,
           g_set_error_literal (error, G_FILE_ERROR,
                                g_file_error_from_errno (errsv),
                                g_strerror (errsv));
+          g_free (contents);
           return FALSE;
         }
 
-      g_key_file_parse_data (key_file,
-			     read_buf, bytes_read,
-			     &key_file_error);
+      length += bytes_read;
     }
-  while (!key_file_error);
 
-  if (key_file_error)
-    {
-      g_propagate_error (error, key_file_error);
-      return FALSE;
-    }
-
-  g_key_file_flush_parse_buffer (key_file, &key_file_error);
-
-  if (key_file_error)
-    {
-      g_propagate_error (error, key_file_error);
-      return FALSE;
-    }
+  contents[length] = '\0';
 
-  return TRUE;
+  return g_key_file_parse_owned_data (key_file, contents, length, error);
 }
 
 /**
@@ -970,8 +990,8 @@ g_key_file_load_from_data (GKeyFile       *key_file,
 			   GKeyFileFlags   flags,
 			   GError        **error)
 {
-  GError *key_file_error = NULL;
   gchar list_separator;
+  gchar *contents;
 
   g_return_val_if_fail (key_file != NULL, FALSE);
   g_return_val_if_fail (data != NULL || length == 0, FALSE);
@@ -985,23 +1005,12 @@ g_key_file_load_from_data (GKeyFile       *key_file,
   key_file->list_separator = list_separator;
   key_file->flags = flags;
 
-  g_key_file_parse_data (key_file, data, length, &key_file_error);
-  
-  if (key_file_error)
-    {
-      g_propagate_error (error, key_file_error);
-      return FALSE;
-    }
-
-  g_key_file_flush_parse_buffer (key_file, &key_file_error);
-  
-  if (key_file_error)
-    {
-      g_propagate_error (error, key_file_error);
-      return FALSE;
-    }
+  contents = g_malloc (length + 1);
+  if (length > 0)
+    memcpy (contents, data, length);
+  contents[length] = '\0';
 
-  return TRUE;
+  return g_key_file_parse_owned_data (key_file, contents, length, error);
 }
 
 /**
@@ -1282,6 +1291,48 @@ g_key_file_locale_is_interesting (GKeyFile    *key_file,
   return FALSE;
 }
 
+/* Prepends a new pair to @group, taking ownership of @key and @value. In
+ * read-only key files, they point into the loaded data, and the pair and
+ * its list link are taken from the line storage instead of being
+ * allocated. */
+static void
+g_key_file_prepend_pair (GKeyFile      *key_file,
+                         GKeyFileGroup *group,
+                         gchar         *key,
+                         gchar         *value)
+{
+  GKeyFileKeyValuePair *pair;
+
+  if (key_file->read_only_lines != NULL)
+    {
+      GKeyFileLine *line;
+
+      g_assert (key_file->n_read_only_lines_used < key_file->n_read_only_lines);
+      line = &key_file->read_only_lines[key_file->n_read_only_lines_used++];
+      pair = &line->pair;
+      pair->key = key;
+      pair->value = value;
+
+      line->link.data = pair;
+      line->link.prev = NULL;
+      line->link.next = group->key_value_pairs;
+      if (group->key_value_pairs != NULL)
+        group->key_value_pairs->prev = &line->link;
+      group->key_value_pairs = &line->link;
+    }
+  else
+    {
+      pair = g_new (GKeyFileKeyValuePair, 1);
+      pair->key = key;
+      pair->value = value;
+
+      group->key_value_pairs = g_list_prepend (group->key_value_pairs, pair);
+    }
+
+  if (key != NULL)
+    g_hash_table_replace (group->lookup_map, pair->key, pair);
+}
+
 static void
 g_key_file_parse_line (GKeyFile     *key_file,
 		       const gchar  *line,
@@ -1331,19 +1382,20 @@ g_key_file_parse_comment (GKeyFile     *key_file,
 			  gsize         length,
 			  GError      **error)
 {
-  GKeyFileKeyValuePair *pair;
-  
+  gchar *value;
+
   if (!(key_file->flags & G_KEY_FILE_KEEP_COMMENTS))
     return;
   
   g_warn_if_fail (key_file->current_group != NULL);
 
-  pair = g_new (GKeyFileKeyValuePair, 1);
-  pair->key = NULL;
-  pair->value = g_strndup (line, length);
-  
-  key_file->current_group->key_value_pairs =
-    g_list_prepend (key_file->current_group->key_value_pairs, pair);
+  /* In read-only key files, @line is nul-terminated in the loaded data */
+  if (key_file->read_only_data != NULL)
+    value = (gchar *) line;
+  else
+    value = g_strndup (line, length);
+
+  g_key_file_prepend_pair (key_file, key_file->current_group, NULL, value);
 }
 
 static void
@@ -1386,6 +1438,7 @@ g_key_file_parse_key_value_pair (GKeyFile     *key_file,
 				 GError      **error)
 {
   gchar *key, *key_end, *value_start;
+  gchar *owned_key = NULL;
   const gchar *locale;
   gsize locale_len;
   gsize key_len, value_len;
@@ -1422,7 +1475,16 @@ g_key_file_parse_key_value_pair (GKeyFile     *key_file,
       return; 
     }
 
-  key = g_strndup (line, key_len - 1);
+  /* In read-only key files, the key and value are kept in the loaded data.
+   * The value is already nul-terminated, and the key can be terminated in
+   * place, as the character after it is either whitespace or the '='. */
+  if (key_file->read_only_data != NULL)
+    {
+      key = (gchar *) line;
+      key[key_len - 1] = '\0';
+    }
+  else
+    key = owned_key = g_strndup (line, key_len - 1);
 
   /* Pull the value from the line (chugging leading whitespace)
    */
@@ -1450,7 +1512,7 @@ g_key_file_parse_key_value_pair (GKeyFile     *key_file,
 			 "encoding “%s”"), value_utf8);
 	  g_free (value_utf8);
 
-          g_free (key);
+          g_free (owned_key);
           return;
         }
     }
@@ -1461,17 +1523,16 @@ g_key_file_parse_key_value_pair (GKeyFile     *key_file,
 
   if (locale == NULL || g_key_file_locale_is_interesting (key_file, locale, locale_len))
     {
-      GKeyFileKeyValuePair *pair;
-
-      pair = g_new (GKeyFileKeyValuePair, 1);
-      pair->key = g_steal_pointer (&key);
-      pair->value = g_strndup (value_start, value_len);
-
-      g_key_file_add_key_value_pair (key_file, key_file->current_group, pair,
-                                     key_file->current_group->key_value_pairs);
+      if (key_file->read_only_data != NULL)
+        g_key_file_prepend_pair (key_file, key_file->current_group,
+                                 key, value_start);
+      else
+        g_key_file_prepend_pair (key_file, key_file->current_group,
+                                 g_steal_pointer (&owned_key),
+                                 g_strndup (value_start, value_len));
     }
 
-  g_free (key);
+  g_free (owned_key);
 }
 
 static const gchar *
@@ -1502,97 +1563,96 @@ key_get_locale (const gchar *key,
   return locale;
 }
 
+/* Splits @data into lines in place and parses them, in a single pass which
+ * needs no copying or allocation per line. @data must be nul-terminated at
+ * @length. */
 static void
-g_key_file_parse_data (GKeyFile     *key_file,
-		       const gchar  *data,
-		       gsize         length,
-		       GError      **error)
+g_key_file_parse_data_in_place (GKeyFile     *key_file,
+                                gchar        *data,
+                                gsize         length,
+                                GError      **error)
 {
-  GError *parse_error;
-  gsize i;
-
-  g_return_if_fail (key_file != NULL);
-  g_return_if_fail (data != NULL || length == 0);
+  gchar *line = data;
+  gchar *end = data + length;
 
-  parse_error = NULL;
+  while (line < end)
+    {
+      GError *parse_error = NULL;
+      gchar *end_of_line;
+      gsize line_length;
 
-  if (!key_file->parse_buffer)
-    key_file->parse_buffer = g_string_sized_new (128);
+      end_of_line = memchr (line, '\n', end - line);
 
-  i = 0;
-  while (i < length)
-    {
-      if (data[i] == '\n')
+      if (end_of_line != NULL)
         {
-	  if (key_file->parse_buffer->len > 0
-	      && (key_file->parse_buffer->str[key_file->parse_buffer->len - 1]
-		  == '\r'))
-	    g_string_erase (key_file->parse_buffer,
-			    key_file->parse_buffer->len - 1,
-			    1);
-	    
-          /* When a newline is encountered flush the parse buffer so that the
-           * line can be parsed.  Note that completely blank lines won't show
-           * up in the parse buffer, so they get parsed directly.
-           */
-          if (key_file->parse_buffer->len > 0)
-            g_key_file_flush_parse_buffer (key_file, &parse_error);
+          *end_of_line = '\0';
+          line_length = end_of_line - line;
+
+          if (line_length > 0 && line[line_length - 1] == '\r')
+            line[--line_length] = '\0';
+
+          /* Completely blank lines are kept as comments */
+          if (line_length > 0)
+            g_key_file_parse_line (key_file, line, line_length, &parse_error);
           else
-            g_key_file_parse_comment (key_file, "", 1, &parse_error);
+            g_key_file_parse_comment (key_file, line, 0, &parse_error);
 
-          if (parse_error)
-            {
-              g_propagate_error (error, parse_error);
-              return;
-            }
-          i++;
+          line = end_of_line + 1;
         }
       else
         {
-          const gchar *start_of_line;
-          const gchar *end_of_line;
-          gsize line_length;
-
-          start_of_line = data + i;
-          end_of_line = memchr (start_of_line, '\n', length - i);
-
-          if (end_of_line == NULL)
-            end_of_line = data + length;
-
-          line_length = end_of_line - start_of_line;
+          /* The last line is not terminated by a newline */
+          g_key_file_parse_line (key_file, line, end - line, &parse_error);
+          line = end;
+        }
 
-          g_string_append_len (key_file->parse_buffer, start_of_line, line_length);
-          i += line_length;
+      if (parse_error)
+        {
+          g_propagate_error (error, parse_error);
+          return;
         }
     }
 }
 
-static void
-g_key_file_flush_parse_buffer (GKeyFile  *key_file,
-			       GError   **error)
+/* Parses @data, which must be nul-terminated at @length, taking ownership
+ * of it. */
+static gboolean
+g_key_file_parse_owned_data (GKeyFile     *key_file,
+                             gchar        *data,
+                             gsize         length,
+                             GError      **error)
 {
-  GError *file_error = NULL;
-
-  g_return_if_fail (key_file != NULL);
-
-  if (!key_file->parse_buffer)
-    return;
-
-  file_error = NULL;
+  GError *parse_error = NULL;
 
-  if (key_file->parse_buffer->len > 0)
+  if (key_file->flags & G_KEY_FILE_READ_ONLY)
     {
-      g_key_file_parse_line (key_file, key_file->parse_buffer->str,
-			     key_file->parse_buffer->len,
-			     &file_error);
-      g_string_erase (key_file->parse_buffer, 0, -1);
+      const gchar *p = data;
+      gsize n_lines = 1;
 
-      if (file_error)
+      while ((p = memchr (p, '\n', data + length - p)) != NULL)
         {
-          g_propagate_error (error, file_error);
-          return;
+          n_lines++;
+          p++;
         }
+
+      key_file->read_only_data = data;
+      key_file->read_only_lines = g_new (GKeyFileLine, n_lines);
+      key_file->n_read_only_lines = n_lines;
+      key_file->n_read_only_lines_used = 0;
+    }
+
+  g_key_file_parse_data_in_place (key_file, data, length, &parse_error);
+
+  if (!(key_file->flags & G_KEY_FILE_READ_ONLY))
+    g_free (data);
+
+  if (parse_error)
+    {
+      g_propagate_error (error, parse_error);
+      return FALSE;
     }
+
+  return TRUE;
 }
 
 /**
@@ -1908,6 +1968,7 @@ g_key_file_set_value (GKeyFile    *key_file,
   GKeyFileKeyValuePair *pair;
 
   g_return_if_fail (key_file != NULL);
+  g_return_if_fail (!(key_file->flags & G_KEY_FILE_READ_ONLY));
   g_return_if_fail (group_name != NULL && g_key_file_is_group_name (group_name));
   g_return_if_fail (key != NULL && g_key_file_is_key_name (key, strlen (key)));
   g_return_if_fail (value != NULL);
@@ -3516,6 +3577,7 @@ g_key_file_set_comment (GKeyFile     *key_file,
                         GError      **error)
 {
   g_return_val_if_fail (key_file != NULL, FALSE);
+  g_return_val_if_fail (!(key_file->flags & G_KEY_FILE_READ_ONLY), FALSE);
 
   if (group_name != NULL && key != NULL) 
     {
@@ -3776,6 +3838,7 @@ g_key_file_remove_comment (GKeyFile     *key_file,
                            GError      **error)
 {
   g_return_val_if_fail (key_file != NULL, FALSE);
+  g_return_val_if_fail (!(key_file->flags & G_KEY_FILE_READ_ONLY), FALSE);
 
   if (group_name != NULL && key != NULL)
     return g_key_file_set_key_comment (key_file, group_name, key, NULL, error);
@@ -3922,10 +3985,9 @@ g_key_file_add_group (GKeyFile    *key_file,
       if (next_group->key_value_pairs == NULL ||
           (pair->key != NULL && !g_strstr_len (pair->value, -1, "\n")))
         {
-          GKeyFileKeyValuePair *pair = g_new (GKeyFileKeyValuePair, 1);
-          pair->key = NULL;
-          pair->value = g_strdup ("");
-          next_group->key_value_pairs = g_list_prepend (next_group->key_value_pairs, pair);
+          gchar *value = (key_file->read_only_data != NULL) ? (gchar *) "" : g_strdup ("");
+
+          g_key_file_prepend_pair (key_file, next_group, NULL, value);
         }
     }
 
@@ -4070,6 +4132,7 @@ g_key_file_remove_group (GKeyFile     *key_file,
   GList *group_node;
 
   g_return_val_if_fail (key_file != NULL, FALSE);
+  g_return_val_if_fail (!(key_file->flags & G_KEY_FILE_READ_ONLY), FALSE);
   g_return_val_if_fail (group_name != NULL, FALSE);
 
   group_node = g_key_file_lookup_group_node (key_file, group_name);
@@ -4142,6 +4205,7 @@ g_key_file_remove_key (GKeyFile     *key_file,
   GKeyFileKeyValuePair *pair;
 
   g_return_val_if_fail (key_file != NULL, FALSE);
+  g_return_val_if_fail (!(key_file->flags & G_KEY_FILE_READ_ONLY), FALSE);
   g_return_val_if_fail (group_name != NULL, FALSE);
   g_return_val_if_fail (key != NULL, FALSE);
 
@@ -53,7 +53,8 @@ typedef enum
 {
   G_KEY_FILE_NONE              = 0,
   G_KEY_FILE_KEEP_COMMENTS     = 1 << 0,
-  G_KEY_FILE_KEEP_TRANSLATIONS = 1 << 1
+  G_KEY_FILE_KEEP_TRANSLATIONS = 1 << 1,
+  G_KEY_FILE_READ_ONLY GLIB_AVAILABLE_ENUMERATOR_IN_2_86 = 1 << 2
 } GKeyFileFlags;
 
 GLIB_AVAILABLE_IN_ALL
@@ -40,6 +40,7 @@
 #include <glib/gbytes.h>
 #include <glib/gcharset.h>
 #include <glib/gchecksum.h>
+#include <glib/gconcurrenthash.h>
 #include <glib/gconvert.h>
 #include <glib/gdataset.h>
 #include <glib/gdate.h>
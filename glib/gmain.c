@@ -64,6 +64,9 @@
 #ifdef HAVE_EVENTFD
 #include <sys/eventfd.h>
 #endif
+#ifdef HAVE_EPOLL_CREATE1
+#include <sys/epoll.h>
+#endif
 #endif
 
 #include <signal.h>
@@ -143,7 +146,12 @@ typedef struct _GTimeoutSource GTimeoutSource;
 typedef struct _GChildWatchSource GChildWatchSource;
 typedef struct _GUnixSignalWatchSource GUnixSignalWatchSource;
 typedef struct _GPollRec GPollRec;
+typedef struct _GEpollRec GEpollRec;
 typedef struct _GSourceCallback GSourceCallback;
+typedef struct _GInvokeItem GInvokeItem;
+typedef struct _GInvokeQueue GInvokeQueue;
+typedef struct _GInvokeSource GInvokeSource;
+typedef struct _GSourceStats GSourceStats;
 
 typedef enum
 {
@@ -158,6 +166,7 @@ struct _GSourceList
 {
   GList link;
   GSource *head, *tail;
+  GSource *timers;  /* timer sources which are not ready, in no order */
   gint priority;
 };
 
@@ -204,6 +213,21 @@ struct _GMainContext
   GQueue source_lists;
   gint in_check_or_prepare;
 
+  /* Timer sources waiting for their ready time, as a binary min-heap
+   * ordered by ready time. See source_is_timer(). */
+  GPtrArray *timers;
+  GPtrArray *expired_timers;  /* scratch space for expiring timers */
+  guint64 next_timer_seq;
+  guint64 next_source_seq;
+
+  /* Functions queued from other threads by g_main_context_invoke_full()
+   * when G_MAIN_CONTEXT_FLAGS_QUEUE_INVOCATIONS is set,
+   * one queue per priority. Queues are only ever added. */
+  GInvokeQueue *invoke_queues;  /* (atomic) */
+
+  gboolean source_stats_enabled;
+  GHashTable *source_stats;  /* (nullable) source name → GSourceStats */
+
   GPollRec *poll_records;
   guint n_poll_records;
   GPollFD *cached_poll_array;
@@ -218,6 +242,18 @@ struct _GMainContext
 
   GPollFunc poll_func;
 
+#ifdef HAVE_EPOLL_CREATE1
+  /* Only used with G_MAIN_CONTEXT_FLAGS_EPOLL, otherwise epoll_fd is -1 */
+  gint epoll_fd;
+  GHashTable *epoll_records;        /* gint fd -> GEpollRec */
+  GPtrArray *epoll_unpollable;      /* GEpollRec refused by the kernel */
+  GPtrArray *epoll_untracked;       /* GEpollRec with n_untracked > 0 */
+  GArray *epoll_fallback_fds;       /* GPollFD scratch space for poll_fallback */
+  GArray *epoll_ready_fds;          /* gint fds given revents by the last wait */
+  struct epoll_event *epoll_events;
+  guint epoll_events_size;
+#endif
+
   gint64   time;
   gboolean time_is_fresh;
 };
@@ -243,6 +279,50 @@ struct _GIdleSource
   gboolean one_shot;
 };
 
+/* Bucket i counts dispatches which happened from 2^i to 2^(i + 1) µs
+ * after their source was found ready, bucket 0 counting from 0 µs and the
+ * last bucket having no upper bound. */
+#define N_LATENCY_BUCKETS 20
+
+struct _GSourceStats
+{
+  guint64 dispatch_count;
+  guint64 dispatch_time;      /* µs */
+  guint64 max_dispatch_time;  /* µs */
+  guint64 latency_histogram[N_LATENCY_BUCKETS];
+};
+
+struct _GInvokeItem
+{
+  GInvokeItem *next;
+  GSourceFunc function;
+  gpointer data;
+  GDestroyNotify notify;
+};
+
+/* A multi-producer, single-consumer queue: any thread pushes onto
+ * @incoming without locking, and the thread dispatching @source takes all
+ * of it at once. @source can recurse, so a function which iterates the
+ * context again lets the nested dispatch carry on with @pending.
+ */
+struct _GInvokeQueue
+{
+  GInvokeQueue *next;
+  GMainContext *context;
+  gint priority;
+  GInvokeItem *incoming;  /* (atomic) newest first */
+  GInvokeItem *pending;   /* (owned by the dispatching thread) oldest first */
+  GInvokeItem *again;     /* (owned by the dispatching thread) oldest first */
+  GInvokeItem **again_tail;
+  GSource *source;
+};
+
+struct _GInvokeSource
+{
+  GSource source;
+  GInvokeQueue *queue;
+};
+
 struct _GTimeoutSource
 {
   GSource     source;
@@ -277,6 +357,23 @@ struct _GPollRec
   GPollRec *prev;
   GPollRec *next;
   gint priority;
+  gboolean tracked;
+};
+
+/* Kernel-side registration of all the GPollRecs sharing a file descriptor.
+ * As poll_records is sorted by fd, those form a run of @n_recs consecutive
+ * records starting at @first.
+ */
+struct _GEpollRec
+{
+  gint fd;
+  GPollRec *first;
+  guint n_recs;
+  guint n_untracked;            /* records whose events may change in place */
+  gboolean registered;
+  guint32 registered_events;    /* events registered, or polled if poll_fallback */
+  gushort unpollable_revents;   /* non-zero if the kernel refused the fd */
+  gboolean poll_fallback;       /* the kernel couldn’t take it right now */
 };
 
 struct _GSourcePrivate
@@ -294,12 +391,25 @@ struct _GSourcePrivate
   GSourceDisposeFunc dispose;
 
   gboolean static_name;
+
+  /* Only used while the source is attached */
+  gboolean is_timer;
+  gboolean in_timer_list;
+  guint timer_index;    /* in context->timers, or G_MAXUINT if not there */
+  guint64 timer_seq;    /* orders timers with the same ready time */
+  guint64 source_seq;   /* position in the source list of its priority */
+
+  /* Only used while the context's source statistics are enabled */
+  gint64 ready_since;   /* when the source was found ready, or 0 */
+  GSourceStats *stats;  /* (nullable) entry for the current name */
 };
 
 typedef struct _GSourceIter
 {
   GMainContext *context;
   gboolean may_modify;
+  gboolean include_timers;
+  gboolean in_timers;
   GList *current_list;
   GSource *source;
 } GSourceIter;
@@ -348,13 +458,24 @@ static void g_main_context_poll_unlocked        (GMainContext *context,
                                                  int           n_fds);
 static void g_main_context_add_poll_unlocked    (GMainContext *context,
 						 gint          priority,
-						 GPollFD      *fd);
+						 GPollFD      *fd,
+						 gboolean      tracked);
 static void g_main_context_remove_poll_unlocked (GMainContext *context,
 						 GPollFD      *fd);
+#ifdef HAVE_EPOLL_CREATE1
+static void g_main_context_epoll_unlocked       (GMainContext *context,
+                                                 gint64        timeout_usec,
+                                                 int           priority);
+static void g_main_context_epoll_update_unlocked (GMainContext *context,
+                                                  GEpollRec    *epoll_rec);
+#endif
+
+static void     g_invoke_queue_free (GInvokeQueue  *queue);
 
 static void     g_source_iter_init  (GSourceIter   *iter,
 				     GMainContext  *context,
-				     gboolean       may_modify);
+				     gboolean       may_modify,
+				     gboolean       include_timers);
 static gboolean g_source_iter_next  (GSourceIter   *iter,
 				     GSource      **source);
 static void     g_source_iter_clear (GSourceIter   *iter);
@@ -362,6 +483,12 @@ static void     g_source_iter_clear (GSourceIter   *iter);
 static gboolean g_timeout_dispatch (GSource     *source,
 				    GSourceFunc  callback,
 				    gpointer     user_data);
+static gboolean g_invoke_prepare   (GSource     *source,
+				    gint        *timeout);
+static gboolean g_invoke_check     (GSource     *source);
+static gboolean g_invoke_dispatch  (GSource     *source,
+				    GSourceFunc  callback,
+				    gpointer     user_data);
 static gboolean g_child_watch_prepare  (GSource     *source,
 				        gint        *timeout);
 static gboolean g_child_watch_check    (GSource     *source);
@@ -473,6 +600,14 @@ GSourceFuncs g_idle_funcs =
   NULL, NULL, NULL
 };
 
+static GSourceFuncs g_invoke_funcs =
+{
+  g_invoke_prepare,
+  g_invoke_check,
+  g_invoke_dispatch,
+  NULL, NULL, NULL
+};
+
 /**
  * g_main_context_ref:
  * @context: (not nullable): a #GMainContext
@@ -566,7 +701,7 @@ retry_decrement:
    * sources and destroying them below does not also free them, and so that
    * none of the sources can access the context from their finalize/dispose
    * functions. */
-  g_source_iter_init (&iter, context, FALSE);
+  g_source_iter_init (&iter, context, FALSE, TRUE);
   while (g_source_iter_next (&iter, &source))
     {
       source->context = NULL;
@@ -609,10 +744,34 @@ retry_decrement:
       g_mutex_clear (&context->mutex);
 
       g_ptr_array_free (context->pending_dispatches, TRUE);
+      g_ptr_array_free (context->timers, TRUE);
+      g_ptr_array_free (context->expired_timers, TRUE);
+      g_clear_pointer (&context->source_stats, g_hash_table_unref);
+
+      while (context->invoke_queues)
+        {
+          GInvokeQueue *queue = context->invoke_queues;
+
+          context->invoke_queues = queue->next;
+          g_invoke_queue_free (queue);
+        }
       g_free (context->cached_poll_array);
 
       poll_rec_list_free (context, context->poll_records);
 
+#ifdef HAVE_EPOLL_CREATE1
+      if (context->epoll_fd >= 0)
+        {
+          close (context->epoll_fd);
+          g_hash_table_unref (context->epoll_records);
+          g_ptr_array_unref (context->epoll_unpollable);
+          g_ptr_array_unref (context->epoll_untracked);
+          g_array_unref (context->epoll_fallback_fds);
+          g_array_unref (context->epoll_ready_fds);
+          g_free (context->epoll_events);
+        }
+#endif
+
       g_wakeup_free (context->wakeup);
       g_cond_clear (&context->cond);
 
@@ -708,12 +867,32 @@ g_main_context_new_with_flags (GMainContextFlags flags)
   context->cached_poll_array_size = 0;
   
   context->pending_dispatches = g_ptr_array_new ();
+  context->timers = g_ptr_array_new ();
+  context->expired_timers = g_ptr_array_new ();
   
   context->time_is_fresh = FALSE;
-  
+
+#ifdef HAVE_EPOLL_CREATE1
+  /* If epoll is not available at runtime, silently fall back to poll() */
+  context->epoll_fd = -1;
+  if (flags & G_MAIN_CONTEXT_FLAGS_EPOLL)
+    context->epoll_fd = epoll_create1 (EPOLL_CLOEXEC);
+
+  if (context->epoll_fd >= 0)
+    {
+      context->epoll_records = g_hash_table_new_full (g_int_hash, g_int_equal, NULL, g_free);
+      context->epoll_unpollable = g_ptr_array_new ();
+      context->epoll_untracked = g_ptr_array_new ();
+      context->epoll_fallback_fds = g_array_new (FALSE, FALSE, sizeof (GPollFD));
+      context->epoll_ready_fds = g_array_new (FALSE, FALSE, sizeof (gint));
+      context->epoll_events_size = 64;
+      context->epoll_events = g_new (struct epoll_event, context->epoll_events_size);
+    }
+#endif
+
   context->wakeup = g_wakeup_new ();
   g_wakeup_get_pollfd (context->wakeup, &context->wake_up_rec);
-  g_main_context_add_poll_unlocked (context, 0, &context->wake_up_rec);
+  g_main_context_add_poll_unlocked (context, 0, &context->wake_up_rec, TRUE);
 
 #ifdef G_MAIN_POLL_DEBUG
   if (_g_main_poll_debug)
@@ -979,6 +1158,7 @@ g_source_new (GSourceFuncs *source_funcs,
   g_atomic_int_set (&source->flags, G_HOOK_FLAG_ACTIVE);
 
   source->priv->ready_time = -1;
+  source->priv->timer_index = G_MAXUINT;
 
   /* NULL/0 initialization for all other fields */
 
@@ -1032,12 +1212,15 @@ g_source_set_dispose_function (GSource            *source,
 static void
 g_source_iter_init (GSourceIter  *iter,
 		    GMainContext *context,
-		    gboolean      may_modify)
+		    gboolean      may_modify,
+		    gboolean      include_timers)
 {
   iter->context = context;
   iter->current_list = NULL;
   iter->source = NULL;
   iter->may_modify = may_modify;
+  iter->include_timers = include_timers;
+  iter->in_timers = FALSE;
 }
 
 /* Holds context's lock */
@@ -1051,19 +1234,31 @@ g_source_iter_next (GSourceIter *iter, GSource **source)
   else
     next_source = NULL;
 
-  if (!next_source)
+  while (!next_source)
     {
+      GSourceList *source_list;
+
+      /* Timers which are not ready follow the other sources of
+       * their priority, if wanted at all */
+      if (iter->include_timers && !iter->in_timers && iter->current_list)
+        {
+          source_list = iter->current_list->data;
+          next_source = source_list->timers;
+          iter->in_timers = TRUE;
+          continue;
+        }
+
       if (iter->current_list)
 	iter->current_list = iter->current_list->next;
       else
 	iter->current_list = iter->context->source_lists.head;
 
-      if (iter->current_list)
-	{
-	  GSourceList *source_list = iter->current_list->data;
+      if (!iter->current_list)
+        break;
 
-	  next_source = source_list->head;
-	}
+      source_list = iter->current_list->data;
+      next_source = source_list->head;
+      iter->in_timers = FALSE;
     }
 
   /* Note: unreffing iter->source could potentially cause its
@@ -1142,6 +1337,166 @@ find_source_list_for_priority (GMainContext *context,
   return source_list;
 }
 
+/* A timer source is one which only becomes ready through its ready time:
+ * it has no prepare() or check(), no file descriptors and no parent or
+ * child sources. Those are kept out of the context's source lists, so
+ * that prepare() and check() never need to look at them, and tracked in
+ * a heap ordered by ready time instead. Once ready, a timer moves to the
+ * source lists like any other source until it has been dispatched.
+ */
+static gboolean
+source_is_timer (GSource *source)
+{
+  return source->source_funcs->prepare == NULL &&
+         source->source_funcs->check == NULL &&
+         source->poll_fds == NULL &&
+         source->priv->fds == NULL &&
+         source->priv->parent_source == NULL &&
+         source->priv->child_sources == NULL;
+}
+
+static inline gboolean
+timer_heap_less (GSource *a,
+                 GSource *b)
+{
+  if (a->priv->ready_time != b->priv->ready_time)
+    return a->priv->ready_time < b->priv->ready_time;
+
+  return a->priv->timer_seq < b->priv->timer_seq;
+}
+
+static inline void
+timer_heap_set (GMainContext *context,
+                guint         index,
+                GSource      *source)
+{
+  context->timers->pdata[index] = source;
+  source->priv->timer_index = index;
+}
+
+static void
+timer_heap_sift_up (GMainContext *context,
+                    guint         index)
+{
+  GSource *source = context->timers->pdata[index];
+
+  while (index > 0)
+    {
+      guint parent = (index - 1) / 2;
+
+      if (!timer_heap_less (source, context->timers->pdata[parent]))
+        break;
+
+      timer_heap_set (context, index, context->timers->pdata[parent]);
+      index = parent;
+    }
+
+  timer_heap_set (context, index, source);
+}
+
+static void
+timer_heap_sift_down (GMainContext *context,
+                      guint         index)
+{
+  GSource *source = context->timers->pdata[index];
+  guint len = context->timers->len;
+
+  while (TRUE)
+    {
+      guint child = 2 * index + 1;
+
+      if (child >= len)
+        break;
+      if (child + 1 < len &&
+          timer_heap_less (context->timers->pdata[child + 1], context->timers->pdata[child]))
+        child++;
+
+      if (!timer_heap_less (context->timers->pdata[child], source))
+        break;
+
+      timer_heap_set (context, index, context->timers->pdata[child]);
+      index = child;
+    }
+
+  timer_heap_set (context, index, source);
+}
+
+static void
+timer_heap_remove (GMainContext *context,
+                   GSource      *source)
+{
+  guint index = source->priv->timer_index;
+  GSource *last;
+
+  last = g_ptr_array_steal_index_fast (context->timers, context->timers->len - 1);
+  source->priv->timer_index = G_MAXUINT;
+
+  if (last == source)
+    return;
+
+  timer_heap_set (context, index, last);
+  if (index > 0 && timer_heap_less (last, context->timers->pdata[(index - 1) / 2]))
+    timer_heap_sift_up (context, index);
+  else
+    timer_heap_sift_down (context, index);
+}
+
+/* Holds context's lock
+ *
+ * Puts @source in the timer heap, moves it within it or takes it out, as
+ * its ready time and state require. Must be called whenever either
+ * changes for a source in a timer list.
+ */
+static void
+source_update_timer (GSource      *source,
+                     GMainContext *context)
+{
+  gboolean in_heap = source->priv->timer_index != G_MAXUINT;
+
+  if (source->priv->in_timer_list &&
+      source->priv->ready_time != -1 &&
+      !SOURCE_DESTROYED (source) &&
+      !SOURCE_BLOCKED (source))
+    {
+      source->priv->timer_seq = context->next_timer_seq++;
+
+      if (!in_heap)
+        {
+          g_ptr_array_add (context->timers, source);
+          timer_heap_sift_up (context, context->timers->len - 1);
+        }
+      else
+        {
+          timer_heap_sift_up (context, source->priv->timer_index);
+          timer_heap_sift_down (context, source->priv->timer_index);
+        }
+    }
+  else if (in_heap)
+    {
+      timer_heap_remove (context, source);
+    }
+}
+
+/* Links @source into @source_list between @prev and @next */
+static void
+source_list_link (GSourceList *source_list,
+                  GSource     *source,
+                  GSource     *prev,
+                  GSource     *next)
+{
+  source->next = next;
+  if (next)
+    next->prev = source;
+  else
+    source_list->tail = source;
+
+  source->prev = prev;
+  if (prev)
+    prev->next = source;
+  else
+    source_list->head = source;
+}
+
 /* Holds context's lock
  */
 static void
@@ -1153,6 +1508,29 @@ source_add_to_context (GSource      *source,
 
   source_list = find_source_list_for_priority (context, source->priority, TRUE);
 
+  /* Sources keep their position among the others of their priority while
+   * they move between the source list and the timers, so they are still
+   * dispatched in the order they were attached. Child sources go right
+   * before their parent. */
+  if (source->priv->parent_source)
+    source->priv->source_seq = source->priv->parent_source->priv->source_seq;
+  else if (source->priv->source_seq == 0)
+    source->priv->source_seq = ++context->next_source_seq;
+
+  if (source->priv->is_timer &&
+      !(g_atomic_int_get (&source->flags) & G_SOURCE_READY))
+    {
+      source->prev = NULL;
+      source->next = source_list->timers;
+      if (source->next)
+        source->next->prev = source;
+      source_list->timers = source;
+
+      source->priv->in_timer_list = TRUE;
+      source_update_timer (source, context);
+      return;
+    }
+
   if (source->priv->parent_source)
     {
       g_assert (source_list->head != NULL);
@@ -1163,21 +1541,14 @@ source_add_to_context (GSource      *source,
     }
   else
     {
+      /* Usually this is the tail, unless a timer comes back */
       prev = source_list->tail;
-      next = NULL;
+      while (prev != NULL && prev->priv->source_seq > source->priv->source_seq)
+        prev = prev->prev;
+      next = prev ? prev->next : source_list->head;
     }
 
-  source->next = next;
-  if (next)
-    next->prev = source;
-  else
-    source_list->tail = source;
-  
-  source->prev = prev;
-  if (prev)
-    prev->next = source;
-  else
-    source_list->head = source;
+  source_list_link (source_list, source, prev, next);
 }
 
 /* Holds context's lock
@@ -1191,26 +1562,165 @@ source_remove_from_context (GSource      *source,
   source_list = find_source_list_for_priority (context, source->priority, FALSE);
   g_return_if_fail (source_list != NULL);
 
-  if (source->prev)
-    source->prev->next = source->next;
-  else
-    source_list->head = source->next;
+  if (source->priv->in_timer_list)
+    {
+      if (source->prev)
+        source->prev->next = source->next;
+      else
+        source_list->timers = source->next;
+
+      if (source->next)
+        source->next->prev = source->prev;
 
-  if (source->next)
-    source->next->prev = source->prev;
+      source->priv->in_timer_list = FALSE;
+      source_update_timer (source, context);
+    }
   else
-    source_list->tail = source->prev;
+    {
+      if (source->prev)
+        source->prev->next = source->next;
+      else
+        source_list->head = source->next;
+
+      if (source->next)
+        source->next->prev = source->prev;
+      else
+        source_list->tail = source->prev;
+    }
 
   source->prev = NULL;
   source->next = NULL;
 
-  if (source_list->head == NULL)
+  if (source_list->head == NULL && source_list->timers == NULL)
     {
       g_queue_unlink (&context->source_lists, &source_list->link);
       g_slice_free (GSourceList, source_list);
     }
 }
 
+/* Holds context's lock */
+static void
+source_mark_ready (GSource      *source,
+                   GMainContext *context)
+{
+  guint old_flags = g_atomic_int_or (&source->flags, G_SOURCE_READY);
+
+  if (old_flags & G_SOURCE_READY)
+    return;
+
+  if (context->source_stats_enabled)
+    {
+      if (!context->time_is_fresh)
+        {
+          context->time = g_get_monotonic_time ();
+          context->time_is_fresh = TRUE;
+        }
+
+      source->priv->ready_since = context->time;
+    }
+  else
+    source->priv->ready_since = 0;
+}
+
+/* Sorts expired timers by priority, and latest attached first within a
+ * priority */
+static gint
+expired_timer_compare (gconstpointer a,
+                       gconstpointer b)
+{
+  const GSource *source_a = a;
+  const GSource *source_b = b;
+
+  if (source_a->priority != source_b->priority)
+    return source_a->priority < source_b->priority ? -1 : 1;
+  if (source_a->priv->source_seq != source_b->priv->source_seq)
+    return source_a->priv->source_seq > source_b->priv->source_seq ? -1 : 1;
+
+  return 0;
+}
+
+/* Holds context's lock
+ *
+ * Moves the timers whose ready time has passed to the source lists and
+ * marks them ready, so that they are picked up by prepare() and check().
+ *
+ * Each goes back to its position among the sources of its priority, which
+ * is found walking back from the tail. The timers are merged in sorted by
+ * that position, so that each list is walked at most once.
+ */
+static void
+g_main_context_expire_timers_unlocked (GMainContext *context)
+{
+  GPtrArray *expired = context->expired_timers;
+  GSourceList *source_list = NULL;
+  GSource *prev = NULL;
+  guint i;
+
+  if (context->timers->len == 0)
+    return;
+
+  if (!context->time_is_fresh)
+    {
+      context->time = g_get_monotonic_time ();
+      context->time_is_fresh = TRUE;
+    }
+
+  while (context->timers->len > 0)
+    {
+      GSource *source = context->timers->pdata[0];
+
+      if (source->priv->ready_time > context->time)
+        break;
+
+      source_mark_ready (source, context);
+      source_remove_from_context (source, context);
+      g_ptr_array_add (expired, source);
+    }
+
+  if (expired->len > 1)
+    g_ptr_array_sort_values (expired, expired_timer_compare);
+
+  for (i = 0; i < expired->len; i++)
+    {
+      GSource *source = expired->pdata[i];
+
+      if (source_list == NULL || source->priority != source_list->priority)
+        {
+          source_list = find_source_list_for_priority (context, source->priority, TRUE);
+          prev = source_list->tail;
+        }
+
+      while (prev != NULL && prev->priv->source_seq > source->priv->source_seq)
+        prev = prev->prev;
+
+      source_list_link (source_list, source, prev, prev ? prev->next : source_list->head);
+    }
+
+  g_ptr_array_set_size (expired, 0);
+}
+
+/* Holds context's lock
+ *
+ * Makes @source a normal source, once it can be woken up by more than its
+ * ready time.
+ */
+static void
+source_unset_timer (GSource      *source,
+                    GMainContext *context)
+{
+  if (!source->priv->is_timer)
+    return;
+
+  if (source->priv->in_timer_list)
+    {
+      source_remove_from_context (source, context);
+      source->priv->is_timer = FALSE;
+      source_add_to_context (source, context);
+    }
+  else
+    source->priv->is_timer = FALSE;
+}
+
 static guint
 g_source_attach_unlocked (GSource      *source,
                           GMainContext *context,
@@ -1232,6 +1742,7 @@ g_source_attach_unlocked (GSource      *source,
 
   g_hash_table_add (context->sources, &source->source_id);
 
+  source->priv->is_timer = source_is_timer (source);
   source_add_to_context (source, context);
 
   if (!SOURCE_BLOCKED (source))
@@ -1239,12 +1750,12 @@ g_source_attach_unlocked (GSource      *source,
       tmp_list = source->poll_fds;
       while (tmp_list)
         {
-          g_main_context_add_poll_unlocked (context, source->priority, tmp_list->data);
+          g_main_context_add_poll_unlocked (context, source->priority, tmp_list->data, FALSE);
           tmp_list = tmp_list->next;
         }
 
       for (tmp_list = source->priv->fds; tmp_list; tmp_list = tmp_list->next)
-        g_main_context_add_poll_unlocked (context, source->priority, tmp_list->data);
+        g_main_context_add_poll_unlocked (context, source->priority, tmp_list->data, TRUE);
     }
 
   tmp_list = source->priv->child_sources;
@@ -1333,6 +1844,9 @@ g_source_destroy_internal (GSource      *source,
 
       g_atomic_int_and (&source->flags, ~G_HOOK_FLAG_ACTIVE);
 
+      if (source->priv->in_timer_list)
+        source_update_timer (source, context);
+
       old_cb_data = source->callback_data;
       old_cb_funcs = source->callback_funcs;
 
@@ -1559,8 +2073,9 @@ g_source_add_poll (GSource *source,
 
   if (context)
     {
+      source_unset_timer (source, context);
       if (!SOURCE_BLOCKED (source))
-	g_main_context_add_poll_unlocked (context, source->priority, fd);
+	g_main_context_add_poll_unlocked (context, source->priority, fd, FALSE);
       UNLOCK_CONTEXT (context);
       g_main_context_unref (context);
     }
@@ -1652,6 +2167,10 @@ g_source_add_child_source (GSource *source,
 
   TRACE (GLIB_SOURCE_ADD_CHILD_SOURCE (source, child_source));
 
+  /* The child is put next to its parent in the source lists */
+  if (context)
+    source_unset_timer (source, context);
+
   source->priv->child_sources = g_slist_prepend (source->priv->child_sources,
 						 g_source_ref (child_source));
   child_source->priv->parent_source = source;
@@ -1914,6 +2433,7 @@ g_source_set_priority_unlocked (GSource      *source,
        * add it back after so it is sorted in the correct place
        */
       source_remove_from_context (source, context);
+      source->priv->source_seq = 0;
     }
 
   source->priority = priority;
@@ -1928,7 +2448,7 @@ g_source_set_priority_unlocked (GSource      *source,
 	  while (tmp_list)
 	    {
 	      g_main_context_remove_poll_unlocked (context, tmp_list->data);
-	      g_main_context_add_poll_unlocked (context, priority, tmp_list->data);
+	      g_main_context_add_poll_unlocked (context, priority, tmp_list->data, FALSE);
 	      
 	      tmp_list = tmp_list->next;
 	    }
@@ -1936,7 +2456,7 @@ g_source_set_priority_unlocked (GSource      *source,
           for (tmp_list = source->priv->fds; tmp_list; tmp_list = tmp_list->next)
             {
               g_main_context_remove_poll_unlocked (context, tmp_list->data);
-              g_main_context_add_poll_unlocked (context, priority, tmp_list->data);
+              g_main_context_add_poll_unlocked (context, priority, tmp_list->data, TRUE);
             }
 	}
     }
@@ -2066,6 +2586,19 @@ g_source_set_ready_time (GSource *source,
 
   if (context)
     {
+      /* A timer which expired, but which was not dispatched yet because
+       * sources of a higher priority were ready, waits for its new ready
+       * time instead */
+      if (source->priv->is_timer && !source->priv->in_timer_list &&
+          (g_atomic_int_get (&source->flags) & G_SOURCE_READY))
+        {
+          g_atomic_int_and (&source->flags, ~G_SOURCE_READY);
+          source_remove_from_context (source, context);
+          source_add_to_context (source, context);
+        }
+      else if (source->priv->in_timer_list)
+        source_update_timer (source, context);
+
       /* Quite likely that we need to change the timeout on the poll */
       if (!SOURCE_BLOCKED (source))
         g_wakeup_signal (context->wakeup);
@@ -2181,6 +2714,9 @@ g_source_set_name_full (GSource    *source,
 
   source->priv->static_name = is_static;
 
+  /* Statistics are kept by name */
+  source->priv->stats = NULL;
+
   if (context)
     {
       UNLOCK_CONTEXT (context);
@@ -2568,7 +3104,7 @@ g_main_context_find_source_by_funcs_user_data (GMainContext *context,
   
   LOCK_CONTEXT (context);
 
-  g_source_iter_init (&iter, context, FALSE);
+  g_source_iter_init (&iter, context, FALSE, TRUE);
   while (g_source_iter_next (&iter, &source))
     {
       if (!SOURCE_DESTROYED (source) &&
@@ -2615,7 +3151,7 @@ g_main_context_find_source_by_user_data (GMainContext *context,
   
   LOCK_CONTEXT (context);
 
-  g_source_iter_init (&iter, context, FALSE);
+  g_source_iter_init (&iter, context, FALSE, TRUE);
   while (g_source_iter_next (&iter, &source))
     {
       if (!SOURCE_DESTROYED (source) &&
@@ -2818,8 +3354,9 @@ g_source_add_unix_fd (GSource      *source,
 
   if (context)
     {
+      source_unset_timer (source, context);
       if (!SOURCE_BLOCKED (source))
-        g_main_context_add_poll_unlocked (context, source->priority, poll_fd);
+        g_main_context_add_poll_unlocked (context, source->priority, poll_fd, TRUE);
       UNLOCK_CONTEXT (context);
       g_main_context_unref (context);
     }
@@ -2866,6 +3403,19 @@ g_source_modify_unix_fd (GSource      *source,
 
   if (context)
     {
+#ifdef HAVE_EPOLL_CREATE1
+      if (context->epoll_fd >= 0)
+        {
+          GEpollRec *epoll_rec;
+
+          LOCK_CONTEXT (context);
+          epoll_rec = g_hash_table_lookup (context->epoll_records, &poll_fd->fd);
+          if (epoll_rec != NULL)
+            g_main_context_epoll_update_unlocked (context, epoll_rec);
+          UNLOCK_CONTEXT (context);
+        }
+#endif
+
       g_main_context_wakeup (context);
       g_main_context_unref (context);
     }
@@ -3405,6 +3955,9 @@ block_source (GSource      *source,
 
   if (context)
     {
+      if (source->priv->in_timer_list)
+        source_update_timer (source, context);
+
       tmp_list = source->poll_fds;
       while (tmp_list)
         {
@@ -3439,15 +3992,18 @@ unblock_source (GSource      *source,
 
   g_atomic_int_and (&source->flags, ~G_SOURCE_BLOCKED);
 
+  if (source->priv->in_timer_list)
+    source_update_timer (source, context);
+
   tmp_list = source->poll_fds;
   while (tmp_list)
     {
-      g_main_context_add_poll_unlocked (context, source->priority, tmp_list->data);
+      g_main_context_add_poll_unlocked (context, source->priority, tmp_list->data, FALSE);
       tmp_list = tmp_list->next;
     }
 
   for (tmp_list = source->priv->fds; tmp_list; tmp_list = tmp_list->next)
-    g_main_context_add_poll_unlocked (context, source->priority, tmp_list->data);
+    g_main_context_add_poll_unlocked (context, source->priority, tmp_list->data, TRUE);
 
   if (source->priv && source->priv->child_sources)
     {
@@ -3460,7 +4016,217 @@ unblock_source (GSource      *source,
     }
 }
 
-/* HOLDS: context's lock */
+/**
+ * g_main_context_set_source_stats_enabled:
+ * @context: (nullable): a #GMainContext (if %NULL, the global-default
+ *   main context will be used)
+ * @enabled: whether to collect statistics
+ *
+ * Enables or disables the collection of dispatch statistics for the
+ * sources of @context.
+ *
+ * While enabled, each dispatch of a source costs two extra reads of the
+ * monotonic clock. Statistics which have already been collected are kept
+ * when disabling their collection; use
+ * [method@GLib.MainContext.reset_source_stats] to clear them.
+ *
+ * See [method@GLib.MainContext.get_source_stats].
+ *
+ * Since: 2.86
+ */
+void
+g_main_context_set_source_stats_enabled (GMainContext *context,
+                                         gboolean      enabled)
+{
+  if (context == NULL)
+    context = g_main_context_default ();
+
+  LOCK_CONTEXT (context);
+  context->source_stats_enabled = !!enabled;
+  UNLOCK_CONTEXT (context);
+}
+
+/**
+ * g_main_context_get_source_stats_enabled:
+ * @context: (nullable): a #GMainContext (if %NULL, the global-default
+ *   main context will be used)
+ *
+ * Gets whether dispatch statistics are collected for the sources of
+ * @context. See [method@GLib.MainContext.set_source_stats_enabled].
+ *
+ * Returns: %TRUE if statistics are being collected
+ *
+ * Since: 2.86
+ */
+gboolean
+g_main_context_get_source_stats_enabled (GMainContext *context)
+{
+  gboolean enabled;
+
+  if (context == NULL)
+    context = g_main_context_default ();
+
+  LOCK_CONTEXT (context);
+  enabled = context->source_stats_enabled;
+  UNLOCK_CONTEXT (context);
+
+  return enabled;
+}
+
+/**
+ * g_main_context_get_source_stats:
+ * @context: (nullable): a #GMainContext (if %NULL, the global-default
+ *   main context will be used)
+ *
+ * Gets the dispatch statistics collected for the sources of @context
+ * while [method@GLib.MainContext.set_source_stats_enabled] was enabled.
+ *
+ * Statistics are grouped by source name, as set with
+ * [method@GLib.Source.set_name]; sources without a name are counted
+ * together under `(unnamed)`. The result is of type `a{sa{sv}}`, mapping
+ * each name to a dictionary with the following entries, all times being
+ * in microseconds:
+ *
+ * - `dispatch-count` (`t`): the number of dispatches
+ * - `dispatch-time` (`t`): the total time spent dispatching
+ * - `max-dispatch-time` (`t`): the longest time spent in one dispatch
+ * - `latency-histogram` (`at`): the number of dispatches by the time
+ *   between their source being found ready and being dispatched. Element
+ *   `i` counts latencies from 2^i to 2^(i + 1) microseconds, except that
+ *   the first element starts from 0 and the last one has no upper bound.
+ *
+ * This may be called from any thread.
+ *
+ * Returns: (transfer full): the statistics
+ *
+ * Since: 2.86
+ */
+GVariant *
+g_main_context_get_source_stats (GMainContext *context)
+{
+  GVariantBuilder builder;
+  GHashTableIter iter;
+  gpointer key, value;
+
+  if (context == NULL)
+    context = g_main_context_default ();
+
+  g_variant_builder_init_static (&builder, G_VARIANT_TYPE ("a{sa{sv}}"));
+
+  LOCK_CONTEXT (context);
+
+  if (context->source_stats != NULL)
+    {
+      g_hash_table_iter_init (&iter, context->source_stats);
+      while (g_hash_table_iter_next (&iter, &key, &value))
+        {
+          const GSourceStats *stats = value;
+
+          if (stats->dispatch_count == 0)
+            continue;
+
+          g_variant_builder_open (&builder, G_VARIANT_TYPE ("{sa{sv}}"));
+          g_variant_builder_add (&builder, "s", key);
+          g_variant_builder_open (&builder, G_VARIANT_TYPE_VARDICT);
+          g_variant_builder_add (&builder, "{sv}", "dispatch-count",
+                                 g_variant_new_uint64 (stats->dispatch_count));
+          g_variant_builder_add (&builder, "{sv}", "dispatch-time",
+                                 g_variant_new_uint64 (stats->dispatch_time));
+          g_variant_builder_add (&builder, "{sv}", "max-dispatch-time",
+                                 g_variant_new_uint64 (stats->max_dispatch_time));
+          g_variant_builder_add (&builder, "{sv}", "latency-histogram",
+                                 g_variant_new_fixed_array (G_VARIANT_TYPE_UINT64,
+                                                            stats->latency_histogram,
+                                                            N_LATENCY_BUCKETS,
+                                                            sizeof (guint64)));
+          g_variant_builder_close (&builder);
+          g_variant_builder_close (&builder);
+        }
+    }
+
+  UNLOCK_CONTEXT (context);
+
+  return g_variant_ref_sink (g_variant_builder_end (&builder));
+}
+
+/**
+ * g_main_context_reset_source_stats:
+ * @context: (nullable): a #GMainContext (if %NULL, the global-default
+ *   main context will be used)
+ *
+ * Clears the dispatch statistics collected for the sources of @context.
+ * See [method@GLib.MainContext.get_source_stats].
+ *
+ * Since: 2.86
+ */
+void
+g_main_context_reset_source_stats (GMainContext *context)
+{
+  GHashTableIter iter;
+  gpointer value;
+
+  if (context == NULL)
+    context = g_main_context_default ();
+
+  LOCK_CONTEXT (context);
+
+  /* Sources keep pointers to their entries, so clear them in place */
+  if (context->source_stats != NULL)
+    {
+      g_hash_table_iter_init (&iter, context->source_stats);
+      while (g_hash_table_iter_next (&iter, NULL, &value))
+        memset (value, 0, sizeof (GSourceStats));
+    }
+
+  UNLOCK_CONTEXT (context);
+}
+
+/* HOLDS: context's lock */
+static void
+source_record_dispatch (GSource      *source,
+                        GMainContext *context,
+                        gint64        start_time)
+{
+  GSourceStats *stats = source->priv->stats;
+  gint64 dispatch_time;
+  gint64 latency;
+  guint bucket;
+
+  if (stats == NULL)
+    {
+      const char *name = (source->name != NULL) ? source->name : "(unnamed)";
+
+      if (context->source_stats == NULL)
+        context->source_stats = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+
+      stats = g_hash_table_lookup (context->source_stats, name);
+      if (stats == NULL)
+        {
+          stats = g_new0 (GSourceStats, 1);
+          g_hash_table_insert (context->source_stats, g_strdup (name), stats);
+        }
+
+      source->priv->stats = stats;
+    }
+
+  dispatch_time = MAX (g_get_monotonic_time () - start_time, 0);
+  stats->dispatch_count++;
+  stats->dispatch_time += dispatch_time;
+  stats->max_dispatch_time = MAX (stats->max_dispatch_time, (guint64) dispatch_time);
+
+  /* Sources found ready before statistics were enabled count as having
+   * no latency */
+  if (source->priv->ready_since != 0)
+    latency = CLAMP (start_time - source->priv->ready_since, 0, G_GINT64_CONSTANT (1) << (N_LATENCY_BUCKETS - 1));
+  else
+    latency = 0;
+  source->priv->ready_since = 0;
+
+  bucket = g_bit_storage ((gulong) latency) - 1;
+  stats->latency_histogram[MIN (bucket, N_LATENCY_BUCKETS - 1)]++;
+}
+
+/* HOLDS: context's lock */
 static void
 g_main_dispatch (GMainContext *context)
 {
@@ -3476,6 +4242,13 @@ g_main_dispatch (GMainContext *context)
 
       g_atomic_int_and (&source->flags, ~G_SOURCE_READY);
 
+      /* Timers wait in the heap again for their next ready time */
+      if (source->priv->is_timer && !source->priv->in_timer_list)
+        {
+          source_remove_from_context (source, context);
+          source_add_to_context (source, context);
+        }
+
       if (!SOURCE_DESTROYED (source))
 	{
 	  gboolean was_in_call;
@@ -3490,6 +4263,7 @@ g_main_dispatch (GMainContext *context)
 				gpointer);
           GSource *prev_source;
           gint64 begin_time_nsec G_GNUC_UNUSED;
+          gint64 dispatch_start_time;
 
 	  dispatch = source->source_funcs->dispatch;
 	  cb_funcs = source->callback_funcs;
@@ -3508,6 +4282,8 @@ g_main_dispatch (GMainContext *context)
 	  if (cb_funcs)
 	    cb_funcs->get (cb_data, source, &callback, &user_data);
 
+          dispatch_start_time = context->source_stats_enabled ? g_get_monotonic_time () : 0;
+
 	  UNLOCK_CONTEXT (context);
 
           /* These operations are safe because 'current' is thread-local
@@ -3542,6 +4318,9 @@ g_main_dispatch (GMainContext *context)
 	  if (!was_in_call)
             g_atomic_int_and (&source->flags, ~G_HOOK_FLAG_IN_CALL);
 
+          if (dispatch_start_time != 0)
+            source_record_dispatch (source, context, dispatch_start_time);
+
           if (SOURCE_BLOCKED (source) && !SOURCE_DESTROYED (source))
 	    unblock_source (source, context);
 	  
@@ -3898,8 +4677,10 @@ g_main_context_prepare_unlocked (GMainContext *context,
   /* Prepare all sources */
 
   context->timeout_usec = -1;
-  
-  g_source_iter_init (&iter, context, TRUE);
+
+  g_main_context_expire_timers_unlocked (context);
+
+  g_source_iter_init (&iter, context, TRUE, FALSE);
   while (g_source_iter_next (&iter, &source))
     {
       gint64 source_timeout_usec = -1;
@@ -3970,7 +4751,7 @@ g_main_context_prepare_unlocked (GMainContext *context,
 
 	      while (ready_source)
 		{
-                  g_atomic_int_or (&ready_source->flags, G_SOURCE_READY);
+                  source_mark_ready (ready_source, context);
 		  ready_source = ready_source->priv->parent_source;
 		}
 	    }
@@ -3993,6 +4774,27 @@ g_main_context_prepare_unlocked (GMainContext *context,
     }
   g_source_iter_clear (&iter);
 
+  /* The timers left in the heap aren't ready yet, so only the first one
+   * matters for the timeout */
+  if (context->timeout_usec != 0 && context->timers->len > 0)
+    {
+      GSource *first_timer = context->timers->pdata[0];
+      gint64 timer_timeout_usec;
+
+      if (!context->time_is_fresh)
+        {
+          context->time = g_get_monotonic_time ();
+          context->time_is_fresh = TRUE;
+        }
+
+      timer_timeout_usec = MAX (0, first_timer->priv->ready_time - context->time);
+
+      if (context->timeout_usec < 0)
+        context->timeout_usec = timer_timeout_usec;
+      else
+        context->timeout_usec = MIN (context->timeout_usec, timer_timeout_usec);
+    }
+
   TRACE (GLIB_MAIN_CONTEXT_AFTER_PREPARE (context, current_priority, n_ready));
   
   if (priority)
@@ -4234,7 +5036,9 @@ g_main_context_check_unlocked (GMainContext *context,
       i++;
     }
 
-  g_source_iter_init (&iter, context, TRUE);
+  g_main_context_expire_timers_unlocked (context);
+
+  g_source_iter_init (&iter, context, TRUE, FALSE);
   while (g_source_iter_next (&iter, &source))
     {
       if (SOURCE_DESTROYED (source) || SOURCE_BLOCKED (source))
@@ -4313,7 +5117,7 @@ g_main_context_check_unlocked (GMainContext *context,
 
 	      while (ready_source)
 		{
-                  g_atomic_int_or (&ready_source->flags, G_SOURCE_READY);
+                  source_mark_ready (ready_source, context);
 		  ready_source = ready_source->priv->parent_source;
 		}
 	    }
@@ -4409,33 +5213,53 @@ g_main_context_iterate_unlocked (GMainContext *context,
 	return FALSE;
     }
   
-  if (!context->cached_poll_array)
-    {
-      context->cached_poll_array_size = context->n_poll_records;
-      context->cached_poll_array = g_new (GPollFD, context->n_poll_records);
-    }
-
-  allocated_nfds = context->cached_poll_array_size;
-  fds = context->cached_poll_array;
-  
   g_main_context_prepare_unlocked (context, &max_priority);
 
-  while ((nfds = g_main_context_query_unlocked (
-              context, max_priority, &timeout_usec, fds,
-              allocated_nfds)) > allocated_nfds)
+#ifdef HAVE_EPOLL_CREATE1
+  /* The file descriptors stay registered with epoll between iterations, so
+   * there is no array of GPollFDs to build (or to scan afterwards). */
+  if (context->epoll_fd >= 0 && context->poll_func == g_poll)
     {
-      g_free (fds);
-      context->cached_poll_array_size = allocated_nfds = nfds;
-      context->cached_poll_array = fds = g_new (GPollFD, nfds);
+      timeout_usec = context->timeout_usec;
+      if (timeout_usec != 0)
+        context->time_is_fresh = FALSE;
+
+      if (!block)
+        timeout_usec = 0;
+
+      g_main_context_epoll_unlocked (context, timeout_usec, max_priority);
+
+      some_ready = g_main_context_check_unlocked (context, max_priority, NULL, 0);
     }
+  else
+#endif
+    {
+      if (!context->cached_poll_array)
+        {
+          context->cached_poll_array_size = context->n_poll_records;
+          context->cached_poll_array = g_new (GPollFD, context->n_poll_records);
+        }
 
-  if (!block)
-    timeout_usec = 0;
+      allocated_nfds = context->cached_poll_array_size;
+      fds = context->cached_poll_array;
 
-  g_main_context_poll_unlocked (context, timeout_usec, max_priority, fds, nfds);
+      while ((nfds = g_main_context_query_unlocked (
+                  context, max_priority, &timeout_usec, fds,
+                  allocated_nfds)) > allocated_nfds)
+        {
+          g_free (fds);
+          context->cached_poll_array_size = allocated_nfds = nfds;
+          context->cached_poll_array = fds = g_new (GPollFD, nfds);
+        }
+
+      if (!block)
+        timeout_usec = 0;
+
+      g_main_context_poll_unlocked (context, timeout_usec, max_priority, fds, nfds);
+
+      some_ready = g_main_context_check_unlocked (context, max_priority, fds, nfds);
+    }
 
-  some_ready = g_main_context_check_unlocked (context, max_priority, fds, nfds);
-  
   if (dispatch)
     g_main_context_dispatch_unlocked (context);
   
@@ -4823,6 +5647,345 @@ g_main_context_poll_unlocked (GMainContext *context,
     } /* if (n_fds || timeout_usec != 0) */
 }
 
+#ifdef HAVE_EPOLL_CREATE1
+static inline guint32
+io_condition_to_epoll_events (gushort condition)
+{
+  guint32 events = 0;
+
+  if (condition & G_IO_IN)
+    events |= EPOLLIN;
+  if (condition & G_IO_PRI)
+    events |= EPOLLPRI;
+  if (condition & G_IO_OUT)
+    events |= EPOLLOUT;
+
+  return events;
+}
+
+static inline gushort
+epoll_events_to_io_condition (guint32 events)
+{
+  gushort condition = 0;
+
+  if (events & EPOLLIN)
+    condition |= G_IO_IN;
+  if (events & EPOLLPRI)
+    condition |= G_IO_PRI;
+  if (events & EPOLLOUT)
+    condition |= G_IO_OUT;
+  if (events & EPOLLERR)
+    condition |= G_IO_ERR;
+  if (events & EPOLLHUP)
+    condition |= G_IO_HUP;
+
+  return condition;
+}
+
+static inline gboolean
+epoll_rec_is_unpollable (GEpollRec *epoll_rec)
+{
+  return epoll_rec->unpollable_revents != 0 || epoll_rec->poll_fallback;
+}
+
+/* HOLDS: context's lock
+ *
+ * Brings the kernel registration of @epoll_rec's fd in line with the events
+ * of its poll records, dropping it if there are none left.
+ */
+static void
+g_main_context_epoll_update_unlocked (GMainContext *context,
+                                      GEpollRec    *epoll_rec)
+{
+  struct epoll_event event = { 0, };
+  GPollRec *pollrec;
+  gushort events = 0;
+  guint i;
+  int ret, errsv;
+
+  if (epoll_rec->n_recs == 0)
+    {
+      if (epoll_rec->registered)
+        epoll_ctl (context->epoll_fd, EPOLL_CTL_DEL, epoll_rec->fd, NULL);
+      if (epoll_rec_is_unpollable (epoll_rec))
+        g_ptr_array_remove_fast (context->epoll_unpollable, epoll_rec);
+      g_hash_table_remove (context->epoll_records, &epoll_rec->fd);
+      return;
+    }
+
+  for (pollrec = epoll_rec->first, i = 0; i < epoll_rec->n_recs; pollrec = pollrec->next, i++)
+    events |= pollrec->fd->events;
+
+  /* Like poll(), ignore negative fds and those the kernel refuses */
+  if (epoll_rec->fd < 0 || epoll_rec->unpollable_revents)
+    return;
+
+  event.events = io_condition_to_epoll_events (events);
+  event.data.fd = epoll_rec->fd;
+
+  /* An fd which is being polled is only offered to epoll again once its
+   * events change, rather than on every iteration. */
+  if ((epoll_rec->registered || epoll_rec->poll_fallback) &&
+      event.events == epoll_rec->registered_events)
+    return;
+
+  /* The fd may have been closed (and possibly reused) behind our back, in
+   * which case the kernel has already forgotten the old registration. */
+  if (epoll_rec->registered)
+    {
+      ret = epoll_ctl (context->epoll_fd, EPOLL_CTL_MOD, epoll_rec->fd, &event);
+      if (ret < 0 && errno == ENOENT)
+        ret = epoll_ctl (context->epoll_fd, EPOLL_CTL_ADD, epoll_rec->fd, &event);
+    }
+  else
+    {
+      ret = epoll_ctl (context->epoll_fd, EPOLL_CTL_ADD, epoll_rec->fd, &event);
+      if (ret < 0 && errno == EEXIST)
+        ret = epoll_ctl (context->epoll_fd, EPOLL_CTL_MOD, epoll_rec->fd, &event);
+    }
+  errsv = errno;
+
+  epoll_rec->registered_events = event.events;
+
+  if (ret == 0)
+    {
+      epoll_rec->registered = TRUE;
+      if (epoll_rec->poll_fallback)
+        {
+          epoll_rec->poll_fallback = FALSE;
+          g_ptr_array_remove_fast (context->epoll_unpollable, epoll_rec);
+        }
+      return;
+    }
+
+  epoll_rec->registered = FALSE;
+
+  /* Regular files and some devices can’t be used with epoll; poll() always
+   * reports them as readable and writable, and invalid fds as G_IO_NVAL, so
+   * emulate that. Anything else (such as running into max_user_watches or
+   * out of memory) says nothing about the fd, so poll() it instead. */
+  if (!epoll_rec->poll_fallback)
+    g_ptr_array_add (context->epoll_unpollable, epoll_rec);
+
+  if (errsv == EPERM)
+    epoll_rec->unpollable_revents = G_IO_IN | G_IO_OUT;
+  else if (errsv == EBADF)
+    epoll_rec->unpollable_revents = G_IO_NVAL;
+
+  epoll_rec->poll_fallback = (epoll_rec->unpollable_revents == 0);
+}
+
+/* HOLDS: context's lock */
+static void
+g_main_context_epoll_add_unlocked (GMainContext *context,
+                                   GPollRec     *pollrec)
+{
+  GEpollRec *epoll_rec;
+
+  epoll_rec = g_hash_table_lookup (context->epoll_records, &pollrec->fd->fd);
+  if (epoll_rec == NULL)
+    {
+      epoll_rec = g_new0 (GEpollRec, 1);
+      epoll_rec->fd = pollrec->fd->fd;
+      g_hash_table_insert (context->epoll_records, &epoll_rec->fd, epoll_rec);
+    }
+
+  if (pollrec->prev == NULL || pollrec->prev->fd->fd != epoll_rec->fd)
+    epoll_rec->first = pollrec;
+  epoll_rec->n_recs++;
+
+  if (!pollrec->tracked && epoll_rec->n_untracked++ == 0)
+    g_ptr_array_add (context->epoll_untracked, epoll_rec);
+
+  g_main_context_epoll_update_unlocked (context, epoll_rec);
+}
+
+/* HOLDS: context's lock
+ *
+ * Must be called before @pollrec is unlinked from poll_records.
+ */
+static void
+g_main_context_epoll_remove_unlocked (GMainContext *context,
+                                      GPollRec     *pollrec)
+{
+  GEpollRec *epoll_rec;
+
+  epoll_rec = g_hash_table_lookup (context->epoll_records, &pollrec->fd->fd);
+  g_return_if_fail (epoll_rec != NULL);
+
+  if (epoll_rec->first == pollrec)
+    epoll_rec->first = pollrec->next;
+  epoll_rec->n_recs--;
+
+  if (!pollrec->tracked && --epoll_rec->n_untracked == 0)
+    g_ptr_array_remove_fast (context->epoll_untracked, epoll_rec);
+
+  g_main_context_epoll_update_unlocked (context, epoll_rec);
+}
+
+/* HOLDS: context's lock */
+static void
+epoll_rec_set_revents (GMainContext *context,
+                       GEpollRec    *epoll_rec,
+                       gushort       revents,
+                       int           priority)
+{
+  GPollRec *pollrec;
+  guint i;
+
+  for (pollrec = epoll_rec->first, i = 0; i < epoll_rec->n_recs; pollrec = pollrec->next, i++)
+    {
+      if (pollrec->priority <= priority)
+        pollrec->fd->revents = revents & (pollrec->fd->events | G_IO_ERR | G_IO_HUP | G_IO_NVAL);
+    }
+
+  g_array_append_val (context->epoll_ready_fds, epoll_rec->fd);
+}
+
+/* HOLDS: context's lock
+ *
+ * The epoll equivalent of g_main_context_query_unlocked() followed by
+ * g_main_context_poll_unlocked() and the revents update at the start of
+ * g_main_context_check_unlocked(). Only the records of ready fds (and of
+ * those which were ready last time) have their revents touched, but the
+ * events of every untracked record are compared with what is registered,
+ * so this is O(ready + untracked fds). Only changed ones cost a syscall.
+ */
+static void
+g_main_context_epoll_unlocked (GMainContext *context,
+                               gint64        timeout_usec,
+                               int           priority)
+{
+  GArray *fallback_fds;
+  guint i;
+  int n_events, errsv;
+
+  /* Forget about the events reported by the previous wait */
+  for (i = 0; i < context->epoll_ready_fds->len; i++)
+    {
+      gint fd = g_array_index (context->epoll_ready_fds, gint, i);
+      GEpollRec *epoll_rec;
+      GPollRec *pollrec;
+      guint j;
+
+      epoll_rec = g_hash_table_lookup (context->epoll_records, &fd);
+      if (epoll_rec == NULL)
+        continue;
+
+      for (pollrec = epoll_rec->first, j = 0; j < epoll_rec->n_recs; pollrec = pollrec->next, j++)
+        pollrec->fd->revents = 0;
+    }
+  g_array_set_size (context->epoll_ready_fds, 0);
+
+  /* The owners of GPollFDs passed to g_source_add_poll() may change their
+   * events at any time without telling us */
+  for (i = 0; i < context->epoll_untracked->len; i++)
+    g_main_context_epoll_update_unlocked (context, g_ptr_array_index (context->epoll_untracked, i));
+
+  context->poll_changed = FALSE;
+
+  /* If some fds have to be polled the old way, poll() them together with
+   * the epoll fd, and then collect the epoll events without waiting */
+  fallback_fds = context->epoll_fallback_fds;
+  g_array_set_size (fallback_fds, 0);
+
+  for (i = 0; i < context->epoll_unpollable->len; i++)
+    {
+      GEpollRec *epoll_rec = g_ptr_array_index (context->epoll_unpollable, i);
+      GPollFD poll_fd = { epoll_rec->fd, 0, 0 };
+
+      if (!epoll_rec->poll_fallback)
+        {
+          timeout_usec = 0;
+          continue;
+        }
+
+      if (fallback_fds->len == 0)
+        {
+          GPollFD epoll_poll_fd = { context->epoll_fd, G_IO_IN, 0 };
+          g_array_append_val (fallback_fds, epoll_poll_fd);
+        }
+
+      poll_fd.events = epoll_events_to_io_condition (epoll_rec->registered_events);
+      g_array_append_val (fallback_fds, poll_fd);
+    }
+
+  UNLOCK_CONTEXT (context);
+  if (fallback_fds->len > 0)
+    {
+      if (g_poll ((GPollFD *) fallback_fds->data, fallback_fds->len,
+                  round_timeout_to_msec (timeout_usec)) < 0 &&
+          errno != EINTR)
+        g_warning ("poll(2) failed due to: %s.", g_strerror (errno));
+      timeout_usec = 0;
+    }
+  n_events = epoll_wait (context->epoll_fd, context->epoll_events,
+                         context->epoll_events_size,
+                         round_timeout_to_msec (timeout_usec));
+  errsv = errno;
+  LOCK_CONTEXT (context);
+
+  if (n_events < 0)
+    {
+      if (errsv != EINTR)
+        g_warning ("epoll_wait(2) failed due to: %s.", g_strerror (errsv));
+      n_events = 0;
+    }
+
+  for (i = 0; i < (guint) n_events; i++)
+    {
+      gint fd = context->epoll_events[i].data.fd;
+      GEpollRec *epoll_rec;
+
+      if (fd == context->wake_up_rec.fd)
+        {
+          TRACE (GLIB_MAIN_CONTEXT_WAKEUP_ACKNOWLEDGE (context));
+          g_wakeup_acknowledge (context->wakeup);
+          continue;
+        }
+
+      /* The fd may have been removed while the lock was dropped */
+      epoll_rec = g_hash_table_lookup (context->epoll_records, &fd);
+      if (epoll_rec == NULL || !epoll_rec->registered)
+        continue;
+
+      epoll_rec_set_revents (context, epoll_rec,
+                             epoll_events_to_io_condition (context->epoll_events[i].events),
+                             priority);
+    }
+
+  for (i = 0; i < context->epoll_unpollable->len; i++)
+    {
+      GEpollRec *epoll_rec = g_ptr_array_index (context->epoll_unpollable, i);
+
+      if (!epoll_rec->poll_fallback)
+        epoll_rec_set_revents (context, epoll_rec, epoll_rec->unpollable_revents, priority);
+    }
+
+  /* The fds may have been removed or registered with epoll meanwhile */
+  for (i = 1; i < fallback_fds->len; i++)
+    {
+      GPollFD *poll_fd = &g_array_index (fallback_fds, GPollFD, i);
+      GEpollRec *epoll_rec;
+
+      if (poll_fd->revents == 0)
+        continue;
+
+      epoll_rec = g_hash_table_lookup (context->epoll_records, &poll_fd->fd);
+      if (epoll_rec != NULL && epoll_rec->poll_fallback)
+        epoll_rec_set_revents (context, epoll_rec, poll_fd->revents, priority);
+    }
+
+  /* Leave room for more events next time if we may have missed some */
+  if ((guint) n_events == context->epoll_events_size)
+    {
+      context->epoll_events_size *= 2;
+      context->epoll_events = g_renew (struct epoll_event, context->epoll_events,
+                                       context->epoll_events_size);
+    }
+}
+#endif /* HAVE_EPOLL_CREATE1 */
+
 /**
  * g_main_context_add_poll:
  * @context: (nullable): a #GMainContext (or %NULL for the global-default
@@ -4849,15 +6012,21 @@ g_main_context_add_poll (GMainContext *context,
   g_return_if_fail (fd);
 
   LOCK_CONTEXT (context);
-  g_main_context_add_poll_unlocked (context, priority, fd);
+  g_main_context_add_poll_unlocked (context, priority, fd, FALSE);
   UNLOCK_CONTEXT (context);
 }
 
-/* HOLDS: main_loop_lock */
+/* HOLDS: main_loop_lock
+ *
+ * @tracked is %TRUE if every change to @fd->events is made through
+ * g_source_modify_unix_fd(), rather than by the owner of a #GPollFD passed
+ * to g_source_add_poll() or g_main_context_add_poll() writing to it.
+ */
 static void 
 g_main_context_add_poll_unlocked (GMainContext *context,
 				  gint          priority,
-				  GPollFD      *fd)
+				  GPollFD      *fd,
+				  gboolean      tracked)
 {
   GPollRec *prevrec, *nextrec;
   GPollRec *newrec = g_slice_new (GPollRec);
@@ -4866,6 +6035,7 @@ g_main_context_add_poll_unlocked (GMainContext *context,
   fd->revents = 0;
   newrec->fd = fd;
   newrec->priority = priority;
+  newrec->tracked = tracked;
 
   /* Poll records are incrementally sorted by file descriptor identifier. */
   prevrec = NULL;
@@ -4891,6 +6061,11 @@ g_main_context_add_poll_unlocked (GMainContext *context,
 
   context->n_poll_records++;
 
+#ifdef HAVE_EPOLL_CREATE1
+  if (context->epoll_fd >= 0)
+    g_main_context_epoll_add_unlocked (context, newrec);
+#endif
+
   context->poll_changed = TRUE;
 
   /* Now wake up the main loop if it is waiting in the poll() */
@@ -4937,6 +6112,11 @@ g_main_context_remove_poll_unlocked (GMainContext *context,
       nextrec = pollrec->next;
       if (pollrec->fd == fd)
 	{
+#ifdef HAVE_EPOLL_CREATE1
+          if (context->epoll_fd >= 0)
+            g_main_context_epoll_remove_unlocked (context, pollrec);
+#endif
+
 	  if (prevrec != NULL)
 	    prevrec->next = nextrec;
 	  else
@@ -6585,6 +7765,202 @@ g_idle_remove_by_data (gpointer data)
   return g_source_remove_by_funcs_user_data (&g_idle_funcs, data);
 }
 
+/* Holds context's lock */
+static void
+g_invoke_queue_attach_source (GInvokeQueue *queue)
+{
+  GSource *source;
+
+  source = g_source_new (&g_invoke_funcs, sizeof (GInvokeSource));
+  g_source_set_static_name (source, "GInvokeSource");
+  source->priority = queue->priority;
+  source->flags |= G_SOURCE_CAN_RECURSE;
+  ((GInvokeSource *) source)->queue = queue;
+
+  queue->source = source;
+  g_source_attach_unlocked (source, queue->context, FALSE);
+  g_source_unref_internal (source, queue->context, TRUE);
+}
+
+static GInvokeQueue *
+g_main_context_get_invoke_queue (GMainContext *context,
+                                 gint          priority)
+{
+  GInvokeQueue *queue;
+
+  for (queue = g_atomic_pointer_get (&context->invoke_queues); queue; queue = queue->next)
+    {
+      if (queue->priority == priority)
+        return queue;
+    }
+
+  LOCK_CONTEXT (context);
+
+  /* Another thread may have added it in the meantime */
+  for (queue = context->invoke_queues; queue; queue = queue->next)
+    {
+      if (queue->priority == priority)
+        break;
+    }
+
+  if (queue == NULL)
+    {
+      queue = g_new0 (GInvokeQueue, 1);
+      queue->context = context;
+      queue->priority = priority;
+      queue->again_tail = &queue->again;
+      g_invoke_queue_attach_source (queue);
+
+      queue->next = context->invoke_queues;
+      g_atomic_pointer_set (&context->invoke_queues, queue);
+    }
+
+  UNLOCK_CONTEXT (context);
+
+  return queue;
+}
+
+static void
+g_invoke_queue_push (GInvokeQueue   *queue,
+                     GSourceFunc     function,
+                     gpointer        data,
+                     GDestroyNotify  notify)
+{
+  GInvokeItem *item;
+  GInvokeItem *head;
+
+  item = g_new (GInvokeItem, 1);
+  item->function = function;
+  item->data = data;
+  item->notify = notify;
+
+  head = g_atomic_pointer_get (&queue->incoming);
+  do
+    item->next = head;
+  while (!g_atomic_pointer_compare_and_exchange_full (&queue->incoming, head, item, &head));
+
+  /* Only the first item since the queue was last emptied needs to wake
+   * the context up; the rest are picked up in the same batch */
+  if (head == NULL)
+    g_wakeup_signal (queue->context->wakeup);
+}
+
+static void
+g_invoke_items_free (GInvokeItem *items)
+{
+  while (items)
+    {
+      GInvokeItem *item = items;
+
+      items = item->next;
+      if (item->notify)
+        item->notify (item->data);
+      g_free (item);
+    }
+}
+
+static void
+g_invoke_queue_free (GInvokeQueue *queue)
+{
+  g_invoke_items_free (queue->again);
+  g_invoke_items_free (queue->pending);
+  g_invoke_items_free (g_atomic_pointer_exchange (&queue->incoming, NULL));
+  g_free (queue);
+}
+
+static gboolean
+g_invoke_check (GSource *source)
+{
+  GInvokeQueue *queue = ((GInvokeSource *) source)->queue;
+
+  return queue->pending != NULL ||
+         queue->again != NULL ||
+         g_atomic_pointer_get (&queue->incoming) != NULL;
+}
+
+static gboolean
+g_invoke_prepare (GSource *source,
+                  gint    *timeout)
+{
+  *timeout = -1;
+
+  return g_invoke_check (source);
+}
+
+static gboolean
+g_invoke_dispatch (GSource     *source,
+                   GSourceFunc  callback,
+                   gpointer     user_data)
+{
+  GInvokeQueue *queue = ((GInvokeSource *) source)->queue;
+  GInvokeItem *incoming, **tail;
+
+  /* Take everything queued so far, after any functions which asked to be
+   * called again and any left over by an outer dispatch, restoring the
+   * order it was queued in. Functions queued from now on, or asking to be
+   * called again, are called in the next iteration. */
+  incoming = g_atomic_pointer_exchange (&queue->incoming, NULL);
+
+  if (queue->again)
+    {
+      *queue->again_tail = queue->pending;
+      queue->pending = queue->again;
+      queue->again = NULL;
+      queue->again_tail = &queue->again;
+    }
+
+  for (tail = &queue->pending; *tail; tail = &(*tail)->next)
+    ;
+
+  while (incoming)
+    {
+      GInvokeItem *item = incoming;
+
+      incoming = item->next;
+      item->next = *tail;
+      *tail = item;
+    }
+
+  /* Items are only taken off @pending as they are called, so that a
+   * nested dispatch from within one of them continues where it is */
+  while (queue->pending && queue->source == source)
+    {
+      GInvokeItem *item = queue->pending;
+      gboolean again;
+
+      queue->pending = item->next;
+      item->next = NULL;
+
+      again = item->function (item->data);
+
+      /* A function which destroyed g_main_current_source() is stopped,
+       * like an idle source would be, and the rest carry on with a new
+       * source */
+      if (SOURCE_DESTROYED (source) && queue->source == source)
+        {
+          LOCK_CONTEXT (queue->context);
+          g_invoke_queue_attach_source (queue);
+          UNLOCK_CONTEXT (queue->context);
+
+          again = FALSE;
+        }
+
+      if (again)
+        {
+          *queue->again_tail = item;
+          queue->again_tail = &item->next;
+        }
+      else
+        {
+          if (item->notify)
+            item->notify (item->data);
+          g_free (item);
+        }
+    }
+
+  return G_SOURCE_CONTINUE;
+}
+
 /**
  * g_main_context_invoke:
  * @context: (nullable): a #GMainContext, or %NULL for the global-default
@@ -6610,6 +7986,10 @@ g_idle_remove_by_data (gpointer data)
  * priority.  If you want a different priority, use
  * [method@GLib.MainContext.invoke_full].
  *
+ * If @context was created with %G_MAIN_CONTEXT_FLAGS_QUEUE_INVOCATIONS,
+ * @function is queued instead of being given a source of its own; see
+ * #GMainContextFlags.
+ *
  * Note that, as with normal idle functions, @function should probably
  * return %FALSE.  If it returns %TRUE, it will be continuously run in a
  * loop (and may prevent this call from returning).
@@ -6684,6 +8064,13 @@ g_main_context_invoke_full (GMainContext   *context,
           if (notify != NULL)
             notify (data);
         }
+      else if (context->flags & G_MAIN_CONTEXT_FLAGS_QUEUE_INVOCATIONS)
+        {
+          GInvokeQueue *queue;
+
+          queue = g_main_context_get_invoke_queue (context, priority);
+          g_invoke_queue_push (queue, function, data, notify);
+        }
       else
         {
           GSource *source;
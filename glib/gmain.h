@@ -27,6 +27,7 @@
 #include <glib/gpoll.h>
 #include <glib/gslist.h>
 #include <glib/gthread.h>
+#include <glib/gvariant.h>
 
 G_BEGIN_DECLS
 
@@ -47,6 +48,28 @@ typedef enum /*< flags >*/
  * free the thread to process other jobs. That's useful if you're using
  * `g_main_context_{prepare,query,check,dispatch}` to integrate GMainContext in
  * other event loops.
+ * @G_MAIN_CONTEXT_FLAGS_EPOLL: Keep the file descriptors of the context
+ * registered with the kernel between iterations (using epoll on Linux),
+ * rather than passing all of them to poll() on every iteration. File
+ * descriptors added with g_source_add_unix_fd() then cost nothing in an
+ * iteration unless they are ready. Every source is still prepared and
+ * checked, and the events of file descriptors added with
+ * g_source_add_poll() are still compared on each iteration, as their
+ * owners may change them at any time. This is only used when the context
+ * uses the default poll function; where it is not supported, the flag is
+ * ignored and poll() is used. Since: 2.86
+ * @G_MAIN_CONTEXT_FLAGS_QUEUE_INVOCATIONS: Functions passed to
+ * [method@GLib.MainContext.invoke_full] which cannot be called directly are
+ * queued rather than each being given an idle source of its own. Functions
+ * queued from any number of threads are called in batches, in the order
+ * they were queued, with one wakeup of the context per batch. They share
+ * one source per priority, which is what [func@GLib.main_current_source]
+ * returns while they run: calling [method@GLib.Source.destroy] on it only
+ * stops the calling function, but [method@GLib.Source.set_priority] and
+ * [method@GLib.Source.set_ready_time] affect every function queued at that
+ * priority, so should not be used. Queued functions cannot be found or
+ * cancelled with [method@GLib.MainContext.find_source_by_user_data] or
+ * [func@GLib.source_remove_by_user_data]. Since: 2.86
  *
  * Flags to pass to [ctor@GLib.MainContext.new_with_flags] which affect the
  * behaviour of a [struct@GLib.MainContext].
@@ -57,7 +80,9 @@ GLIB_AVAILABLE_TYPE_IN_2_72
 typedef enum /*< flags >*/
 {
   G_MAIN_CONTEXT_FLAGS_NONE = 0,
-  G_MAIN_CONTEXT_FLAGS_OWNERLESS_POLLING = 1
+  G_MAIN_CONTEXT_FLAGS_OWNERLESS_POLLING = 1,
+  G_MAIN_CONTEXT_FLAGS_EPOLL GLIB_AVAILABLE_ENUMERATOR_IN_2_86 = 2,
+  G_MAIN_CONTEXT_FLAGS_QUEUE_INVOCATIONS GLIB_AVAILABLE_ENUMERATOR_IN_2_86 = 4
 } GMainContextFlags;
 
 
@@ -564,6 +589,16 @@ GLIB_AVAILABLE_IN_ALL
 void     g_main_context_remove_poll (GMainContext *context,
                                      GPollFD      *fd);
 
+GLIB_AVAILABLE_IN_2_86
+void      g_main_context_set_source_stats_enabled (GMainContext *context,
+                                                   gboolean      enabled);
+GLIB_AVAILABLE_IN_2_86
+gboolean  g_main_context_get_source_stats_enabled (GMainContext *context);
+GLIB_AVAILABLE_IN_2_86
+GVariant *g_main_context_get_source_stats         (GMainContext *context);
+GLIB_AVAILABLE_IN_2_86
+void      g_main_context_reset_source_stats       (GMainContext *context);
+
 GLIB_AVAILABLE_IN_ALL
 gint     g_main_depth               (void);
 GLIB_AVAILABLE_IN_ALL
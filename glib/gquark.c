@@ -36,6 +36,7 @@
 #include <string.h>
 
 #include "gslice.h"
+#include "gconcurrenthash.h"
 #include "ghash.h"
 #include "gquark.h"
 #include "gstrfuncs.h"
@@ -47,21 +48,33 @@
 
 #define QUARK_BLOCK_SIZE         2048
 #define QUARK_STRING_BLOCK_SIZE (4096 - sizeof (gsize))
+#define QUARK_N_SHARDS           16
+
+/* Existing quarks are looked up without taking any lock. New quarks are
+ * created under the lock of the shard their string hashes to, so that two
+ * threads can't create a quark for the same string, while threads creating
+ * unrelated quarks rarely contend. Only handing out the quark number itself
+ * is serialised on quark_global. */
+typedef struct
+{
+  GMutex lock;
+  gchar *block;
+  gsize block_offset;
+} QuarkShard;
 
 static inline GQuark  quark_new (gchar *string);
 
 G_LOCK_DEFINE_STATIC (quark_global);
-static GHashTable    *quark_ht = NULL;
+static GConcurrentHashTable *quark_ht = NULL;
 static gchar        **quarks = NULL;
 static gint           quark_seq_id = 0;
-static gchar         *quark_block = NULL;
-static gint           quark_block_offset = 0;
+static QuarkShard     quark_shards[QUARK_N_SHARDS];
 
 void
 g_quark_init (void)
 {
   g_assert (quark_seq_id == 0);
-  quark_ht = g_hash_table_new (g_str_hash, g_str_equal);
+  quark_ht = g_concurrent_hash_table_new (g_str_hash, g_str_equal);
   quarks = g_new (gchar*, QUARK_BLOCK_SIZE);
   quarks[0] = NULL;
   quark_seq_id = 1;
@@ -137,16 +150,15 @@ g_quark_try_string (const gchar *string)
   if (string == NULL)
     return 0;
 
-  G_LOCK (quark_global);
-  quark = GPOINTER_TO_UINT (g_hash_table_lookup (quark_ht, string));
-  G_UNLOCK (quark_global);
+  quark = GPOINTER_TO_UINT (g_concurrent_hash_table_lookup (quark_ht, string));
 
   return quark;
 }
 
-/* HOLDS: quark_global_lock */
+/* HOLDS: shard->lock */
 static char *
-quark_strdup (const gchar *string)
+quark_strdup (QuarkShard  *shard,
+              const gchar *string)
 {
   gchar *copy;
   gsize len;
@@ -158,50 +170,48 @@ quark_strdup (const gchar *string)
   if (len > QUARK_STRING_BLOCK_SIZE / 2)
     return g_strdup (string);
 
-  if (quark_block == NULL ||
-      QUARK_STRING_BLOCK_SIZE - quark_block_offset < len)
+  if (shard->block == NULL ||
+      QUARK_STRING_BLOCK_SIZE - shard->block_offset < len)
     {
-      quark_block = g_malloc (QUARK_STRING_BLOCK_SIZE);
-      quark_block_offset = 0;
+      shard->block = g_malloc (QUARK_STRING_BLOCK_SIZE);
+      shard->block_offset = 0;
     }
 
-  copy = quark_block + quark_block_offset;
+  copy = shard->block + shard->block_offset;
   memcpy (copy, string, len);
-  quark_block_offset += len;
+  shard->block_offset += len;
 
   return copy;
 }
 
-/* HOLDS: quark_global_lock */
 static inline GQuark
 quark_from_string (const gchar *string,
                    gboolean     duplicate)
 {
+  QuarkShard *shard;
   GQuark quark = 0;
 
-  quark = GPOINTER_TO_UINT (g_hash_table_lookup (quark_ht, string));
+  quark = GPOINTER_TO_UINT (g_concurrent_hash_table_lookup (quark_ht, string));
+  if (quark)
+    return quark;
+
+  shard = &quark_shards[g_str_hash (string) % QUARK_N_SHARDS];
+
+  g_mutex_lock (&shard->lock);
+
+  /* Another thread may have created it while we were waiting */
+  quark = GPOINTER_TO_UINT (g_concurrent_hash_table_lookup (quark_ht, string));
 
   if (!quark)
     {
-      quark = quark_new (duplicate ? quark_strdup (string) : (gchar *)string);
+      gchar *copy = duplicate ? quark_strdup (shard, string) : (gchar *) string;
+
+      quark = quark_new (copy);
+      g_concurrent_hash_table_insert (quark_ht, copy, GUINT_TO_POINTER (quark));
       TRACE(GLIB_QUARK_NEW(string, quark));
     }
 
-  return quark;
-}
-
-static inline GQuark
-quark_from_string_locked (const gchar   *string,
-                          gboolean       duplicate)
-{
-  GQuark quark = 0;
-
-  if (!string)
-    return 0;
-
-  G_LOCK (quark_global);
-  quark = quark_from_string (string, duplicate);
-  G_UNLOCK (quark_global);
+  g_mutex_unlock (&shard->lock);
 
   return quark;
 }
@@ -223,7 +233,10 @@ quark_from_string_locked (const gchar   *string,
 GQuark
 g_quark_from_string (const gchar *string)
 {
-  return quark_from_string_locked (string, TRUE);
+  if (!string)
+    return 0;
+
+  return quark_from_string (string, TRUE);
 }
 
 /**
@@ -252,7 +265,10 @@ g_quark_from_string (const gchar *string)
 GQuark
 g_quark_from_static_string (const gchar *string)
 {
-  return quark_from_string_locked (string, FALSE);
+  if (!string)
+    return 0;
+
+  return quark_from_string (string, FALSE);
 }
 
 /**
@@ -279,13 +295,14 @@ g_quark_to_string (GQuark quark)
   return result;
 }
 
-/* HOLDS: g_quark_global_lock */
 static inline GQuark
 quark_new (gchar *string)
 {
   GQuark quark;
   gchar **quarks_new;
 
+  G_LOCK (quark_global);
+
   if (quark_seq_id % QUARK_BLOCK_SIZE == 0)
     {
       quarks_new = g_new (gchar*, quark_seq_id + QUARK_BLOCK_SIZE);
@@ -302,28 +319,25 @@ quark_new (gchar *string)
 
   quark = quark_seq_id;
   g_atomic_pointer_set (&quarks[quark], string);
-  g_hash_table_insert (quark_ht, string, GUINT_TO_POINTER (quark));
   g_atomic_int_inc (&quark_seq_id);
 
+  G_UNLOCK (quark_global);
+
   return quark;
 }
 
 static inline const gchar *
-quark_intern_string_locked (const gchar   *string,
-                            gboolean       duplicate)
+quark_intern_string (const gchar *string,
+                     gboolean     duplicate)
 {
-  const gchar *result;
   GQuark quark;
 
   if (!string)
     return NULL;
 
-  G_LOCK (quark_global);
   quark = quark_from_string (string, duplicate);
-  result = quarks[quark];
-  G_UNLOCK (quark_global);
 
-  return result;
+  return g_quark_to_string (quark);
 }
 
 /**
@@ -345,7 +359,7 @@ quark_intern_string_locked (const gchar   *string,
 const gchar *
 g_intern_string (const gchar *string)
 {
-  return quark_intern_string_locked (string, TRUE);
+  return quark_intern_string (string, TRUE);
 }
 
 /**
@@ -368,5 +382,5 @@ g_intern_string (const gchar *string)
 const gchar *
 g_intern_static_string (const gchar *string)
 {
-  return quark_intern_string_locked (string, FALSE);
+  return quark_intern_string (string, FALSE);
 }
@@ -31,6 +31,7 @@
 
 #include "gtypes.h"
 #include "gregex.h"
+#include "garray.h"
 #include "glibintl.h"
 #include "glist.h"
 #include "gmessages.h"
@@ -299,6 +300,7 @@ struct _GMatchInfo
   uint32_t n_subpatterns;       /* total number of sub patterns in the regex */
   gint pos;                     /* position in the string where last match left off */
   uint32_t n_offsets;           /* number of offsets */
+  uint32_t n_offsets_allocated; /* number of offsets there is room for */
   gint *offsets;                /* array of offsets paired 0,1 ; 2,3 ; 3,4 etc */
   gint *workspace;              /* workspace for pcre2_dfa_match() */
   PCRE2_SIZE n_workspace;       /* number of workspace elements */
@@ -917,7 +919,7 @@ match_info_new (const GRegex     *regex,
       match_info->workspace = g_new (gint, match_info->n_workspace);
     }
 
-  match_info->n_offsets = 2;
+  match_info->n_offsets = match_info->n_offsets_allocated = 2;
   match_info->offsets = g_new0 (gint, match_info->n_offsets);
   /* Set an invalid position for the previous match. */
   match_info->offsets[0] = -1;
@@ -930,13 +932,90 @@ match_info_new (const GRegex     *regex,
   return match_info;
 }
 
+/* Prepares @match_info, which nothing else may be using, to match @regex
+ * against a new string, keeping the memory it already has. */
+static void
+match_info_reset (GMatchInfo       *match_info,
+                  const GRegex     *regex,
+                  const gchar      *string,
+                  gint              string_len,
+                  gint              start_position,
+                  GRegexMatchFlags  match_options)
+{
+  if (string_len < 0)
+    string_len = strlen (string);
+
+  if (match_info->regex != regex)
+    {
+      g_clear_pointer (&match_info->regex, g_regex_unref);
+      match_info->regex = g_regex_ref ((GRegex *)regex);
+      pcre2_pattern_info (regex->pcre_re, PCRE2_INFO_CAPTURECOUNT,
+                          &match_info->n_subpatterns);
+    }
+
+  match_info->string = string;
+  match_info->string_len = string_len;
+  match_info->matches = PCRE2_ERROR_NOMATCH;
+  match_info->pos = start_position;
+  match_info->match_opts =
+    get_pcre2_match_options (match_options, regex->orig_compile_opts);
+
+  match_info->n_offsets = 2;
+  match_info->offsets[0] = -1;
+  match_info->offsets[1] = -1;
+
+  /* The match data may have been sized for a regex with fewer groups */
+  if (pcre2_get_ovector_count (match_info->match_data) < match_info->n_subpatterns + 1)
+    {
+      pcre2_match_data_free (match_info->match_data);
+      match_info->match_data = pcre2_match_data_create_from_pattern (regex->pcre_re, NULL);
+    }
+}
+
+/* A GMatchInfo kept for each thread, for the matches whose GMatchInfo is
+ * not returned to the caller. It is taken out while in use, in case
+ * matching is re-entered, for instance from a log handler. */
+static GPrivate cached_match_info = G_PRIVATE_INIT ((GDestroyNotify) g_match_info_unref);
+
+static GMatchInfo *
+match_info_take_cached (const GRegex     *regex,
+                        const gchar      *string,
+                        gint              string_len,
+                        gint              start_position,
+                        GRegexMatchFlags  match_options)
+{
+  GMatchInfo *match_info = g_private_get (&cached_match_info);
+
+  if (match_info == NULL)
+    return match_info_new (regex, string, string_len, start_position,
+                           match_options, FALSE);
+
+  g_private_set (&cached_match_info, NULL);
+  match_info_reset (match_info, regex, string, string_len, start_position,
+                    match_options);
+
+  return match_info;
+}
+
+static void
+match_info_return_cached (GMatchInfo *match_info)
+{
+  /* Don't keep the regex alive */
+  g_clear_pointer (&match_info->regex, g_regex_unref);
+  match_info->string = NULL;
+
+  if (g_private_get (&cached_match_info) == NULL)
+    g_private_set (&cached_match_info, match_info);
+  else
+    g_match_info_unref (match_info);
+}
+
 static gboolean
 recalc_match_offsets (GMatchInfo *match_info,
                       GError     **error)
 {
   PCRE2_SIZE *ovector;
   uint32_t ovector_size = 0;
-  uint32_t pre_n_offset;
   uint32_t i;
 
   g_assert (!IS_PCRE2_ERROR (match_info->matches));
@@ -956,15 +1035,17 @@ recalc_match_offsets (GMatchInfo *match_info,
       return FALSE;
     }
 
-  pre_n_offset = match_info->n_offsets;
   match_info->n_offsets = ovector_size * 2;
   ovector = pcre2_get_ovector_pointer (match_info->match_data);
 
-  if (match_info->n_offsets != pre_n_offset)
+  /* Only ever grow the array, so that reusing the match info for other
+   * strings doesn't keep reallocating it */
+  if (match_info->n_offsets > match_info->n_offsets_allocated)
     {
       match_info->offsets = g_realloc_n (match_info->offsets,
                                          match_info->n_offsets,
                                          sizeof (gint));
+      match_info->n_offsets_allocated = match_info->n_offsets;
     }
 
   for (i = 0; i < match_info->n_offsets; i++)
@@ -975,23 +1056,26 @@ recalc_match_offsets (GMatchInfo *match_info,
   return TRUE;
 }
 
+/* Tries to JIT compile @regex for @match_options (pcre2 values), unless it
+ * already has been or JIT is not available. Not thread-safe: the regex is
+ * modified. */
 static JITStatus
-enable_jit_with_match_options (GMatchInfo  *match_info,
-                               uint32_t  match_options)
+regex_enable_jit (GRegex   *regex,
+                  uint32_t  match_options)
 {
   gint retval;
   uint32_t old_jit_options, new_jit_options;
 
-  if (!(match_info->regex->orig_compile_opts & G_REGEX_OPTIMIZE))
+  if (!(regex->orig_compile_opts & G_REGEX_OPTIMIZE))
     return JIT_STATUS_DISABLED;
 
-  if (match_info->regex->jit_status == JIT_STATUS_DISABLED)
+  if (regex->jit_status == JIT_STATUS_DISABLED)
     return JIT_STATUS_DISABLED;
 
   if (match_options & G_REGEX_PCRE2_JIT_UNSUPPORTED_OPTIONS)
     return JIT_STATUS_DISABLED;
 
-  old_jit_options = match_info->regex->jit_options;
+  old_jit_options = regex->jit_options;
   new_jit_options = old_jit_options | PCRE2_JIT_COMPLETE;
   if (match_options & PCRE2_PARTIAL_HARD)
     new_jit_options |= PCRE2_JIT_PARTIAL_HARD;
@@ -1001,23 +1085,19 @@ enable_jit_with_match_options (GMatchInfo  *match_info,
   /* no new options enabled */
   if (new_jit_options == old_jit_options)
     {
-      g_assert (match_info->regex->jit_status != JIT_STATUS_DEFAULT);
-      return match_info->regex->jit_status;
+      g_assert (regex->jit_status != JIT_STATUS_DEFAULT);
+      return regex->jit_status;
     }
 
-  retval = pcre2_jit_compile (match_info->regex->pcre_re, new_jit_options);
+  retval = pcre2_jit_compile (regex->pcre_re, new_jit_options);
   if (retval == 0)
     {
-      match_info->regex->jit_status = JIT_STATUS_ENABLED;
-
-      match_info->regex->jit_options = new_jit_options;
-      /* Set min stack size for JIT to 32KiB and max to 512KiB */
-      match_info->jit_stack = pcre2_jit_stack_create (1 << 15, 1 << 19, NULL);
-      pcre2_jit_stack_assign (match_info->match_context, NULL, match_info->jit_stack);
+      regex->jit_status = JIT_STATUS_ENABLED;
+      regex->jit_options = new_jit_options;
     }
   else
     {
-      match_info->regex->jit_status = JIT_STATUS_DISABLED;
+      regex->jit_status = JIT_STATUS_DISABLED;
 
       switch (retval)
         {
@@ -1040,9 +1120,28 @@ enable_jit_with_match_options (GMatchInfo  *match_info,
         }
     }
 
-  return match_info->regex->jit_status;
+  return regex->jit_status;
+}
+
+static JITStatus
+enable_jit_with_match_options (GMatchInfo  *match_info,
+                               uint32_t  match_options)
+{
+  uint32_t old_jit_options = match_info->regex->jit_options;
+  JITStatus jit_status;
+
+  jit_status = regex_enable_jit (match_info->regex, match_options);
+
+  if (jit_status == JIT_STATUS_ENABLED &&
+      match_info->regex->jit_options != old_jit_options &&
+      match_info->jit_stack == NULL)
+    {
+      /* Set min stack size for JIT to 32KiB and max to 512KiB */
+      match_info->jit_stack = pcre2_jit_stack_create (1 << 15, 1 << 19, NULL);
+      pcre2_jit_stack_assign (match_info->match_context, NULL, match_info->jit_stack);
+    }
 
-  g_assert_not_reached ();
+  return jit_status;
 }
 
 /**
@@ -1115,7 +1214,7 @@ g_match_info_unref (GMatchInfo *match_info)
 {
   if (g_atomic_int_dec_and_test (&match_info->ref_count))
     {
-      g_regex_unref (match_info->regex);
+      g_clear_pointer (&match_info->regex, g_regex_unref);
       if (match_info->match_context)
         pcre2_match_context_free (match_info->match_context);
       if (match_info->jit_stack)
@@ -1237,6 +1336,7 @@ g_match_info_next (GMatchInfo  *match_info,
       match_info->offsets = g_realloc_n (match_info->offsets,
                                          match_info->n_offsets,
                                          sizeof (gint));
+      match_info->n_offsets_allocated = match_info->n_offsets;
 
       pcre2_match_data_free (match_info->match_data);
       match_info->match_data = pcre2_match_data_create (match_info->n_offsets, NULL);
@@ -2500,7 +2600,8 @@ g_regex_match (const GRegex      *regex,
  * stored in @match_info if not %NULL. Note that if @match_info is
  * not %NULL then it is created even if the function returns %FALSE,
  * i.e. you must free it regardless if regular expression actually
- * matched.
+ * matched. When matching many strings, g_regex_match_reuse() avoids
+ * creating a new #GMatchInfo for each of them.
  *
  * @string is not copied and is used in #GMatchInfo internally. If
  * you use any #GMatchInfo method (except g_match_info_free()) after
@@ -2559,17 +2660,93 @@ g_regex_match_full (const GRegex      *regex,
   g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
   g_return_val_if_fail ((match_options & ~G_REGEX_MATCH_MASK) == 0, FALSE);
 
+  if (match_info == NULL)
+    {
+      info = match_info_take_cached (regex, string, string_len, start_position,
+                                     match_options);
+      match_ok = g_match_info_next (info, error);
+      match_info_return_cached (info);
+
+      return match_ok;
+    }
+
   info = match_info_new (regex, string, string_len, start_position,
                          match_options, FALSE);
   match_ok = g_match_info_next (info, error);
-  if (match_info != NULL)
-    *match_info = info;
-  else
-    g_match_info_free (info);
+  *match_info = info;
 
   return match_ok;
 }
 
+/**
+ * g_regex_match_reuse:
+ * @regex: a #GRegex structure from g_regex_new()
+ * @string: (array length=string_len): the string to scan for matches
+ * @string_len: the length of @string, in bytes, or -1 if @string is nul-terminated
+ * @start_position: starting index of the string to match, in bytes
+ * @match_options: match options
+ * @match_info: (inout) (nullable) (not optional): pointer to a #GMatchInfo
+ *   to reuse, or to %NULL to create one
+ * @error: location to store the error occurring, or %NULL to ignore errors
+ *
+ * Scans for a match in @string for the pattern in @regex, as
+ * g_regex_match_full() does, but reusing the #GMatchInfo in @match_info
+ * rather than creating a new one for each match.
+ *
+ * If @match_info points to %NULL, a new #GMatchInfo is created and stored
+ * there, to be freed with g_match_info_free() once it’s not needed anymore.
+ * Otherwise the #GMatchInfo it points to, which may have been used with
+ * any #GRegex, is reset to match @string with @regex. Its memory for the
+ * match results and the JIT stack is kept, so matching many strings in a
+ * loop doesn’t allocate memory once that memory is large enough:
+ *
+ * |[<!-- language="C" -->
+ * GMatchInfo *match_info = NULL;
+ *
+ * for (guint i = 0; lines[i] != NULL; i++)
+ *   {
+ *     if (g_regex_match_reuse (regex, lines[i], -1, 0, 0, &match_info, NULL))
+ *       handle_match (match_info);
+ *   }
+ *
+ * g_match_info_free (match_info);
+ * ]|
+ *
+ * The #GMatchInfo must not be referenced from anywhere else when it is
+ * reused, as the results it holds are replaced.
+ *
+ * Returns: %TRUE is the string matched, %FALSE otherwise
+ *
+ * Since: 2.86
+ */
+gboolean
+g_regex_match_reuse (const GRegex      *regex,
+                     const gchar       *string,
+                     gssize             string_len,
+                     gint               start_position,
+                     GRegexMatchFlags   match_options,
+                     GMatchInfo       **match_info,
+                     GError           **error)
+{
+  g_return_val_if_fail (regex != NULL, FALSE);
+  g_return_val_if_fail (string != NULL, FALSE);
+  g_return_val_if_fail (start_position >= 0, FALSE);
+  g_return_val_if_fail (match_info != NULL, FALSE);
+  g_return_val_if_fail (*match_info == NULL ||
+                        g_atomic_int_get (&(*match_info)->ref_count) == 1, FALSE);
+  g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+  g_return_val_if_fail ((match_options & ~G_REGEX_MATCH_MASK) == 0, FALSE);
+
+  if (*match_info == NULL)
+    *match_info = match_info_new (regex, string, string_len, start_position,
+                                  match_options, FALSE);
+  else
+    match_info_reset (*match_info, regex, string, string_len, start_position,
+                      match_options);
+
+  return g_match_info_next (*match_info, error);
+}
+
 /**
  * g_regex_match_all:
  * @regex: a #GRegex structure from g_regex_new()
@@ -2733,6 +2910,7 @@ g_regex_match_all_full (const GRegex      *regex,
           info->offsets = g_realloc_n (info->offsets,
                                        info->n_offsets,
                                        sizeof (gint));
+          info->n_offsets_allocated = info->n_offsets;
           pcre2_match_data_free (info->match_data);
           info->match_data = pcre2_match_data_create (info->n_offsets, NULL);
           done = FALSE;
@@ -3956,3 +4134,918 @@ g_regex_escape_string (const gchar *string,
 
   return g_string_free (escaped, FALSE);
 }
+
+/* GRegexSet */
+
+/**
+ * GRegexSet:
+ *
+ * A `GRegexSet` is a set of regular expressions which are matched together
+ * against the same strings, for instance to classify log lines.
+ *
+ * [func@GLib.RegexSet.match] returns the indexes of all the patterns which
+ * match a string. This is faster than matching each pattern in turn with
+ * [method@GLib.Regex.match]: a pattern is only run if the string contains
+ * the literal text the pattern requires, and all these literals are found
+ * in a single pass over the string.
+ *
+ * ```c
+ * static const gchar * const patterns[] = {
+ *   "^kernel: .*error",
+ *   "Connection (refused|reset)",
+ *   "disk [a-z]+ full",
+ *   NULL
+ * };
+ * GRegexSet *set;
+ * GArray *matches;
+ *
+ * set = g_regex_set_new (patterns, G_REGEX_OPTIMIZE, G_REGEX_MATCH_DEFAULT, NULL);
+ * matches = g_array_new (FALSE, FALSE, sizeof (guint));
+ *
+ * if (g_regex_set_match (set, line, G_REGEX_MATCH_DEFAULT, matches))
+ *   {
+ *     for (guint i = 0; i < matches->len; i++)
+ *       g_print ("matched %s\n", g_regex_set_get_pattern (set, g_array_index (matches, guint, i)));
+ *   }
+ *
+ * g_array_unref (matches);
+ * g_regex_set_unref (set);
+ * ```
+ *
+ * A `GRegexSet` is immutable once created, and may be used from several
+ * threads at once.
+ *
+ * Since: 2.86
+ */
+
+typedef struct
+{
+  guint fail;           /* state for the longest proper suffix of this one */
+  guint output;         /* nearest state on the fail chain ending literals, or 0 */
+  guint first_edge;     /* into set->edges, sorted by byte */
+  guint n_edges;
+  guint first_regex;    /* regexes whose literal ends here, into set->state_regexes */
+  guint n_regexes;
+} RegexSetState;
+
+typedef struct
+{
+  guint8 byte;
+  guint target;
+} RegexSetEdge;
+
+struct _GRegexSet
+{
+  gint ref_count;               /* (atomic) */
+  GRegex **regexes;
+  guint n_regexes;
+  GRegexMatchFlags match_opts;
+  gboolean *has_literal;        /* whether regexes[i] is only run if its literal is found */
+
+  /* Aho-Corasick automaton for the literals; state 0 is the root */
+  gboolean fold_case;           /* literals and strings are ASCII lowercased */
+  guint root[256];              /* transitions from the root */
+  RegexSetState *states;
+  guint n_states;
+  RegexSetEdge *edges;
+  guint *state_regexes;
+};
+
+/* Skips the part of an escape sequence following `\x` for an ASCII
+ * alphanumeric x, so that it isn't mistaken for literal characters. */
+static const gchar *
+skip_escape_arguments (const gchar *p,
+                       gchar        escape)
+{
+  gint i;
+
+  if (*p == '{')
+    {
+      p = strchr (p, '}');
+      return (p != NULL) ? p + 1 : NULL;
+    }
+
+  switch (escape)
+    {
+    case 'x':
+      for (i = 0; i < 2 && g_ascii_isxdigit (*p); i++)
+        p++;
+      break;
+    case 'c':
+    case 'p':
+    case 'P':
+      if (*p == '\0')
+        return NULL;
+      p++;
+      break;
+    case 'g':
+    case 'k':
+      if (*p == '<' || *p == '\'')
+        {
+          p = strchr (p + 1, (*p == '<') ? '>' : '\'');
+          return (p != NULL) ? p + 1 : NULL;
+        }
+      if (*p == '+' || *p == '-')
+        p++;
+      while (g_ascii_isdigit (*p))
+        p++;
+      break;
+    default:
+      if (g_ascii_isdigit (escape))
+        {
+          while (g_ascii_isdigit (*p))
+            p++;
+        }
+      break;
+    }
+
+  return p;
+}
+
+static void
+end_literal_run (GString *run,
+                 GString *best)
+{
+  if (run->len > best->len)
+    g_string_assign (best, run->str);
+  g_string_truncate (run, 0);
+}
+
+/* Finds a run of ASCII characters which any match of @regex must contain,
+ * by looking for literal characters outside of groups, classes and
+ * repetitions. This errs on the side of returning %NULL for patterns using
+ * syntax which would make it harder to be sure the literal is required. */
+static gchar *
+regex_get_required_literal (const GRegex *regex)
+{
+  const gchar *p = regex->pattern;
+  gboolean caseless = (regex->compile_opts & PCRE2_CASELESS) != 0;
+  gboolean utf = (regex->compile_opts & PCRE2_UTF) != 0;
+  GString *run, *best;
+  gint depth = 0;
+
+  if (regex->compile_opts & (PCRE2_EXTENDED | PCRE2_EXTENDED_MORE))
+    return NULL;
+
+  /* Everything between \Q and \E is literal, which is more than this
+   * parser wants to know about */
+  if (strstr (p, "\\Q") != NULL || strstr (p, "\\E") != NULL)
+    return NULL;
+
+  run = g_string_new (NULL);
+  best = g_string_new (NULL);
+
+  while (p != NULL && *p != '\0')
+    {
+      gchar c = *p;
+
+      switch (c)
+        {
+        case '\\':
+          c = p[1];
+          if (c == '\0')
+            {
+              p = NULL;
+              continue;
+            }
+          p += 2;
+          if (!(c & 0x80) && !g_ascii_isalnum (c))
+            break;  /* an escaped literal character */
+          end_literal_run (run, best);
+          p = skip_escape_arguments (p, c);
+          continue;
+
+        case '[':
+          end_literal_run (run, best);
+          p++;
+          if (*p == '^')
+            p++;
+          if (*p == ']')
+            p++;
+          while (p != NULL && *p != ']')
+            {
+              if (*p == '\0')
+                p = NULL;
+              else if (*p == '\\' && p[1] != '\0')
+                p += 2;
+              else if (p[0] == '[' && p[1] == ':')
+                {
+                  p = strstr (p + 2, ":]");
+                  if (p != NULL)
+                    p += 2;
+                }
+              else
+                p++;
+            }
+          if (p != NULL)
+            p++;
+          continue;
+
+        case '(':
+          end_literal_run (run, best);
+          if (p[1] == '*')
+            {
+              /* Verbs such as (*ACCEPT) */
+              p = NULL;
+              continue;
+            }
+          if (p[1] == '?')
+            {
+              if (p[2] == '#')
+                {
+                  p = strchr (p + 3, ')');
+                  if (p != NULL)
+                    p++;
+                  continue;
+                }
+
+              /* Anything but a group, assertion, reference or callout may
+               * be an option setting such as (?i) */
+              if (strchr (":=!>|<P'&R(C+*", p[2]) == NULL &&
+                  !g_ascii_isdigit (p[2]) &&
+                  !(p[2] == '-' && g_ascii_isdigit (p[3])))
+                {
+                  p = NULL;
+                  continue;
+                }
+            }
+          depth++;
+          p++;
+          continue;
+
+        case ')':
+          end_literal_run (run, best);
+          depth--;
+          p++;
+          continue;
+
+        case '|':
+          if (depth == 0)
+            {
+              p = NULL;
+              continue;
+            }
+          p++;
+          continue;
+
+        case '?':
+        case '*':
+          /* The previous character may not be there at all */
+          if (depth == 0 && run->len > 0)
+            g_string_truncate (run, run->len - 1);
+          end_literal_run (run, best);
+          p++;
+          continue;
+
+        case '+':
+          end_literal_run (run, best);
+          p++;
+          continue;
+
+        case '{':
+          if (depth == 0 && run->len > 0)
+            g_string_truncate (run, run->len - 1);
+          end_literal_run (run, best);
+          p++;
+          {
+            const gchar *q = p;
+
+            while (g_ascii_isdigit (*q) || *q == ',' || *q == ' ')
+              q++;
+            if (*q == '}')
+              p = q + 1;
+          }
+          continue;
+
+        case '.':
+        case '^':
+        case '$':
+          end_literal_run (run, best);
+          p++;
+          continue;
+
+        default:
+          p++;
+          break;
+        }
+
+      /* A literal character */
+      if (depth != 0)
+        continue;
+
+      /* In UTF-8 mode, k and s caselessly match non-ASCII characters too */
+      if ((c & 0x80) ||
+          (caseless && utf && strchr ("kKsS", c) != NULL))
+        {
+          end_literal_run (run, best);
+          continue;
+        }
+
+      g_string_append_c (run, caseless ? g_ascii_tolower (c) : c);
+    }
+
+  if (p != NULL)
+    end_literal_run (run, best);
+  else
+    g_string_truncate (best, 0);
+
+  g_string_free (run, TRUE);
+
+  if (best->len == 0)
+    {
+      g_string_free (best, TRUE);
+      return NULL;
+    }
+
+  return g_string_free (best, FALSE);
+}
+
+typedef struct
+{
+  GArray *edges;    /* (element-type RegexSetEdge) sorted by byte */
+  GArray *regexes;  /* (element-type guint) */
+  guint fail;
+  guint output;
+} RegexSetBuildState;
+
+static guint
+build_state_next (GArray *states,
+                  guint   state,
+                  guint8  byte)
+{
+  GArray *edges = g_array_index (states, RegexSetBuildState, state).edges;
+  guint i;
+
+  for (i = 0; i < edges->len; i++)
+    {
+      RegexSetEdge *edge = &g_array_index (edges, RegexSetEdge, i);
+
+      if (edge->byte == byte)
+        return edge->target;
+    }
+
+  return 0;
+}
+
+static guint
+build_state_add (GArray *states)
+{
+  RegexSetBuildState state = { 0, };
+
+  state.edges = g_array_new (FALSE, FALSE, sizeof (RegexSetEdge));
+  state.regexes = g_array_new (FALSE, FALSE, sizeof (guint));
+  g_array_append_val (states, state);
+
+  return states->len - 1;
+}
+
+static void
+regex_set_build_automaton (GRegexSet  *set,
+                           gchar     **literals)
+{
+  GArray *states;
+  GArray *queue;
+  guint n_edges = 0, n_state_regexes = 0;
+  guint i, j;
+
+  states = g_array_new (FALSE, FALSE, sizeof (RegexSetBuildState));
+  build_state_add (states);
+
+  /* Build a trie of the literals */
+  for (i = 0; i < set->n_regexes; i++)
+    {
+      const guint8 *p;
+      guint state = 0;
+
+      if (literals[i] == NULL)
+        continue;
+
+      for (p = (const guint8 *) literals[i]; *p != '\0'; p++)
+        {
+          guint8 byte = set->fold_case ? g_ascii_tolower (*p) : *p;
+          guint next = build_state_next (states, state, byte);
+
+          if (next == 0)
+            {
+              RegexSetEdge edge = { byte, 0 };
+              GArray *edges;
+
+              next = edge.target = build_state_add (states);
+              edges = g_array_index (states, RegexSetBuildState, state).edges;
+              j = 0;
+              while (j < edges->len && g_array_index (edges, RegexSetEdge, j).byte < byte)
+                j++;
+              g_array_insert_val (edges, j, edge);
+              n_edges++;
+            }
+
+          state = next;
+        }
+
+      g_array_append_val (g_array_index (states, RegexSetBuildState, state).regexes, i);
+      n_state_regexes++;
+    }
+
+  /* Link each state to the longest proper suffix of it in the trie, and to
+   * the nearest such suffix which completes a literal, breadth-first */
+  queue = g_array_new (FALSE, FALSE, sizeof (guint));
+  i = 0;
+  g_array_append_val (queue, i);
+
+  for (i = 0; i < queue->len; i++)
+    {
+      guint state = g_array_index (queue, guint, i);
+      GArray *edges = g_array_index (states, RegexSetBuildState, state).edges;
+
+      for (j = 0; j < edges->len; j++)
+        {
+          RegexSetEdge *edge = &g_array_index (edges, RegexSetEdge, j);
+          RegexSetBuildState *target = &g_array_index (states, RegexSetBuildState, edge->target);
+          RegexSetBuildState *fail;
+
+          target->fail = 0;
+
+          if (state != 0)
+            {
+              guint f = g_array_index (states, RegexSetBuildState, state).fail;
+
+              while (TRUE)
+                {
+                  guint next = build_state_next (states, f, edge->byte);
+
+                  if (next != 0)
+                    {
+                      target->fail = next;
+                      break;
+                    }
+                  if (f == 0)
+                    break;
+                  f = g_array_index (states, RegexSetBuildState, f).fail;
+                }
+            }
+
+          fail = &g_array_index (states, RegexSetBuildState, target->fail);
+          target->output = (fail->regexes->len > 0) ? target->fail : fail->output;
+
+          g_array_append_val (queue, edge->target);
+        }
+    }
+
+  g_array_unref (queue);
+
+  /* Flatten it */
+  set->n_states = states->len;
+  set->states = g_new0 (RegexSetState, states->len);
+  set->edges = g_new (RegexSetEdge, n_edges);
+  set->state_regexes = g_new (guint, n_state_regexes);
+  n_edges = n_state_regexes = 0;
+
+  for (i = 0; i < states->len; i++)
+    {
+      RegexSetBuildState *build_state = &g_array_index (states, RegexSetBuildState, i);
+      RegexSetState *state = &set->states[i];
+
+      state->fail = build_state->fail;
+      state->output = build_state->output;
+
+      state->first_edge = n_edges;
+      state->n_edges = build_state->edges->len;
+      if (state->n_edges > 0)
+        memcpy (&set->edges[n_edges], build_state->edges->data, state->n_edges * sizeof (RegexSetEdge));
+      n_edges += state->n_edges;
+
+      state->first_regex = n_state_regexes;
+      state->n_regexes = build_state->regexes->len;
+      if (state->n_regexes > 0)
+        memcpy (&set->state_regexes[n_state_regexes], build_state->regexes->data, state->n_regexes * sizeof (guint));
+      n_state_regexes += state->n_regexes;
+
+      g_array_unref (build_state->edges);
+      g_array_unref (build_state->regexes);
+    }
+
+  g_array_unref (states);
+
+  for (i = 0; i < set->states[0].n_edges; i++)
+    {
+      RegexSetEdge *edge = &set->edges[set->states[0].first_edge + i];
+      set->root[edge->byte] = edge->target;
+    }
+}
+
+/**
+ * g_regex_set_new:
+ * @patterns: (array zero-terminated=1): the regular expressions
+ * @compile_options: compile options for the regular expressions, or 0
+ * @match_options: match options for the regular expressions, or 0
+ * @error: return location for a #GError
+ *
+ * Compiles each of @patterns as with [ctor@GLib.Regex.new], so they can be
+ * matched together with [func@GLib.RegexSet.match]. Patterns are referred
+ * to by their index in @patterns.
+ *
+ * Passing %G_REGEX_OPTIMIZE in @compile_options is recommended, as it lets
+ * each pattern be JIT compiled here rather than when it is first matched.
+ *
+ * Returns: (nullable): a new #GRegexSet, or %NULL if one of the patterns
+ *   could not be compiled. Call g_regex_set_unref() when you are done
+ *   with it
+ *
+ * Since: 2.86
+ */
+GRegexSet *
+g_regex_set_new (const gchar * const  *patterns,
+                 GRegexCompileFlags    compile_options,
+                 GRegexMatchFlags      match_options,
+                 GError              **error)
+{
+  GRegexSet *set;
+  gchar **literals;
+  gboolean any_literal = FALSE;
+  guint i;
+
+  g_return_val_if_fail (patterns != NULL, NULL);
+  g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+  set = g_new0 (GRegexSet, 1);
+  set->ref_count = 1;
+  set->n_regexes = g_strv_length ((gchar **) patterns);
+  set->regexes = g_new0 (GRegex *, set->n_regexes);
+  set->match_opts = match_options;
+  set->has_literal = g_new0 (gboolean, set->n_regexes);
+
+  for (i = 0; i < set->n_regexes; i++)
+    {
+      set->regexes[i] = g_regex_new (patterns[i], compile_options, match_options, error);
+      if (set->regexes[i] == NULL)
+        {
+          g_regex_set_unref (set);
+          return NULL;
+        }
+
+      /* Nobody else has the regex, so it can be JIT compiled now, before
+       * the set is shared between threads */
+      regex_enable_jit (set->regexes[i], set->regexes[i]->match_opts);
+    }
+
+  literals = g_new0 (gchar *, set->n_regexes + 1);
+
+  for (i = 0; i < set->n_regexes; i++)
+    {
+      literals[i] = regex_get_required_literal (set->regexes[i]);
+      if (literals[i] != NULL)
+        {
+          set->has_literal[i] = any_literal = TRUE;
+          if (set->regexes[i]->compile_opts & PCRE2_CASELESS)
+            set->fold_case = TRUE;
+        }
+    }
+
+  if (any_literal)
+    regex_set_build_automaton (set, literals);
+
+  g_strfreev (literals);
+
+  return set;
+}
+
+/**
+ * g_regex_set_ref:
+ * @set: a #GRegexSet
+ *
+ * Increases reference count of @set by 1.
+ *
+ * Returns: @set
+ *
+ * Since: 2.86
+ */
+GRegexSet *
+g_regex_set_ref (GRegexSet *set)
+{
+  g_return_val_if_fail (set != NULL, NULL);
+  g_atomic_int_inc (&set->ref_count);
+  return set;
+}
+
+/**
+ * g_regex_set_unref:
+ * @set: a #GRegexSet
+ *
+ * Decreases reference count of @set by 1. When reference count drops
+ * to zero, it frees all the memory associated with the set.
+ *
+ * Since: 2.86
+ */
+void
+g_regex_set_unref (GRegexSet *set)
+{
+  guint i;
+
+  g_return_if_fail (set != NULL);
+
+  if (g_atomic_int_dec_and_test (&set->ref_count))
+    {
+      for (i = 0; i < set->n_regexes; i++)
+        g_clear_pointer (&set->regexes[i], g_regex_unref);
+      g_free (set->regexes);
+      g_free (set->has_literal);
+      g_free (set->states);
+      g_free (set->edges);
+      g_free (set->state_regexes);
+      g_free (set);
+    }
+}
+
+/**
+ * g_regex_set_get_n_patterns:
+ * @set: a #GRegexSet
+ *
+ * Gets the number of patterns in @set.
+ *
+ * Returns: the number of patterns
+ *
+ * Since: 2.86
+ */
+guint
+g_regex_set_get_n_patterns (const GRegexSet *set)
+{
+  g_return_val_if_fail (set != NULL, 0);
+
+  return set->n_regexes;
+}
+
+/**
+ * g_regex_set_get_pattern:
+ * @set: a #GRegexSet
+ * @index_: the index of a pattern in @set
+ *
+ * Gets the pattern at @index_ in @set.
+ *
+ * Returns: the pattern, owned by @set
+ *
+ * Since: 2.86
+ */
+const gchar *
+g_regex_set_get_pattern (const GRegexSet *set,
+                         guint            index_)
+{
+  g_return_val_if_fail (set != NULL, NULL);
+  g_return_val_if_fail (index_ < set->n_regexes, NULL);
+
+  return set->regexes[index_]->pattern;
+}
+
+static inline guint
+regex_set_next_state (const GRegexSet *set,
+                      guint            state,
+                      guint8           byte)
+{
+  while (TRUE)
+    {
+      const RegexSetState *s;
+      guint i;
+
+      if (state == 0)
+        return set->root[byte];
+
+      s = &set->states[state];
+      for (i = 0; i < s->n_edges; i++)
+        {
+          const RegexSetEdge *edge = &set->edges[s->first_edge + i];
+
+          if (edge->byte == byte)
+            return edge->target;
+          if (edge->byte > byte)
+            break;
+        }
+
+      state = s->fail;
+    }
+}
+
+/* @found is a bitset with a bit for each regex */
+#define REGEX_SET_FOUND_BITS (sizeof (gsize) * 8)
+#define REGEX_SET_FOUND_WORDS(n) (((n) + REGEX_SET_FOUND_BITS - 1) / REGEX_SET_FOUND_BITS)
+#define REGEX_SET_FOUND_SET(found, i) \
+  ((found)[(i) / REGEX_SET_FOUND_BITS] |= (gsize) 1 << ((i) % REGEX_SET_FOUND_BITS))
+#define REGEX_SET_FOUND_GET(found, i) \
+  (((found)[(i) / REGEX_SET_FOUND_BITS] >> ((i) % REGEX_SET_FOUND_BITS)) & 1)
+
+/* Marks the regexes whose literal appears in the string. */
+static void
+regex_set_find_literals (const GRegexSet *set,
+                         const guint8    *string,
+                         gsize            string_len,
+                         gsize           *found)
+{
+  guint state = 0;
+  gsize i;
+
+  for (i = 0; i < string_len; i++)
+    {
+      guint8 byte = set->fold_case ? g_ascii_tolower (string[i]) : string[i];
+      guint s;
+
+      state = regex_set_next_state (set, state, byte);
+
+      for (s = (set->states[state].n_regexes > 0) ? state : set->states[state].output;
+           s != 0;
+           s = set->states[s].output)
+        {
+          const RegexSetState *output = &set->states[s];
+          guint j;
+
+          for (j = 0; j < output->n_regexes; j++)
+            REGEX_SET_FOUND_SET (found, set->state_regexes[output->first_regex + j]);
+        }
+    }
+}
+
+static gint
+regex_set_match_one (GRegex              *regex,
+                     const gchar         *string,
+                     gsize                string_len,
+                     gsize                start_position,
+                     GRegexMatchFlags     match_options,
+                     pcre2_match_data    *match_data,
+                     pcre2_match_context *match_context)
+{
+  uint32_t opts;
+  gint rc;
+
+  opts = regex->match_opts | get_pcre2_match_options (match_options, regex->orig_compile_opts);
+
+  /* Only use the JIT for the modes it was compiled for in
+   * g_regex_set_new(), as compiling it again isn't thread-safe */
+  if (regex->jit_status == JIT_STATUS_ENABLED &&
+      !(opts & G_REGEX_PCRE2_JIT_UNSUPPORTED_OPTIONS) &&
+      (!(opts & PCRE2_PARTIAL_HARD) || (regex->jit_options & PCRE2_JIT_PARTIAL_HARD)) &&
+      (!(opts & PCRE2_PARTIAL_SOFT) || (regex->jit_options & PCRE2_JIT_PARTIAL_SOFT)))
+    {
+      rc = pcre2_jit_match (regex->pcre_re, (PCRE2_SPTR8) string, string_len,
+                            start_position, opts, match_data, match_context);
+      if (rc != PCRE2_ERROR_JIT_STACKLIMIT)
+        return rc;
+    }
+
+  return pcre2_match (regex->pcre_re, (PCRE2_SPTR8) string, string_len,
+                      start_position, opts | PCRE2_NO_JIT, match_data, match_context);
+}
+
+/**
+ * g_regex_set_match:
+ * @set: a #GRegexSet
+ * @string: the string to scan for matches
+ * @match_options: match options
+ * @matches: (nullable) (element-type guint): an array to store the indexes
+ *   of the matching patterns in, or %NULL
+ *
+ * Finds which patterns of @set match @string. This is equivalent to
+ * calling g_regex_match() with each pattern, but faster.
+ *
+ * See g_regex_set_match_full() for more details.
+ *
+ * Returns: %TRUE if at least one pattern matched, %FALSE otherwise
+ *
+ * Since: 2.86
+ */
+gboolean
+g_regex_set_match (const GRegexSet  *set,
+                   const gchar      *string,
+                   GRegexMatchFlags  match_options,
+                   GArray           *matches)
+{
+  return g_regex_set_match_full (set, string, -1, 0, match_options,
+                                 matches, NULL);
+}
+
+/**
+ * g_regex_set_match_full:
+ * @set: a #GRegexSet
+ * @string: (array length=string_len): the string to scan for matches
+ * @string_len: the length of @string, in bytes, or -1 if @string is
+ *   nul-terminated
+ * @start_position: starting index of the string to match, in bytes
+ * @match_options: match options
+ * @matches: (nullable) (element-type guint): an array to store the indexes
+ *   of the matching patterns in, or %NULL
+ * @error: location to store the error occurring, or %NULL to ignore errors
+ *
+ * Finds which patterns of @set match @string, as g_regex_match_full()
+ * would for each of them with the same arguments.
+ *
+ * If @matches is not %NULL, it is first cleared, then the indexes of all
+ * the matching patterns are appended to it in increasing order. Its
+ * elements must be of type #guint. Reusing the same array for each string
+ * saves allocating a new one. If @matches is %NULL, this stops at the first
+ * matching pattern.
+ *
+ * Returns: %TRUE if at least one pattern matched, %FALSE otherwise
+ *
+ * Since: 2.86
+ */
+gboolean
+g_regex_set_match_full (const GRegexSet   *set,
+                        const gchar       *string,
+                        gssize             string_len,
+                        gint               start_position,
+                        GRegexMatchFlags   match_options,
+                        GArray            *matches,
+                        GError           **error)
+{
+  gsize found_static[1024 / sizeof (gsize)];
+  gsize *found = NULL;
+  GMatchInfo *match_info = NULL;
+  gboolean filter;
+  gboolean any_match = FALSE;
+  guint i;
+
+  g_return_val_if_fail (set != NULL, FALSE);
+  g_return_val_if_fail (string != NULL, FALSE);
+  g_return_val_if_fail (start_position >= 0, FALSE);
+  g_return_val_if_fail (matches == NULL || g_array_get_element_size (matches) == sizeof (guint), FALSE);
+  g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+  g_return_val_if_fail ((match_options & ~G_REGEX_MATCH_MASK) == 0, FALSE);
+
+  if (matches != NULL)
+    g_array_set_size (matches, 0);
+
+  if (string_len < 0)
+    string_len = strlen (string);
+
+  if ((gsize) start_position > (gsize) string_len)
+    return FALSE;
+
+  /* A partial match needn't contain the whole literal */
+  filter = set->n_states > 0 &&
+           !((match_options | set->match_opts) & (G_REGEX_MATCH_PARTIAL_SOFT | G_REGEX_MATCH_PARTIAL_HARD));
+
+  if (filter)
+    {
+      gsize n_words = REGEX_SET_FOUND_WORDS (set->n_regexes);
+
+      if (n_words <= G_N_ELEMENTS (found_static))
+        {
+          found = found_static;
+          memset (found, 0, n_words * sizeof (gsize));
+        }
+      else
+        {
+          found = g_new0 (gsize, n_words);
+        }
+
+      regex_set_find_literals (set, (const guint8 *) string + start_position,
+                               string_len - start_position, found);
+    }
+
+  for (i = 0; i < set->n_regexes; i++)
+    {
+      gint rc;
+
+      if (filter && set->has_literal[i] && !REGEX_SET_FOUND_GET (found, i))
+        continue;
+
+      /* Only whether each pattern matches is needed, not where, so any
+       * match data will do */
+      if (match_info == NULL)
+        match_info = match_info_take_cached (set->regexes[i], string, string_len,
+                                             start_position, match_options);
+
+      rc = regex_set_match_one (set->regexes[i], string, string_len,
+                                start_position, match_options,
+                                match_info->match_data, match_info->match_context);
+
+      if (IS_PCRE2_ERROR (rc))
+        {
+          gchar *error_msg = get_match_error_message (rc);
+
+          g_set_error (error, G_REGEX_ERROR, G_REGEX_ERROR_MATCH,
+                       _("Error while matching regular expression %s: %s"),
+                       set->regexes[i]->pattern, error_msg);
+          g_free (error_msg);
+
+          if (matches != NULL)
+            g_array_set_size (matches, 0);
+          any_match = FALSE;
+          break;
+        }
+
+      /* Like g_regex_match(), a partial match isn't a match */
+      if (rc >= 0)
+        {
+          any_match = TRUE;
+
+          if (matches == NULL)
+            break;
+
+          g_array_append_val (matches, i);
+        }
+    }
+
+  if (match_info != NULL)
+    match_info_return_cached (match_info);
+  if (found != found_static)
+    g_free (found);
+
+  return any_match;
+}
@@ -29,6 +29,7 @@
 
 #include <glib/gerror.h>
 #include <glib/gstring.h>
+#include <glib/garray.h>
 
 G_BEGIN_DECLS
 
@@ -414,6 +415,7 @@ typedef enum
 } GRegexMatchFlags;
 
 typedef struct _GRegex		GRegex;
+typedef struct _GRegexSet	GRegexSet;
 
 
 /**
@@ -499,6 +501,14 @@ gboolean	  g_regex_match_full		(const GRegex        *regex,
 						 GRegexMatchFlags     match_options,
 						 GMatchInfo         **match_info,
 						 GError             **error);
+GLIB_AVAILABLE_IN_2_86
+gboolean	  g_regex_match_reuse		(const GRegex        *regex,
+						 const gchar         *string,
+						 gssize               string_len,
+						 gint                 start_position,
+						 GRegexMatchFlags     match_options,
+						 GMatchInfo         **match_info,
+						 GError             **error);
 GLIB_AVAILABLE_IN_ALL
 gboolean	  g_regex_match_all		(const GRegex        *regex,
 						 const gchar         *string,
@@ -607,6 +617,35 @@ gboolean	  g_match_info_fetch_named_pos	(const GMatchInfo    *match_info,
 GLIB_AVAILABLE_IN_ALL
 gchar		**g_match_info_fetch_all	(const GMatchInfo    *match_info);
 
+/* Regex sets */
+GLIB_AVAILABLE_IN_2_86
+GRegexSet	 *g_regex_set_new		(const gchar * const *patterns,
+						 GRegexCompileFlags   compile_options,
+						 GRegexMatchFlags     match_options,
+						 GError             **error);
+GLIB_AVAILABLE_IN_2_86
+GRegexSet	 *g_regex_set_ref		(GRegexSet           *set);
+GLIB_AVAILABLE_IN_2_86
+void		  g_regex_set_unref		(GRegexSet           *set);
+GLIB_AVAILABLE_IN_2_86
+guint		  g_regex_set_get_n_patterns	(const GRegexSet     *set);
+GLIB_AVAILABLE_IN_2_86
+const gchar	 *g_regex_set_get_pattern	(const GRegexSet     *set,
+						 guint                index_);
+GLIB_AVAILABLE_IN_2_86
+gboolean	  g_regex_set_match		(const GRegexSet     *set,
+						 const gchar         *string,
+						 GRegexMatchFlags     match_options,
+						 GArray              *matches);
+GLIB_AVAILABLE_IN_2_86
+gboolean	  g_regex_set_match_full	(const GRegexSet     *set,
+						 const gchar         *string,
+						 gssize               string_len,
+						 gint                 start_position,
+						 GRegexMatchFlags     match_options,
+						 GArray              *matches,
+						 GError             **error);
+
 G_END_DECLS
 
 #endif  /*  __G_REGEX_H__ */
@@ -42,6 +42,28 @@
 
 typedef struct _GRealThreadPool GRealThreadPool;
 
+/* Per-worker task queue of a work-stealing pool. Each one is padded to
+ * its own cache line so that workers popping from their own deque do not
+ * contend with each other. */
+#define DEQUE_ALIGNMENT 64
+
+typedef struct
+{
+  GMutex mutex;
+  GQueue tasks;  /* (element-type gpointer) (owned) (locked-by mutex) */
+  gchar padding[DEQUE_ALIGNMENT - sizeof (GMutex) - sizeof (GQueue)];
+} GThreadPoolDeque;
+
+G_STATIC_ASSERT (sizeof (GThreadPoolDeque) == DEQUE_ALIGNMENT);
+
+/* Identifies the pool and deque a work-stealing worker is currently
+ * serving, so that tasks pushed from within @func stay local. */
+typedef struct
+{
+  GRealThreadPool *pool;
+  guint slot;
+} GThreadPoolWorker;
+
 /**
  * GThreadPool:
  * @func: the function to execute in the threads of this pool
@@ -60,7 +82,10 @@ typedef struct _GRealThreadPool GRealThreadPool;
  * threads can be shared between the different subsystems of your program, when they are using GLib.
  *
  * To create a new thread pool, you use [func@GLib.ThreadPool.new].
- * It is destroyed by [method@GLib.ThreadPool.free].
+ * It is destroyed by [method@GLib.ThreadPool.free]. Pools with many threads
+ * running many small tasks may benefit from being created with
+ * [func@GLib.ThreadPool.new_with_flags] and
+ * [flags@GLib.ThreadPoolFlags.WORK_STEALING].
  *
  * If you want to execute a certain task within a thread pool, use [method@GLib.ThreadPool.push].
  *
@@ -87,6 +112,18 @@ struct _GRealThreadPool
   gboolean waiting;
   GCompareDataFunc sort_func;
   gpointer sort_user_data;
+
+  /* Only used by work-stealing pools (G_THREAD_POOL_FLAGS_WORK_STEALING).
+   * In that case tasks are kept in @deques rather than in @queue, whose
+   * mutex then only protects the thread bookkeeping above and @steal_cond. */
+  GThreadPoolDeque *deques;  /* (array length=n_deques) (nullable) (owned) */
+  guint n_deques;
+  guint next_deque;  /* (atomic) */
+  guint next_slot;
+  gint n_tasks;  /* (atomic) */
+  gint n_sleeping;  /* (atomic) */
+  GCond steal_cond;
+  GDestroyNotify item_free_func;
 };
 
 /* The following is just an address to mark the wakeup order for a
@@ -116,6 +153,8 @@ typedef struct
 static GCond spawn_thread_cond;
 static GAsyncQueue *spawn_thread_queue;
 
+static GPrivate current_worker;  /* (type GThreadPoolWorker) (not owned) */
+
 static void             g_thread_pool_queue_push_unlocked (GRealThreadPool  *pool,
                                                            gpointer          data);
 static void             g_thread_pool_free_internal       (GRealThreadPool  *pool);
@@ -125,6 +164,18 @@ static gboolean         g_thread_pool_start_thread        (GRealThreadPool  *poo
 static void             g_thread_pool_wakeup_and_stop_all (GRealThreadPool  *pool);
 static GRealThreadPool* g_thread_pool_wait_for_new_pool   (void);
 static gpointer         g_thread_pool_wait_for_new_task   (GRealThreadPool  *pool);
+static void             g_thread_pool_run_stealing        (GRealThreadPool  *pool);
+
+/* The equivalent of g_async_queue_length_unlocked() on @pool->queue:
+ * the number of queued tasks minus the number of idle threads. */
+static gint
+g_thread_pool_queue_length_unlocked (GRealThreadPool *pool)
+{
+  if (pool->deques != NULL)
+    return g_atomic_int_get (&pool->n_tasks) - g_atomic_int_get (&pool->n_sleeping);
+  else
+    return g_async_queue_length_unlocked (pool->queue);
+}
 
 static void
 g_thread_pool_queue_push_unlocked (GRealThreadPool *pool,
@@ -277,6 +328,149 @@ g_thread_pool_wait_for_new_task (GRealThreadPool *pool)
   return task;
 }
 
+static gboolean
+g_thread_pool_is_superfluous (GRealThreadPool *pool)
+{
+  gint max_threads = g_atomic_int_get (&pool->max_threads);
+
+  return max_threads != -1 &&
+         (guint) g_atomic_int_get (&pool->num_threads) > (guint) max_threads;
+}
+
+/* Takes the next task for a worker serving @slot: first the newest task of
+ * its own deque, whose data is most likely still in cache, then the oldest
+ * task of one of the other deques in turn. If the pool has a @sort_func,
+ * tasks are always taken from the head of a deque instead, so that the
+ * order it gives is kept within each of them. */
+static gpointer
+g_thread_pool_steal_task (GRealThreadPool *pool,
+                          guint            slot)
+{
+  gboolean sorted = (pool->sort_func != NULL);
+  guint i;
+
+  for (i = 0; i < pool->n_deques; i++)
+    {
+      GThreadPoolDeque *deque = &pool->deques[(slot + i) % pool->n_deques];
+      gpointer task;
+
+      /* Avoid taking locks on deques that are known to be empty. */
+      if (g_atomic_int_get (&pool->n_tasks) <= 0)
+        break;
+
+      g_mutex_lock (&deque->mutex);
+      if (i == 0 && !sorted)
+        task = g_queue_pop_tail (&deque->tasks);
+      else
+        task = g_queue_pop_head (&deque->tasks);
+      if (task != NULL)
+        g_atomic_int_add (&pool->n_tasks, -1);
+      g_mutex_unlock (&deque->mutex);
+
+      if (task != NULL)
+        return task;
+    }
+
+  return NULL;
+}
+
+static gboolean
+g_thread_pool_stealing_is_active_unlocked (GRealThreadPool *pool)
+{
+  if (!pool->running &&
+      (pool->immediate || g_atomic_int_get (&pool->n_tasks) <= 0))
+    {
+      /* This thread pool is inactive, it will no longer process tasks. */
+      return FALSE;
+    }
+
+  /* A superfluous thread goes to the global pool. */
+  return !g_thread_pool_is_superfluous (pool);
+}
+
+/* The main loop of a thread in a work-stealing pool. It is called and
+ * returns with @pool->queue locked, but only takes that lock to go to
+ * sleep or to leave the pool, never to fetch a task. It returns when
+ * the thread should go back to the global pool.
+ */
+static void
+g_thread_pool_run_stealing (GRealThreadPool *pool)
+{
+  GThreadPoolWorker self;
+  gint64 end_time = -1;
+
+  self.pool = pool;
+  self.slot = pool->next_slot++ % pool->n_deques;
+  g_private_set (&current_worker, &self);
+
+  while (g_thread_pool_stealing_is_active_unlocked (pool))
+    {
+      gboolean woken;
+
+      if (g_atomic_int_get (&pool->n_tasks) > 0)
+        {
+          gpointer task;
+
+          g_async_queue_unlock (pool->queue);
+
+          while (!g_atomic_int_get (&pool->immediate) &&
+                 (task = g_thread_pool_steal_task (pool, self.slot)) != NULL)
+            {
+              DEBUG_MSG (("thread %p in pool %p calling func.",
+                          g_thread_self (), pool));
+              pool->pool.func (task, pool->pool.user_data);
+
+              if (g_thread_pool_is_superfluous (pool))
+                break;
+            }
+
+          g_async_queue_lock (pool->queue);
+          end_time = -1;
+          continue;
+        }
+
+      /* Nothing to do, so sleep until g_thread_pool_push() signals a new
+       * task. @n_sleeping is raised before checking @n_tasks again, and
+       * pushers raise @n_tasks before checking @n_sleeping, so a wakeup
+       * cannot be missed. */
+      g_atomic_int_inc (&pool->n_sleeping);
+
+      if (g_atomic_int_get (&pool->n_tasks) > 0)
+        woken = TRUE;
+      else if (pool->pool.exclusive)
+        {
+          /* Exclusive threads stay attached to the pool. */
+          g_cond_wait (&pool->steal_cond, _g_async_queue_get_mutex (pool->queue));
+          woken = TRUE;
+        }
+      else
+        {
+          /* A thread will wait for new tasks for at most 1/2 second
+           * before going to the global pool. */
+          if (end_time == -1)
+            end_time = g_get_monotonic_time () + G_USEC_PER_SEC / 2;
+
+          woken = g_cond_wait_until (&pool->steal_cond,
+                                     _g_async_queue_get_mutex (pool->queue),
+                                     end_time);
+        }
+
+      g_atomic_int_add (&pool->n_sleeping, -1);
+
+      if (!woken && g_atomic_int_get (&pool->n_tasks) <= 0)
+        break;
+    }
+
+  DEBUG_MSG (("thread %p in work-stealing pool %p going idle "
+              "(running: %s, immediate: %s, tasks: %d).",
+              g_thread_self (), pool,
+              pool->running ? "true" : "false",
+              pool->immediate ? "true" : "false",
+              g_atomic_int_get (&pool->n_tasks)));
+
+  g_private_set (&current_worker, NULL);
+}
+
 static gpointer
 g_thread_pool_spawn_thread (gpointer data)
 {
@@ -322,7 +516,16 @@ g_thread_pool_thread_proxy (gpointer data)
     {
       gpointer task;
 
-      task = g_thread_pool_wait_for_new_task (pool);
+      if (pool->deques != NULL)
+        {
+          /* Work-stealing pools run their tasks without holding the pool
+           * lock, and only come back here to leave the pool. */
+          g_thread_pool_run_stealing (pool);
+          task = NULL;
+        }
+      else
+        task = g_thread_pool_wait_for_new_task (pool);
+
       if (task)
         {
           if (pool->running || !pool->immediate)
@@ -344,7 +547,7 @@ g_thread_pool_thread_proxy (gpointer data)
 
           DEBUG_MSG (("thread %p leaving pool %p for global pool.",
                       g_thread_self (), pool));
-          pool->num_threads--;
+          g_atomic_int_add (&pool->num_threads, -1);
 
           if (!pool->running)
             {
@@ -367,13 +570,13 @@ g_thread_pool_thread_proxy (gpointer data)
                        * this pool and there are no tasks left in the
                        * queue, wakeup the remaining threads.
                        */
-                      if (g_async_queue_length_unlocked (pool->queue) ==
+                      if (g_thread_pool_queue_length_unlocked (pool) ==
                           (gint) -pool->num_threads)
                         g_thread_pool_wakeup_and_stop_all (pool);
                     }
                 }
               else if (pool->immediate ||
-                       g_async_queue_length_unlocked (pool->queue) <= 0)
+                       g_thread_pool_queue_length_unlocked (pool) <= 0)
                 {
                   /* If the pool is not running and another thread is
                    * waiting for this thread pool to finish and there
@@ -480,7 +683,7 @@ g_thread_pool_start_thread (GRealThreadPool  *pool,
   /* See comment in g_thread_pool_thread_proxy as to why this is done
    * here and not there
    */
-  pool->num_threads++;
+  g_atomic_int_inc (&pool->num_threads);
 
   return TRUE;
 }
@@ -579,6 +782,62 @@ g_thread_pool_new_full (GFunc           func,
                         gint            max_threads,
                         gboolean        exclusive,
                         GError        **error)
+{
+  return g_thread_pool_new_with_flags (func, user_data, item_free_func,
+                                       max_threads, exclusive,
+                                       G_THREAD_POOL_FLAGS_NONE, error);
+}
+
+/**
+ * g_thread_pool_new_with_flags:
+ * @func: a function to execute in the threads of the new thread pool
+ * @user_data: user data that is handed over to @func every time it
+ *     is called
+ * @item_free_func: (nullable): used to free the data passed to
+ *     g_thread_pool_push() which is not processed before the pool is freed
+ * @max_threads: the maximal number of threads to execute concurrently
+ *     in the new thread pool, `-1` means no limit
+ * @exclusive: should this thread pool be exclusive?
+ * @flags: a bitwise-OR combination of #GThreadPoolFlags flags that can
+ *     only be set at creation time
+ * @error: return location for error, or %NULL
+ *
+ * This function creates a new thread pool similar to
+ * g_thread_pool_new_full(), but allowing @flags to be specified.
+ *
+ * If @flags contains %G_THREAD_POOL_FLAGS_WORK_STEALING, each worker
+ * thread takes its tasks from a queue of its own. Tasks pushed from
+ * within @func are added to the queue of the calling worker, other tasks
+ * are distributed between the queues in turn. A worker takes the task
+ * most recently added to its own queue, and workers which run out of
+ * tasks steal the oldest task from the queues of other workers. This
+ * avoids having all threads contend for a single lock when many small
+ * tasks are pushed, and keeps tasks spawned by a task on the thread
+ * which spawned them, at the cost of a weaker ordering of tasks: tasks
+ * are not processed in the order they were pushed. If a sort function
+ * is set with g_thread_pool_set_sort_function(), workers take tasks from
+ * the front of each queue instead, but the sort function is applied to
+ * each queue separately, so tasks are only processed in order relative
+ * to other tasks in the same queue.
+ *
+ * The number of queues is @max_threads, or the number of logical
+ * processors if @max_threads is `-1` or `0`, and is fixed when the pool
+ * is created: changing the maximum number of threads later does not
+ * change it. The semantics of @exclusive and @max_threads are otherwise
+ * the same as for g_thread_pool_new().
+ *
+ * Returns: (transfer full): the new #GThreadPool
+ *
+ * Since: 2.86
+ */
+GThreadPool *
+g_thread_pool_new_with_flags (GFunc             func,
+                              gpointer          user_data,
+                              GDestroyNotify    item_free_func,
+                              gint              max_threads,
+                              gboolean          exclusive,
+                              GThreadPoolFlags  flags,
+                              GError          **error)
 {
   GRealThreadPool *retval;
   G_LOCK_DEFINE_STATIC (init);
@@ -602,6 +861,28 @@ g_thread_pool_new_full (GFunc           func,
   retval->waiting = FALSE;
   retval->sort_func = NULL;
   retval->sort_user_data = NULL;
+  retval->deques = NULL;
+  retval->n_deques = 0;
+  retval->next_deque = 0;
+  retval->next_slot = 0;
+  retval->n_tasks = 0;
+  retval->n_sleeping = 0;
+  g_cond_init (&retval->steal_cond);
+  retval->item_free_func = item_free_func;
+
+  if (flags & G_THREAD_POOL_FLAGS_WORK_STEALING)
+    {
+      guint i;
+
+      retval->n_deques = (max_threads > 0) ? (guint) max_threads : g_get_num_processors ();
+      retval->deques = g_aligned_alloc0 (retval->n_deques, sizeof (GThreadPoolDeque),
+                                         DEQUE_ALIGNMENT);
+      for (i = 0; i < retval->n_deques; i++)
+        {
+          g_mutex_init (&retval->deques[i].mutex);
+          g_queue_init (&retval->deques[i].tasks);
+        }
+    }
 
   G_LOCK (init);
   if (!unused_thread_queue)
@@ -670,6 +951,16 @@ g_thread_pool_new_full (GFunc           func,
 
       g_clear_pointer (&retval->queue, g_async_queue_unref);
       g_cond_clear (&retval->cond);
+      g_cond_clear (&retval->steal_cond);
+
+      if (retval->deques != NULL)
+        {
+          guint i;
+
+          for (i = 0; i < retval->n_deques; i++)
+            g_mutex_clear (&retval->deques[i].mutex);
+          g_aligned_free (retval->deques);
+        }
 
       g_clear_pointer (&retval, g_free);
     }
@@ -677,6 +968,66 @@ g_thread_pool_new_full (GFunc           func,
   return (GThreadPool*) retval;
 }
 
+static gboolean
+g_thread_pool_push_stealing (GRealThreadPool  *pool,
+                             gpointer          data,
+                             GError          **error)
+{
+  GThreadPoolWorker *worker;
+  GThreadPoolDeque *deque;
+  gint max_threads;
+  gboolean result = TRUE;
+
+  /* As with g_async_queue_push(), %NULL would be taken for an empty deque */
+  g_return_val_if_fail (data != NULL, FALSE);
+
+  /* Tasks pushed by a worker of this pool are kept local to it, others
+   * are spread over all deques. */
+  worker = g_private_get (&current_worker);
+  if (worker != NULL && worker->pool == pool)
+    deque = &pool->deques[worker->slot];
+  else
+    deque = &pool->deques[(guint) g_atomic_int_add (&pool->next_deque, 1) % pool->n_deques];
+
+  g_mutex_lock (&deque->mutex);
+  if (pool->sort_func)
+    g_queue_insert_sorted (&deque->tasks, data, pool->sort_func, pool->sort_user_data);
+  else
+    g_queue_push_tail (&deque->tasks, data);
+  g_atomic_int_inc (&pool->n_tasks);
+  g_mutex_unlock (&deque->mutex);
+
+  /* Only take the pool lock if there is an idle thread to wake up, or if
+   * another thread may have to be started. */
+  max_threads = g_atomic_int_get (&pool->max_threads);
+
+  if (g_atomic_int_get (&pool->n_sleeping) > 0)
+    {
+      g_async_queue_lock (pool->queue);
+      g_cond_signal (&pool->steal_cond);
+      g_async_queue_unlock (pool->queue);
+    }
+  else if (max_threads == -1 ||
+           (guint) g_atomic_int_get (&pool->num_threads) < (guint) max_threads)
+    {
+      GError *local_error = NULL;
+
+      g_async_queue_lock (pool->queue);
+
+      if (g_atomic_int_get (&pool->n_sleeping) > 0)
+        g_cond_signal (&pool->steal_cond);
+      else if (!g_thread_pool_start_thread (pool, &local_error))
+        {
+          g_propagate_error (error, local_error);
+          result = FALSE;
+        }
+
+      g_async_queue_unlock (pool->queue);
+    }
+
+  return result;
+}
+
 /**
  * g_thread_pool_push:
  * @pool: a #GThreadPool
@@ -713,6 +1064,9 @@ g_thread_pool_push (GThreadPool  *pool,
   g_return_val_if_fail (real, FALSE);
   g_return_val_if_fail (real->running, FALSE);
 
+  if (real->deques != NULL)
+    return g_thread_pool_push_stealing (real, data, error);
+
   result = TRUE;
 
   g_async_queue_lock (real->queue);
@@ -785,12 +1139,12 @@ g_thread_pool_set_max_threads (GThreadPool  *pool,
 
   g_async_queue_lock (real->queue);
 
-  real->max_threads = max_threads;
+  g_atomic_int_set (&real->max_threads, max_threads);
 
   if (pool->exclusive)
     to_start = real->max_threads - real->num_threads;
   else
-    to_start = g_async_queue_length_unlocked (real->queue);
+    to_start = g_thread_pool_queue_length_unlocked (real);
 
   for ( ; to_start > 0; to_start--)
     {
@@ -880,7 +1234,10 @@ g_thread_pool_unprocessed (GThreadPool *pool)
   g_return_val_if_fail (real, 0);
   g_return_val_if_fail (real->running, 0);
 
-  unprocessed = g_async_queue_length (real->queue);
+  if (real->deques != NULL)
+    unprocessed = g_atomic_int_get (&real->n_tasks);
+  else
+    unprocessed = g_async_queue_length (real->queue);
 
   return MAX (unprocessed, 0);
 }
@@ -923,22 +1280,22 @@ g_thread_pool_free (GThreadPool *pool,
    */
   g_return_if_fail (immediate ||
                     real->max_threads != 0 ||
-                    g_async_queue_length (real->queue) == 0);
+                    g_thread_pool_unprocessed (pool) == 0);
 
   g_async_queue_lock (real->queue);
 
   real->running = FALSE;
-  real->immediate = immediate;
+  g_atomic_int_set (&real->immediate, immediate);
   real->waiting = wait_;
 
   if (wait_)
     {
-      while (g_async_queue_length_unlocked (real->queue) != (gint) -real->num_threads &&
+      while (g_thread_pool_queue_length_unlocked (real) != (gint) -real->num_threads &&
              !(immediate && real->num_threads == 0))
         g_cond_wait (&real->cond, _g_async_queue_get_mutex (real->queue));
     }
 
-  if (immediate || g_async_queue_length_unlocked (real->queue) == (gint) -real->num_threads)
+  if (immediate || g_thread_pool_queue_length_unlocked (real) == (gint) -real->num_threads)
     {
       /* No thread is currently doing something (and nothing is left
        * to process in the queue)
@@ -973,6 +1330,23 @@ g_thread_pool_free_internal (GRealThreadPool* pool)
 
   g_async_queue_unref (pool->queue);
   g_cond_clear (&pool->cond);
+  g_cond_clear (&pool->steal_cond);
+
+  if (pool->deques != NULL)
+    {
+      guint i;
+
+      for (i = 0; i < pool->n_deques; i++)
+        {
+          if (pool->item_free_func != NULL)
+            g_queue_clear_full (&pool->deques[i].tasks, pool->item_free_func);
+          else
+            g_queue_clear (&pool->deques[i].tasks);
+          g_mutex_clear (&pool->deques[i].mutex);
+        }
+
+      g_aligned_free (pool->deques);
+    }
 
   g_free (pool);
 }
@@ -986,7 +1360,15 @@ g_thread_pool_wakeup_and_stop_all (GRealThreadPool *pool)
   g_return_if_fail (pool->running == FALSE);
   g_return_if_fail (pool->num_threads != 0);
 
-  pool->immediate = TRUE;
+  g_atomic_int_set (&pool->immediate, TRUE);
+
+  /* Threads of a work-stealing pool sleep on @steal_cond rather than in
+   * the queue. */
+  if (pool->deques != NULL)
+    {
+      g_cond_broadcast (&pool->steal_cond);
+      return;
+    }
 
   /*
    * So here we're sending bogus data to the pool threads, which
@@ -1096,6 +1478,9 @@ g_thread_pool_stop_unused_threads (void)
  * tasks to be processed by a priority determined by @func, and not
  * just in the order in which they were added to the pool.
  *
+ * For pools created with %G_THREAD_POOL_FLAGS_WORK_STEALING, each worker
+ * queue is sorted separately.
+ *
  * Note, if the maximum number of threads is more than 1, the order
  * that threads are executed cannot be guaranteed 100%. Threads are
  * scheduled by the operating system and are executed at random. It
@@ -1118,13 +1503,34 @@ g_thread_pool_set_sort_function (GThreadPool      *pool,
 
   g_async_queue_lock (real->queue);
 
-  real->sort_func = func;
-  real->sort_user_data = user_data;
+  if (real->deques != NULL)
+    {
+      guint i;
+
+      /* @sort_func is read by pushers with only a deque locked. */
+      for (i = 0; i < real->n_deques; i++)
+        g_mutex_lock (&real->deques[i].mutex);
+
+      real->sort_func = func;
+      real->sort_user_data = user_data;
 
-  if (func)
-    g_async_queue_sort_unlocked (real->queue,
-                                 real->sort_func,
-                                 real->sort_user_data);
+      for (i = 0; i < real->n_deques; i++)
+        {
+          if (func)
+            g_queue_sort (&real->deques[i].tasks, func, user_data);
+          g_mutex_unlock (&real->deques[i].mutex);
+        }
+    }
+  else
+    {
+      real->sort_func = func;
+      real->sort_user_data = user_data;
+
+      if (func)
+        g_async_queue_sort_unlocked (real->queue,
+                                     real->sort_func,
+                                     real->sort_user_data);
+    }
 
   g_async_queue_unlock (real->queue);
 }
@@ -1137,6 +1543,10 @@ g_thread_pool_set_sort_function (GThreadPool      *pool,
  * Moves the item to the front of the queue of unprocessed
  * items, so that it will be processed next.
  *
+ * For pools created with %G_THREAD_POOL_FLAGS_WORK_STEALING, the item is
+ * moved within the worker queue it is in, so that it is the next one the
+ * worker owning that queue processes.
+ *
  * Returns: %TRUE if the item was found and moved
  *
  * Since: 2.46
@@ -1148,6 +1558,27 @@ g_thread_pool_move_to_front (GThreadPool *pool,
   GRealThreadPool *real = (GRealThreadPool*) pool;
   gboolean found;
 
+  if (real->deques != NULL)
+    {
+      guint i;
+
+      for (i = 0, found = FALSE; i < real->n_deques && !found; i++)
+        {
+          GThreadPoolDeque *deque = &real->deques[i];
+
+          /* The owner of an unsorted deque takes its tasks from the tail */
+          g_mutex_lock (&deque->mutex);
+          found = g_queue_remove (&deque->tasks, data);
+          if (found && real->sort_func == NULL)
+            g_queue_push_tail (&deque->tasks, data);
+          else if (found)
+            g_queue_push_head (&deque->tasks, data);
+          g_mutex_unlock (&deque->mutex);
+        }
+
+      return found;
+    }
+
   g_async_queue_lock (real->queue);
 
   found = g_async_queue_remove_unlocked (real->queue, data);
@@ -37,6 +37,27 @@ G_BEGIN_DECLS
 
 typedef struct _GThreadPool GThreadPool;
 
+/**
+ * GThreadPoolFlags:
+ * @G_THREAD_POOL_FLAGS_NONE: Default behaviour.
+ * @G_THREAD_POOL_FLAGS_WORK_STEALING: Give every worker thread its own
+ *   task queue and let idle workers steal tasks from the queues of busy
+ *   ones, instead of feeding all workers from a single shared queue.
+ *   This reduces lock contention when many small tasks are pushed to a
+ *   pool with many threads.
+ *
+ * Flags to pass to [func@GLib.ThreadPool.new_with_flags] which affect the
+ * behaviour of a [struct@GLib.ThreadPool].
+ *
+ * Since: 2.86
+ */
+GLIB_AVAILABLE_TYPE_IN_2_86
+typedef enum /*< flags >*/
+{
+  G_THREAD_POOL_FLAGS_NONE = 0,
+  G_THREAD_POOL_FLAGS_WORK_STEALING = 1 << 0
+} GThreadPoolFlags;
+
 /* Thread Pools
  */
 
@@ -60,6 +81,16 @@ GThreadPool *   g_thread_pool_new_full          (GFunc            func,
                                                  gint             max_threads,
                                                  gboolean         exclusive,
                                                  GError         **error);
+G_GNUC_BEGIN_IGNORE_DEPRECATIONS
+GLIB_AVAILABLE_IN_2_86
+GThreadPool *   g_thread_pool_new_with_flags    (GFunc            func,
+                                                 gpointer         user_data,
+                                                 GDestroyNotify   item_free_func,
+                                                 gint             max_threads,
+                                                 gboolean         exclusive,
+                                                 GThreadPoolFlags flags,
+                                                 GError         **error);
+G_GNUC_END_IGNORE_DEPRECATIONS
 GLIB_AVAILABLE_IN_ALL
 void            g_thread_pool_free              (GThreadPool     *pool,
                                                  gboolean         immediate,
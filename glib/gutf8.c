@@ -28,6 +28,19 @@
 #endif
 #include <string.h>
 
+#ifdef HAVE_X86_AVX2_INTRINSICS
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+#if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define USE_SSE2_KERNELS
+#elif defined (__aarch64__) && defined (__ARM_NEON)
+#include <arm_neon.h>
+#define USE_NEON_KERNELS
+#endif
+
 #ifdef G_PLATFORM_WIN32
 #include <stdio.h>
 #include <windows.h>
@@ -125,6 +138,578 @@ static const gchar utf8_skip_data[256] = {
 
 const gchar * const g_utf8_skip = utf8_skip_data;
 
+/* SIMD-based UTF-8 validation originates in the c-utf8 project from
+ * https://github.com/c-util/c-utf8/ from the following authors:
+ *
+ *   David Rheinsberg <david@readahead.eu>
+ *   Evgeny Vereshchagin <evvers@ya.ru>
+ *   Jan Engelhardt <jengelh@inai.de>
+ *   Tom Gundersen <teg@jklm.no>
+ *
+ * It has been adapted for portability and integration.
+ * The original code is dual-licensed Apache-2.0 or LGPLv2.1+
+ */
+
+#define align_to(_val, _to) (((_val) + (_to) - 1) & ~((_to) - 1))
+
+static inline guint8
+load_u8 (gconstpointer memory,
+         gsize         offset)
+{
+  return ((const guint8 *)memory)[offset];
+}
+
+#if G_GNUC_CHECK_VERSION(4,8) || defined(__clang__)
+# define _attribute_aligned(n) __attribute__((aligned(n)))
+#elif defined(_MSC_VER)
+# define _attribute_aligned(n) __declspec(align(n))
+#else
+# define _attribute_aligned(n)
+#endif
+
+static inline gsize
+load_word (gconstpointer memory,
+           gsize         offset)
+{
+#if GLIB_SIZEOF_VOID_P == 8
+  _attribute_aligned(8) const guint8 *m = ((const guint8 *)memory) + offset;
+
+  return ((guint64)m[0] <<  0) | ((guint64)m[1] <<  8) |
+         ((guint64)m[2] << 16) | ((guint64)m[3] << 24) |
+         ((guint64)m[4] << 32) | ((guint64)m[5] << 40) |
+         ((guint64)m[6] << 48) | ((guint64)m[7] << 56);
+#else
+  _attribute_aligned(4) const guint8 *m = ((const guint8 *)memory) + offset;
+
+  return ((guint)m[0] <<  0) | ((guint)m[1] <<  8) |
+         ((guint)m[2] << 16) | ((guint)m[3] << 24);
+#endif
+}
+
+/* The following constants are truncated on 32-bit machines */
+#define UTF8_ASCII_MASK ((gsize)0x8080808080808080L)
+#define UTF8_ASCII_SUB  ((gsize)0x0101010101010101L)
+
+static inline int
+utf8_word_is_ascii (gsize word)
+{
+  /* True unless any byte is NULL or has the MSB set. */
+  return ((((word - UTF8_ASCII_SUB) | word) & UTF8_ASCII_MASK) == 0);
+}
+
+/* The following helpers process a word at a time in the functions below
+ * which only need to know where characters start. Every byte which is not
+ * a continuation byte (0b10xxxxxx) starts a character, so for valid UTF-8
+ * the number of characters in a range of bytes is the number of bytes in
+ * it which are not continuation bytes.
+ */
+
+#define UTF8_BYTE_IS_TAIL(_x) (((guint8) (_x) & 0xC0) == 0x80)
+
+/* Returns the number of continuation bytes in @word */
+static inline gsize
+utf8_word_count_tails (gsize word)
+{
+  /* Set the low bit of each byte whose top two bits are 0b10 */
+  gsize tails = (word & ~(word << 1) & UTF8_ASCII_MASK) >> 7;
+
+  /* Sum those bits into the most significant byte */
+  return (tails * UTF8_ASCII_SUB) >> ((sizeof (gsize) - 1) * 8);
+}
+
+/*
+ * Vector kernels
+ *
+ * Each of these handles whole vectors from the start of a buffer and
+ * returns the number of bytes it handled, leaving the rest to the word at
+ * a time code. SSE2 and NEON are used whenever the compiler targets them,
+ * as they are always available on x86-64 and 64-bit ARM; AVX2 is used
+ * when the CPU has it, which is checked at runtime.
+ *
+ * The kernels for runs of ASCII are called from loops over characters, and
+ * are kept out of line so that inlining them does not slow those loops
+ * down for text with few long runs of ASCII.
+ *
+ * Continuation bytes (0x80 to 0xBF) are exactly the bytes which are
+ * smaller than 0xC0 as signed integers.
+ */
+
+#ifdef HAVE_X86_AVX2_INTRINSICS
+
+static gboolean
+x86_avx2_probe (void)
+{
+  unsigned int eax, ebx, ecx, edx;
+  unsigned int xcr0_lo, xcr0_hi;
+
+  /* The OS must also save the YMM registers on context switches */
+  if (!__get_cpuid (1, &eax, &ebx, &ecx, &edx) ||
+      (ecx & bit_OSXSAVE) == 0 ||
+      (ecx & bit_AVX) == 0)
+    return FALSE;
+
+  __asm__ ("xgetbv" : "=a" (xcr0_lo), "=d" (xcr0_hi) : "c" (0));
+
+  return (xcr0_lo & 0x6) == 0x6 &&
+         __get_cpuid_count (7, 0, &eax, &ebx, &ecx, &edx) &&
+         (ebx & bit_AVX2) != 0;
+}
+
+/* Kept small so that it is inlined into the callers below, which can run
+ * once for every run of ASCII in a string */
+static inline gboolean
+have_x86_avx2 (void)
+{
+  static gsize result = 0;  /* 1 if AVX2 can't be used, 2 if it can */
+
+  if (g_once_init_enter (&result))
+    g_once_init_leave (&result, x86_avx2_probe () ? 2 : 1);
+
+  return result == 2;
+}
+
+__attribute__((target ("avx2")))
+static gsize
+utf8_count_tails_avx2 (const gchar *str,
+                       gsize        len,
+                       gsize       *n_tails)
+{
+  const __m256i tail_max = _mm256_set1_epi8 (-64);
+  const __m256i zero = _mm256_setzero_si256 ();
+  __m256i total = zero;
+  guint64 sums[4];
+  gsize i = 0;
+
+  while (i + 32 <= len)
+    {
+      /* Byte counters can take 255 vectors before they overflow */
+      gsize n = MIN ((len - i) / 32, 255);
+      __m256i counts = zero;
+
+      for (; n > 0; n--, i += 32)
+        {
+          __m256i v = _mm256_loadu_si256 ((const __m256i *) (str + i));
+          counts = _mm256_sub_epi8 (counts, _mm256_cmpgt_epi8 (tail_max, v));
+        }
+
+      total = _mm256_add_epi64 (total, _mm256_sad_epu8 (counts, zero));
+    }
+
+  _mm256_storeu_si256 ((__m256i *) sums, total);
+  *n_tails += sums[0] + sums[1] + sums[2] + sums[3];
+
+  return i;
+}
+
+/* Stops at the first vector which has a byte which is not ASCII, or nul */
+__attribute__((target ("avx2")))
+static gsize
+utf8_skip_ascii_avx2 (const gchar *str,
+                      gsize        len)
+{
+  const __m256i zero = _mm256_setzero_si256 ();
+  gsize i;
+
+  for (i = 0; i + 32 <= len; i += 32)
+    {
+      __m256i v = _mm256_loadu_si256 ((const __m256i *) (str + i));
+
+      if (_mm256_movemask_epi8 (_mm256_or_si256 (v, _mm256_cmpeq_epi8 (v, zero))) != 0)
+        break;
+    }
+
+  return i;
+}
+
+__attribute__((target ("avx2")))
+static gsize
+utf8_widen_ascii_utf16_avx2 (const gchar *str,
+                             gsize        len,
+                             gunichar2   *out)
+{
+  gsize i;
+
+  for (i = 0; i + 32 <= len; i += 32)
+    {
+      __m256i v = _mm256_loadu_si256 ((const __m256i *) (str + i));
+
+      if (_mm256_movemask_epi8 (v) != 0)
+        break;
+
+      _mm256_storeu_si256 ((__m256i *) (out + i),
+                           _mm256_cvtepu8_epi16 (_mm256_castsi256_si128 (v)));
+      _mm256_storeu_si256 ((__m256i *) (out + i + 16),
+                           _mm256_cvtepu8_epi16 (_mm256_extracti128_si256 (v, 1)));
+    }
+
+  return i;
+}
+
+__attribute__((target ("avx2")))
+static gsize
+utf8_widen_ascii_ucs4_avx2 (const gchar *str,
+                            gsize        len,
+                            gunichar    *out)
+{
+  gsize i;
+
+  for (i = 0; i + 32 <= len; i += 32)
+    {
+      __m256i v = _mm256_loadu_si256 ((const __m256i *) (str + i));
+      __m128i lo, hi;
+
+      if (_mm256_movemask_epi8 (v) != 0)
+        break;
+
+      lo = _mm256_castsi256_si128 (v);
+      hi = _mm256_extracti128_si256 (v, 1);
+      _mm256_storeu_si256 ((__m256i *) (out + i), _mm256_cvtepu8_epi32 (lo));
+      _mm256_storeu_si256 ((__m256i *) (out + i + 8), _mm256_cvtepu8_epi32 (_mm_srli_si128 (lo, 8)));
+      _mm256_storeu_si256 ((__m256i *) (out + i + 16), _mm256_cvtepu8_epi32 (hi));
+      _mm256_storeu_si256 ((__m256i *) (out + i + 24), _mm256_cvtepu8_epi32 (_mm_srli_si128 (hi, 8)));
+    }
+
+  return i;
+}
+
+#endif /* HAVE_X86_AVX2_INTRINSICS */
+
+#if defined (USE_SSE2_KERNELS)
+
+static gsize
+utf8_count_tails_vector (const gchar *str,
+                         gsize        len,
+                         gsize       *n_tails)
+{
+  const __m128i tail_max = _mm_set1_epi8 (-64);
+  const __m128i zero = _mm_setzero_si128 ();
+  __m128i total = zero;
+  guint64 sums[2];
+  gsize i = 0;
+
+  while (i + 16 <= len)
+    {
+      /* Byte counters can take 255 vectors before they overflow */
+      gsize n = MIN ((len - i) / 16, 255);
+      __m128i counts = zero;
+
+      for (; n > 0; n--, i += 16)
+        {
+          __m128i v = _mm_loadu_si128 ((const __m128i *) (str + i));
+          counts = _mm_sub_epi8 (counts, _mm_cmplt_epi8 (v, tail_max));
+        }
+
+      total = _mm_add_epi64 (total, _mm_sad_epu8 (counts, zero));
+    }
+
+  _mm_storeu_si128 ((__m128i *) sums, total);
+  *n_tails += sums[0] + sums[1];
+
+  return i;
+}
+
+G_GNUC_NO_INLINE
+static gsize
+utf8_skip_ascii_vector (const gchar *str,
+                        gsize        len)
+{
+  const __m128i zero = _mm_setzero_si128 ();
+  gsize i;
+
+  for (i = 0; i + 16 <= len; i += 16)
+    {
+      __m128i v = _mm_loadu_si128 ((const __m128i *) (str + i));
+
+      if (_mm_movemask_epi8 (_mm_or_si128 (v, _mm_cmpeq_epi8 (v, zero))) != 0)
+        break;
+    }
+
+  return i;
+}
+
+G_GNUC_NO_INLINE
+static gsize
+utf8_widen_ascii_utf16_vector (const gchar *str,
+                               gsize        len,
+                               gunichar2   *out)
+{
+  const __m128i zero = _mm_setzero_si128 ();
+  gsize i;
+
+  for (i = 0; i + 16 <= len; i += 16)
+    {
+      __m128i v = _mm_loadu_si128 ((const __m128i *) (str + i));
+
+      if (_mm_movemask_epi8 (v) != 0)
+        break;
+
+      _mm_storeu_si128 ((__m128i *) (out + i), _mm_unpacklo_epi8 (v, zero));
+      _mm_storeu_si128 ((__m128i *) (out + i + 8), _mm_unpackhi_epi8 (v, zero));
+    }
+
+  return i;
+}
+
+G_GNUC_NO_INLINE
+static gsize
+utf8_widen_ascii_ucs4_vector (const gchar *str,
+                              gsize        len,
+                              gunichar    *out)
+{
+  const __m128i zero = _mm_setzero_si128 ();
+  gsize i;
+
+  for (i = 0; i + 16 <= len; i += 16)
+    {
+      __m128i v = _mm_loadu_si128 ((const __m128i *) (str + i));
+      __m128i lo, hi;
+
+      if (_mm_movemask_epi8 (v) != 0)
+        break;
+
+      lo = _mm_unpacklo_epi8 (v, zero);
+      hi = _mm_unpackhi_epi8 (v, zero);
+      _mm_storeu_si128 ((__m128i *) (out + i), _mm_unpacklo_epi16 (lo, zero));
+      _mm_storeu_si128 ((__m128i *) (out + i + 4), _mm_unpackhi_epi16 (lo, zero));
+      _mm_storeu_si128 ((__m128i *) (out + i + 8), _mm_unpacklo_epi16 (hi, zero));
+      _mm_storeu_si128 ((__m128i *) (out + i + 12), _mm_unpackhi_epi16 (hi, zero));
+    }
+
+  return i;
+}
+
+#elif defined (USE_NEON_KERNELS)
+
+static gsize
+utf8_count_tails_vector (const gchar *str,
+                         gsize        len,
+                         gsize       *n_tails)
+{
+  const int8x16_t tail_max = vdupq_n_s8 (-64);
+  gsize i = 0;
+
+  while (i + 16 <= len)
+    {
+      /* Byte counters can take 255 vectors before they overflow */
+      gsize n = MIN ((len - i) / 16, 255);
+      uint8x16_t counts = vdupq_n_u8 (0);
+
+      for (; n > 0; n--, i += 16)
+        {
+          int8x16_t v = vld1q_s8 ((const int8_t *) (str + i));
+          counts = vsubq_u8 (counts, vcltq_s8 (v, tail_max));
+        }
+
+      *n_tails += vaddlvq_u8 (counts);
+    }
+
+  return i;
+}
+
+G_GNUC_NO_INLINE
+static gsize
+utf8_skip_ascii_vector (const gchar *str,
+                        gsize        len)
+{
+  gsize i;
+
+  for (i = 0; i + 16 <= len; i += 16)
+    {
+      uint8x16_t v = vld1q_u8 ((const uint8_t *) (str + i));
+
+      if (vmaxvq_u8 (v) >= 0x80 || vminvq_u8 (v) == 0)
+        break;
+    }
+
+  return i;
+}
+
+G_GNUC_NO_INLINE
+static gsize
+utf8_widen_ascii_utf16_vector (const gchar *str,
+                               gsize        len,
+                               gunichar2   *out)
+{
+  gsize i;
+
+  for (i = 0; i + 16 <= len; i += 16)
+    {
+      uint8x16_t v = vld1q_u8 ((const uint8_t *) (str + i));
+
+      if (vmaxvq_u8 (v) >= 0x80)
+        break;
+
+      vst1q_u16 (out + i, vmovl_u8 (vget_low_u8 (v)));
+      vst1q_u16 (out + i + 8, vmovl_high_u8 (v));
+    }
+
+  return i;
+}
+
+G_GNUC_NO_INLINE
+static gsize
+utf8_widen_ascii_ucs4_vector (const gchar *str,
+                              gsize        len,
+                              gunichar    *out)
+{
+  gsize i;
+
+  for (i = 0; i + 16 <= len; i += 16)
+    {
+      uint8x16_t v = vld1q_u8 ((const uint8_t *) (str + i));
+      uint16x8_t lo, hi;
+
+      if (vmaxvq_u8 (v) >= 0x80)
+        break;
+
+      lo = vmovl_u8 (vget_low_u8 (v));
+      hi = vmovl_high_u8 (v);
+      vst1q_u32 (out + i, vmovl_u16 (vget_low_u16 (lo)));
+      vst1q_u32 (out + i + 4, vmovl_high_u16 (lo));
+      vst1q_u32 (out + i + 8, vmovl_u16 (vget_low_u16 (hi)));
+      vst1q_u32 (out + i + 12, vmovl_high_u16 (hi));
+    }
+
+  return i;
+}
+
+#endif
+
+/* Adds the number of continuation bytes in the first bytes of @str to
+ * @n_tails, and returns how many bytes that covered */
+static inline gsize
+utf8_count_tails_fast (const gchar *str,
+                       gsize        len,
+                       gsize       *n_tails)
+{
+  gsize i = 0;
+
+#ifdef HAVE_X86_AVX2_INTRINSICS
+  if (len >= 32 && have_x86_avx2 ())
+    i = utf8_count_tails_avx2 (str, len, n_tails);
+#endif
+#if defined (USE_SSE2_KERNELS) || defined (USE_NEON_KERNELS)
+  i += utf8_count_tails_vector (str + i, len - i, n_tails);
+#endif
+
+  return i;
+}
+
+/* Returns the length of a run of ASCII bytes other than nul at the start
+ * of @str, in whole vectors */
+static inline gsize
+utf8_skip_ascii_fast (const gchar *str,
+                      gsize        len)
+{
+  gsize i = 0;
+
+#ifdef HAVE_X86_AVX2_INTRINSICS
+  if (len >= 32 && have_x86_avx2 ())
+    i = utf8_skip_ascii_avx2 (str, len);
+#endif
+#if defined (USE_SSE2_KERNELS) || defined (USE_NEON_KERNELS)
+  i += utf8_skip_ascii_vector (str + i, len - i);
+#endif
+
+  return i;
+}
+
+/* Copies a run of ASCII at the start of @str to @out, widening each byte
+ * to a UTF-16 unit, in whole vectors; returns the number of bytes copied */
+static inline gsize
+utf8_widen_ascii_utf16_fast (const gchar *str,
+                             gsize        len,
+                             gunichar2   *out)
+{
+  gsize i = 0;
+
+#ifdef HAVE_X86_AVX2_INTRINSICS
+  if (len >= 32 && have_x86_avx2 ())
+    i = utf8_widen_ascii_utf16_avx2 (str, len, out);
+#endif
+#if defined (USE_SSE2_KERNELS) || defined (USE_NEON_KERNELS)
+  i += utf8_widen_ascii_utf16_vector (str + i, len - i, out + i);
+#endif
+
+  return i;
+}
+
+/* Likewise, widening each byte to a #gunichar */
+static inline gsize
+utf8_widen_ascii_ucs4_fast (const gchar *str,
+                            gsize        len,
+                            gunichar    *out)
+{
+  gsize i = 0;
+
+#ifdef HAVE_X86_AVX2_INTRINSICS
+  if (len >= 32 && have_x86_avx2 ())
+    i = utf8_widen_ascii_ucs4_avx2 (str, len, out);
+#endif
+#if defined (USE_SSE2_KERNELS) || defined (USE_NEON_KERNELS)
+  i += utf8_widen_ascii_ucs4_vector (str + i, len - i, out + i);
+#endif
+
+  return i;
+}
+
+/* The ASCII kernels above are only worth calling once a run of ASCII is
+ * known to fill a whole vector; shorter runs between other characters are
+ * cheaper to handle a word at a time. @str must have
+ * %UTF8_VECTOR_SIZE bytes. */
+#define UTF8_VECTOR_SIZE 16
+
+static inline gboolean
+utf8_vector_is_ascii (const gchar *str)
+{
+  gsize words[UTF8_VECTOR_SIZE / sizeof (gsize)];
+  gsize word = 0;
+  gsize j;
+
+  /* Byte order doesn't matter here, so this can load whole words */
+  memcpy (words, str, sizeof (words));
+  for (j = 0; j < G_N_ELEMENTS (words); j++)
+    word |= words[j];
+
+  return (word & UTF8_ASCII_MASK) == 0;
+}
+
+static gsize
+utf8_count_chars (const gchar *str,
+                  gsize        len)
+{
+  gsize n_tails = 0;
+  gsize i;
+
+  i = utf8_count_tails_fast (str, len, &n_tails);
+
+  for (; i + sizeof (gsize) <= len; i += sizeof (gsize))
+    n_tails += utf8_word_count_tails (load_word (str, i));
+
+  for (; i < len; i++)
+    n_tails += UTF8_BYTE_IS_TAIL (load_u8 (str, i));
+
+  return len - n_tails;
+}
+
+/* Returns whether the last character which starts in the first @len bytes
+ * of @str does not end within them */
+static gboolean
+utf8_ends_in_partial_char (const gchar *str,
+                           gsize        len)
+{
+  gsize i = len;
+
+  while (i > 0 && len - i < 6)
+    {
+      i--;
+      if (!UTF8_BYTE_IS_TAIL (load_u8 (str, i)))
+        return i + g_utf8_skip[load_u8 (str, i)] > len;
+    }
+
+  return FALSE;
+}
+
 /**
  * g_utf8_find_prev_char:
  * @str: pointer to the beginning of a UTF-8 encoded string
@@ -235,37 +820,25 @@ glong
 g_utf8_strlen (const gchar *p,
                gssize       max)
 {
-  glong len = 0;
-  const gchar *start = p;
+  const gchar *nul;
+  gsize n_bytes;
+  glong len;
+
   g_return_val_if_fail (p != NULL || max == 0, 0);
 
   if (max < 0)
-    {
-      while (*p)
-        {
-          p = g_utf8_next_char (p);
-          ++len;
-        }
-    }
-  else
-    {
-      if (max == 0 || !*p)
-        return 0;
+    return utf8_count_chars (p, strlen (p));
 
-      p = g_utf8_next_char (p);
+  if (max == 0)
+    return 0;
 
-      while (p - start < max && *p)
-        {
-          ++len;
-          p = g_utf8_next_char (p);
-        }
+  nul = memchr (p, '\0', max);
+  n_bytes = nul != NULL ? (gsize) (nul - p) : (gsize) max;
+  len = utf8_count_chars (p, n_bytes);
 
-      /* only do the last len increment if we got a complete
-       * char (don't count partial chars)
-       */
-      if (p - start <= max)
-        ++len;
-    }
+  /* don't count a partial char at the end */
+  if (utf8_ends_in_partial_char (p, n_bytes))
+    --len;
 
   return len;
 }
@@ -371,9 +944,29 @@ g_utf8_offset_to_pointer  (const gchar *str,
 {
   const gchar *s = str;
 
-  if (offset > 0) 
-    while (offset--)
-      s = g_utf8_next_char (s);
+  if (offset > 0)
+    {
+      /* The target is at least @offset bytes away, so while @offset is
+       * at least a word, the whole of the next word can be read. Only the
+       * bytes in it which start characters are counted, so it does not
+       * matter if it ends in the middle of one. */
+      if ((gsize) offset >= sizeof (gsize))
+        {
+          do
+            {
+              offset -= sizeof (gsize) - utf8_word_count_tails (load_word (s, 0));
+              s += sizeof (gsize);
+            }
+          while ((gsize) offset >= sizeof (gsize));
+
+          /* finish the character the last word ended in, if any */
+          while (UTF8_BYTE_IS_TAIL (*s))
+            s++;
+        }
+
+      while (offset--)
+        s = g_utf8_next_char (s);
+    }
   else
     {
       const char *s1;
@@ -418,13 +1011,13 @@ g_utf8_pointer_to_offset (const gchar *str,
 
   if (pos < str) 
     offset = - g_utf8_pointer_to_offset (pos, str);
-  else
-    while (s < pos)
-      {
-	s = g_utf8_next_char (s);
-	offset++;
-      }
-  
+  else if (pos > str)
+    {
+      /* count the characters which start before @pos, including one
+       * which @pos is in the middle of */
+      offset = utf8_count_chars (s, pos - s);
+    }
+
   return offset;
 }
 
@@ -815,37 +1408,61 @@ g_utf8_to_ucs4_fast (const gchar *str,
 {
   gunichar *result;
   gint n_chars, i;
-  const gchar *p;
+  const gchar *p, *end;
 
   g_return_val_if_fail (str != NULL, NULL);
 
-  p = str;
-  n_chars = 0;
   if (len < 0)
-    {
-      while (*p)
-	{
-	  p = g_utf8_next_char (p);
-	  ++n_chars;
-	}
-    }
+    end = str + strlen (str);
   else
     {
-      while (p < str + len && *p)
-	{
-	  p = g_utf8_next_char (p);
-	  ++n_chars;
-	}
+      end = memchr (str, '\0', len);
+      if (end == NULL)
+        end = str + len;
     }
+
+  n_chars = utf8_count_chars (str, end - str);
   
   result = g_new (gunichar, n_chars + 1);
   
   p = str;
   for (i=0; i < n_chars; i++)
     {
-      guchar first = (guchar)*p++;
+      guchar first;
       gunichar wc;
 
+      /* widen runs of ASCII a vector, or a word, at a time */
+      while ((gsize) (n_chars - i) >= sizeof (gsize) &&
+             (gsize) (end - p) >= sizeof (gsize) &&
+             (load_word (p, 0) & UTF8_ASCII_MASK) == 0)
+        {
+          gsize n_ascii = 0;
+
+          if ((gsize) (n_chars - i) >= UTF8_VECTOR_SIZE &&
+              (gsize) (end - p) >= UTF8_VECTOR_SIZE &&
+              utf8_vector_is_ascii (p))
+            n_ascii = utf8_widen_ascii_ucs4_fast (p, MIN ((gsize) (n_chars - i), (gsize) (end - p)),
+                                                  result + i);
+
+          if (n_ascii == 0)
+            {
+              gsize j;
+
+              for (j = 0; j < sizeof (gsize); j++)
+                result[i + j] = load_u8 (p, j);
+
+              n_ascii = sizeof (gsize);
+            }
+
+          i += n_ascii;
+          p += n_ascii;
+        }
+
+      if (i == n_chars)
+        break;
+
+      first = (guchar)*p++;
+
       if (first < 0xc0)
 	{
           /* We really hope first < 0x80, but we don't want to test an
@@ -1397,15 +2014,38 @@ g_utf8_to_utf16 (const gchar *str,
   gunichar2 *result = NULL;
   gint n16;
   const gchar *in;
+  const gchar *end;
   gint i;
 
   g_return_val_if_fail (str != NULL, NULL);
 
+  end = str + (len < 0 ? (glong) strlen (str) : len);
+
   in = str;
   n16 = 0;
   while ((len < 0 || str + len - in > 0) && *in)
     {
-      gunichar wc = g_utf8_get_char_extended (in, len < 0 ? 6 : str + len - in);
+      gunichar wc;
+
+      /* skip runs of ASCII a vector, or a word, at a time */
+      if ((gsize) (end - in) >= sizeof (gsize) &&
+          utf8_word_is_ascii (load_word (in, 0)))
+        {
+          gsize n_ascii = 0;
+
+          if ((gsize) (end - in) >= UTF8_VECTOR_SIZE && utf8_vector_is_ascii (in))
+            n_ascii = utf8_skip_ascii_fast (in, end - in);
+
+          /* the kernel stops short of a nul */
+          if (n_ascii == 0)
+            n_ascii = sizeof (gsize);
+
+          n16 += n_ascii;
+          in += n_ascii;
+          continue;
+        }
+
+      wc = g_utf8_get_char_extended (in, len < 0 ? 6 : str + len - in);
       if (wc & 0x80000000)
 	{
 	  if (wc == (gunichar)-2)
@@ -1454,7 +2094,34 @@ g_utf8_to_utf16 (const gchar *str,
   in = str;
   for (i = 0; i < n16;)
     {
-      gunichar wc = g_utf8_get_char (in);
+      gunichar wc;
+
+      /* @in has been validated, and every UTF-16 unit left to write
+       * comes from at least one byte, so this does not read past it */
+      if ((gsize) (n16 - i) >= sizeof (gsize) &&
+          (load_word (in, 0) & UTF8_ASCII_MASK) == 0)
+        {
+          gsize n_ascii = 0;
+
+          if ((gsize) (n16 - i) >= UTF8_VECTOR_SIZE && utf8_vector_is_ascii (in))
+            n_ascii = utf8_widen_ascii_utf16_fast (in, n16 - i, result + i);
+
+          if (n_ascii == 0)
+            {
+              gsize j;
+
+              for (j = 0; j < sizeof (gsize); j++)
+                result[i + j] = load_u8 (in, j);
+
+              n_ascii = sizeof (gsize);
+            }
+
+          i += n_ascii;
+          in += n_ascii;
+          continue;
+        }
+
+      wc = g_utf8_get_char (in);
 
       if (wc < 0x10000)
 	{
@@ -1574,65 +2241,6 @@ g_ucs4_to_utf16 (const gunichar  *str,
   return result;
 }
 
-/* SIMD-based UTF-8 validation originates in the c-utf8 project from
- * https://github.com/c-util/c-utf8/ from the following authors:
- *
- *   David Rheinsberg <david@readahead.eu>
- *   Evgeny Vereshchagin <evvers@ya.ru>
- *   Jan Engelhardt <jengelh@inai.de>
- *   Tom Gundersen <teg@jklm.no>
- *
- * It has been adapted for portability and integration.
- * The original code is dual-licensed Apache-2.0 or LGPLv2.1+
- */
-
-#define align_to(_val, _to) (((_val) + (_to) - 1) & ~((_to) - 1))
-
-static inline guint8
-load_u8 (gconstpointer memory,
-         gsize         offset)
-{
-  return ((const guint8 *)memory)[offset];
-}
-
-#if G_GNUC_CHECK_VERSION(4,8) || defined(__clang__)
-# define _attribute_aligned(n) __attribute__((aligned(n)))
-#elif defined(_MSC_VER)
-# define _attribute_aligned(n) __declspec(align(n))
-#else
-# define _attribute_aligned(n)
-#endif
-
-static inline gsize
-load_word (gconstpointer memory,
-           gsize         offset)
-{
-#if GLIB_SIZEOF_VOID_P == 8
-  _attribute_aligned(8) const guint8 *m = ((const guint8 *)memory) + offset;
-
-  return ((guint64)m[0] <<  0) | ((guint64)m[1] <<  8) |
-         ((guint64)m[2] << 16) | ((guint64)m[3] << 24) |
-         ((guint64)m[4] << 32) | ((guint64)m[5] << 40) |
-         ((guint64)m[6] << 48) | ((guint64)m[7] << 56);
-#else
-  _attribute_aligned(4) const guint8 *m = ((const guint8 *)memory) + offset;
-
-  return ((guint)m[0] <<  0) | ((guint)m[1] <<  8) |
-         ((guint)m[2] << 16) | ((guint)m[3] << 24);
-#endif
-}
-
-/* The following constants are truncated on 32-bit machines */
-#define UTF8_ASCII_MASK ((gsize)0x8080808080808080L)
-#define UTF8_ASCII_SUB  ((gsize)0x0101010101010101L)
-
-static inline int
-utf8_word_is_ascii (gsize word)
-{
-  /* True unless any byte is NULL or has the MSB set. */
-  return ((((word - UTF8_ASCII_SUB) | word) & UTF8_ASCII_MASK) == 0);
-}
-
 static void
 utf8_verify_ascii (const char **strp,
                    gsize       *lenp)
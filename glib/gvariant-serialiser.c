@@ -27,8 +27,10 @@
 #include "gvariant-serialiser.h"
 
 #include <glib/gvariant-internal.h>
+#include <glib/gatomic.h>
 #include <glib/gtestutils.h>
 #include <glib/gstrfuncs.h>
+#include <glib/gthread.h>
 #include <glib/gtypes.h>
 
 #include <string.h>
@@ -448,8 +450,90 @@ gvs_variable_sized_maybe_is_normal (GVariantSerialised value)
  * In the event that a fixed-sized array is presented with a size that
  * is not an integer multiple of the element size then the value of the
  * array must be taken as being empty.
+ *
+ * Arrays of numbers are common and can be large, so normal form
+ * checking and byteswapping handle them as a whole rather than
+ * dispatching on each element.  The loops for this are simple enough
+ * for the compiler to vectorise.
  */
 
+/* Every possible value of these types is in normal form.  Booleans are
+ * not included, as only 0 and 1 are valid. */
+static gboolean
+gvs_type_info_is_numeric (GVariantTypeInfo *type_info)
+{
+  switch (g_variant_type_info_get_type_char (type_info))
+    {
+    case 'y': case 'n': case 'q': case 'i': case 'u':
+    case 'x': case 't': case 'h': case 'd':
+      return TRUE;
+
+    default:
+      return FALSE;
+    }
+}
+
+/* If @type_info is an array whose elements are a single integer (or a
+ * tuple of one), returns the size of the elements, otherwise 0. */
+static gsize
+gvs_fixed_sized_array_get_swap_size (GVariantTypeInfo *type_info)
+{
+  gsize element_fixed_size;
+  guint element_alignment;
+
+  if (g_variant_type_info_get_type_char (type_info) != G_VARIANT_TYPE_INFO_CHAR_ARRAY)
+    return 0;
+
+  g_variant_type_info_query (g_variant_type_info_element (type_info),
+                             &element_alignment, &element_fixed_size);
+
+  if (element_alignment == 0 || element_alignment + 1 != element_fixed_size)
+    return 0;
+
+  return element_fixed_size;
+}
+
+static void
+gvs_fixed_sized_array_byteswap (guchar *data,
+                                gsize   size,
+                                gsize   element_size)
+{
+  gsize i;
+
+  switch (element_size)
+    {
+    case 2:
+      {
+        guint16 *ptr = (guint16 *) data;
+
+        for (i = 0; i < size / 2; i++)
+          ptr[i] = GUINT16_SWAP_LE_BE (ptr[i]);
+      }
+      break;
+
+    case 4:
+      {
+        guint32 *ptr = (guint32 *) data;
+
+        for (i = 0; i < size / 4; i++)
+          ptr[i] = GUINT32_SWAP_LE_BE (ptr[i]);
+      }
+      break;
+
+    case 8:
+      {
+        guint64 *ptr = (guint64 *) data;
+
+        for (i = 0; i < size / 8; i++)
+          ptr[i] = GUINT64_SWAP_LE_BE (ptr[i]);
+      }
+      break;
+
+    default:
+      g_assert_not_reached ();
+    }
+}
+
 static gsize
 gvs_fixed_sized_array_n_children (GVariantSerialised value)
 {
@@ -525,6 +609,23 @@ gvs_fixed_sized_array_is_normal (GVariantSerialised value)
   if (value.size % child.size != 0)
     return FALSE;
 
+  if (child.depth < G_VARIANT_MAX_RECURSION_DEPTH)
+    {
+      if (gvs_type_info_is_numeric (child.type_info))
+        return TRUE;
+
+      if (g_variant_type_info_get_type_char (child.type_info) == 'b')
+        {
+          guchar bits = 0;
+          gsize i;
+
+          for (i = 0; i < value.size; i++)
+            bits |= value.data[i];
+
+          return bits < 2;
+        }
+    }
+
   for (child.data = value.data;
        child.data < value.data + value.size;
        child.data += child.size)
@@ -888,37 +989,42 @@ gvs_variable_sized_array_serialise (GVariantSerialised        value,
     }
 }
 
+/* Checks the elements from @start up to (but not including) @end.  The
+ * offsets before @start must be checked separately.  If @failed is
+ * non-%NULL, give up early once it has been set by another thread. */
 static gboolean
-gvs_variable_sized_array_is_normal (GVariantSerialised value)
+gvs_variable_sized_array_range_is_normal (GVariantSerialised    value,
+                                          const struct Offsets *offsets,
+                                          gsize                 start,
+                                          gsize                 end,
+                                          const gint           *failed)
 {
   GVariantSerialised child = { 0, };
   guint alignment;
   gsize offset;
   gsize i;
 
-  struct Offsets offsets = gvs_variable_sized_array_get_frame_offsets (value);
-
-  if (!offsets.is_normal)
-    return FALSE;
-
-  if (value.size != 0 && offsets.length == 0)
-    return FALSE;
-
-  g_assert (value.size != 0 || offsets.length == 0);
-
   child.type_info = g_variant_type_info_element (value.type_info);
   g_variant_type_info_query (child.type_info, &alignment, NULL);
   child.depth = value.depth + 1;
-  offset = 0;
 
-  for (i = 0; i < offsets.length; i++)
+  if (start > 0)
+    offset = gvs_read_unaligned_le (offsets->array + offsets->offset_size * (start - 1),
+                                    offsets->offset_size);
+  else
+    offset = 0;
+
+  for (i = start; i < end; i++)
     {
       gsize this_end;
 
-      this_end = gvs_read_unaligned_le (offsets.array + offsets.offset_size * i,
-                                        offsets.offset_size);
+      if (failed != NULL && (i % 1024) == 0 && g_atomic_int_get (failed))
+        return FALSE;
 
-      if (this_end < offset || this_end > offsets.data_size)
+      this_end = gvs_read_unaligned_le (offsets->array + offsets->offset_size * i,
+                                        offsets->offset_size);
+
+      if (this_end < offset || this_end > offsets->data_size)
         return FALSE;
 
       while (offset & alignment)
@@ -940,7 +1046,132 @@ gvs_variable_sized_array_is_normal (GVariantSerialised value)
       offset = this_end;
     }
 
-  g_assert (offset == offsets.data_size);
+  return TRUE;
+}
+
+/* Large arrays are split into ranges of at least
+ * GVS_PARALLEL_MIN_RANGE_SIZE bytes of elements, which are checked by
+ * as many threads as there are processors to run them.  Neighbouring
+ * ranges only share the offset at their boundary, which both of them
+ * check against, so together they check exactly what a single pass
+ * would.
+ *
+ * Arrays nested inside a range are checked on the thread handling that
+ * range, so that threads are only ever started for the outermost large
+ * array. */
+#define GVS_PARALLEL_MIN_RANGE_SIZE (1024 * 1024)
+#define GVS_PARALLEL_MAX_RANGES     64
+#define GVS_PARALLEL_MAX_THREADS    16
+
+static GPrivate gvs_in_parallel_check;
+
+struct ParallelCheck
+{
+  GVariantSerialised    value;
+  const struct Offsets *offsets;
+  gsize                 range_length;
+  guint                 n_ranges;
+  gint                  next_range;  /* (atomic) */
+  gint                  failed;      /* (atomic) */
+};
+
+static void
+gvs_parallel_check_run (struct ParallelCheck *check)
+{
+  gboolean was_in_parallel_check;
+
+  was_in_parallel_check = g_private_get (&gvs_in_parallel_check) != NULL;
+  g_private_set (&gvs_in_parallel_check, GINT_TO_POINTER (TRUE));
+
+  while (!g_atomic_int_get (&check->failed))
+    {
+      guint i = (guint) g_atomic_int_add (&check->next_range, 1);
+      gsize start, end;
+
+      if (i >= check->n_ranges)
+        break;
+
+      start = check->range_length * i;
+      end = (i + 1 < check->n_ranges) ? start + check->range_length : check->offsets->length;
+
+      if (!gvs_variable_sized_array_range_is_normal (check->value, check->offsets,
+                                                     start, end, &check->failed))
+        g_atomic_int_set (&check->failed, TRUE);
+    }
+
+  g_private_set (&gvs_in_parallel_check, GINT_TO_POINTER (was_in_parallel_check));
+}
+
+static gpointer
+gvs_parallel_check_thread (gpointer data)
+{
+  gvs_parallel_check_run (data);
+
+  return NULL;
+}
+
+static gboolean
+gvs_variable_sized_array_is_normal_parallel (GVariantSerialised    value,
+                                             const struct Offsets *offsets,
+                                             guint                 n_ranges)
+{
+  struct ParallelCheck check = { 0, };
+  GThread *threads[GVS_PARALLEL_MAX_THREADS - 1];
+  guint n_threads;
+  guint i;
+
+  check.value = value;
+  check.offsets = offsets;
+  check.range_length = offsets->length / n_ranges;
+  check.n_ranges = n_ranges;
+
+  /* This thread takes part too, so start one fewer */
+  n_threads = MIN ((guint) g_get_num_processors (), n_ranges);
+  n_threads = MIN (n_threads, GVS_PARALLEL_MAX_THREADS) - 1;
+
+  for (i = 0; i < n_threads; i++)
+    threads[i] = g_thread_try_new ("gvariant-check", gvs_parallel_check_thread,
+                                   &check, NULL);
+
+  gvs_parallel_check_run (&check);
+
+  for (i = 0; i < n_threads; i++)
+    if (threads[i] != NULL)
+      g_thread_join (threads[i]);
+
+  return !g_atomic_int_get (&check.failed);
+}
+
+static gboolean
+gvs_variable_sized_array_is_normal (GVariantSerialised value)
+{
+  gsize n_ranges;
+
+  struct Offsets offsets = gvs_variable_sized_array_get_frame_offsets (value);
+
+  if (!offsets.is_normal)
+    return FALSE;
+
+  if (value.size != 0 && offsets.length == 0)
+    return FALSE;
+
+  g_assert (value.size != 0 || offsets.length == 0);
+
+  n_ranges = offsets.data_size / GVS_PARALLEL_MIN_RANGE_SIZE;
+  n_ranges = MIN (n_ranges, GVS_PARALLEL_MAX_RANGES);
+  n_ranges = MIN (n_ranges, offsets.length);
+
+  if (n_ranges > 1 && g_private_get (&gvs_in_parallel_check) == NULL)
+    {
+      if (!gvs_variable_sized_array_is_normal_parallel (value, &offsets, n_ranges))
+        return FALSE;
+    }
+  else
+    {
+      if (!gvs_variable_sized_array_range_is_normal (value, &offsets,
+                                                     0, offsets.length, NULL))
+        return FALSE;
+    }
 
   /* All offsets have now been checked. */
   value.ordered_offsets_up_to = G_MAXSIZE;
@@ -1670,6 +1901,58 @@ g_variant_serialiser_needed_size (GVariantTypeInfo         *type_info,
   g_assert_not_reached ();
 }
 
+/* < private >
+ * g_variant_serialiser_framed_size:
+ * @body_size: the size of the data of the children of a container
+ * @n_offsets: the number of framing offsets the container needs
+ *
+ * Determines the total size of an array or tuple with @body_size bytes
+ * of child data and @n_offsets framing offsets, using the smallest
+ * offset size which can represent it.
+ *
+ * This, together with g_variant_serialiser_write_offsets(), allows a
+ * container to be serialized as its children are added, rather than by
+ * g_variant_serialiser_serialise() once they are all known.
+ */
+gsize
+g_variant_serialiser_framed_size (gsize body_size,
+                                  gsize n_offsets)
+{
+  return gvs_calculate_total_size (body_size, n_offsets);
+}
+
+/* < private >
+ * g_variant_serialiser_write_offsets:
+ * @data: the start of the serialized container
+ * @size: the total size of the container, from
+ *   g_variant_serialiser_framed_size()
+ * @offsets: the framing offsets, relative to @data
+ * @n_offsets: the length of @offsets
+ * @reversed: %TRUE to store the offsets in reverse, as tuples do
+ *
+ * Writes the framing offsets to the end of a container whose children
+ * have already been serialized to the start of @data.
+ */
+void
+g_variant_serialiser_write_offsets (guchar      *data,
+                                    gsize        size,
+                                    const gsize *offsets,
+                                    gsize        n_offsets,
+                                    gboolean     reversed)
+{
+  guint offset_size = gvs_get_offset_size (size);
+  guchar *offset_ptr = data + size - offset_size * n_offsets;
+  gsize i;
+
+  for (i = 0; i < n_offsets; i++)
+    {
+      gsize offset = offsets[reversed ? n_offsets - 1 - i : i];
+
+      gvs_write_unaligned_le (offset_ptr, offset, offset_size);
+      offset_ptr += offset_size;
+    }
+}
+
 /* Byteswapping {{{2 */
 
 /* < private >
@@ -1682,6 +1965,7 @@ g_variant_serialiser_needed_size (GVariantTypeInfo         *type_info,
 void
 g_variant_serialised_byteswap (GVariantSerialised serialised)
 {
+  gsize element_size;
   gsize fixed_size;
   guint alignment;
 
@@ -1738,6 +2022,19 @@ g_variant_serialised_byteswap (GVariantSerialised serialised)
       }
     }
 
+  /* arrays of such values can be swapped in one go, without
+   * visiting each child.
+   */
+  else if ((element_size = gvs_fixed_sized_array_get_swap_size (serialised.type_info)))
+    {
+      /* a size which isn't a multiple of the element size means the
+       * array is empty, as in gvs_fixed_sized_array_n_children()
+       */
+      if (serialised.size % element_size == 0)
+        gvs_fixed_sized_array_byteswap (serialised.data, serialised.size,
+                                        element_size);
+    }
+
   /* else, we have a container that potentially contains
    * some children that need to be byteswapped.
    */
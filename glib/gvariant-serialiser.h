@@ -77,6 +77,17 @@ void                            g_variant_serialiser_serialise          (GVarian
                                                                          const gpointer           *children,
                                                                          gsize                     n_children);
 
+/* incremental serialization */
+GLIB_AVAILABLE_IN_2_86
+gsize                           g_variant_serialiser_framed_size        (gsize                     body_size,
+                                                                         gsize                     n_offsets);
+GLIB_AVAILABLE_IN_2_86
+void                            g_variant_serialiser_write_offsets      (guchar                   *data,
+                                                                         gsize                     size,
+                                                                         const gsize              *offsets,
+                                                                         gsize                     n_offsets,
+                                                                         gboolean                  reversed);
+
 /* misc */
 GLIB_AVAILABLE_IN_2_60
 gboolean                        g_variant_serialised_check              (GVariantSerialised        serialised);
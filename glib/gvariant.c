@@ -3207,11 +3207,38 @@ struct stack_builder
   /* If @type was copied when constructing the builder */
   guint type_owned : 1;
 
+  /* for builders initialised with g_variant_builder_init_serialised(),
+   * the buffer which the value is serialised into as it is built (shared
+   * with all subcontainers), the type info for @type, and where this
+   * container's data and framing offsets start in the buffer.
+   * @children is unused in this case.
+   */
+  struct builder_arena *arena;
+  GVariantTypeInfo *type_info;
+  gsize arena_start;
+  gsize arena_offsets_start;
+
   gsize magic;
 };
 
 G_STATIC_ASSERT (sizeof (struct stack_builder) <= sizeof (GVariantBuilder));
 
+struct builder_arena
+{
+  /* the serialised data of all complete children so far */
+  guchar *data;
+  gsize size;
+  gsize allocated;
+
+  /* the framing offsets of the children of all open containers which
+   * need them, with each container's starting at its
+   * arena_offsets_start
+   */
+  gsize *offsets;
+  gsize n_offsets;
+  gsize allocated_offsets;
+};
+
 struct heap_builder
 {
   GVariantBuilder builder;
@@ -3228,6 +3255,69 @@ struct heap_builder
 #define is_valid_builder(b)      (GVSB(b)->magic == GVSB_MAGIC)
 #define is_valid_heap_builder(b) (GVHB(b)->magic == GVHB_MAGIC)
 
+static struct builder_arena *
+builder_arena_new (void)
+{
+  struct builder_arena *arena;
+
+  arena = g_new0 (struct builder_arena, 1);
+  arena->allocated = 64;
+  arena->data = g_malloc (arena->allocated);
+
+  return arena;
+}
+
+static void
+builder_arena_free (struct builder_arena *arena)
+{
+  g_free (arena->data);
+  g_free (arena->offsets);
+  g_free (arena);
+}
+
+/* Returns a pointer to @size new bytes at the end of the arena, which
+ * are only valid until the next call. */
+static guchar *
+builder_arena_append (struct builder_arena *arena,
+                      gsize                 size)
+{
+  guchar *data;
+
+  if (arena->allocated - arena->size < size)
+    {
+      arena->allocated = MAX (arena->allocated * 2, arena->size + size);
+      arena->data = g_realloc (arena->data, arena->allocated);
+    }
+
+  data = arena->data + arena->size;
+  arena->size += size;
+
+  return data;
+}
+
+static void
+builder_arena_align (struct builder_arena *arena,
+                     guint                 alignment)
+{
+  gsize padding = (-arena->size) & alignment;
+
+  if (padding)
+    memset (builder_arena_append (arena, padding), 0, padding);
+}
+
+static void
+builder_arena_push_offset (struct builder_arena *arena,
+                           gsize                 offset)
+{
+  if (arena->n_offsets == arena->allocated_offsets)
+    {
+      arena->allocated_offsets = MAX (arena->allocated_offsets * 2, 16);
+      arena->offsets = g_renew (gsize, arena->offsets, arena->allocated_offsets);
+    }
+
+  arena->offsets[arena->n_offsets++] = offset;
+}
+
 /* Just to make sure that by adding a union to GVariantBuilder, we
  * didn't accidentally change ABI. */
 G_STATIC_ASSERT (sizeof (GVariantBuilder) == sizeof (guintptr[16]));
@@ -3389,30 +3479,58 @@ g_variant_builder_clear (GVariantBuilder *builder)
   if (GVSB(builder)->type_owned)
     g_variant_type_free (GVSB(builder)->type);
 
-  for (i = 0; i < GVSB(builder)->offset; i++)
-    g_variant_unref (GVSB(builder)->children[i]);
+  if (GVSB(builder)->children != NULL)
+    for (i = 0; i < GVSB(builder)->offset; i++)
+      g_variant_unref (GVSB(builder)->children[i]);
 
   g_free (GVSB(builder)->children);
 
+  if (GVSB(builder)->type_info != NULL)
+    g_variant_type_info_unref (GVSB(builder)->type_info);
+
   if (GVSB(builder)->parent)
     {
       g_variant_builder_clear (GVSB(builder)->parent);
       g_slice_free (GVariantBuilder, GVSB(builder)->parent);
     }
+  else if (GVSB(builder)->arena != NULL)
+    builder_arena_free (GVSB(builder)->arena);
 
   memset (builder, 0, sizeof (GVariantBuilder));
 }
 
+/* If @arena is non-%NULL, @type_info must be a reference to the type
+ * info for @type, which the builder takes. */
 static void
-_g_variant_builder_init (GVariantBuilder    *builder,
-                         const GVariantType *type,
-                         gboolean            type_owned)
+_g_variant_builder_init (GVariantBuilder      *builder,
+                         const GVariantType   *type,
+                         gboolean              type_owned,
+                         struct builder_arena *arena,
+                         GVariantTypeInfo     *type_info)
 {
   g_return_if_fail (type != NULL);
   g_return_if_fail (g_variant_type_is_container (type));
 
   memset (builder, 0, sizeof (GVariantBuilder));
 
+  if (arena != NULL)
+    {
+      guint alignment;
+
+      /* the type info keeps a copy of the type string, so there is
+       * no need to copy @type */
+      g_assert (!type_owned);
+      type = G_VARIANT_TYPE (g_variant_type_info_get_type_string (type_info));
+
+      g_variant_type_info_query (type_info, &alignment, NULL);
+      builder_arena_align (arena, alignment);
+
+      GVSB(builder)->arena = arena;
+      GVSB(builder)->type_info = type_info;
+      GVSB(builder)->arena_start = arena->size;
+      GVSB(builder)->arena_offsets_start = arena->n_offsets;
+    }
+
   GVSB(builder)->type = (GVariantType *)type;
   GVSB(builder)->magic = GVSB_MAGIC;
   GVSB(builder)->trusted = TRUE;
@@ -3476,6 +3594,9 @@ _g_variant_builder_init (GVariantBuilder    *builder,
       g_assert_not_reached ();
    }
 
+  if (arena != NULL)
+    return;
+
 #if G_ANALYZER_ANALYZING
   /* Static analysers can’t couple the code in g_variant_builder_init() to the
    * code in g_variant_builder_end() by GVariantType, so end up assuming that
@@ -3536,7 +3657,7 @@ void
 g_variant_builder_init (GVariantBuilder    *builder,
                         const GVariantType *type)
 {
-  _g_variant_builder_init (builder, g_variant_type_copy (type), TRUE);
+  _g_variant_builder_init (builder, g_variant_type_copy (type), TRUE, NULL, NULL);
 }
 
 /**
@@ -3557,7 +3678,166 @@ void
 g_variant_builder_init_static (GVariantBuilder    *builder,
                                const GVariantType *type)
 {
-  _g_variant_builder_init (builder, type, FALSE);
+  _g_variant_builder_init (builder, type, FALSE, NULL, NULL);
+}
+
+/**
+ * g_variant_builder_init_serialised: (skip)
+ * @builder: a #GVariantBuilder
+ * @type: a definite container type
+ *
+ * Initialises a #GVariantBuilder structure to serialise values as they
+ * are added.
+ *
+ * The builder is used in the same way as one initialised with
+ * g_variant_builder_init(), but instead of keeping a #GVariant for each
+ * child until g_variant_builder_end() is called, each child is written
+ * straight into a single growing buffer.  Subcontainers opened with
+ * g_variant_builder_open() are written into the same buffer, and values
+ * of basic types added with g_variant_builder_add() do not allocate a
+ * #GVariant at all.  g_variant_builder_end() then returns a #GVariant
+ * which takes ownership of the buffer.
+ *
+ * This makes building large values, such as arrays of many small
+ * dictionaries, considerably cheaper.
+ *
+ * @type, and the types of any subcontainers opened with
+ * g_variant_builder_open(), must be definite.  @type does not need to
+ * remain valid after this call.
+ *
+ * As with g_variant_builder_init(), you must not call
+ * g_variant_builder_ref() or g_variant_builder_unref() on @builder.
+ *
+ * Since: 2.86
+ **/
+void
+g_variant_builder_init_serialised (GVariantBuilder    *builder,
+                                   const GVariantType *type)
+{
+  g_return_if_fail (type != NULL);
+  g_return_if_fail (g_variant_type_is_container (type));
+  g_return_if_fail (g_variant_type_is_definite (type));
+
+  _g_variant_builder_init (builder, type, FALSE, builder_arena_new (),
+                           g_variant_type_info_get (type));
+}
+
+/* Records that a complete child of type @child_info has just been
+ * written to the end of the arena of @builder. */
+static void
+g_variant_builder_arena_child_added (struct stack_builder *builder,
+                                     GVariantTypeInfo     *child_info)
+{
+  struct builder_arena *arena = builder->arena;
+  gsize fixed_size;
+
+  g_variant_type_info_query (child_info, NULL, &fixed_size);
+
+  switch (g_variant_type_info_get_type_char (builder->type_info))
+    {
+    case G_VARIANT_TYPE_INFO_CHAR_ARRAY:
+      if (!fixed_size)
+        builder_arena_push_offset (arena, arena->size - builder->arena_start);
+      break;
+
+    case G_VARIANT_TYPE_INFO_CHAR_MAYBE:
+      if (!fixed_size)
+        *builder_arena_append (arena, 1) = '\0';
+      break;
+
+    case G_VARIANT_TYPE_INFO_CHAR_VARIANT:
+      {
+        const gchar *type_string = g_variant_type_info_get_type_string (child_info);
+        gsize length = strlen (type_string);
+        guchar *data = builder_arena_append (arena, length + 1);
+
+        data[0] = '\0';
+        memcpy (data + 1, type_string, length);
+      }
+      break;
+
+    case G_VARIANT_TYPE_INFO_CHAR_TUPLE:
+    case G_VARIANT_TYPE_INFO_CHAR_DICT_ENTRY:
+      {
+        const GVariantMemberInfo *member_info;
+
+        member_info = g_variant_type_info_member_info (builder->type_info,
+                                                       builder->offset);
+        if (member_info->ending_type == G_VARIANT_MEMBER_ENDING_OFFSET)
+          builder_arena_push_offset (arena, arena->size - builder->arena_start);
+      }
+      break;
+
+    default:
+      g_assert_not_reached ();
+    }
+
+  builder->offset++;
+}
+
+/* Writes the framing offsets or padding at the end of the container
+ * being built by @builder, whose children are all complete. */
+static void
+g_variant_builder_arena_finish (struct stack_builder *builder)
+{
+  struct builder_arena *arena = builder->arena;
+  gsize n_offsets = arena->n_offsets - builder->arena_offsets_start;
+  gsize body_size = arena->size - builder->arena_start;
+  gboolean reversed;
+  gsize fixed_size;
+
+  switch (g_variant_type_info_get_type_char (builder->type_info))
+    {
+    case G_VARIANT_TYPE_INFO_CHAR_ARRAY:
+      reversed = FALSE;
+      break;
+
+    case G_VARIANT_TYPE_INFO_CHAR_TUPLE:
+    case G_VARIANT_TYPE_INFO_CHAR_DICT_ENTRY:
+      g_variant_type_info_query (builder->type_info, NULL, &fixed_size);
+
+      /* fixed-sized tuples are padded out to their fixed size */
+      if (fixed_size)
+        {
+          if (body_size < fixed_size)
+            memset (builder_arena_append (arena, fixed_size - body_size),
+                    0, fixed_size - body_size);
+          return;
+        }
+
+      reversed = TRUE;
+      break;
+
+    default:
+      /* maybes and variants have no framing of their own */
+      return;
+    }
+
+  if (n_offsets > 0)
+    {
+      gsize size = g_variant_serialiser_framed_size (body_size, n_offsets);
+
+      builder_arena_append (arena, size - body_size);
+      g_variant_serialiser_write_offsets (arena->data + builder->arena_start, size,
+                                          arena->offsets + builder->arena_offsets_start,
+                                          n_offsets, reversed);
+      arena->n_offsets = builder->arena_offsets_start;
+    }
+}
+
+static void
+g_variant_builder_arena_add_value (struct stack_builder *builder,
+                                   GVariant             *value)
+{
+  GVariantTypeInfo *type_info = g_variant_get_type_info (value);
+  guint alignment;
+
+  g_variant_type_info_query (type_info, &alignment, NULL);
+  builder_arena_align (builder->arena, alignment);
+
+  g_variant_store (value, builder_arena_append (builder->arena,
+                                                g_variant_get_size (value)));
+  g_variant_builder_arena_child_added (builder, type_info);
 }
 
 static void
@@ -3615,9 +3895,19 @@ g_variant_builder_add_value (GVariantBuilder *builder,
         GVSB(builder)->prev_item_type =
           g_variant_type_next (GVSB(builder)->prev_item_type);
     }
-  else
+  else if (GVSB(builder)->arena == NULL)
     GVSB(builder)->prev_item_type = g_variant_get_type (value);
 
+  /* the types of serialised builders are definite, so there is no
+   * need to keep @value around to remember its type */
+  if (GVSB(builder)->arena != NULL)
+    {
+      g_variant_ref_sink (value);
+      g_variant_builder_arena_add_value (GVSB(builder), value);
+      g_variant_unref (value);
+      return;
+    }
+
   g_variant_builder_make_room (GVSB(builder));
 
   GVSB(builder)->children[GVSB(builder)->offset++] =
@@ -3682,8 +3972,43 @@ g_variant_builder_open (GVariantBuilder    *builder,
   g_return_if_fail (!GVSB(builder)->prev_item_type ||
                     g_variant_type_is_subtype_of (GVSB(builder)->prev_item_type,
                                                   type));
+  g_return_if_fail (GVSB(builder)->arena == NULL ||
+                    g_variant_type_is_definite (type));
 
   parent = g_slice_dup (GVariantBuilder, builder);
+
+  if (GVSB(parent)->arena != NULL)
+    {
+      GVariantTypeInfo *type_info;
+
+      /* avoid looking up the type info for @type when it is already
+       * known from the parent's type */
+      switch (g_variant_type_info_get_type_char (GVSB(parent)->type_info))
+        {
+        case G_VARIANT_TYPE_INFO_CHAR_ARRAY:
+        case G_VARIANT_TYPE_INFO_CHAR_MAYBE:
+          type_info = g_variant_type_info_element (GVSB(parent)->type_info);
+          g_variant_type_info_ref (type_info);
+          break;
+
+        case G_VARIANT_TYPE_INFO_CHAR_TUPLE:
+        case G_VARIANT_TYPE_INFO_CHAR_DICT_ENTRY:
+          type_info = g_variant_type_info_member_info (GVSB(parent)->type_info,
+                                                       GVSB(parent)->offset)->type_info;
+          g_variant_type_info_ref (type_info);
+          break;
+
+        default:
+          type_info = g_variant_type_info_get (type);
+          break;
+        }
+
+      _g_variant_builder_init (builder, type, FALSE, GVSB(parent)->arena, type_info);
+      GVSB(builder)->parent = parent;
+
+      return;
+    }
+
   g_variant_builder_init (builder, type);
   GVSB(builder)->parent = parent;
 
@@ -3724,6 +4049,31 @@ g_variant_builder_close (GVariantBuilder *builder)
   g_return_if_fail (GVSB(builder)->parent != NULL);
 
   parent = GVSB(builder)->parent;
+
+  if (GVSB(builder)->arena != NULL)
+    {
+      g_return_if_fail (GVSB(builder)->offset >= GVSB(builder)->min_items);
+
+      /* the subcontainer was written in place, so finish it and then
+       * account for it in the parent as g_variant_builder_add_value()
+       * would */
+      g_variant_builder_arena_finish (GVSB(builder));
+      g_variant_builder_arena_child_added (GVSB(parent), GVSB(builder)->type_info);
+      GVSB(parent)->trusted &= GVSB(builder)->trusted;
+
+      if (!GVSB(parent)->uniform_item_types && GVSB(parent)->expected_type)
+        GVSB(parent)->expected_type =
+          g_variant_type_next (GVSB(parent)->expected_type);
+
+      GVSB(builder)->parent = NULL;
+      g_variant_type_info_unref (GVSB(builder)->type_info);
+      *builder = *parent;
+
+      g_slice_free (GVariantBuilder, parent);
+
+      return;
+    }
+
   GVSB(builder)->parent = NULL;
 
   g_variant_builder_add_value (parent, g_variant_builder_end (builder));
@@ -3817,6 +4167,27 @@ g_variant_builder_end (GVariantBuilder *builder)
   else
     g_assert_not_reached ();
 
+  if (GVSB(builder)->arena != NULL)
+    {
+      struct builder_arena *arena = GVSB(builder)->arena;
+      GBytes *bytes;
+
+      /* subcontainers are written in place, so can only be finished
+       * by g_variant_builder_close() */
+      g_return_val_if_fail (GVSB(builder)->parent == NULL, NULL);
+
+      g_variant_builder_arena_finish (GVSB(builder));
+
+      bytes = g_bytes_new_take (g_realloc (arena->data, arena->size), arena->size);
+      value = g_variant_new_from_bytes (type, bytes, GVSB(builder)->trusted);
+      g_bytes_unref (bytes);
+
+      arena->data = NULL;
+      g_variant_builder_clear (builder);
+
+      return value;
+    }
+
   children = GVSB(builder)->children;
 
   /* shrink allocation to release extra space to allocator */
@@ -5651,6 +6022,135 @@ g_variant_get_va (GVariant     *value,
 
 /* Varargs-enabled Utility Functions {{{1 */
 
+/* For builders initialised with g_variant_builder_init_serialised(),
+ * writes a value of a basic type straight into the arena, without
+ * creating a #GVariant for it.  Returns %FALSE, having not consumed any
+ * arguments, if @format_string is not a single basic type or @builder
+ * is not serialised. */
+static gboolean
+g_variant_builder_arena_add_basic (GVariantBuilder *builder,
+                                   const gchar     *format_string,
+                                   va_list         *app)
+{
+  const GVariantType *type;
+  GVariantTypeInfo *type_info;
+  guint alignment;
+  gsize fixed_size;
+  guchar *data;
+
+  if (!ensure_valid_builder (builder) || GVSB(builder)->arena == NULL ||
+      format_string == NULL || format_string[0] == '\0' || format_string[1] != '\0' ||
+      !g_variant_type_string_is_valid (format_string))
+    return FALSE;
+
+  type = G_VARIANT_TYPE (format_string);
+
+  if (!g_variant_type_is_basic (type) || !g_variant_type_is_definite (type))
+    return FALSE;
+
+  g_return_val_if_fail (GVSB(builder)->offset < GVSB(builder)->max_items, TRUE);
+  g_return_val_if_fail (!GVSB(builder)->expected_type ||
+                        g_variant_type_is_subtype_of (type, GVSB(builder)->expected_type),
+                        TRUE);
+
+  type_info = g_variant_type_info_get (type);
+  g_variant_type_info_query (type_info, &alignment, &fixed_size);
+
+  if (fixed_size)
+    {
+      builder_arena_align (GVSB(builder)->arena, alignment);
+      data = builder_arena_append (GVSB(builder)->arena, fixed_size);
+
+      switch (format_string[0])
+        {
+        case 'b':
+          *data = va_arg (*app, gboolean) != FALSE;
+          break;
+
+        case 'y':
+          *data = (guchar) va_arg (*app, guint);
+          break;
+
+        case 'n':
+        case 'q':
+          {
+            guint16 value = (guint16) va_arg (*app, guint);
+            memcpy (data, &value, sizeof value);
+          }
+          break;
+
+        case 'i':
+        case 'u':
+        case 'h':
+          {
+            guint32 value = va_arg (*app, guint32);
+            memcpy (data, &value, sizeof value);
+          }
+          break;
+
+        case 'x':
+        case 't':
+          {
+            guint64 value = va_arg (*app, guint64);
+            memcpy (data, &value, sizeof value);
+          }
+          break;
+
+        case 'd':
+          {
+            gdouble value = va_arg (*app, gdouble);
+            memcpy (data, &value, sizeof value);
+          }
+          break;
+
+        default:
+          g_assert_not_reached ();
+        }
+    }
+  else
+    {
+      const gchar *string = va_arg (*app, const gchar *);
+      gboolean valid;
+      gsize length;
+
+      switch (format_string[0])
+        {
+        case 's':
+          valid = string != NULL && g_utf8_validate (string, -1, NULL);
+          break;
+
+        case 'o':
+          valid = string != NULL && g_variant_is_object_path (string);
+          break;
+
+        case 'g':
+          valid = string != NULL && g_variant_is_signature (string);
+          break;
+
+        default:
+          g_assert_not_reached ();
+        }
+
+      if (!valid)
+        {
+          g_critical ("g_variant_builder_add: invalid value for type ‘%s’", format_string);
+          g_variant_type_info_unref (type_info);
+          return TRUE;
+        }
+
+      length = strlen (string) + 1;
+      memcpy (builder_arena_append (GVSB(builder)->arena, length), string, length);
+    }
+
+  if (!GVSB(builder)->uniform_item_types && GVSB(builder)->expected_type)
+    GVSB(builder)->expected_type = g_variant_type_next (GVSB(builder)->expected_type);
+
+  g_variant_builder_arena_child_added (GVSB(builder), type_info);
+  g_variant_type_info_unref (type_info);
+
+  return TRUE;
+}
+
 /**
  * g_variant_builder_add: (skip)
  * @builder: a #GVariantBuilder
@@ -5699,6 +6199,13 @@ g_variant_builder_add (GVariantBuilder *builder,
   va_list ap;
 
   va_start (ap, format_string);
+
+  if (g_variant_builder_arena_add_basic (builder, format_string, &ap))
+    {
+      va_end (ap);
+      return;
+    }
+
   variant = g_variant_new_va (format_string, NULL, &ap);
   va_end (ap);
 
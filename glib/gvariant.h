@@ -419,6 +419,9 @@ void                            g_variant_builder_init                  (GVarian
 GLIB_AVAILABLE_IN_2_84
 void                            g_variant_builder_init_static           (GVariantBuilder      *builder,
                                                                          const GVariantType   *type);
+GLIB_AVAILABLE_IN_2_86
+void                            g_variant_builder_init_serialised       (GVariantBuilder      *builder,
+                                                                         const GVariantType   *type);
 GLIB_AVAILABLE_IN_ALL
 GVariant *                      g_variant_builder_end                   (GVariantBuilder      *builder);
 GLIB_AVAILABLE_IN_ALL
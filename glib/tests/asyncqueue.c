@@ -523,6 +523,193 @@ test_basics (void)
   g_assert_cmpint (destroy_count, ==, 2);
 }
 
+static void
+test_async_queue_bounded (void)
+{
+  GAsyncQueue *q;
+  gint64 start, diff;
+  gint i;
+
+  destroy_count = 0;
+
+  /* The capacity is rounded up to 4. */
+  q = g_async_queue_new_bounded (3, destroy_notify);
+
+  g_assert_null (g_async_queue_try_pop (q));
+  g_assert_cmpint (g_async_queue_length (q), ==, 0);
+
+  for (i = 1; i <= 4; i++)
+    g_async_queue_push (q, GINT_TO_POINTER (i));
+  g_assert_cmpint (g_async_queue_length (q), ==, 4);
+
+  g_assert_cmpint (GPOINTER_TO_INT (g_async_queue_pop (q)), ==, 1);
+  g_assert_cmpint (GPOINTER_TO_INT (g_async_queue_try_pop (q)), ==, 2);
+  g_assert_cmpint (GPOINTER_TO_INT (g_async_queue_timeout_pop (q, 0)), ==, 3);
+
+  /* Wrap around the ring. */
+  for (i = 5; i <= 7; i++)
+    g_async_queue_push (q, GINT_TO_POINTER (i));
+  for (i = 4; i <= 7; i++)
+    g_assert_cmpint (GPOINTER_TO_INT (g_async_queue_pop (q)), ==, i);
+
+  start = g_get_monotonic_time ();
+  g_assert_null (g_async_queue_timeout_pop (q, G_USEC_PER_SEC / 10));
+  diff = g_get_monotonic_time () - start;
+  g_assert_cmpint (diff, >=, G_USEC_PER_SEC / 10);
+
+  if (g_test_undefined ())
+    {
+      g_test_expect_message (G_LOG_DOMAIN, G_LOG_LEVEL_CRITICAL,
+                             "*assertion* failed*");
+      g_async_queue_lock (q);
+      g_test_assert_expected_messages ();
+
+      g_test_expect_message (G_LOG_DOMAIN, G_LOG_LEVEL_CRITICAL,
+                             "*assertion* failed*");
+      g_async_queue_push_front (q, GINT_TO_POINTER (1));
+      g_test_assert_expected_messages ();
+    }
+
+  g_async_queue_push (q, GINT_TO_POINTER (1));
+  g_async_queue_push (q, GINT_TO_POINTER (2));
+  g_async_queue_unref (q);
+  g_assert_cmpint (destroy_count, ==, 2);
+}
+
+static gpointer
+pop_one_later_thread (gpointer data)
+{
+  GAsyncQueue *q = data;
+
+  g_usleep (G_USEC_PER_SEC / 20);
+
+  return g_async_queue_pop (q);
+}
+
+static void
+test_async_queue_bounded_full (void)
+{
+  GAsyncQueue *q;
+  GThread *thread;
+
+  q = g_async_queue_new_bounded (2, NULL);
+
+  g_async_queue_push (q, GINT_TO_POINTER (1));
+  g_async_queue_push (q, GINT_TO_POINTER (2));
+
+  /* The queue is full, so this only returns once the thread has popped
+   * the first item. */
+  thread = g_thread_new ("pop", pop_one_later_thread, q);
+  g_async_queue_push (q, GINT_TO_POINTER (3));
+
+  g_assert_cmpint (GPOINTER_TO_INT (g_thread_join (thread)), ==, 1);
+  g_assert_cmpint (GPOINTER_TO_INT (g_async_queue_pop (q)), ==, 2);
+  g_assert_cmpint (GPOINTER_TO_INT (g_async_queue_pop (q)), ==, 3);
+  g_assert_null (g_async_queue_try_pop (q));
+
+  g_async_queue_unref (q);
+}
+
+#define LOCK_FREE_N_THREADS 4
+#define LOCK_FREE_N_ITEMS 20000
+
+static gpointer
+lock_free_producer_thread (gpointer data)
+{
+  GAsyncQueue *q = data;
+  gint i;
+
+  for (i = 1; i <= LOCK_FREE_N_ITEMS; i++)
+    g_async_queue_push (q, GINT_TO_POINTER (i));
+
+  return NULL;
+}
+
+static gpointer
+lock_free_consumer_thread (gpointer data)
+{
+  GAsyncQueue *q = data;
+  gint64 sum = 0;
+  gint i;
+
+  for (i = 0; i < LOCK_FREE_N_ITEMS; i++)
+    sum += GPOINTER_TO_INT (g_async_queue_pop (q));
+
+  return g_memdup2 (&sum, sizeof (sum));
+}
+
+static void
+test_async_queue_lock_free_threads (gconstpointer single_consumer)
+{
+  GThread *producers[LOCK_FREE_N_THREADS];
+  GThread *consumers[LOCK_FREE_N_THREADS];
+  const gint64 expected_sum = (gint64) LOCK_FREE_N_THREADS * LOCK_FREE_N_ITEMS * (LOCK_FREE_N_ITEMS + 1) / 2;
+  gint64 sum = 0;
+  GAsyncQueue *q;
+  gint i;
+
+  if (GPOINTER_TO_INT (single_consumer))
+    q = g_async_queue_new_single_consumer (NULL);
+  else
+    q = g_async_queue_new_bounded (16, NULL);
+
+  for (i = 0; i < LOCK_FREE_N_THREADS; i++)
+    producers[i] = g_thread_new ("producer", lock_free_producer_thread, q);
+
+  if (GPOINTER_TO_INT (single_consumer))
+    {
+      for (i = 0; i < LOCK_FREE_N_THREADS * LOCK_FREE_N_ITEMS; i++)
+        sum += GPOINTER_TO_INT (g_async_queue_pop (q));
+    }
+  else
+    {
+      for (i = 0; i < LOCK_FREE_N_THREADS; i++)
+        consumers[i] = g_thread_new ("consumer", lock_free_consumer_thread, q);
+
+      for (i = 0; i < LOCK_FREE_N_THREADS; i++)
+        {
+          gint64 *consumer_sum = g_thread_join (consumers[i]);
+
+          sum += *consumer_sum;
+          g_free (consumer_sum);
+        }
+    }
+
+  for (i = 0; i < LOCK_FREE_N_THREADS; i++)
+    g_thread_join (producers[i]);
+
+  g_assert_cmpint (sum, ==, expected_sum);
+  g_assert_null (g_async_queue_try_pop (q));
+  g_assert_cmpint (g_async_queue_length (q), ==, 0);
+
+  g_async_queue_unref (q);
+}
+
+static void
+test_async_queue_single_consumer (void)
+{
+  GAsyncQueue *q;
+  gint i;
+
+  destroy_count = 0;
+
+  q = g_async_queue_new_single_consumer (destroy_notify);
+
+  g_assert_null (g_async_queue_try_pop (q));
+  g_assert_null (g_async_queue_timeout_pop (q, 1000));
+
+  for (i = 1; i <= 100; i++)
+    g_async_queue_push (q, GINT_TO_POINTER (i));
+  g_assert_cmpint (g_async_queue_length (q), ==, 100);
+
+  for (i = 1; i <= 50; i++)
+    g_assert_cmpint (GPOINTER_TO_INT (g_async_queue_pop (q)), ==, i);
+  g_assert_cmpint (g_async_queue_length (q), ==, 50);
+
+  g_async_queue_unref (q);
+  g_assert_cmpint (destroy_count, ==, 50);
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -535,6 +722,11 @@ main (int argc, char *argv[])
   g_test_add_func ("/asyncqueue/timed", test_async_queue_timed);
   g_test_add_func ("/asyncqueue/remove", test_async_queue_remove);
   g_test_add_func ("/asyncqueue/push_front", test_async_queue_push_front);
+  g_test_add_func ("/asyncqueue/bounded", test_async_queue_bounded);
+  g_test_add_func ("/asyncqueue/bounded/full", test_async_queue_bounded_full);
+  g_test_add_data_func ("/asyncqueue/bounded/threads", GINT_TO_POINTER (FALSE), test_async_queue_lock_free_threads);
+  g_test_add_func ("/asyncqueue/single-consumer", test_async_queue_single_consumer);
+  g_test_add_data_func ("/asyncqueue/single-consumer/threads", GINT_TO_POINTER (TRUE), test_async_queue_lock_free_threads);
 
   return g_test_run ();
 }
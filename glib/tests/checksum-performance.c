@@ -0,0 +1,116 @@
+/* GLIB - Library of useful routines for C programming
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+
+/* Number of bytes to hash in each test */
+static gsize total_length = 0;
+
+typedef struct {
+  GChecksumType checksum_type;
+  gboolean hmac;
+  gsize length;
+} ChecksumPerfTest;
+
+static void
+perform (gconstpointer data)
+{
+  const ChecksumPerfTest *test = data;
+  const guchar key[] = "The quick brown fox jumps over the lazy dog";
+  guchar *buffer;
+  gsize i, n_iterations;
+  gdouble time_elapsed;
+  gdouble result;
+
+  buffer = g_malloc (test->length);
+  for (i = 0; i < test->length; i++)
+    buffer[i] = (guchar) (i * 7);
+
+  n_iterations = MAX (total_length / test->length, 1);
+
+  g_test_timer_start ();
+
+  for (i = 0; i < n_iterations; i++)
+    {
+      if (test->hmac)
+        {
+          GHmac *hmac = g_hmac_new (test->checksum_type, key, sizeof (key) - 1);
+          g_hmac_update (hmac, buffer, test->length);
+          g_hmac_get_string (hmac);
+          g_hmac_unref (hmac);
+        }
+      else
+        {
+          GChecksum *checksum = g_checksum_new (test->checksum_type);
+          g_checksum_update (checksum, buffer, test->length);
+          g_checksum_get_string (checksum);
+          g_checksum_free (checksum);
+        }
+    }
+
+  time_elapsed = g_test_timer_elapsed ();
+
+  result = ((gdouble) test->length * n_iterations / time_elapsed) * 1.0e-6;
+
+  g_test_maximized_result (result, "%7.1f MB/s", result);
+
+  g_free (buffer);
+}
+
+static void
+add_cases (GChecksumType  checksum_type,
+           const char    *type_name,
+           gboolean       hmac)
+{
+  const gsize lengths[] = { 64, 1024, 1024 * 1024 };
+  gsize i;
+
+  for (i = 0; i < G_N_ELEMENTS (lengths); i++)
+    {
+      ChecksumPerfTest *test;
+      gchar *path;
+
+      test = g_new0 (ChecksumPerfTest, 1);
+      test->checksum_type = checksum_type;
+      test->hmac = hmac;
+      test->length = lengths[i];
+
+      path = g_strdup_printf ("/%s/perf/%s/%" G_GSIZE_FORMAT,
+                              hmac ? "hmac" : "checksum", type_name, lengths[i]);
+      g_test_add_data_func_full (path, test, perform, g_free);
+      g_free (path);
+    }
+}
+
+int
+main (int argc, char **argv)
+{
+  g_test_init (&argc, &argv, NULL);
+
+  total_length = g_test_perf () ? 256 * 1024 * 1024 : 1;
+
+  add_cases (G_CHECKSUM_MD5, "MD5", FALSE);
+  add_cases (G_CHECKSUM_SHA1, "SHA1", FALSE);
+  add_cases (G_CHECKSUM_SHA256, "SHA256", FALSE);
+  add_cases (G_CHECKSUM_SHA384, "SHA384", FALSE);
+  add_cases (G_CHECKSUM_SHA512, "SHA512", FALSE);
+  add_cases (G_CHECKSUM_SHA1, "SHA1", TRUE);
+  add_cases (G_CHECKSUM_SHA256, "SHA256", TRUE);
+
+  return g_test_run ();
+}
@@ -1168,6 +1168,61 @@ add_checksum_bytes_test (GChecksumType   type,
   g_free (path);
 }
 
+/* The test vectors for one million repetitions of 'a' from FIPS 180-2 and
+ * RFC 1321. Feeding them in chunks of various sizes exercises the paths
+ * which hash many whole blocks at once, and their interaction with the
+ * buffering of partial blocks. */
+static void
+test_checksum_long (void)
+{
+  const struct {
+    GChecksumType type;
+    const gchar *sum;
+  } tests[] = {
+    { G_CHECKSUM_MD5, "7707d6ae4e027c70eea2a935c2296f21" },
+    { G_CHECKSUM_SHA1, "34aa973cd4c4daa4f61eeb2bdbad27316534016f" },
+    { G_CHECKSUM_SHA256, "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0" },
+    { G_CHECKSUM_SHA384, "9d0e1809716474cb086e834e310a4a1ced149e9c00f248527972cec5704c2a5b"
+                         "07b8b3dc38ecc4ebae97ddd87f3d8985" },
+    { G_CHECKSUM_SHA512, "e718483d0ce769644e2e42c7bc15b4638e1f98b13b2044285632a803afa973eb"
+                         "de0ff244877ea60a4cb0432ce577c31beb009c5c2c49aa2e4eadb217ad8cc09b" },
+  };
+  const gsize chunk_lengths[] = { 1000000, 64, 65, 127, 1000, 4096 + 7 };
+  const gsize length = 1000000;
+  guchar *data;
+  gsize i, j;
+
+  data = g_malloc (length);
+  memset (data, 'a', length);
+
+  for (i = 0; i < G_N_ELEMENTS (tests); i++)
+    {
+      GChecksum *checksum = g_checksum_new (tests[i].type);
+
+      for (j = 0; j < G_N_ELEMENTS (chunk_lengths); j++)
+        {
+          gsize offset;
+
+          g_test_message ("Checksum type %d, chunks of %" G_GSIZE_FORMAT " bytes",
+                          tests[i].type, chunk_lengths[j]);
+
+          /* Start with a short update so that the long ones are unaligned
+           * with respect to the block size */
+          g_checksum_update (checksum, data, 3);
+          for (offset = 3; offset < length; offset += chunk_lengths[j])
+            g_checksum_update (checksum, data + offset,
+                               MIN (chunk_lengths[j], length - offset));
+
+          g_assert_cmpstr (g_checksum_get_string (checksum), ==, tests[i].sum);
+          g_checksum_reset (checksum);
+        }
+
+      g_checksum_free (checksum);
+    }
+
+  g_free (data);
+}
+
 static void
 test_unsupported (void)
 {
@@ -1183,6 +1238,7 @@ main (int argc, char *argv[])
   g_test_init (&argc, &argv, NULL);
 
   g_test_add_func ("/checksum/unsupported", test_unsupported);
+  g_test_add_func ("/checksum/long", test_checksum_long);
 
   for (length = 0; length <= FIXED_LEN; length++)
     add_checksum_test (G_CHECKSUM_MD5, "MD5", MD5_sums[length], length);
@@ -0,0 +1,364 @@
+/* GLIB - Library of useful routines for C programming
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+
+static void
+test_basic (void)
+{
+  GConcurrentHashTable *table;
+  gpointer value = NULL;
+  guint i;
+
+  table = g_concurrent_hash_table_new (g_direct_hash, NULL);
+  g_assert_cmpuint (g_concurrent_hash_table_size (table), ==, 0);
+  g_assert_null (g_concurrent_hash_table_lookup (table, GUINT_TO_POINTER (1)));
+
+  /* Enough to grow the table a few times */
+  for (i = 1; i <= 1000; i++)
+    g_assert_true (g_concurrent_hash_table_insert (table, GUINT_TO_POINTER (i), GUINT_TO_POINTER (i * 2)));
+  g_assert_cmpuint (g_concurrent_hash_table_size (table), ==, 1000);
+
+  for (i = 1; i <= 1000; i++)
+    g_assert_cmpuint (GPOINTER_TO_UINT (g_concurrent_hash_table_lookup (table, GUINT_TO_POINTER (i))), ==, i * 2);
+  g_assert_false (g_concurrent_hash_table_contains (table, GUINT_TO_POINTER (1001)));
+
+  g_assert_false (g_concurrent_hash_table_insert (table, GUINT_TO_POINTER (10), GUINT_TO_POINTER (1)));
+  g_assert_cmpuint (g_concurrent_hash_table_size (table), ==, 1000);
+  g_assert_true (g_concurrent_hash_table_lookup_copy (table, GUINT_TO_POINTER (10), NULL, NULL, &value));
+  g_assert_cmpuint (GPOINTER_TO_UINT (value), ==, 1);
+
+  for (i = 1; i <= 1000; i += 2)
+    g_assert_true (g_concurrent_hash_table_remove (table, GUINT_TO_POINTER (i)));
+  g_assert_false (g_concurrent_hash_table_remove (table, GUINT_TO_POINTER (1)));
+  g_assert_cmpuint (g_concurrent_hash_table_size (table), ==, 500);
+
+  for (i = 1; i <= 1000; i++)
+    g_assert_cmpint (g_concurrent_hash_table_contains (table, GUINT_TO_POINTER (i)), ==, i % 2 == 0);
+
+  g_concurrent_hash_table_remove_all (table);
+  g_assert_cmpuint (g_concurrent_hash_table_size (table), ==, 0);
+  g_assert_false (g_concurrent_hash_table_contains (table, GUINT_TO_POINTER (2)));
+
+  g_concurrent_hash_table_unref (table);
+}
+
+static guint
+constant_hash (gconstpointer key)
+{
+  return 42;
+}
+
+static void
+test_collisions (void)
+{
+  GConcurrentHashTable *table;
+  gchar *keys[100];
+  guint i;
+
+  table = g_concurrent_hash_table_new_full (constant_hash, g_str_equal, g_free, NULL);
+
+  for (i = 0; i < G_N_ELEMENTS (keys); i++)
+    {
+      keys[i] = g_strdup_printf ("key-%u", i);
+      g_concurrent_hash_table_insert (table, g_strdup (keys[i]), GUINT_TO_POINTER (i + 1));
+    }
+
+  for (i = 0; i < G_N_ELEMENTS (keys); i++)
+    g_assert_cmpuint (GPOINTER_TO_UINT (g_concurrent_hash_table_lookup (table, keys[i])), ==, i + 1);
+
+  for (i = 0; i < G_N_ELEMENTS (keys); i += 3)
+    g_assert_true (g_concurrent_hash_table_remove (table, keys[i]));
+
+  for (i = 0; i < G_N_ELEMENTS (keys); i++)
+    g_assert_cmpint (g_concurrent_hash_table_contains (table, keys[i]), ==, i % 3 != 0);
+
+  g_concurrent_hash_table_unref (table);
+
+  for (i = 0; i < G_N_ELEMENTS (keys); i++)
+    g_free (keys[i]);
+}
+
+typedef struct
+{
+  gint refs;
+  gint value;
+} Counted;
+
+static gint live_keys = 0;
+static gint live_values = 0;
+
+static gchar *
+key_new (guint i)
+{
+  g_atomic_int_inc (&live_keys);
+  return g_strdup_printf ("%u", i);
+}
+
+static void
+key_free (gpointer key)
+{
+  g_atomic_int_add (&live_keys, -1);
+  g_free (key);
+}
+
+static Counted *
+counted_new (gint value)
+{
+  Counted *counted = g_new (Counted, 1);
+
+  g_atomic_int_inc (&live_values);
+  counted->refs = 1;
+  counted->value = value;
+
+  return counted;
+}
+
+static gpointer
+counted_ref (gconstpointer src,
+             gpointer      user_data)
+{
+  Counted *counted = (Counted *) src;
+
+  g_atomic_int_inc (&counted->refs);
+
+  return counted;
+}
+
+static void
+counted_unref (gpointer data)
+{
+  Counted *counted = data;
+
+  if (g_atomic_int_dec_and_test (&counted->refs))
+    {
+      g_atomic_int_add (&live_values, -1);
+      g_free (counted);
+    }
+}
+
+static void
+test_destroy_notify (void)
+{
+  GConcurrentHashTable *table;
+  Counted *counted = NULL;
+  gchar *key;
+  guint i;
+
+  table = g_concurrent_hash_table_new_full (g_str_hash, g_str_equal, key_free, counted_unref);
+
+  for (i = 0; i < 100; i++)
+    g_concurrent_hash_table_insert (table, key_new (i), counted_new (i));
+  g_assert_cmpint (live_keys, ==, 100);
+  g_assert_cmpint (live_values, ==, 100);
+
+  /* insert() keeps the old key, and frees the new one straight away */
+  g_concurrent_hash_table_insert (table, key_new (0), counted_new (1000));
+  g_assert_cmpint (live_keys, ==, 100);
+
+  /* replace() frees the old key, but only later */
+  g_concurrent_hash_table_replace (table, key_new (1), counted_new (1001));
+
+  g_assert_true (g_concurrent_hash_table_lookup_copy (table, "1", counted_ref, NULL, (gpointer *) &counted));
+  g_assert_nonnull (counted);
+  g_assert_cmpint (counted->value, ==, 1001);
+
+  key = key_new (2);
+  g_assert_true (g_concurrent_hash_table_remove (table, key));
+  key_free (key);
+
+  /* remove_all() waits for all pending destroy notifies */
+  g_concurrent_hash_table_remove_all (table);
+  g_assert_cmpint (live_keys, ==, 0);
+  g_assert_cmpint (live_values, ==, 1);
+  g_assert_cmpint (counted->value, ==, 1001);
+  counted_unref (counted);
+  g_assert_cmpint (live_values, ==, 0);
+
+  for (i = 0; i < 100; i++)
+    g_concurrent_hash_table_insert (table, key_new (i), counted_new (i));
+  for (i = 0; i < 100; i += 2)
+    g_concurrent_hash_table_replace (table, key_new (i), counted_new (i));
+
+  g_concurrent_hash_table_unref (table);
+  g_assert_cmpint (live_keys, ==, 0);
+  g_assert_cmpint (live_values, ==, 0);
+}
+
+static void
+count_cb (gpointer key,
+          gpointer value,
+          gpointer user_data)
+{
+  guint *sum = user_data;
+
+  g_assert_cmpuint (GPOINTER_TO_UINT (key), ==, GPOINTER_TO_UINT (value));
+  *sum += GPOINTER_TO_UINT (value);
+}
+
+static void
+test_foreach (void)
+{
+  GConcurrentHashTable *table;
+  guint sum = 0;
+  guint i;
+
+  table = g_concurrent_hash_table_new (NULL, NULL);
+
+  for (i = 1; i <= 100; i++)
+    g_concurrent_hash_table_insert (table, GUINT_TO_POINTER (i), GUINT_TO_POINTER (i));
+
+  g_concurrent_hash_table_foreach (table, count_cb, &sum);
+  g_assert_cmpuint (sum, ==, 5050);
+
+  g_concurrent_hash_table_unref (table);
+}
+
+#define N_THREAD_KEYS 512
+#define N_WRITER_ITERATIONS 20000
+
+typedef struct
+{
+  GConcurrentHashTable *table;
+  gchar *keys[N_THREAD_KEYS];
+  gint stop;  /* (atomic) */
+  gint n_writers_done;  /* (atomic) */
+} StressData;
+
+static gpointer
+stress_reader (gpointer user_data)
+{
+  StressData *data = user_data;
+  guint n_found = 0;
+  guint i = 0;
+
+  while (!g_atomic_int_get (&data->stop))
+    {
+      Counted *counted = NULL;
+      guint key_index = i++ % N_THREAD_KEYS;
+
+      /* A value must stay valid once a reference has been taken, even if
+       * it is concurrently replaced or removed. */
+      if (g_concurrent_hash_table_lookup_copy (data->table, data->keys[key_index],
+                                               counted_ref, NULL, (gpointer *) &counted))
+        {
+          g_assert_cmpint (counted->value % N_THREAD_KEYS, ==, key_index);
+          counted_unref (counted);
+          n_found++;
+        }
+    }
+
+  return GUINT_TO_POINTER (n_found);
+}
+
+static gpointer
+stress_writer (gpointer user_data)
+{
+  StressData *data = user_data;
+  guint i;
+
+  for (i = 0; i < N_WRITER_ITERATIONS; i++)
+    {
+      guint key_index = g_random_int_range (0, N_THREAD_KEYS);
+      guint value = g_random_int_range (0, 1000) * N_THREAD_KEYS + key_index;
+
+      switch (g_random_int_range (0, 3))
+        {
+        case 0:
+          g_concurrent_hash_table_insert (data->table,
+                                          key_new (key_index),
+                                          counted_new (value));
+          break;
+        case 1:
+          g_concurrent_hash_table_replace (data->table,
+                                           key_new (key_index),
+                                           counted_new (value));
+          break;
+        default:
+          {
+            gchar *key = key_new (key_index);
+            g_concurrent_hash_table_remove (data->table, key);
+            key_free (key);
+          }
+          break;
+        }
+    }
+
+  if (g_atomic_int_add (&data->n_writers_done, 1) == 1)
+    g_atomic_int_set (&data->stop, TRUE);
+
+  return NULL;
+}
+
+static void
+test_threads (void)
+{
+  StressData data = { 0, };
+  GThread *readers[4];
+  GThread *writers[2];
+  guint n_found = 0;
+  guint i;
+
+  g_test_summary ("Test that lookups, insertions and removals from "
+                  "several threads at once do not access freed memory");
+
+  data.table = g_concurrent_hash_table_new_full (g_str_hash, g_str_equal, key_free, counted_unref);
+  for (i = 0; i < N_THREAD_KEYS; i++)
+    data.keys[i] = g_strdup_printf ("%u", i);
+
+  for (i = 0; i < G_N_ELEMENTS (readers); i++)
+    readers[i] = g_thread_new ("reader", stress_reader, &data);
+  for (i = 0; i < G_N_ELEMENTS (writers); i++)
+    writers[i] = g_thread_new ("writer", stress_writer, &data);
+
+  for (i = 0; i < G_N_ELEMENTS (writers); i++)
+    g_thread_join (writers[i]);
+  for (i = 0; i < G_N_ELEMENTS (readers); i++)
+    n_found += GPOINTER_TO_UINT (g_thread_join (readers[i]));
+
+  g_test_message ("%u successful lookups", n_found);
+
+  for (i = 0; i < N_THREAD_KEYS; i++)
+    {
+      Counted *counted = g_concurrent_hash_table_lookup (data.table, data.keys[i]);
+
+      if (counted != NULL)
+        g_assert_cmpint (counted->value % N_THREAD_KEYS, ==, i);
+    }
+
+  g_concurrent_hash_table_unref (data.table);
+  g_assert_cmpint (live_keys, ==, 0);
+  g_assert_cmpint (live_values, ==, 0);
+
+  for (i = 0; i < N_THREAD_KEYS; i++)
+    g_free (data.keys[i]);
+}
+
+int
+main (int argc, char *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+
+  g_test_add_func ("/concurrenthash/basic", test_basic);
+  g_test_add_func ("/concurrenthash/collisions", test_collisions);
+  g_test_add_func ("/concurrenthash/destroy-notify", test_destroy_notify);
+  g_test_add_func ("/concurrenthash/foreach", test_foreach);
+  g_test_add_func ("/concurrenthash/threads", test_threads);
+
+  return g_test_run ();
+}
@@ -68,6 +68,60 @@ test_quark_string (void)
   g_free (copy);
 }
 
+#define QUARK_THREADS_N_THREADS 4
+#define QUARK_THREADS_N_NAMES 5000
+
+static gpointer
+quark_threads_func (gpointer data)
+{
+  GQuark *quarks = data;
+  guint i;
+
+  /* All threads race to create the same quarks, in different orders */
+  for (i = 0; i < QUARK_THREADS_N_NAMES; i++)
+    {
+      guint n = (i * 7919 + GPOINTER_TO_UINT (quarks)) % QUARK_THREADS_N_NAMES;
+      gchar *name = g_strdup_printf ("quark-threads-%u", n);
+
+      quarks[n] = g_quark_from_string (name);
+      g_assert_cmpstr (g_quark_to_string (quarks[n]), ==, name);
+      g_free (name);
+    }
+
+  return NULL;
+}
+
+static void
+test_quark_threads (void)
+{
+  GThread *threads[QUARK_THREADS_N_THREADS];
+  GQuark *quarks[QUARK_THREADS_N_THREADS];
+  guint i, j;
+
+  for (i = 0; i < QUARK_THREADS_N_THREADS; i++)
+    {
+      quarks[i] = g_new0 (GQuark, QUARK_THREADS_N_NAMES);
+      threads[i] = g_thread_new ("quark", quark_threads_func, quarks[i]);
+    }
+
+  for (i = 0; i < QUARK_THREADS_N_THREADS; i++)
+    g_thread_join (threads[i]);
+
+  for (j = 0; j < QUARK_THREADS_N_NAMES; j++)
+    {
+      gchar *name = g_strdup_printf ("quark-threads-%u", j);
+
+      g_assert_cmpuint (quarks[0][j], !=, 0);
+      g_assert_cmpuint (g_quark_try_string (name), ==, quarks[0][j]);
+      for (i = 1; i < QUARK_THREADS_N_THREADS; i++)
+        g_assert_cmpuint (quarks[i][j], ==, quarks[0][j]);
+      g_free (name);
+    }
+
+  for (i = 0; i < QUARK_THREADS_N_THREADS; i++)
+    g_free (quarks[i]);
+}
+
 static void
 test_dataset_basic (void)
 {
@@ -551,6 +605,7 @@ main (int argc, char *argv[])
 
   g_test_add_func ("/quark/basic", test_quark_basic);
   g_test_add_func ("/quark/string", test_quark_string);
+  g_test_add_func ("/quark/threads", test_quark_threads);
   g_test_add_func ("/dataset/basic", test_dataset_basic);
   g_test_add_func ("/dataset/id", test_dataset_id);
   g_test_add_func ("/dataset/full", test_dataset_full);
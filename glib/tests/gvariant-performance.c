@@ -0,0 +1,271 @@
+/* GLIB - Library of useful routines for C programming
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+
+#include <glib.h>
+
+static guint num_iterations = 0;
+
+/* Approximate size of the serialised data for each test */
+static gsize target_size = 0;
+
+typedef GVariant * (* BuildFunc) (void);
+
+static GVariant *
+build_array_of_say (void)
+{
+  GVariantBuilder builder;
+  gsize size = 0;
+  guint i;
+
+  g_variant_builder_init_static (&builder, G_VARIANT_TYPE ("a(say)"));
+
+  for (i = 0; size < target_size; i++)
+    {
+      gchar *str = g_strdup_printf ("/org/gtk/example/object%u", i);
+      gsize len = strlen (str);
+
+      g_variant_builder_add (&builder, "(s@ay)", str,
+                             g_variant_new_fixed_array (G_VARIANT_TYPE_BYTE, str,
+                                                        len, 1));
+      size += 2 * len + 4;
+      g_free (str);
+    }
+
+  return g_variant_builder_end (&builder);
+}
+
+static GVariant *
+build_array_of_dicts (void)
+{
+  GVariantBuilder builder;
+  gsize size = 0;
+  guint i;
+
+  g_variant_builder_init_static (&builder, G_VARIANT_TYPE ("aa{sv}"));
+
+  for (i = 0; size < target_size; i++)
+    {
+      GVariantDict dict;
+
+      g_variant_dict_init (&dict, NULL);
+      g_variant_dict_insert (&dict, "id", "u", i);
+      g_variant_dict_insert (&dict, "name", "s", "An example entry");
+      g_variant_dict_insert (&dict, "enabled", "b", i % 2);
+      g_variant_dict_insert (&dict, "position", "(dd)", (gdouble) i, -(gdouble) i);
+      g_variant_builder_add_value (&builder, g_variant_dict_end (&dict));
+      size += 100;
+    }
+
+  return g_variant_builder_end (&builder);
+}
+
+static GVariant *
+build_array_of_uint32 (void)
+{
+  gsize n_elements = target_size / sizeof (guint32);
+  guint32 *values;
+  GVariant *variant;
+  gsize i;
+
+  values = g_new (guint32, n_elements);
+  for (i = 0; i < n_elements; i++)
+    values[i] = i;
+
+  variant = g_variant_new_fixed_array (G_VARIANT_TYPE_UINT32, values,
+                                       n_elements, sizeof (guint32));
+  g_free (values);
+
+  return variant;
+}
+
+static GVariant *
+build_array_of_boolean (void)
+{
+  guchar *values;
+  GVariant *variant;
+  gsize i;
+
+  /* Booleans are serialised as single bytes */
+  values = g_malloc (target_size);
+  for (i = 0; i < target_size; i++)
+    values[i] = i % 2;
+
+  variant = g_variant_new_fixed_array (G_VARIANT_TYPE_BOOLEAN, values,
+                                       target_size, 1);
+  g_free (values);
+
+  return variant;
+}
+
+typedef struct {
+  BuildFunc build;
+  gboolean byteswap;
+} PerfTest;
+
+static void
+perform (gconstpointer data)
+{
+  const PerfTest *test = data;
+  GVariant *variant;
+  GBytes *bytes;
+  gdouble time_elapsed;
+  gdouble result;
+  guint i;
+
+  variant = g_variant_ref_sink (test->build ());
+  bytes = g_variant_get_data_as_bytes (variant);
+
+  g_test_timer_start ();
+
+  for (i = 0; i < num_iterations; i++)
+    {
+      /* Create a new untrusted variant each time, as the result of
+       * checking the normal form is cached */
+      GVariant *untrusted = g_variant_new_from_bytes (g_variant_get_type (variant),
+                                                      bytes, FALSE);
+
+      g_variant_ref_sink (untrusted);
+
+      if (test->byteswap)
+        {
+          GVariant *swapped = g_variant_byteswap (untrusted);
+          g_variant_unref (swapped);
+        }
+      else
+        {
+          g_assert_true (g_variant_is_normal_form (untrusted));
+        }
+
+      g_variant_unref (untrusted);
+    }
+
+  time_elapsed = g_test_timer_elapsed ();
+
+  result = ((gdouble) g_bytes_get_size (bytes) * num_iterations / time_elapsed) * 1.0e-6;
+
+  g_test_maximized_result (result, "%7.1f MB/s", result);
+
+  g_bytes_unref (bytes);
+  g_variant_unref (variant);
+}
+
+/* Builds an array of small dictionaries of the sort exported over D-Bus,
+ * with the builder opening each subcontainer in turn */
+static void
+perform_builder (gconstpointer data)
+{
+  gboolean serialised = GPOINTER_TO_INT (data);
+  gsize n_entries = target_size / 100;
+  gsize size = 0;
+  gdouble time_elapsed;
+  gdouble result;
+  guint i;
+
+  g_test_timer_start ();
+
+  for (i = 0; i < num_iterations; i++)
+    {
+      GVariantBuilder builder;
+      GVariant *variant;
+      gsize j;
+
+      if (serialised)
+        g_variant_builder_init_serialised (&builder, G_VARIANT_TYPE ("aa{sv}"));
+      else
+        g_variant_builder_init_static (&builder, G_VARIANT_TYPE ("aa{sv}"));
+
+      for (j = 0; j < n_entries; j++)
+        {
+          g_variant_builder_open (&builder, G_VARIANT_TYPE_VARDICT);
+
+          g_variant_builder_open (&builder, G_VARIANT_TYPE ("{sv}"));
+          g_variant_builder_add (&builder, "s", "id");
+          g_variant_builder_add (&builder, "v", g_variant_new_uint32 (j));
+          g_variant_builder_close (&builder);
+
+          g_variant_builder_open (&builder, G_VARIANT_TYPE ("{sv}"));
+          g_variant_builder_add (&builder, "s", "name");
+          g_variant_builder_add (&builder, "v", g_variant_new_string ("An example entry"));
+          g_variant_builder_close (&builder);
+
+          g_variant_builder_open (&builder, G_VARIANT_TYPE ("{sv}"));
+          g_variant_builder_add (&builder, "s", "enabled");
+          g_variant_builder_add (&builder, "v", g_variant_new_boolean (j % 2));
+          g_variant_builder_close (&builder);
+
+          g_variant_builder_close (&builder);
+        }
+
+      variant = g_variant_ref_sink (g_variant_builder_end (&builder));
+      size += g_variant_get_size (variant);
+      g_variant_unref (variant);
+    }
+
+  time_elapsed = g_test_timer_elapsed ();
+
+  result = ((gdouble) size / time_elapsed) * 1.0e-6;
+
+  g_test_maximized_result (result, "%7.1f MB/s", result);
+}
+
+static void
+add_case (const char *path,
+          BuildFunc   build,
+          gboolean    byteswap)
+{
+  PerfTest *test;
+
+  test = g_new0 (PerfTest, 1);
+  test->build = build;
+  test->byteswap = byteswap;
+
+  g_test_add_data_func_full (path, test, perform, g_free);
+}
+
+int
+main (int argc, char **argv)
+{
+  g_test_init (&argc, &argv, NULL);
+
+  if (g_test_perf ())
+    {
+      num_iterations = 10;
+      target_size = 64 * 1024 * 1024;
+    }
+  else
+    {
+      num_iterations = 1;
+      target_size = 4096;
+    }
+
+  add_case ("/gvariant/perf/is-normal/a(say)", build_array_of_say, FALSE);
+  add_case ("/gvariant/perf/is-normal/aa{sv}", build_array_of_dicts, FALSE);
+  add_case ("/gvariant/perf/is-normal/au", build_array_of_uint32, FALSE);
+  add_case ("/gvariant/perf/is-normal/ab", build_array_of_boolean, FALSE);
+  add_case ("/gvariant/perf/byteswap/au", build_array_of_uint32, TRUE);
+  add_case ("/gvariant/perf/byteswap/aa{sv}", build_array_of_dicts, TRUE);
+
+  g_test_add_data_func ("/gvariant/perf/builder/aa{sv}",
+                        GINT_TO_POINTER (FALSE), perform_builder);
+  g_test_add_data_func ("/gvariant/perf/builder-serialised/aa{sv}",
+                        GINT_TO_POINTER (TRUE), perform_builder);
+
+  return g_test_run ();
+}
@@ -5159,6 +5159,205 @@ get_asv (void)
   return g_variant_ref_sink (g_variant_builder_end (&builder));
 }
 
+typedef void (* BuildFunc) (GVariantBuilder *builder);
+
+static void
+build_vardict (GVariantBuilder *builder)
+{
+  guint i;
+
+  for (i = 0; i < 20; i++)
+    {
+      gchar *key = g_strdup_printf ("key%u", i);
+
+      g_variant_builder_open (builder, G_VARIANT_TYPE ("{sv}"));
+      g_variant_builder_add (builder, "s", key);
+
+      switch (i % 4)
+        {
+        case 0:
+          g_variant_builder_add (builder, "v", g_variant_new_int32 (i));
+          break;
+        case 1:
+          g_variant_builder_add (builder, "v", g_variant_new_string (key));
+          break;
+        case 2:
+          g_variant_builder_add (builder, "v", g_variant_new_parsed ("[(1, 'a'), (2, 'bb')]"));
+          break;
+        default:
+          /* a container opened directly inside a variant */
+          g_variant_builder_open (builder, G_VARIANT_TYPE_VARIANT);
+          g_variant_builder_open (builder, G_VARIANT_TYPE ("(tas)"));
+          g_variant_builder_add (builder, "t", (guint64) i << 40);
+          g_variant_builder_open (builder, G_VARIANT_TYPE_STRING_ARRAY);
+          g_variant_builder_add (builder, "s", key);
+          g_variant_builder_add (builder, "s", "");
+          g_variant_builder_close (builder);
+          g_variant_builder_close (builder);
+          g_variant_builder_close (builder);
+          break;
+        }
+
+      g_variant_builder_close (builder);
+      g_free (key);
+    }
+}
+
+static void
+build_basic_tuple (GVariantBuilder *builder)
+{
+  g_variant_builder_add (builder, "y", 0xa5);
+  g_variant_builder_add (builder, "b", TRUE);
+  g_variant_builder_add (builder, "n", -12345);
+  g_variant_builder_add (builder, "q", 54321);
+  g_variant_builder_add (builder, "i", -123456789);
+  g_variant_builder_add (builder, "u", 3123456789u);
+  g_variant_builder_add (builder, "x", G_GINT64_CONSTANT (-1234567890123));
+  g_variant_builder_add (builder, "t", G_GUINT64_CONSTANT (12345678901234567890));
+  g_variant_builder_add (builder, "h", 3);
+  g_variant_builder_add (builder, "d", 3.25);
+  g_variant_builder_add (builder, "s", "a string");
+  g_variant_builder_add (builder, "o", "/an/object/path");
+  g_variant_builder_add (builder, "g", "a{sv}");
+  g_variant_builder_add (builder, "y", 1);
+}
+
+static void
+build_array_of_tuples (GVariantBuilder *builder)
+{
+  guint i, j;
+
+  for (i = 0; i < 10; i++)
+    {
+      g_variant_builder_open (builder, G_VARIANT_TYPE ("(y(yi)ay()ms)"));
+      g_variant_builder_add (builder, "y", i);
+      g_variant_builder_add (builder, "(yi)", i, -i);
+      g_variant_builder_open (builder, G_VARIANT_TYPE_BYTESTRING);
+      for (j = 0; j < i; j++)
+        g_variant_builder_add (builder, "y", j);
+      g_variant_builder_close (builder);
+      g_variant_builder_open (builder, G_VARIANT_TYPE_UNIT);
+      g_variant_builder_close (builder);
+      g_variant_builder_open (builder, G_VARIANT_TYPE ("ms"));
+      if (i % 2)
+        g_variant_builder_add (builder, "s", "just");
+      g_variant_builder_close (builder);
+      g_variant_builder_close (builder);
+    }
+}
+
+static void
+build_maybes (GVariantBuilder *builder)
+{
+  g_variant_builder_open (builder, G_VARIANT_TYPE ("m(iy)"));
+  g_variant_builder_open (builder, G_VARIANT_TYPE ("(iy)"));
+  g_variant_builder_add (builder, "i", 7);
+  g_variant_builder_add (builder, "y", 8);
+  g_variant_builder_close (builder);
+  g_variant_builder_close (builder);
+
+  g_variant_builder_open (builder, G_VARIANT_TYPE ("m(iy)"));
+  g_variant_builder_close (builder);
+
+  g_variant_builder_open (builder, G_VARIANT_TYPE ("mas"));
+  g_variant_builder_open (builder, G_VARIANT_TYPE_STRING_ARRAY);
+  g_variant_builder_close (builder);
+  g_variant_builder_close (builder);
+
+  g_variant_builder_add (builder, "mi", FALSE, 0);
+}
+
+/* Big enough to need 4-byte framing offsets */
+static void
+build_large_string_array (GVariantBuilder *builder)
+{
+  guint i;
+
+  for (i = 0; i < 20000; i++)
+    {
+      gchar *str = g_strdup_printf ("string %u", i);
+      g_variant_builder_add (builder, "s", str);
+      g_free (str);
+    }
+}
+
+static void
+build_untrusted_children (GVariantBuilder *builder)
+{
+  GBytes *bytes = g_bytes_new ("ab", 3);
+
+  g_variant_builder_add_value (builder,
+                               g_variant_new_from_bytes (G_VARIANT_TYPE_STRING,
+                                                         bytes, FALSE));
+  g_variant_builder_add (builder, "s", "trusted");
+  g_bytes_unref (bytes);
+}
+
+/* Test that builders initialised with g_variant_builder_init_serialised()
+ * produce exactly the same serialised data as normal ones. */
+static void
+test_builder_serialised (void)
+{
+  const struct {
+    const gchar *type;
+    BuildFunc build;
+  } tests[] = {
+    { "a{sv}", build_vardict },
+    { "(ybnqiuxthdsogy)", build_basic_tuple },
+    { "a(y(yi)ay()ms)", build_array_of_tuples },
+    { "(m(iy)m(iy)masmi)", build_maybes },
+    { "as", build_large_string_array },
+    { "as", build_untrusted_children },
+  };
+  gsize i;
+
+  for (i = 0; i < G_N_ELEMENTS (tests); i++)
+    {
+      GVariantBuilder builder;
+      GVariant *expected, *value, *untrusted;
+
+      g_test_message ("Building %s with %" G_GSIZE_FORMAT, tests[i].type, i);
+
+      g_variant_builder_init_static (&builder, G_VARIANT_TYPE (tests[i].type));
+      tests[i].build (&builder);
+      expected = g_variant_ref_sink (g_variant_builder_end (&builder));
+
+      g_variant_builder_init_serialised (&builder, G_VARIANT_TYPE (tests[i].type));
+      tests[i].build (&builder);
+      value = g_variant_ref_sink (g_variant_builder_end (&builder));
+
+      g_assert_cmpvariant (value, expected);
+      g_assert_cmpmem (g_variant_get_data (value), g_variant_get_size (value),
+                       g_variant_get_data (expected), g_variant_get_size (expected));
+
+      untrusted = g_variant_new_from_data (G_VARIANT_TYPE (tests[i].type),
+                                           g_variant_get_data (value),
+                                           g_variant_get_size (value),
+                                           FALSE, NULL, NULL);
+      g_variant_ref_sink (untrusted);
+      g_assert_true (g_variant_is_normal_form (untrusted));
+
+      g_variant_unref (untrusted);
+      g_variant_unref (value);
+      g_variant_unref (expected);
+    }
+}
+
+/* Test that clearing a serialised builder with open subcontainers frees
+ * everything. */
+static void
+test_builder_serialised_clear (void)
+{
+  GVariantBuilder builder;
+
+  g_variant_builder_init_serialised (&builder, G_VARIANT_TYPE ("a{sv}"));
+  g_variant_builder_open (&builder, G_VARIANT_TYPE ("{sv}"));
+  g_variant_builder_add (&builder, "s", "key");
+  g_variant_builder_open (&builder, G_VARIANT_TYPE_VARIANT);
+  g_variant_builder_open (&builder, G_VARIANT_TYPE ("a(ii)"));
+  g_variant_builder_clear (&builder);
+}
+
 static void
 test_stack_dict_init (void)
 {
@@ -5878,6 +6077,136 @@ test_normal_checking_empty_object_path (void)
   g_variant_unref (variant);
 }
 
+/* Test normal form checking of an array big enough to be checked in several
+ * ranges, possibly in parallel, including errors close to the boundaries
+ * between the ranges. */
+static void
+test_normal_checking_large_array (void)
+{
+  const gsize n_elements = 64 * 1024;
+  GVariantBuilder builder;
+  GVariant *variant, *corrupt_variant;
+  const guint8 *data;
+  guint8 *corrupt_data;
+  gsize size, data_size, i;
+
+  g_variant_builder_init_static (&builder, G_VARIANT_TYPE ("a(say)"));
+  for (i = 0; i < n_elements; i++)
+    {
+      gchar *str = g_strdup_printf ("element %" G_GSIZE_FORMAT " of a large array", i);
+
+      g_variant_builder_add (&builder, "(s@ay)", str,
+                             g_variant_new_fixed_array (G_VARIANT_TYPE_BYTE, str,
+                                                        strlen (str), 1));
+      g_free (str);
+    }
+  variant = g_variant_ref_sink (g_variant_builder_end (&builder));
+
+  data = g_variant_get_data (variant);
+  size = g_variant_get_size (variant);
+  g_assert_cmpuint (size, >, 2 * 1024 * 1024);
+  g_assert_cmpuint (size, <=, G_MAXUINT32);
+
+  g_assert_true (g_variant_is_normal_form (variant));
+
+  /* The framing offsets are 32 bits wide at this size */
+  data_size = GUINT32_FROM_LE (*(const guint32 *) (data + size - 4));
+  g_assert_cmpuint ((size - data_size) / 4, ==, n_elements);
+
+  /* Corrupt the last element of the first half, and then the framing offset
+   * of the first element in the second half, and finally the last element */
+  for (i = 0; i < 3; i++)
+    {
+      gsize element = (i == 2) ? n_elements - 1 : n_elements / 2 - 1;
+      guint32 element_end;
+
+      corrupt_data = g_memdup2 (data, size);
+      element_end = GUINT32_FROM_LE (*(guint32 *) (corrupt_data + data_size + 4 * element));
+
+      if (i == 1)
+        {
+          /* Make the next element end before this one */
+          *(guint32 *) (corrupt_data + data_size + 4 * (element + 1)) = GUINT32_TO_LE (element_end - 1);
+        }
+      else
+        {
+          /* Point the tuple’s framing offset for the string past its end */
+          corrupt_data[element_end - 1] = 0xff;
+        }
+
+      corrupt_variant = g_variant_new_from_data (G_VARIANT_TYPE ("a(say)"),
+                                                 corrupt_data, size, FALSE,
+                                                 g_free, corrupt_data);
+      g_variant_ref_sink (corrupt_variant);
+      g_assert_false (g_variant_is_normal_form (corrupt_variant));
+      g_variant_unref (corrupt_variant);
+    }
+
+  g_variant_unref (variant);
+}
+
+/* Test normal form checking and byteswapping of arrays of fixed-sized basic
+ * types, which are handled as a whole rather than element by element. */
+static void
+test_fixed_sized_basic_arrays (void)
+{
+  const struct {
+    const gchar *type;
+    gsize element_size;
+  } arrays[] = {
+    { "aq", 2 },
+    { "au", 4 },
+    { "at", 8 },
+    { "ad", 8 },
+    { "a(i)", 4 },
+  };
+  guint8 data[64];
+  guint8 swapped[64];
+  gsize i, j;
+  GVariant *variant, *swapped_variant;
+
+  for (i = 0; i < sizeof (data); i++)
+    data[i] = i;
+
+  for (i = 0; i < G_N_ELEMENTS (arrays); i++)
+    {
+      gsize element_size = arrays[i].element_size;
+
+      g_test_message ("Array type %s", arrays[i].type);
+
+      for (j = 0; j < sizeof (data); j++)
+        swapped[j] = data[(j / element_size) * element_size + (element_size - 1 - j % element_size)];
+
+      variant = g_variant_new_from_data (G_VARIANT_TYPE (arrays[i].type),
+                                         data, sizeof (data), FALSE, NULL, NULL);
+      g_variant_ref_sink (variant);
+      g_assert_true (g_variant_is_normal_form (variant));
+
+      swapped_variant = g_variant_byteswap (variant);
+      g_assert_cmpmem (g_variant_get_data (swapped_variant),
+                       g_variant_get_size (swapped_variant),
+                       swapped, sizeof (swapped));
+
+      g_variant_unref (swapped_variant);
+      g_variant_unref (variant);
+    }
+
+  /* Booleans must be 0 or 1 */
+  memset (data, 1, sizeof (data));
+  variant = g_variant_new_from_data (G_VARIANT_TYPE ("ab"), data, sizeof (data),
+                                     FALSE, NULL, NULL);
+  g_variant_ref_sink (variant);
+  g_assert_true (g_variant_is_normal_form (variant));
+  g_variant_unref (variant);
+
+  data[sizeof (data) - 1] = 2;
+  variant = g_variant_new_from_data (G_VARIANT_TYPE ("ab"), data, sizeof (data),
+                                     FALSE, NULL, NULL);
+  g_variant_ref_sink (variant);
+  g_assert_false (g_variant_is_normal_form (variant));
+  g_variant_unref (variant);
+}
+
 /* Test that constructing a #GVariant from data which is not correctly aligned
  * for the variant type is OK, by loading a variant from data at various offsets
  * which are aligned and unaligned. When unaligned, a slow construction path
@@ -6018,6 +6347,8 @@ main (int argc, char **argv)
   g_test_add_func ("/gvariant/stack-builder-init-static", test_stack_builder_init_static);
   g_test_add_func ("/gvariant/stack-builder-init-unset", test_stack_builder_init_unset);
   g_test_add_func ("/gvariant/stack-dict-init", test_stack_dict_init);
+  g_test_add_func ("/gvariant/builder-serialised", test_builder_serialised);
+  g_test_add_func ("/gvariant/builder-serialised/clear", test_builder_serialised_clear);
 
   g_test_add_func ("/gvariant/normal-checking/tuples",
                    test_normal_checking_tuples);
@@ -6043,6 +6374,10 @@ main (int argc, char **argv)
                    test_normal_checking_tuple_offsets_minimal_sized);
   g_test_add_func ("/gvariant/normal-checking/empty-object-path",
                    test_normal_checking_empty_object_path);
+  g_test_add_func ("/gvariant/normal-checking/large-array",
+                   test_normal_checking_large_array);
+  g_test_add_func ("/gvariant/normal-checking/fixed-sized-basic-arrays",
+                   test_fixed_sized_basic_arrays);
 
   g_test_add_func ("/gvariant/recursion-limits/variant-in-variant",
                    test_recursion_limits_variant_in_variant);
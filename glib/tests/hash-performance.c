@@ -0,0 +1,177 @@
+/* GLIB - Library of useful routines for C programming
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+
+/* Compares the default layout of a string-keyed GHashTable with the
+ * %G_HASH_TABLE_FLAGS_GROUP_PROBING one, for lookups which hit and miss,
+ * insertions and removals. Run with `-m perf` to get meaningful numbers
+ * from tables which do not fit into the CPU caches. */
+
+static guint num_keys = 0;
+static gchar **keys = NULL;
+static gchar **missing_keys = NULL;
+
+typedef enum
+{
+  OP_LOOKUP_HIT,
+  OP_LOOKUP_MISS,
+  OP_INSERT,
+  OP_REMOVE,
+} Operation;
+
+typedef struct
+{
+  Operation op;
+  GHashTableFlags flags;
+} PerfData;
+
+static GHashTable *
+create_table (GHashTableFlags flags,
+              gboolean        fill)
+{
+  GHashTable *table;
+  guint i;
+
+  table = g_hash_table_new_with_flags (g_str_hash, g_str_equal, NULL, NULL, flags);
+
+  if (fill)
+    for (i = 0; i < num_keys; i++)
+      g_hash_table_insert (table, keys[i], keys[i]);
+
+  return table;
+}
+
+static void
+perform (gconstpointer data)
+{
+  const PerfData *pd = data;
+  GHashTable *table;
+  gdouble time_elapsed;
+  gdouble result;
+  guint found = 0;
+  guint i;
+
+  table = create_table (pd->flags, pd->op != OP_INSERT);
+
+  g_test_timer_start ();
+
+  switch (pd->op)
+    {
+    case OP_LOOKUP_HIT:
+      for (i = 0; i < num_keys; i++)
+        found += g_hash_table_lookup (table, keys[i]) != NULL;
+      g_assert_cmpuint (found, ==, num_keys);
+      break;
+
+    case OP_LOOKUP_MISS:
+      for (i = 0; i < num_keys; i++)
+        found += g_hash_table_lookup (table, missing_keys[i]) != NULL;
+      g_assert_cmpuint (found, ==, 0);
+      break;
+
+    case OP_INSERT:
+      for (i = 0; i < num_keys; i++)
+        g_hash_table_insert (table, keys[i], keys[i]);
+      g_assert_cmpuint (g_hash_table_size (table), ==, num_keys);
+      break;
+
+    case OP_REMOVE:
+      for (i = 0; i < num_keys; i++)
+        found += g_hash_table_remove (table, keys[i]);
+      g_assert_cmpuint (found, ==, num_keys);
+      break;
+
+    default:
+      g_assert_not_reached ();
+    }
+
+  time_elapsed = g_test_timer_elapsed ();
+
+  g_hash_table_unref (table);
+
+  result = num_keys / time_elapsed * 1.0e-6;
+
+  g_test_maximized_result (result, "%7.2f Mops/s", result);
+}
+
+static void
+add_cases (const char      *path,
+           GHashTableFlags  flags)
+{
+  static const struct
+    {
+      const char *name;
+      Operation op;
+    }
+  ops[] =
+    {
+      { "lookup-hit", OP_LOOKUP_HIT },
+      { "lookup-miss", OP_LOOKUP_MISS },
+      { "insert", OP_INSERT },
+      { "remove", OP_REMOVE },
+    };
+  gsize i;
+
+  for (i = 0; i < G_N_ELEMENTS (ops); i++)
+    {
+      PerfData *pd;
+      gchar *full_path;
+
+      pd = g_new0 (PerfData, 1);
+      pd->op = ops[i].op;
+      pd->flags = flags;
+
+      full_path = g_strdup_printf ("%s/%s", path, ops[i].name);
+      g_test_add_data_func_full (full_path, pd, perform, g_free);
+      g_free (full_path);
+    }
+}
+
+int
+main (int argc, char **argv)
+{
+  int retval;
+  guint i;
+
+  g_test_init (&argc, &argv, NULL);
+
+  num_keys = g_test_perf () ? 2000000 : 1000;
+
+  keys = g_new0 (gchar *, num_keys + 1);
+  missing_keys = g_new0 (gchar *, num_keys + 1);
+  /* Random keys, so that consecutive keys do not end up in neighbouring
+   * buckets and the accesses are as cache-unfriendly as in a real cache. */
+  for (i = 0; i < num_keys; i++)
+    {
+      keys[i] = g_strdup_printf ("/org/gtk/cache/%08x%08x/%u",
+                                 g_test_rand_int (), g_test_rand_int (), i);
+      missing_keys[i] = g_strdup_printf ("/org/gtk/cache/%08x%08x/missing",
+                                         g_test_rand_int (), g_test_rand_int ());
+    }
+
+  add_cases ("/hash/perf/default", G_HASH_TABLE_FLAGS_NONE);
+  add_cases ("/hash/perf/group-probing", G_HASH_TABLE_FLAGS_GROUP_PROBING);
+
+  retval = g_test_run ();
+
+  g_strfreev (keys);
+  g_strfreev (missing_keys);
+
+  return retval;
+}
@@ -1479,10 +1479,12 @@ struct _GHashTable
 
   guint            have_big_keys : 1;
   guint            have_big_values : 1;
+  guint            use_groups : 1;
 
   gpointer        *keys;
   guint           *hashes;
   gpointer        *values;
+  guint8          *ctrl;
 
   GHashFunc        hash_func;
   GEqualFunc       key_equal_func;
@@ -1511,6 +1513,17 @@ count_keys (GHashTable *h, gint *unused, gint *occupied, gint *tombstones)
         (*tombstones)++;
       else
         (*occupied)++;
+
+      /* The control bytes must agree with the hashes */
+      if (h->use_groups)
+        {
+          if (h->hashes[i] == 0)
+            g_assert_cmpuint (h->ctrl[i], ==, 0x80);
+          else if (h->hashes[i] == 1)
+            g_assert_cmpuint (h->ctrl[i], ==, 0xFE);
+          else
+            g_assert_cmpuint (h->ctrl[i], <, 0x80);
+        }
     }
 }
 
@@ -1616,6 +1629,134 @@ test_internal_consistency (void)
   g_hash_table_unref (h);
 }
 
+static guint
+constant_hash (gconstpointer key)
+{
+  return 42;
+}
+
+static void
+test_group_probing (gconstpointer test_data)
+{
+  gboolean colliding = GPOINTER_TO_INT (test_data);
+  guint n_keys = colliding ? 200 : 10000;
+  GHashTable *h;
+  GHashTable *similar;
+  GHashTableIter iter;
+  gpointer key, value;
+  gchar **keys;
+  guint i, n_iterated;
+
+  keys = g_new0 (gchar *, n_keys + 1);
+  for (i = 0; i < n_keys; i++)
+    keys[i] = g_strdup_printf ("key-%u", i);
+
+  h = g_hash_table_new_with_flags (colliding ? constant_hash : g_str_hash, g_str_equal,
+                                   g_free, NULL, G_HASH_TABLE_FLAGS_GROUP_PROBING);
+  check_counts (h, 0, 0);
+  check_consistency (h);
+
+  for (i = 0; i < n_keys; i++)
+    g_assert_true (g_hash_table_insert (h, g_strdup (keys[i]), GUINT_TO_POINTER (i + 1)));
+  g_assert_cmpuint (g_hash_table_size (h), ==, n_keys);
+  check_consistency (h);
+
+  /* Replacing an existing key must not add a new node */
+  g_assert_false (g_hash_table_insert (h, g_strdup (keys[0]), GUINT_TO_POINTER (1)));
+  g_assert_cmpuint (g_hash_table_size (h), ==, n_keys);
+
+  for (i = 0; i < n_keys; i++)
+    g_assert_cmpuint (GPOINTER_TO_UINT (g_hash_table_lookup (h, keys[i])), ==, i + 1);
+  g_assert_null (g_hash_table_lookup (h, "missing"));
+  g_assert_false (g_hash_table_contains (h, "missing"));
+
+  /* Remove every other key, then check that the rest is still there */
+  for (i = 0; i < n_keys; i += 2)
+    g_assert_true (g_hash_table_remove (h, keys[i]));
+  g_assert_false (g_hash_table_remove (h, keys[0]));
+  g_assert_cmpuint (g_hash_table_size (h), ==, n_keys / 2);
+  check_consistency (h);
+
+  for (i = 0; i < n_keys; i++)
+    {
+      if (i % 2 == 0)
+        g_assert_false (g_hash_table_contains (h, keys[i]));
+      else
+        g_assert_cmpuint (GPOINTER_TO_UINT (g_hash_table_lookup (h, keys[i])), ==, i + 1);
+    }
+
+  /* Add the removed keys back, reusing the freed buckets */
+  for (i = 0; i < n_keys; i += 2)
+    g_assert_true (g_hash_table_insert (h, g_strdup (keys[i]), GUINT_TO_POINTER (i + 1)));
+  g_assert_cmpuint (g_hash_table_size (h), ==, n_keys);
+  check_consistency (h);
+
+  n_iterated = 0;
+  g_hash_table_iter_init (&iter, h);
+  while (g_hash_table_iter_next (&iter, &key, &value))
+    {
+      g_assert_cmpstr (key, ==, keys[GPOINTER_TO_UINT (value) - 1]);
+      n_iterated++;
+
+      if (GPOINTER_TO_UINT (value) % 3 == 0)
+        g_hash_table_iter_remove (&iter);
+    }
+  g_assert_cmpuint (n_iterated, ==, n_keys);
+  g_assert_cmpuint (g_hash_table_size (h), ==, n_keys - n_keys / 3);
+  check_consistency (h);
+
+  for (i = 0; i < n_keys; i++)
+    g_assert_cmpint (g_hash_table_contains (h, keys[i]), ==, (i + 1) % 3 != 0);
+
+  similar = g_hash_table_new_similar (h);
+  g_assert_true (similar->use_groups);
+  g_hash_table_unref (similar);
+
+  g_hash_table_remove_all (h);
+  check_counts (h, 0, 0);
+  check_consistency (h);
+
+  g_hash_table_insert (h, g_strdup (keys[0]), GUINT_TO_POINTER (1));
+  g_assert_cmpuint (GPOINTER_TO_UINT (g_hash_table_lookup (h, keys[0])), ==, 1);
+
+  g_hash_table_unref (h);
+  g_strfreev (keys);
+}
+
+static void
+test_group_probing_set (void)
+{
+  GHashTable *h;
+  guint i;
+
+  h = g_hash_table_new_with_flags (NULL, NULL, NULL, NULL,
+                                   G_HASH_TABLE_FLAGS_GROUP_PROBING);
+
+  for (i = 100; i < 1100; i++)
+    g_assert_true (g_hash_table_add (h, GUINT_TO_POINTER (i)));
+  check_consistency (h);
+
+  for (i = 100; i < 1100; i++)
+    {
+      gpointer key, value;
+
+      g_assert_true (g_hash_table_lookup_extended (h, GUINT_TO_POINTER (i), &key, &value));
+      g_assert_true (key == value);
+    }
+
+  /* Turns the set into a map */
+  g_hash_table_insert (h, GUINT_TO_POINTER (100), GUINT_TO_POINTER (1));
+  g_assert_cmpuint (GPOINTER_TO_UINT (g_hash_table_lookup (h, GUINT_TO_POINTER (100))), ==, 1);
+  g_assert_cmpuint (GPOINTER_TO_UINT (g_hash_table_lookup (h, GUINT_TO_POINTER (1000))), ==, 1000);
+
+  for (i = 100; i < 1100; i++)
+    g_assert_true (g_hash_table_steal (h, GUINT_TO_POINTER (i)));
+  g_assert_cmpuint (g_hash_table_size (h), ==, 0);
+  check_consistency (h);
+
+  g_hash_table_unref (h);
+}
+
 static void
 my_key_free (gpointer v)
 {
@@ -1982,6 +2123,9 @@ main (int argc, char *argv[])
   g_test_add_func ("/hash/get-keys-as-ptr-array", test_set_get_keys_as_ptr_array);
   g_test_add_func ("/hash/get-values-as-ptr-array", test_set_get_values_as_ptr_array);
   g_test_add_func ("/hash/primes", test_primes);
+  g_test_add_data_func ("/hash/group-probing", GINT_TO_POINTER (FALSE), test_group_probing);
+  g_test_add_data_func ("/hash/group-probing/collisions", GINT_TO_POINTER (TRUE), test_group_probing);
+  g_test_add_func ("/hash/group-probing/set", test_group_probing_set);
 
   return g_test_run ();
 
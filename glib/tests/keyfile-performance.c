@@ -0,0 +1,115 @@
+/* GLIB - Library of useful routines for C programming
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+
+#include <glib.h>
+
+/* Measures how quickly key files shaped like desktop entries are loaded,
+ * as is done for every installed application at startup. Run with
+ * `-m perf` to get meaningful numbers. */
+
+static guint num_iterations = 0;
+
+static gchar *
+build_desktop_file (void)
+{
+  GString *data = g_string_new ("[Desktop Entry]\n");
+  guint i;
+
+  g_string_append (data,
+                   "Type=Application\n"
+                   "Exec=example %U\n"
+                   "Icon=org.example.App\n"
+                   "Categories=GNOME;GTK;Utility;\n"
+                   "MimeType=text/plain;text/x-csrc;text/x-chdr;\n");
+
+  /* Desktop files are mostly made of translations */
+  for (i = 0; i < 80; i++)
+    {
+      g_string_append_printf (data, "Name[l%u]=Example application %u\n", i, i);
+      g_string_append_printf (data, "Comment[l%u]=Edit example documents %u\n", i, i);
+      g_string_append_printf (data, "Keywords[l%u]=example;edit;document;%u;\n", i, i);
+    }
+
+  g_string_append (data,
+                   "\n"
+                   "[Desktop Action new-window]\n"
+                   "Name=New Window\n"
+                   "Exec=example --new-window\n");
+
+  return g_string_free (data, FALSE);
+}
+
+static void
+perform (gconstpointer data)
+{
+  GKeyFileFlags flags = GPOINTER_TO_UINT (data);
+  gchar *contents;
+  gsize length;
+  gdouble time_elapsed;
+  gdouble result;
+  guint i;
+
+  contents = build_desktop_file ();
+  length = strlen (contents);
+
+  g_test_timer_start ();
+
+  for (i = 0; i < num_iterations; i++)
+    {
+      GKeyFile *key_file = g_key_file_new ();
+      GError *error = NULL;
+      gchar *name;
+
+      g_key_file_load_from_data (key_file, contents, length, flags, &error);
+      g_assert_no_error (error);
+
+      name = g_key_file_get_locale_string (key_file, "Desktop Entry", "Name", "l7", &error);
+      g_assert_no_error (error);
+      g_assert_cmpstr (name, ==, "Example application 7");
+      g_free (name);
+
+      g_key_file_free (key_file);
+    }
+
+  time_elapsed = g_test_timer_elapsed ();
+
+  result = num_iterations / time_elapsed;
+
+  g_test_maximized_result (result, "%8.0f files/s", result);
+
+  g_free (contents);
+}
+
+int
+main (int argc, char **argv)
+{
+  g_test_init (&argc, &argv, NULL);
+
+  num_iterations = g_test_perf () ? 20000 : 1;
+
+  g_test_add_data_func ("/keyfile/perf/load",
+                        GUINT_TO_POINTER (G_KEY_FILE_KEEP_TRANSLATIONS),
+                        perform);
+  g_test_add_data_func ("/keyfile/perf/load-read-only",
+                        GUINT_TO_POINTER (G_KEY_FILE_KEEP_TRANSLATIONS | G_KEY_FILE_READ_ONLY),
+                        perform);
+
+  return g_test_run ();
+}
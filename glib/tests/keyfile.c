@@ -1931,6 +1931,90 @@ test_bytes (void)
   g_key_file_free (kf);
 }
 
+static void
+test_read_only (void)
+{
+  const gchar data[] =
+    "# top comment\r\n"
+    "\r\n"
+    "[Group1]\r\n"
+    "key1 = value1\r\n"
+    "# key comment\r\n"
+    "key2=value\\swith\\sescapes\n"
+    "key1=duplicate\n"
+    "\n"
+    "[Group2]\n"
+    "name=Name\n"
+    "name[de]=Name (de)\n"
+    "name[fr]=Name (fr)\n"
+    "list=a;b;c;\n"
+    "empty=\n"
+    "[Group3]\n"
+    "last=no newline";
+  GKeyFile *normal, *read_only;
+  gchar *normal_data, *read_only_data;
+  gchar *comment;
+  gchar **list;
+  gsize len;
+  GError *error = NULL;
+
+  normal = g_key_file_new ();
+  g_key_file_load_from_data (normal, data, -1,
+                             G_KEY_FILE_KEEP_COMMENTS | G_KEY_FILE_KEEP_TRANSLATIONS,
+                             &error);
+  g_assert_no_error (error);
+
+  read_only = g_key_file_new ();
+  g_key_file_load_from_data (read_only, data, -1,
+                             G_KEY_FILE_KEEP_COMMENTS | G_KEY_FILE_KEEP_TRANSLATIONS |
+                             G_KEY_FILE_READ_ONLY,
+                             &error);
+  g_assert_no_error (error);
+
+  /* Both ways of loading must give the same key file */
+  normal_data = g_key_file_to_data (normal, NULL, NULL);
+  read_only_data = g_key_file_to_data (read_only, NULL, NULL);
+  g_assert_cmpstr (normal_data, ==, read_only_data);
+  g_free (normal_data);
+  g_free (read_only_data);
+
+  check_string_value (read_only, "Group1", "key1", "duplicate");
+  check_string_value (read_only, "Group1", "key2", "value with escapes");
+  check_locale_string_value (read_only, "Group2", "name", "de", "Name (de)");
+  check_locale_string_value (read_only, "Group2", "name", "fr", "Name (fr)");
+  check_string_value (read_only, "Group2", "empty", "");
+  check_string_value (read_only, "Group3", "last", "no newline");
+
+  comment = g_key_file_get_comment (read_only, NULL, NULL, &error);
+  g_assert_no_error (error);
+  g_assert_cmpstr (comment, ==, " top comment\n");
+  g_free (comment);
+
+  comment = g_key_file_get_comment (read_only, "Group1", "key2", &error);
+  g_assert_no_error (error);
+  g_assert_cmpstr (comment, ==, " key comment");
+  g_free (comment);
+
+  list = g_key_file_get_string_list (read_only, "Group2", "list", &len, &error);
+  g_assert_no_error (error);
+  g_assert_cmpuint (len, ==, 3);
+  g_assert_cmpstr (list[2], ==, "c");
+  g_strfreev (list);
+
+  /* Reloading a read-only key file, in either mode, must work */
+  g_key_file_load_from_data (read_only, data, -1, G_KEY_FILE_READ_ONLY, &error);
+  g_assert_no_error (error);
+  check_string_value (read_only, "Group1", "key1", "duplicate");
+
+  g_key_file_load_from_data (read_only, data, -1, G_KEY_FILE_NONE, &error);
+  g_assert_no_error (error);
+  g_key_file_set_string (read_only, "Group1", "key1", "changed");
+  check_string_value (read_only, "Group1", "key1", "changed");
+
+  g_key_file_free (read_only);
+  g_key_file_free (normal);
+}
+
 static void
 test_get_locale (void)
 {
@@ -2036,6 +2120,7 @@ main (int argc, char *argv[])
   g_test_add_func ("/keyfile/utf8", test_utf8);
   g_test_add_func ("/keyfile/roundtrip", test_roundtrip);
   g_test_add_func ("/keyfile/bytes", test_bytes);
+  g_test_add_func ("/keyfile/read-only", test_read_only);
   g_test_add_func ("/keyfile/get-locale", test_get_locale);
   g_test_add_func ("/keyfile/free-when-not-last-ref", test_free_when_not_last_ref);
 
@@ -0,0 +1,152 @@
+/* GLIB - Library of useful routines for C programming
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+
+/* Measures the throughput of g_main_context_invoke() calls made from
+ * several threads into a context run by another one, with and without
+ * G_MAIN_CONTEXT_FLAGS_QUEUE_INVOCATIONS. Run with `-m perf`
+ * to get meaningful numbers. */
+
+static guint num_invokes = 0;
+
+typedef struct
+{
+  GMainContext *context;
+  gint remaining;  /* (atomic) */
+  gboolean done;  /* (atomic) */
+} PerfData;
+
+typedef struct
+{
+  guint n_threads;
+  GMainContextFlags flags;
+} PerfTest;
+
+static gboolean
+invoked (gpointer data)
+{
+  PerfData *pd = data;
+
+  if (g_atomic_int_dec_and_test (&pd->remaining))
+    {
+      g_atomic_int_set (&pd->done, TRUE);
+      g_main_context_wakeup (pd->context);
+    }
+
+  return G_SOURCE_REMOVE;
+}
+
+static gpointer
+invoke_thread (gpointer data)
+{
+  PerfData *pd = data;
+  guint i;
+
+  for (i = 0; i < num_invokes; i++)
+    g_main_context_invoke (pd->context, invoked, pd);
+
+  return NULL;
+}
+
+static gpointer
+loop_thread (gpointer data)
+{
+  PerfData *pd = data;
+
+  g_main_context_push_thread_default (pd->context);
+  while (!g_atomic_int_get (&pd->done))
+    g_main_context_iteration (pd->context, TRUE);
+  g_main_context_pop_thread_default (pd->context);
+
+  return NULL;
+}
+
+static void
+perform (gconstpointer data)
+{
+  const PerfTest *test = data;
+  guint n_threads = test->n_threads;
+  PerfData pd;
+  GThread *loop;
+  GThread **threads;
+  gdouble time_elapsed;
+  gdouble result;
+  guint i;
+
+  pd.context = g_main_context_new_with_flags (test->flags);
+  pd.remaining = n_threads * num_invokes;
+  pd.done = FALSE;
+
+  threads = g_new0 (GThread *, n_threads);
+
+  g_test_timer_start ();
+
+  loop = g_thread_new ("loop", loop_thread, &pd);
+  for (i = 0; i < n_threads; i++)
+    threads[i] = g_thread_new ("invoke", invoke_thread, &pd);
+
+  for (i = 0; i < n_threads; i++)
+    g_thread_join (threads[i]);
+  g_thread_join (loop);
+
+  time_elapsed = g_test_timer_elapsed ();
+
+  g_assert_cmpint (pd.remaining, ==, 0);
+
+  result = n_threads * num_invokes / time_elapsed * 1.0e-6;
+
+  g_test_maximized_result (result, "%8.3f Minvocations/s", result);
+
+  g_free (threads);
+  g_main_context_unref (pd.context);
+}
+
+int
+main (int argc, char **argv)
+{
+  guint max_threads;
+  guint n_threads;
+
+  g_test_init (&argc, &argv, NULL);
+
+  num_invokes = g_test_perf () ? 1000000 : 1000;
+  max_threads = g_test_perf () ? MAX (g_get_num_processors (), 4) : 2;
+
+  for (n_threads = 1; n_threads <= max_threads; n_threads *= 2)
+    {
+      PerfTest *test;
+      gchar *path;
+
+      test = g_new (PerfTest, 1);
+      test->n_threads = n_threads;
+      test->flags = G_MAIN_CONTEXT_FLAGS_NONE;
+      path = g_strdup_printf ("/mainloop/perf/invoke/sources/%u", n_threads);
+      g_test_add_data_func_full (path, test, perform, g_free);
+      g_free (path);
+
+      test = g_new (PerfTest, 1);
+      test->n_threads = n_threads;
+      test->flags = G_MAIN_CONTEXT_FLAGS_QUEUE_INVOCATIONS;
+      path = g_strdup_printf ("/mainloop/perf/invoke/queued/%u", n_threads);
+      g_test_add_data_func_full (path, test, perform, g_free);
+      g_free (path);
+    }
+
+  return g_test_run ();
+}
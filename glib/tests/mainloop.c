@@ -430,6 +430,327 @@ test_invoke (void)
   g_main_context_unref (ctx);
 }
 
+static gint invoke_calls;  /* (atomic) */
+static gint invoke_notifies;  /* (atomic) */
+
+static gboolean
+invoke_count (gpointer data)
+{
+  g_atomic_int_inc (&invoke_calls);
+
+  return G_SOURCE_REMOVE;
+}
+
+static gboolean
+invoke_repeat (gpointer data)
+{
+  gint *remaining = data;
+
+  g_atomic_int_inc (&invoke_calls);
+
+  return --(*remaining) > 0;
+}
+
+static gboolean
+invoke_append (gpointer data)
+{
+  GString *order = data;
+
+  g_string_append_c (order, 'h');
+
+  return G_SOURCE_REMOVE;
+}
+
+static gboolean
+invoke_append_low (gpointer data)
+{
+  GString *order = data;
+
+  g_string_append_c (order, 'l');
+
+  return G_SOURCE_REMOVE;
+}
+
+static gboolean
+invoke_destroy_current (gpointer data)
+{
+  g_atomic_int_inc (&invoke_calls);
+  g_source_destroy (g_main_current_source ());
+
+  return G_SOURCE_CONTINUE;
+}
+
+static gpointer
+invoke_count_thread (gpointer data)
+{
+  g_main_context_invoke (data, invoke_count, NULL);
+
+  return NULL;
+}
+
+static gboolean
+invoke_nested (gpointer data)
+{
+  GMainContext *ctx = data;
+  GThread *thread;
+
+  /* Wait for a function queued by another thread in a nested loop */
+  thread = g_thread_new ("invoke", invoke_count_thread, ctx);
+  while (g_atomic_int_get (&invoke_calls) == 0)
+    g_main_context_iteration (ctx, TRUE);
+  g_thread_join (thread);
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+invoke_notify (gpointer data)
+{
+  g_atomic_int_inc (&invoke_notifies);
+}
+
+#define N_INVOKES_PER_THREAD 1000
+
+static gpointer
+invoke_thread (gpointer data)
+{
+  GMainContext *ctx = data;
+  guint i;
+
+  for (i = 0; i < N_INVOKES_PER_THREAD; i++)
+    g_main_context_invoke_full (ctx, G_PRIORITY_DEFAULT, invoke_count, NULL, invoke_notify);
+
+  return NULL;
+}
+
+static void
+test_invoke_queue (void)
+{
+  GMainContext *ctx;
+  GThread *threads[4];
+  GString *order;
+  gint remaining = 3;
+  guint i;
+
+  g_test_summary ("Test functions invoked in a context owned by no thread are "
+                  "queued when it was created with G_MAIN_CONTEXT_FLAGS_QUEUE_INVOCATIONS");
+
+  ctx = g_main_context_new_with_flags (G_MAIN_CONTEXT_FLAGS_QUEUE_INVOCATIONS);
+  g_atomic_int_set (&invoke_calls, 0);
+  g_atomic_int_set (&invoke_notifies, 0);
+
+  /* From any number of threads */
+  for (i = 0; i < G_N_ELEMENTS (threads); i++)
+    threads[i] = g_thread_new ("invoke", invoke_thread, ctx);
+  for (i = 0; i < G_N_ELEMENTS (threads); i++)
+    g_thread_join (threads[i]);
+
+  g_assert_cmpint (g_atomic_int_get (&invoke_calls), ==, 0);
+  while (g_main_context_iteration (ctx, FALSE));
+  g_assert_cmpint (g_atomic_int_get (&invoke_calls), ==, G_N_ELEMENTS (threads) * N_INVOKES_PER_THREAD);
+  g_assert_cmpint (g_atomic_int_get (&invoke_notifies), ==, G_N_ELEMENTS (threads) * N_INVOKES_PER_THREAD);
+
+  /* Functions returning TRUE are called again in the next iteration */
+  g_atomic_int_set (&invoke_calls, 0);
+  g_main_context_invoke (ctx, invoke_repeat, &remaining);
+  g_main_context_iteration (ctx, FALSE);
+  g_assert_cmpint (g_atomic_int_get (&invoke_calls), ==, 1);
+  while (g_main_context_iteration (ctx, FALSE));
+  g_assert_cmpint (g_atomic_int_get (&invoke_calls), ==, 3);
+  g_assert_cmpint (remaining, ==, 0);
+
+  /* Priorities are respected */
+  order = g_string_new (NULL);
+  g_main_context_invoke_full (ctx, G_PRIORITY_LOW, invoke_append_low, order, NULL);
+  g_main_context_invoke_full (ctx, G_PRIORITY_HIGH, invoke_append, order, NULL);
+  g_main_context_iteration (ctx, FALSE);
+  g_assert_cmpstr (order->str, ==, "h");
+  g_main_context_iteration (ctx, FALSE);
+  g_assert_cmpstr (order->str, ==, "hl");
+  g_string_free (order, TRUE);
+
+  /* A function can run a nested loop until another queued one has run */
+  g_atomic_int_set (&invoke_calls, 0);
+  g_main_context_invoke (ctx, invoke_nested, ctx);
+  while (g_main_context_iteration (ctx, FALSE));
+  g_assert_cmpint (g_atomic_int_get (&invoke_calls), ==, 1);
+
+  /* Destroying the current source stops only the function doing it */
+  g_atomic_int_set (&invoke_calls, 0);
+  g_atomic_int_set (&invoke_notifies, 0);
+  g_main_context_invoke_full (ctx, G_PRIORITY_DEFAULT, invoke_destroy_current, NULL, invoke_notify);
+  g_main_context_invoke (ctx, invoke_count, NULL);
+  while (g_main_context_iteration (ctx, FALSE));
+  g_assert_cmpint (g_atomic_int_get (&invoke_calls), ==, 2);
+  g_assert_cmpint (g_atomic_int_get (&invoke_notifies), ==, 1);
+  g_main_context_invoke (ctx, invoke_count, NULL);
+  while (g_main_context_iteration (ctx, FALSE));
+  g_assert_cmpint (g_atomic_int_get (&invoke_calls), ==, 3);
+
+  /* Data for functions which never ran is freed with the context */
+  g_atomic_int_set (&invoke_notifies, 0);
+  g_main_context_invoke_full (ctx, G_PRIORITY_DEFAULT, invoke_count, NULL, invoke_notify);
+  g_main_context_unref (ctx);
+  g_assert_cmpint (g_atomic_int_get (&invoke_calls), ==, 3);
+  g_assert_cmpint (g_atomic_int_get (&invoke_notifies), ==, 1);
+}
+
+static gboolean
+stats_sleep (gpointer data)
+{
+  g_usleep (2000);
+
+  return G_SOURCE_REMOVE;
+}
+
+static gboolean
+stats_count (gpointer data)
+{
+  gint *remaining = data;
+
+  return --(*remaining) > 0;
+}
+
+static gboolean
+stats_unnamed_prepare (GSource *source,
+                       gint    *timeout)
+{
+  *timeout = -1;
+  return TRUE;
+}
+
+static gboolean
+stats_unnamed_dispatch (GSource     *source,
+                        GSourceFunc  callback,
+                        gpointer     user_data)
+{
+  return callback (user_data);
+}
+
+static GSourceFuncs stats_unnamed_funcs = {
+  stats_unnamed_prepare, NULL, stats_unnamed_dispatch, NULL, NULL, NULL
+};
+
+static GVariant *
+lookup_source_stats (GMainContext *ctx,
+                     const gchar  *name)
+{
+  GVariant *stats, *entry;
+
+  stats = g_main_context_get_source_stats (ctx);
+  g_assert_true (g_variant_is_of_type (stats, G_VARIANT_TYPE ("a{sa{sv}}")));
+  entry = g_variant_lookup_value (stats, name, G_VARIANT_TYPE_VARDICT);
+  g_variant_unref (stats);
+
+  return entry;
+}
+
+static void
+test_source_stats (void)
+{
+  GMainContext *ctx;
+  GSource *source;
+  GVariant *entry, *histogram;
+  const guint64 *buckets;
+  gsize n_buckets, i;
+  guint64 count, dispatch_time, max_time, total;
+  gint remaining = 5;
+
+  g_test_summary ("Test dispatch statistics are collected by source name");
+
+  ctx = g_main_context_new ();
+  g_assert_false (g_main_context_get_source_stats_enabled (ctx));
+
+  /* Nothing is collected until enabled */
+  source = g_idle_source_new ();
+  g_source_set_name (source, "stats-idle");
+  g_source_set_callback (source, stats_count, &remaining, NULL);
+  g_source_attach (source, ctx);
+  g_main_context_iteration (ctx, FALSE);
+  g_assert_cmpint (remaining, ==, 4);
+  g_assert_null (lookup_source_stats (ctx, "stats-idle"));
+
+  g_main_context_set_source_stats_enabled (ctx, TRUE);
+  g_assert_true (g_main_context_get_source_stats_enabled (ctx));
+
+  while (g_main_context_iteration (ctx, FALSE));
+  g_assert_cmpint (remaining, ==, 0);
+  g_source_unref (source);
+
+  source = g_idle_source_new ();
+  g_source_set_name (source, "stats-sleep");
+  g_source_set_callback (source, stats_sleep, NULL, NULL);
+  g_source_attach (source, ctx);
+  g_source_unref (source);
+
+  source = g_source_new (&stats_unnamed_funcs, sizeof (GSource));
+  g_source_set_callback (source, stats_sleep, NULL, NULL);
+  g_source_attach (source, ctx);
+  g_source_unref (source);
+
+  while (g_main_context_iteration (ctx, FALSE));
+
+  entry = lookup_source_stats (ctx, "stats-idle");
+  g_assert_nonnull (entry);
+  g_assert_true (g_variant_lookup (entry, "dispatch-count", "t", &count));
+  g_assert_cmpuint (count, ==, 4);
+  histogram = g_variant_lookup_value (entry, "latency-histogram", G_VARIANT_TYPE ("at"));
+  g_assert_nonnull (histogram);
+  buckets = g_variant_get_fixed_array (histogram, &n_buckets, sizeof (guint64));
+  g_assert_cmpuint (n_buckets, >, 0);
+  for (i = 0, total = 0; i < n_buckets; i++)
+    total += buckets[i];
+  g_assert_cmpuint (total, ==, count);
+  g_variant_unref (histogram);
+  g_variant_unref (entry);
+
+  entry = lookup_source_stats (ctx, "stats-sleep");
+  g_assert_nonnull (entry);
+  g_assert_true (g_variant_lookup (entry, "dispatch-count", "t", &count));
+  g_assert_true (g_variant_lookup (entry, "dispatch-time", "t", &dispatch_time));
+  g_assert_true (g_variant_lookup (entry, "max-dispatch-time", "t", &max_time));
+  g_assert_cmpuint (count, ==, 1);
+  g_assert_cmpuint (max_time, >=, 2000);
+  g_assert_cmpuint (dispatch_time, ==, max_time);
+  g_variant_unref (entry);
+
+  entry = lookup_source_stats (ctx, "(unnamed)");
+  g_assert_nonnull (entry);
+  g_assert_true (g_variant_lookup (entry, "dispatch-count", "t", &count));
+  g_assert_cmpuint (count, ==, 1);
+  g_variant_unref (entry);
+
+  /* Resetting clears everything; disabling keeps what was collected */
+  g_main_context_reset_source_stats (ctx);
+  g_assert_null (lookup_source_stats (ctx, "stats-idle"));
+  g_assert_null (lookup_source_stats (ctx, "stats-sleep"));
+
+  source = g_idle_source_new ();
+  g_source_set_name (source, "stats-sleep");
+  g_source_set_callback (source, stats_sleep, NULL, NULL);
+  g_source_attach (source, ctx);
+  g_source_unref (source);
+  while (g_main_context_iteration (ctx, FALSE));
+
+  g_main_context_set_source_stats_enabled (ctx, FALSE);
+  g_assert_false (g_main_context_get_source_stats_enabled (ctx));
+
+  source = g_idle_source_new ();
+  g_source_set_name (source, "stats-sleep");
+  g_source_set_callback (source, stats_sleep, NULL, NULL);
+  g_source_attach (source, ctx);
+  g_source_unref (source);
+  while (g_main_context_iteration (ctx, FALSE));
+
+  entry = lookup_source_stats (ctx, "stats-sleep");
+  g_assert_nonnull (entry);
+  g_assert_true (g_variant_lookup (entry, "dispatch-count", "t", &count));
+  g_assert_cmpuint (count, ==, 1);
+  g_variant_unref (entry);
+
+  g_main_context_unref (ctx);
+}
+
 /* We can't use timeout sources here because on slow or heavily-loaded
  * machines, the test program might not get enough cycles to hit the
  * timeouts at the expected times. So instead we define a source that
@@ -1097,6 +1418,204 @@ test_ready_time (void)
   g_source_destroy (source);
 }
 
+typedef struct
+{
+  GSource source;
+  guint n_dispatched;
+} CountingSource;
+
+static gboolean
+counting_dispatch (GSource     *source,
+                   GSourceFunc  callback,
+                   gpointer     user_data)
+{
+  ((CountingSource *) source)->n_dispatched++;
+
+  g_source_set_ready_time (source, -1);
+
+  return G_SOURCE_CONTINUE;
+}
+
+static GSourceFuncs counting_funcs = {
+  NULL, NULL, counting_dispatch, NULL, NULL, NULL
+};
+
+static void
+test_many_ready_times (void)
+{
+  const guint n_sources = 1000;
+  GMainContext *ctx;
+  CountingSource **sources;
+  gint64 now;
+  guint i;
+
+  g_test_summary ("Test many sources waiting only on their ready time");
+
+  ctx = g_main_context_new ();
+  sources = g_new0 (CountingSource *, n_sources);
+  now = g_get_monotonic_time ();
+
+  /* Half are ready already, in no particular order, the rest are far away */
+  for (i = 0; i < n_sources; i++)
+    {
+      sources[i] = (CountingSource *) g_source_new (&counting_funcs, sizeof (CountingSource));
+      if (i % 2 == 0)
+        g_source_set_ready_time ((GSource *) sources[i], now - (i * 7919) % n_sources);
+      else
+        g_source_set_ready_time ((GSource *) sources[i], now + G_TIME_SPAN_HOUR + i);
+      g_source_attach ((GSource *) sources[i], ctx);
+    }
+
+  while (g_main_context_iteration (ctx, FALSE));
+
+  for (i = 0; i < n_sources; i++)
+    g_assert_cmpuint (sources[i]->n_dispatched, ==, (i % 2 == 0) ? 1 : 0);
+
+  /* Bring some of the waiting ones forward, put some back and drop others */
+  for (i = 1; i < n_sources; i += 2)
+    {
+      if (i % 3 == 0)
+        g_source_set_ready_time ((GSource *) sources[i], 0);
+      else if (i % 3 == 1)
+        g_source_set_ready_time ((GSource *) sources[i], -1);
+      else
+        g_source_destroy ((GSource *) sources[i]);
+    }
+  g_source_set_ready_time ((GSource *) sources[0], now);
+
+  while (g_main_context_iteration (ctx, FALSE));
+
+  g_assert_cmpuint (sources[0]->n_dispatched, ==, 2);
+  for (i = 1; i < n_sources; i++)
+    {
+      guint expected = (i % 2 == 0) ? 1 : (i % 3 == 0) ? 1 : 0;
+      g_assert_cmpuint (sources[i]->n_dispatched, ==, expected);
+    }
+
+  /* Only the highest priority ready sources are dispatched together */
+  g_source_set_priority ((GSource *) sources[2], G_PRIORITY_HIGH);
+  g_source_set_ready_time ((GSource *) sources[2], 0);
+  g_source_set_ready_time ((GSource *) sources[4], 0);
+  g_main_context_iteration (ctx, FALSE);
+  g_assert_cmpuint (sources[2]->n_dispatched, ==, 2);
+  g_assert_cmpuint (sources[4]->n_dispatched, ==, 1);
+  g_main_context_iteration (ctx, FALSE);
+  g_assert_cmpuint (sources[4]->n_dispatched, ==, 2);
+
+  /* The next ready time gives the timeout to poll for */
+  g_source_set_ready_time ((GSource *) sources[8], g_get_monotonic_time () + 10000);
+  while (sources[8]->n_dispatched == 1)
+    g_main_context_iteration (ctx, TRUE);
+  g_assert_cmpuint (sources[8]->n_dispatched, ==, 2);
+
+  for (i = 0; i < n_sources; i++)
+    {
+      g_source_destroy ((GSource *) sources[i]);
+      g_source_unref ((GSource *) sources[i]);
+    }
+  g_free (sources);
+
+  g_main_context_unref (ctx);
+}
+
+static gboolean
+append_t_cb (gpointer user_data)
+{
+  g_string_append_c (user_data, 't');
+  return G_SOURCE_CONTINUE;
+}
+
+static gboolean
+append_i_cb (gpointer user_data)
+{
+  g_string_append_c (user_data, 'i');
+  return G_SOURCE_CONTINUE;
+}
+
+static void
+test_timer_order (void)
+{
+  GMainContext *ctx;
+  GSource *timeout, *idle;
+  GString *order;
+  guint i;
+
+  g_test_summary ("Test that timers and other sources of the same priority "
+                  "are dispatched in the order they were attached");
+
+  ctx = g_main_context_new ();
+  order = g_string_new (NULL);
+
+  timeout = g_timeout_source_new (0);
+  g_source_set_callback (timeout, append_t_cb, order, NULL);
+  g_source_attach (timeout, ctx);
+
+  idle = g_idle_source_new ();
+  g_source_set_priority (idle, G_PRIORITY_DEFAULT);
+  g_source_set_callback (idle, append_i_cb, order, NULL);
+  g_source_attach (idle, ctx);
+
+  /* The timeout goes back to the timers after each dispatch, and must
+   * come back ahead of the idle every time it expires */
+  for (i = 0; i < 5; i++)
+    g_main_context_iteration (ctx, FALSE);
+
+  g_assert_cmpstr (order->str, ==, "tititititi");
+
+  g_source_destroy (timeout);
+  g_source_unref (timeout);
+  g_source_destroy (idle);
+  g_source_unref (idle);
+  g_string_free (order, TRUE);
+  g_main_context_unref (ctx);
+}
+
+static void
+test_timer_disarm (void)
+{
+  GMainContext *ctx;
+  CountingSource *timer;
+  GSource *idle;
+  gint n_idles = 0;
+
+  g_test_summary ("Test that a timer which expired while sources of a higher "
+                  "priority were ready can still be disarmed before it is "
+                  "dispatched");
+
+  ctx = g_main_context_new ();
+
+  timer = (CountingSource *) g_source_new (&counting_funcs, sizeof (CountingSource));
+  g_source_set_priority ((GSource *) timer, G_PRIORITY_LOW);
+  g_source_set_ready_time ((GSource *) timer, 0);
+  g_source_attach ((GSource *) timer, ctx);
+
+  idle = g_idle_source_new ();
+  g_source_set_priority (idle, G_PRIORITY_HIGH);
+  g_source_set_callback (idle, count_calls, &n_idles, NULL);
+  g_source_attach (idle, ctx);
+
+  /* The idle shadows the timer, which has expired */
+  g_assert_true (g_main_context_iteration (ctx, FALSE));
+  g_assert_cmpint (n_idles, ==, 1);
+  g_assert_cmpuint (timer->n_dispatched, ==, 0);
+
+  g_source_destroy (idle);
+  g_source_set_ready_time ((GSource *) timer, -1);
+
+  g_assert_false (g_main_context_iteration (ctx, FALSE));
+  g_assert_cmpuint (timer->n_dispatched, ==, 0);
+
+  /* It can be armed again afterwards */
+  g_source_set_ready_time ((GSource *) timer, 0);
+  g_assert_true (g_main_context_iteration (ctx, FALSE));
+  g_assert_cmpuint (timer->n_dispatched, ==, 1);
+
+  g_source_unref (idle);
+  g_source_destroy ((GSource *) timer);
+  g_source_unref ((GSource *) timer);
+  g_main_context_unref (ctx);
+}
+
 static void
 test_wakeup(void)
 {
@@ -1433,6 +1952,45 @@ flag_bool (gint         fd,
   return TRUE;
 }
 
+static void
+test_ready_time_unix_fd (void)
+{
+  GMainContext *ctx;
+  CountingSource *source;
+  gint fds[2];
+  gpointer tag;
+  GError *error = NULL;
+
+  g_test_summary ("Test a source waiting on its ready time starting to poll a file descriptor");
+
+  ctx = g_main_context_new ();
+  g_unix_open_pipe (fds, O_CLOEXEC, &error);
+  g_assert_no_error (error);
+
+  source = (CountingSource *) g_source_new (&counting_funcs, sizeof (CountingSource));
+  g_source_set_ready_time ((GSource *) source, g_get_monotonic_time () + G_TIME_SPAN_HOUR);
+  g_source_attach ((GSource *) source, ctx);
+
+  tag = g_source_add_unix_fd ((GSource *) source, fds[0], G_IO_IN);
+  g_assert_false (g_main_context_iteration (ctx, FALSE));
+  g_assert_cmpuint (source->n_dispatched, ==, 0);
+
+  g_assert_cmpint (write (fds[1], "x", 1), ==, 1);
+  g_main_context_iteration (ctx, FALSE);
+  g_assert_cmpuint (source->n_dispatched, ==, 1);
+
+  g_source_remove_unix_fd ((GSource *) source, tag);
+  g_source_set_ready_time ((GSource *) source, 0);
+  g_main_context_iteration (ctx, FALSE);
+  g_assert_cmpuint (source->n_dispatched, ==, 2);
+
+  g_source_destroy ((GSource *) source);
+  g_source_unref ((GSource *) source);
+  g_close (fds[0], NULL);
+  g_close (fds[1], NULL);
+  g_main_context_unref (ctx);
+}
+
 static void
 test_unix_fd_source (void)
 {
@@ -1739,6 +2297,145 @@ test_unix_fd_priority (void)
   close (fd2);
 }
 
+static gboolean
+store_condition (gint         fd,
+                 GIOCondition condition,
+                 gpointer     user_data)
+{
+  GIOCondition *stored = user_data;
+
+  *stored = condition;
+
+  return TRUE;
+}
+
+typedef struct
+{
+  FlagSource parent;
+  GPollFD poll_fd;
+} PollFDSource;
+
+static gboolean
+poll_fd_source_check (GSource *source)
+{
+  return ((PollFDSource *) source)->poll_fd.revents != 0;
+}
+
+static void
+test_epoll_context (void)
+{
+  GSourceFuncs no_funcs = {
+    NULL, NULL, return_true, NULL, NULL, NULL
+  };
+  GSourceFuncs poll_fd_funcs = {
+    NULL, poll_fd_source_check, return_true, NULL, NULL, NULL
+  };
+  GMainContext *context;
+  GSource *source_a;
+  GSource *source_b;
+  GSource *source_null;
+  PollFDSource *source_poll;
+  gpointer tag;
+  gint fds[2];
+  gint null_fd;
+  GIOCondition condition = 0;
+  gboolean null_in = FALSE;
+  char c = 'x';
+
+  g_test_summary ("Test that fd sources are dispatched correctly by a "
+                  "context created with G_MAIN_CONTEXT_FLAGS_EPOLL");
+
+  context = g_main_context_new_with_flags (G_MAIN_CONTEXT_FLAGS_EPOLL);
+  g_assert_cmpint (pipe (fds), ==, 0);
+
+  /* Nothing to read yet */
+  source_a = g_unix_fd_source_new (fds[0], G_IO_IN);
+  g_source_set_callback (source_a, G_SOURCE_FUNC (store_condition), &condition, NULL);
+  g_source_attach (source_a, context);
+  g_assert_false (g_main_context_iteration (context, FALSE));
+  g_assert_cmpint (condition, ==, 0);
+
+  /* A second source watching the same fd, not interested in anything yet */
+  source_b = g_source_new (&no_funcs, sizeof (FlagSource));
+  tag = g_source_add_unix_fd (source_b, fds[0], 0);
+  g_source_attach (source_b, context);
+  g_assert_false (g_main_context_iteration (context, FALSE));
+  assert_not_flagged (source_b);
+
+  /* Both should see the data once they ask for it */
+  g_assert_cmpint (write (fds[1], &c, 1), ==, 1);
+  g_source_modify_unix_fd (source_b, tag, G_IO_IN);
+  g_assert_true (g_main_context_iteration (context, TRUE));
+  g_assert_cmpint (condition, ==, G_IO_IN);
+  assert_flagged (source_b);
+  condition = 0;
+  clear_flag (source_b);
+
+  /* Once drained, neither is ready */
+  g_assert_cmpint (read (fds[0], &c, 1), ==, 1);
+  g_assert_false (g_main_context_iteration (context, FALSE));
+  g_assert_cmpint (condition, ==, 0);
+  assert_not_flagged (source_b);
+
+  /* Removing one of the sources keeps the fd watched for the other */
+  g_source_destroy (source_b);
+  g_source_unref (source_b);
+  g_assert_cmpint (write (fds[1], &c, 1), ==, 1);
+  g_assert_true (g_main_context_iteration (context, TRUE));
+  g_assert_cmpint (condition, ==, G_IO_IN);
+  condition = 0;
+
+  /* Closing the other end is reported as a hang-up */
+  g_assert_cmpint (read (fds[0], &c, 1), ==, 1);
+  close (fds[1]);
+  g_assert_true (g_main_context_iteration (context, TRUE));
+  g_assert_cmpint (condition, ==, G_IO_HUP);
+  g_source_destroy (source_a);
+  g_source_unref (source_a);
+  close (fds[0]);
+
+  /* The events of a GPollFD added with g_source_add_poll() may be changed
+   * in place, without telling the context */
+  g_assert_cmpint (pipe (fds), ==, 0);
+  source_poll = (PollFDSource *) g_source_new (&poll_fd_funcs, sizeof (PollFDSource));
+  source_poll->poll_fd.fd = fds[0];
+  source_poll->poll_fd.events = 0;
+  g_source_add_poll ((GSource *) source_poll, &source_poll->poll_fd);
+  g_source_attach ((GSource *) source_poll, context);
+  g_assert_cmpint (write (fds[1], &c, 1), ==, 1);
+  g_assert_false (g_main_context_iteration (context, FALSE));
+  assert_not_flagged (source_poll);
+
+  source_poll->poll_fd.events = G_IO_IN;
+  g_assert_true (g_main_context_iteration (context, TRUE));
+  assert_flagged (source_poll);
+  clear_flag (source_poll);
+
+  source_poll->poll_fd.events = 0;
+  g_assert_false (g_main_context_iteration (context, FALSE));
+  assert_not_flagged (source_poll);
+  g_source_destroy ((GSource *) source_poll);
+  g_source_unref ((GSource *) source_poll);
+  close (fds[1]);
+
+  /* Files epoll refuses to watch are always ready, as with poll() */
+  null_fd = open ("/dev/null", O_RDONLY);
+  g_assert_cmpint (null_fd, >=, 0);
+  source_null = g_unix_fd_source_new (null_fd, G_IO_IN);
+  g_source_set_callback (source_null, G_SOURCE_FUNC (flag_bool), &null_in, NULL);
+  g_source_attach (source_null, context);
+  g_assert_true (g_main_context_iteration (context, TRUE));
+  g_assert_true (null_in);
+  g_source_destroy (source_null);
+  g_source_unref (source_null);
+
+  g_assert_false (g_main_context_iteration (context, FALSE));
+
+  g_main_context_unref (context);
+  close (null_fd);
+  close (fds[0]);
+}
+
 #endif
 
 #ifdef G_OS_UNIX
@@ -2720,6 +3417,8 @@ main (int argc, char *argv[])
   g_test_add_func ("/mainloop/timeouts", test_timeouts);
   g_test_add_func ("/mainloop/priorities", test_priorities);
   g_test_add_func ("/mainloop/invoke", test_invoke);
+  g_test_add_func ("/mainloop/invoke-queue", test_invoke_queue);
+  g_test_add_func ("/mainloop/source-stats", test_source_stats);
   g_test_add_func ("/mainloop/child_sources", test_child_sources);
   g_test_add_func ("/mainloop/recursive_child_sources", test_recursive_child_sources);
   g_test_add_func ("/mainloop/recursive_loop_child_sources", test_recursive_loop_child_sources);
@@ -2728,16 +3427,21 @@ main (int argc, char *argv[])
   g_test_add_func ("/mainloop/source_time", test_source_time);
   g_test_add_func ("/mainloop/overflow", test_mainloop_overflow);
   g_test_add_func ("/mainloop/ready-time", test_ready_time);
+  g_test_add_func ("/mainloop/many-ready-times", test_many_ready_times);
+  g_test_add_func ("/mainloop/timer-order", test_timer_order);
+  g_test_add_func ("/mainloop/timer-disarm", test_timer_disarm);
   g_test_add_func ("/mainloop/wakeup", test_wakeup);
   g_test_add_func ("/mainloop/remove-invalid", test_remove_invalid);
   g_test_add_func ("/mainloop/unref-while-pending", test_unref_while_pending);
 #ifdef G_OS_UNIX
   g_test_add_func ("/mainloop/unix-fd", test_unix_fd);
   g_test_add_func ("/mainloop/unix-fd-source", test_unix_fd_source);
+  g_test_add_func ("/mainloop/ready-time-unix-fd", test_ready_time_unix_fd);
   g_test_add_func ("/mainloop/source-unix-fd-api", test_source_unix_fd_api);
   g_test_add_func ("/mainloop/wait", test_mainloop_wait);
   g_test_add_func ("/mainloop/unix-file-poll", test_unix_file_poll);
   g_test_add_func ("/mainloop/unix-fd-priority", test_unix_fd_priority);
+  g_test_add_func ("/mainloop/epoll-context", test_epoll_context);
 #endif
   g_test_add_func ("/mainloop/nfds", test_nfds);
   g_test_add_func ("/mainloop/steal-fd", test_steal_fd);
@@ -0,0 +1,169 @@
+/* GLIB - Library of useful routines for C programming
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+
+/* Measures the throughput of interning strings from several threads at
+ * once, as parsers interning element and attribute names do. Run with
+ * `-m perf` to get meaningful numbers. */
+
+/* Number of existing names each thread looks up repeatedly */
+#define N_NAMES 1000
+
+static guint num_iterations = 0;
+
+/* Number of new names each thread creates */
+static guint num_created = 0;
+
+/* Each test run creates quarks which have never been seen before */
+static guint run_id = 0;
+
+typedef struct
+{
+  gboolean create;
+  guint n_threads;
+} PerfData;
+
+typedef struct
+{
+  gchar **names;
+  guint n_names;
+  guint n_iterations;
+} ThreadData;
+
+static gpointer
+intern_thread (gpointer data)
+{
+  ThreadData *td = data;
+  guint i, j;
+
+  for (i = 0; i < td->n_iterations; i++)
+    for (j = 0; j < td->n_names; j++)
+      g_quark_from_string (td->names[j]);
+
+  return NULL;
+}
+
+static void
+perform (gconstpointer data)
+{
+  const PerfData *pd = data;
+  ThreadData *tds;
+  GThread **threads;
+  gdouble time_elapsed;
+  gdouble result;
+  guint64 n_interned = 0;
+  guint i, j;
+
+  tds = g_new0 (ThreadData, pd->n_threads);
+  threads = g_new0 (GThread *, pd->n_threads);
+  run_id++;
+
+  for (i = 0; i < pd->n_threads; i++)
+    {
+      tds[i].n_names = pd->create ? num_created : N_NAMES;
+      tds[i].names = g_new0 (gchar *, tds[i].n_names + 1);
+
+      for (j = 0; j < tds[i].n_names; j++)
+        {
+          /* Either every thread interns new names of its own, or they all
+           * look up the same existing ones */
+          if (pd->create)
+            tds[i].names[j] = g_strdup_printf ("run%u-thread%u-attribute%u", run_id, i, j);
+          else
+            tds[i].names[j] = g_strdup_printf ("attribute%u", j);
+        }
+
+      if (pd->create)
+        {
+          tds[i].n_iterations = 1;
+        }
+      else
+        {
+          tds[i].n_iterations = num_iterations;
+          for (j = 0; j < N_NAMES; j++)
+            g_quark_from_string (tds[i].names[j]);
+        }
+
+      n_interned += (guint64) tds[i].n_iterations * tds[i].n_names;
+    }
+
+  g_test_timer_start ();
+
+  for (i = 0; i < pd->n_threads; i++)
+    threads[i] = g_thread_new ("intern", intern_thread, &tds[i]);
+  for (i = 0; i < pd->n_threads; i++)
+    g_thread_join (threads[i]);
+
+  time_elapsed = g_test_timer_elapsed ();
+
+  result = n_interned / time_elapsed * 1.0e-6;
+
+  g_test_maximized_result (result, "%8.2f Mquarks/s", result);
+
+  for (i = 0; i < pd->n_threads; i++)
+    {
+      for (j = 0; j < tds[i].n_names; j++)
+        g_assert_cmpuint (g_quark_try_string (tds[i].names[j]), !=, 0);
+      g_strfreev (tds[i].names);
+    }
+
+  g_free (threads);
+  g_free (tds);
+}
+
+static void
+add_cases (const char *path,
+           gboolean    create)
+{
+  guint max_threads = g_test_perf () ? MAX (g_get_num_processors (), 4) : 2;
+  guint n_threads = 1;
+
+  while (TRUE)
+    {
+      PerfData *pd;
+      gchar *full_path;
+
+      pd = g_new0 (PerfData, 1);
+      pd->create = create;
+      pd->n_threads = n_threads;
+
+      full_path = g_strdup_printf ("%s/%u", path, n_threads);
+      g_test_add_data_func_full (full_path, pd, perform, g_free);
+      g_free (full_path);
+
+      if (n_threads == max_threads)
+        break;
+
+      n_threads = MIN (n_threads * 2, max_threads);
+    }
+}
+
+int
+main (int argc, char **argv)
+{
+  g_test_init (&argc, &argv, NULL);
+
+  num_iterations = g_test_perf () ? 2000 : 1;
+  num_created = g_test_perf () ? 200000 : 100;
+
+  add_cases ("/quark/perf/lookup", FALSE);
+  add_cases ("/quark/perf/create", TRUE);
+
+  return g_test_run ();
+}
@@ -0,0 +1,249 @@
+/* GLIB - Library of useful routines for C programming
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+
+/* Measures classifying log lines with many patterns, either matching each
+ * pattern in turn or matching them all at once with a GRegexSet, and
+ * matching one pattern against many short strings. Run with `-m perf` to
+ * get meaningful numbers. */
+
+#define N_PATTERNS 500
+#define N_LINES 1000
+
+static guint num_iterations = 0;
+
+static gchar **patterns = NULL;
+static gchar **lines = NULL;
+
+static void
+build_data (void)
+{
+  GPtrArray *array;
+  GRand *rand;
+  guint i;
+
+  array = g_ptr_array_new ();
+  for (i = 0; i < N_PATTERNS; i++)
+    {
+      switch (i % 5)
+        {
+        case 0:
+          g_ptr_array_add (array, g_strdup_printf ("service%u: connection (refused|reset) from [0-9.]+", i));
+          break;
+        case 1:
+          g_ptr_array_add (array, g_strdup_printf ("error code %u\\b", i));
+          break;
+        case 2:
+          g_ptr_array_add (array, g_strdup_printf ("user \\w+ logged in to host%u", i));
+          break;
+        case 3:
+          g_ptr_array_add (array, g_strdup_printf ("^kernel: disk%u: .*I/O error", i));
+          break;
+        default:
+          g_ptr_array_add (array, g_strdup_printf ("took \\d+ms in handler_%u$", i));
+          break;
+        }
+    }
+  g_ptr_array_add (array, NULL);
+  patterns = (gchar **) g_ptr_array_free (array, FALSE);
+
+  /* Mostly lines which match none of the patterns, as in real logs */
+  rand = g_rand_new_with_seed (42);
+  array = g_ptr_array_new ();
+  for (i = 0; i < N_LINES; i++)
+    {
+      guint n = g_rand_int_range (rand, 0, N_PATTERNS * 10);
+
+      switch (g_rand_int_range (rand, 0, 6))
+        {
+        case 0:
+          g_ptr_array_add (array, g_strdup_printf ("Oct 16 12:00:00 myhost service%u: connection reset from 10.0.0.%u", n, n % 256));
+          break;
+        case 1:
+          g_ptr_array_add (array, g_strdup_printf ("Oct 16 12:00:01 myhost app[%u]: request failed with error code %u", n, n));
+          break;
+        case 2:
+          g_ptr_array_add (array, g_strdup_printf ("Oct 16 12:00:02 myhost sshd[%u]: user alice logged in to host%u", n, n));
+          break;
+        case 3:
+          g_ptr_array_add (array, g_strdup_printf ("kernel: disk%u: sector %u: I/O error", n, n * 7));
+          break;
+        case 4:
+          g_ptr_array_add (array, g_strdup_printf ("Oct 16 12:00:04 myhost app[%u]: took %ums in handler_%u", n, n % 1000, n));
+          break;
+        default:
+          g_ptr_array_add (array, g_strdup_printf ("Oct 16 12:00:05 myhost app[%u]: heartbeat %u, all is well", n, n));
+          break;
+        }
+    }
+  g_ptr_array_add (array, NULL);
+  lines = (gchar **) g_ptr_array_free (array, FALSE);
+  g_rand_free (rand);
+}
+
+static void
+test_sequential (void)
+{
+  GRegex **regexes;
+  gdouble time_elapsed;
+  gdouble result;
+  guint64 n_matches = 0;
+  guint i, j, k;
+
+  regexes = g_new (GRegex *, N_PATTERNS);
+  for (i = 0; i < N_PATTERNS; i++)
+    regexes[i] = g_regex_new (patterns[i], G_REGEX_OPTIMIZE, G_REGEX_MATCH_DEFAULT, NULL);
+
+  g_test_timer_start ();
+
+  for (i = 0; i < num_iterations; i++)
+    for (j = 0; j < N_LINES; j++)
+      for (k = 0; k < N_PATTERNS; k++)
+        if (g_regex_match (regexes[k], lines[j], G_REGEX_MATCH_DEFAULT, NULL))
+          n_matches++;
+
+  time_elapsed = g_test_timer_elapsed ();
+
+  result = ((gdouble) num_iterations * N_LINES / time_elapsed) * 1.0e-3;
+  g_test_maximized_result (result, "%7.1f klines/s", result);
+
+  g_assert_cmpuint (n_matches, >, 0);
+
+  for (i = 0; i < N_PATTERNS; i++)
+    g_regex_unref (regexes[i]);
+  g_free (regexes);
+}
+
+static void
+test_set (void)
+{
+  GRegexSet *set;
+  GArray *matches;
+  gdouble time_elapsed;
+  gdouble result;
+  guint64 n_matches = 0;
+  guint i, j;
+
+  set = g_regex_set_new ((const gchar * const *) patterns, G_REGEX_OPTIMIZE,
+                         G_REGEX_MATCH_DEFAULT, NULL);
+  matches = g_array_new (FALSE, FALSE, sizeof (guint));
+
+  g_test_timer_start ();
+
+  for (i = 0; i < num_iterations; i++)
+    for (j = 0; j < N_LINES; j++)
+      {
+        g_regex_set_match (set, lines[j], G_REGEX_MATCH_DEFAULT, matches);
+        n_matches += matches->len;
+      }
+
+  time_elapsed = g_test_timer_elapsed ();
+
+  result = ((gdouble) num_iterations * N_LINES / time_elapsed) * 1.0e-3;
+  g_test_maximized_result (result, "%7.1f klines/s", result);
+
+  g_assert_cmpuint (n_matches, >, 0);
+
+  g_array_unref (matches);
+  g_regex_set_unref (set);
+}
+
+typedef enum
+{
+  MATCH_NEW_INFO,
+  MATCH_NO_INFO,
+  MATCH_REUSE_INFO,
+} MatchMode;
+
+static void
+test_match (gconstpointer data)
+{
+  MatchMode mode = GPOINTER_TO_INT (data);
+  GRegex *regex;
+  GMatchInfo *match_info = NULL;
+  gdouble time_elapsed;
+  gdouble result;
+  guint64 n_matches = 0;
+  guint i, j;
+
+  regex = g_regex_new ("took (\\d+)ms", G_REGEX_OPTIMIZE, G_REGEX_MATCH_DEFAULT, NULL);
+
+  g_test_timer_start ();
+
+  for (i = 0; i < num_iterations * 50; i++)
+    for (j = 0; j < N_LINES; j++)
+      {
+        gboolean matched = FALSE;
+
+        switch (mode)
+          {
+          case MATCH_NEW_INFO:
+            matched = g_regex_match (regex, lines[j], G_REGEX_MATCH_DEFAULT, &match_info);
+            g_clear_pointer (&match_info, g_match_info_free);
+            break;
+          case MATCH_NO_INFO:
+            matched = g_regex_match (regex, lines[j], G_REGEX_MATCH_DEFAULT, NULL);
+            break;
+          case MATCH_REUSE_INFO:
+            matched = g_regex_match_reuse (regex, lines[j], -1, 0, G_REGEX_MATCH_DEFAULT,
+                                           &match_info, NULL);
+            break;
+          }
+
+        if (matched)
+          n_matches++;
+      }
+
+  time_elapsed = g_test_timer_elapsed ();
+
+  result = ((gdouble) num_iterations * 50 * N_LINES / time_elapsed) * 1.0e-6;
+  g_test_maximized_result (result, "%7.2f Mmatches/s", result);
+
+  g_assert_cmpuint (n_matches, >, 0);
+
+  g_clear_pointer (&match_info, g_match_info_free);
+  g_regex_unref (regex);
+}
+
+int
+main (int argc, char **argv)
+{
+  int ret;
+
+  g_test_init (&argc, &argv, NULL);
+
+  num_iterations = g_test_perf () ? 20 : 1;
+  build_data ();
+
+  g_test_add_func ("/regex/perf/classify/sequential", test_sequential);
+  g_test_add_func ("/regex/perf/classify/set", test_set);
+  g_test_add_data_func ("/regex/perf/match/new-info",
+                        GINT_TO_POINTER (MATCH_NEW_INFO), test_match);
+  g_test_add_data_func ("/regex/perf/match/no-info",
+                        GINT_TO_POINTER (MATCH_NO_INFO), test_match);
+  g_test_add_data_func ("/regex/perf/match/reuse-info",
+                        GINT_TO_POINTER (MATCH_REUSE_INFO), test_match);
+
+  ret = g_test_run ();
+
+  g_strfreev (patterns);
+  g_strfreev (lines);
+
+  return ret;
+}
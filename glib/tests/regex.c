@@ -2529,6 +2529,383 @@ test_compiled_regex_after_jit_failure (void)
   g_regex_unref (regex);
 }
 
+static void
+test_match_reuse (void)
+{
+  GRegex *regex, *other;
+  GMatchInfo *match_info = NULL;
+  GMatchInfo *first;
+  GError *error = NULL;
+  gchar *str;
+  gint start, end;
+
+  g_test_summary ("Test reusing a GMatchInfo for several matches");
+
+  regex = g_regex_new ("(\\w+)=(\\d+)?", G_REGEX_OPTIMIZE, G_REGEX_MATCH_DEFAULT, NULL);
+  other = g_regex_new ("(a)(b)(c)(d)(e)", G_REGEX_DEFAULT, G_REGEX_MATCH_DEFAULT, NULL);
+
+  g_assert_true (g_regex_match_reuse (regex, "key=42 foo=7", -1, 0, 0, &match_info, &error));
+  g_assert_no_error (error);
+  g_assert_nonnull (match_info);
+  first = match_info;
+  g_assert_cmpint (g_match_info_get_match_count (match_info), ==, 3);
+  str = g_match_info_fetch (match_info, 2);
+  g_assert_cmpstr (str, ==, "42");
+  g_free (str);
+  g_assert_true (g_match_info_next (match_info, NULL));
+  str = g_match_info_fetch (match_info, 1);
+  g_assert_cmpstr (str, ==, "foo");
+  g_free (str);
+
+  /* Fewer groups matching than last time */
+  g_assert_true (g_regex_match_reuse (regex, "empty=", -1, 0, 0, &match_info, &error));
+  g_assert_no_error (error);
+  g_assert_true (match_info == first);
+  g_assert_cmpstr (g_match_info_get_string (match_info), ==, "empty=");
+  g_assert_cmpint (g_match_info_get_match_count (match_info), ==, 2);
+  g_assert_true (g_match_info_fetch_pos (match_info, 2, &start, &end));
+  g_assert_cmpint (start, ==, -1);
+  g_assert_cmpint (end, ==, -1);
+
+  /* No match */
+  g_assert_false (g_regex_match_reuse (regex, "nothing here", -1, 0, 0, &match_info, &error));
+  g_assert_no_error (error);
+  g_assert_false (g_match_info_matches (match_info));
+
+  /* Another regex, with more groups */
+  g_assert_true (g_regex_match_reuse (other, "xxabcde", -1, 0, 0, &match_info, &error));
+  g_assert_no_error (error);
+  g_assert_true (match_info == first);
+  g_assert_true (g_match_info_get_regex (match_info) == other);
+  g_assert_cmpint (g_match_info_get_match_count (match_info), ==, 6);
+  g_assert_true (g_match_info_fetch_pos (match_info, 5, &start, &end));
+  g_assert_cmpint (start, ==, 6);
+  g_assert_cmpint (end, ==, 7);
+  g_assert_false (g_match_info_next (match_info, NULL));
+
+  /* Start positions are respected */
+  g_assert_true (g_regex_match_reuse (regex, "a=1 b=2", -1, 2, 0, &match_info, &error));
+  g_assert_no_error (error);
+  str = g_match_info_fetch (match_info, 0);
+  g_assert_cmpstr (str, ==, "b=2");
+  g_free (str);
+
+  g_match_info_free (match_info);
+  g_regex_unref (other);
+  g_regex_unref (regex);
+}
+
+static void
+test_regex_set_basic (void)
+{
+  const gchar * const patterns[] = {
+    "^kernel: .*error",
+    "Connection (refused|reset)",
+    "disk [a-z]+ full",
+    "\\d+ms$",
+    NULL
+  };
+  const gchar * const empty[] = { NULL };
+  GRegexSet *set;
+  GArray *matches;
+  GError *error = NULL;
+
+  g_test_summary ("Test matching several patterns at once with a GRegexSet");
+
+  set = g_regex_set_new (patterns, G_REGEX_OPTIMIZE, G_REGEX_MATCH_DEFAULT, &error);
+  g_assert_no_error (error);
+  g_assert_nonnull (set);
+  g_assert_cmpuint (g_regex_set_get_n_patterns (set), ==, 4);
+  g_assert_cmpstr (g_regex_set_get_pattern (set, 2), ==, "disk [a-z]+ full");
+
+  matches = g_array_new (FALSE, FALSE, sizeof (guint));
+
+  g_assert_true (g_regex_set_match (set, "kernel: I/O error: Connection reset after 20ms",
+                                    G_REGEX_MATCH_DEFAULT, matches));
+  g_assert_cmpuint (matches->len, ==, 3);
+  g_assert_cmpuint (g_array_index (matches, guint, 0), ==, 0);
+  g_assert_cmpuint (g_array_index (matches, guint, 1), ==, 1);
+  g_assert_cmpuint (g_array_index (matches, guint, 2), ==, 3);
+
+  /* The array is cleared for each string */
+  g_assert_true (g_regex_set_match (set, "disk sda full", G_REGEX_MATCH_DEFAULT, matches));
+  g_assert_cmpuint (matches->len, ==, 1);
+  g_assert_cmpuint (g_array_index (matches, guint, 0), ==, 2);
+
+  g_assert_false (g_regex_set_match (set, "all is well", G_REGEX_MATCH_DEFAULT, matches));
+  g_assert_cmpuint (matches->len, ==, 0);
+
+  g_assert_true (g_regex_set_match (set, "Connection refused", G_REGEX_MATCH_DEFAULT, NULL));
+  g_assert_false (g_regex_set_match (set, "Connection closed", G_REGEX_MATCH_DEFAULT, NULL));
+
+  /* Lengths and start positions are respected */
+  g_assert_false (g_regex_set_match_full (set, "Connection refused", 15, 0,
+                                          G_REGEX_MATCH_DEFAULT, matches, &error));
+  g_assert_no_error (error);
+  g_assert_true (g_regex_set_match_full (set, "kernel: error", -1, 0,
+                                         G_REGEX_MATCH_DEFAULT, matches, &error));
+  g_assert_no_error (error);
+  g_assert_false (g_regex_set_match_full (set, "kernel: error", -1, 1,
+                                          G_REGEX_MATCH_DEFAULT, matches, &error));
+  g_assert_no_error (error);
+  g_assert_false (g_regex_set_match_full (set, "kernel: error", -1, 100,
+                                          G_REGEX_MATCH_DEFAULT, matches, &error));
+  g_assert_no_error (error);
+
+  g_regex_set_unref (set);
+
+  /* Caseless sets */
+  set = g_regex_set_new (patterns, G_REGEX_CASELESS, G_REGEX_MATCH_DEFAULT, &error);
+  g_assert_no_error (error);
+  g_assert_true (g_regex_set_match (set, "DISK SDA FULL", G_REGEX_MATCH_DEFAULT, matches));
+  g_assert_cmpuint (matches->len, ==, 1);
+  g_assert_cmpuint (g_array_index (matches, guint, 0), ==, 2);
+  g_regex_set_unref (set);
+
+  /* Empty sets match nothing */
+  set = g_regex_set_new (empty, G_REGEX_DEFAULT, G_REGEX_MATCH_DEFAULT, &error);
+  g_assert_no_error (error);
+  g_assert_cmpuint (g_regex_set_get_n_patterns (set), ==, 0);
+  g_assert_false (g_regex_set_match (set, "anything", G_REGEX_MATCH_DEFAULT, matches));
+  g_regex_set_unref (set);
+
+  g_array_unref (matches);
+}
+
+static void
+test_regex_set_errors (void)
+{
+  const gchar * const patterns[] = { "valid", "\\o{999}", NULL };
+  const gchar * const backtracking[] = { "^(a|a)*$", "aaaa", NULL };
+  GRegexSet *set;
+  GArray *matches;
+  GError *error = NULL;
+  gchar *string;
+
+  g_test_summary ("Test errors compiling and matching a GRegexSet");
+
+  set = g_regex_set_new (patterns, G_REGEX_DEFAULT, G_REGEX_MATCH_DEFAULT, &error);
+  g_assert_null (set);
+  g_assert_error (error, G_REGEX_ERROR, G_REGEX_ERROR_COMPILE);
+  g_clear_error (&error);
+
+  /* Catastrophic backtracking hits the match limit */
+  set = g_regex_set_new (backtracking, G_REGEX_DEFAULT, G_REGEX_MATCH_DEFAULT, &error);
+  g_assert_no_error (error);
+
+  matches = g_array_new (FALSE, FALSE, sizeof (guint));
+  string = g_strnfill (41, 'a');
+  string[40] = 'b';
+
+  g_assert_false (g_regex_set_match_full (set, string, -1, 0, G_REGEX_MATCH_DEFAULT,
+                                          matches, &error));
+  g_assert_error (error, G_REGEX_ERROR, G_REGEX_ERROR_MATCH);
+  g_assert_cmpuint (matches->len, ==, 0);
+  g_clear_error (&error);
+
+  g_free (string);
+  g_array_unref (matches);
+  g_regex_set_unref (set);
+}
+
+static void
+test_regex_set_many (void)
+{
+  const guint n_patterns = 9000;
+  const guint expected[] = { 0, 63, 64, 8191, 8192, 8999 };
+  GPtrArray *patterns;
+  GRegexSet *set;
+  GArray *matches;
+  GError *error = NULL;
+  guint i;
+
+  g_test_summary ("Test a GRegexSet with more patterns than its matches "
+                  "can be tracked for on the stack");
+
+  patterns = g_ptr_array_new_with_free_func (g_free);
+  for (i = 0; i < n_patterns; i++)
+    g_ptr_array_add (patterns, g_strdup_printf ("<%u>", i));
+  g_ptr_array_add (patterns, NULL);
+
+  set = g_regex_set_new ((const gchar * const *) patterns->pdata, G_REGEX_DEFAULT,
+                         G_REGEX_MATCH_DEFAULT, &error);
+  g_assert_no_error (error);
+  g_assert_cmpuint (g_regex_set_get_n_patterns (set), ==, n_patterns);
+
+  matches = g_array_new (FALSE, FALSE, sizeof (guint));
+  g_assert_true (g_regex_set_match (set, "<0> <63> <64> <8191> <8192> <8999> <9000>",
+                                    G_REGEX_MATCH_DEFAULT, matches));
+  g_assert_cmpmem (matches->data, matches->len * sizeof (guint), expected, sizeof (expected));
+
+  g_assert_false (g_regex_set_match (set, "<9000>", G_REGEX_MATCH_DEFAULT, matches));
+  g_assert_cmpuint (matches->len, ==, 0);
+
+  g_array_unref (matches);
+  g_regex_set_unref (set);
+  g_ptr_array_unref (patterns);
+}
+
+/* Patterns whose required literals are harder to find */
+static const gchar * const regex_set_patterns[] = {
+  "abc",
+  "ab?c",
+  "ab*c",
+  "ab+c",
+  "ab{0}c",
+  "ab{2}c",
+  "a{b}",
+  "\\x41BC",
+  "\\x{41}BC",
+  "\\x41?BC",
+  "\\d{3}-\\d{4}",
+  "\\d{3}",
+  "foo|bar",
+  "(foo|bar)baz",
+  "(?:foo)?baz",
+  "(?i)HELLO",
+  "h(?i)ELLO",
+  "hel(?#comment)lo",
+  "\\Qa.b\\E",
+  "a\\.b",
+  "a.b",
+  "[abc]def",
+  "[]x]yz",
+  "[[:digit:]]+px",
+  "(?<=foo)bar",
+  "(?=bar)bar",
+  "(?P<n>ab)c(?P=n)",
+  "(a)\\1b",
+  "\\k{n}",
+  "(?<n>x)\\k<n>y",
+  "\\cAz",
+  "\\pLx",
+  "\\p{Lu}x",
+  "key",
+  "KEY",
+  "ask",
+  "\xc3\xa9+x",
+  "caf\xc3\xa9",
+  "\\\\path",
+  "a(*ACCEPT)bc",
+  "^start",
+  "end$",
+  "x\\Ky",
+  "",
+  ".*",
+  NULL
+};
+
+static const gchar * const regex_set_strings[] = {
+  "abc", "ac", "abbc", "abbbc", "aab", "ABC", "a{b}", "AB", "BC",
+  "123-4567", "123", "foobaz", "barbaz", "baz", "foo bar",
+  "hello", "HELLO", "hELLO", "Hello",
+  "a.b", "axb", "bdef", "]yz", "xyz", "42px", "px",
+  "foobar", "bar", "abcab", "aab", "xxy",
+  "\001z", "\xc3\xa9x", "Ax",
+  "key", "KEY", "\xe2\x84\xaa" "EY", "a\xc5\xbf" "k", "ASK",
+  "\xc3\xa9\xc3\xa9x", "caf\xc3\xa9", "CAF\xc3\x89", "\\path", "a",
+  "start here", "not start", "the end", "end.", "xy",
+  "",
+  NULL
+};
+
+typedef struct
+{
+  GRegexCompileFlags compile_options;
+  GRegexMatchFlags match_options;
+} RegexSetConsistencyTest;
+
+static const RegexSetConsistencyTest regex_set_consistency_tests[] = {
+  { G_REGEX_DEFAULT, G_REGEX_MATCH_DEFAULT },
+  { G_REGEX_CASELESS | G_REGEX_OPTIMIZE, G_REGEX_MATCH_DEFAULT },
+  { G_REGEX_RAW | G_REGEX_OPTIMIZE, G_REGEX_MATCH_DEFAULT },
+  { G_REGEX_DEFAULT, G_REGEX_MATCH_PARTIAL_SOFT },
+  { G_REGEX_DEFAULT, G_REGEX_MATCH_PARTIAL_HARD },
+};
+
+static void
+test_regex_set_consistency (gconstpointer data)
+{
+  const RegexSetConsistencyTest *test = data;
+  GRegexCompileFlags compile_options = test->compile_options;
+  GRegexMatchFlags match_options = test->match_options;
+  GPtrArray *patterns;
+  GPtrArray *regexes;
+  GRegexSet *set;
+  GArray *matches;
+  GError *error = NULL;
+  guint i, j;
+
+  g_test_summary ("Test a GRegexSet matches the same strings as its patterns do one by one");
+
+  patterns = g_ptr_array_new ();
+  regexes = g_ptr_array_new_with_free_func ((GDestroyNotify) g_regex_unref);
+
+  /* Some patterns aren't supported by all PCRE2 versions */
+  for (i = 0; regex_set_patterns[i] != NULL; i++)
+    {
+      GRegex *regex = g_regex_new (regex_set_patterns[i], compile_options,
+                                   G_REGEX_MATCH_DEFAULT, NULL);
+
+      if (regex == NULL)
+        continue;
+
+      g_ptr_array_add (patterns, (gpointer) regex_set_patterns[i]);
+      g_ptr_array_add (regexes, regex);
+    }
+  g_ptr_array_add (patterns, NULL);
+
+  set = g_regex_set_new ((const gchar * const *) patterns->pdata, compile_options,
+                         G_REGEX_MATCH_DEFAULT, &error);
+  g_assert_no_error (error);
+  g_assert_cmpuint (g_regex_set_get_n_patterns (set), ==, regexes->len);
+
+  matches = g_array_new (FALSE, FALSE, sizeof (guint));
+
+  for (i = 0; regex_set_strings[i] != NULL; i++)
+    {
+      const gchar *string = regex_set_strings[i];
+      gsize string_len = strlen (string);
+      guint start_position;
+
+      for (start_position = 0; start_position <= MIN (string_len, 2); start_position++)
+        {
+          guint n = 0;
+
+          /* Start positions must not be in the middle of a character */
+          if ((string[start_position] & 0xc0) == 0x80)
+            continue;
+
+          g_regex_set_match_full (set, string, -1, start_position,
+                                  match_options, matches, &error);
+          g_assert_no_error (error);
+
+          for (j = 0; j < regexes->len; j++)
+            {
+              gboolean expected, actual;
+
+              expected = g_regex_match_full (g_ptr_array_index (regexes, j), string, -1,
+                                             start_position, match_options,
+                                             NULL, NULL);
+              actual = (n < matches->len && g_array_index (matches, guint, n) == j);
+              if (actual)
+                n++;
+
+              if (expected != actual)
+                g_error ("%s %s ‘%s’ at %u", (const gchar *) g_ptr_array_index (patterns, j),
+                         expected ? "should match" : "should not match", string, start_position);
+            }
+
+          g_assert_cmpuint (n, ==, matches->len);
+        }
+    }
+
+  g_array_unref (matches);
+  g_regex_set_unref (set);
+  g_ptr_array_unref (regexes);
+  g_ptr_array_unref (patterns);
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -2550,6 +2927,20 @@ main (int argc, char *argv[])
   g_test_add_func ("/regex/jit-unsupported-matching", test_jit_unsupported_matching_options);
   g_test_add_func ("/regex/unmatched-named-subpattern", test_unmatched_named_subpattern);
   g_test_add_func ("/regex/compiled-regex-after-jit-failure", test_compiled_regex_after_jit_failure);
+  g_test_add_func ("/regex/match-reuse", test_match_reuse);
+  g_test_add_func ("/regex/set/basic", test_regex_set_basic);
+  g_test_add_func ("/regex/set/errors", test_regex_set_errors);
+  g_test_add_func ("/regex/set/many", test_regex_set_many);
+  g_test_add_data_func ("/regex/set/consistency/default",
+                        &regex_set_consistency_tests[0], test_regex_set_consistency);
+  g_test_add_data_func ("/regex/set/consistency/caseless",
+                        &regex_set_consistency_tests[1], test_regex_set_consistency);
+  g_test_add_data_func ("/regex/set/consistency/raw",
+                        &regex_set_consistency_tests[2], test_regex_set_consistency);
+  g_test_add_data_func ("/regex/set/consistency/partial-soft",
+                        &regex_set_consistency_tests[3], test_regex_set_consistency);
+  g_test_add_data_func ("/regex/set/consistency/partial-hard",
+                        &regex_set_consistency_tests[4], test_regex_set_consistency);
 
   /* TEST_NEW(pattern, compile_opts, match_opts) */
   TEST_NEW("[A-Z]+", G_REGEX_CASELESS | G_REGEX_EXTENDED | G_REGEX_OPTIMIZE, G_REGEX_MATCH_NOTBOL | G_REGEX_MATCH_PARTIAL);
@@ -0,0 +1,114 @@
+/* GLIB - Library of useful routines for C programming
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+
+/* Measures the throughput of a thread pool for many small tasks, for an
+ * increasing number of threads. Run with `-m perf` to get meaningful
+ * numbers. */
+
+static guint num_tasks = 0;
+static guint task_cost = 0;
+
+typedef struct
+{
+  GThreadPoolFlags flags;
+  guint n_threads;
+} PerfData;
+
+static void
+task_func (gpointer data,
+           gpointer user_data)
+{
+  volatile guint acc = GPOINTER_TO_UINT (data);
+  guint i;
+
+  for (i = 0; i < task_cost; i++)
+    acc = acc * 31 + i;
+}
+
+static void
+perform (gconstpointer data)
+{
+  const PerfData *pd = data;
+  GThreadPool *pool;
+  GError *error = NULL;
+  gdouble time_elapsed;
+  gdouble result;
+  guint i;
+
+  pool = g_thread_pool_new_with_flags (task_func, NULL, NULL,
+                                       (gint) pd->n_threads, TRUE,
+                                       pd->flags, &error);
+  g_assert_no_error (error);
+
+  g_test_timer_start ();
+
+  for (i = 0; i < num_tasks; i++)
+    g_thread_pool_push (pool, GUINT_TO_POINTER (i + 1), NULL);
+
+  /* Waits for all the tasks to be processed. */
+  g_thread_pool_free (pool, FALSE, TRUE);
+
+  time_elapsed = g_test_timer_elapsed ();
+
+  result = num_tasks / time_elapsed * 1.0e-3;
+
+  g_test_maximized_result (result, "%8.1f ktasks/s", result);
+}
+
+static void
+add_cases (const char       *path,
+           GThreadPoolFlags  flags)
+{
+  guint max_threads = g_test_perf () ? g_get_num_processors () : 2;
+  guint n_threads = 1;
+
+  while (TRUE)
+    {
+      PerfData *pd;
+      gchar *full_path;
+
+      pd = g_new0 (PerfData, 1);
+      pd->flags = flags;
+      pd->n_threads = n_threads;
+
+      full_path = g_strdup_printf ("%s/%u", path, n_threads);
+      g_test_add_data_func_full (full_path, pd, perform, g_free);
+      g_free (full_path);
+
+      if (n_threads == max_threads)
+        break;
+
+      n_threads = MIN (n_threads * 2, max_threads);
+    }
+}
+
+int
+main (int argc, char **argv)
+{
+  g_test_init (&argc, &argv, NULL);
+
+  num_tasks = g_test_perf () ? 1000000 : 1000;
+  task_cost = 100;
+
+  add_cases ("/thread-pool/perf/shared-queue", G_THREAD_POOL_FLAGS_NONE);
+  add_cases ("/thread-pool/perf/work-stealing", G_THREAD_POOL_FLAGS_WORK_STEALING);
+
+  return g_test_run ();
+}
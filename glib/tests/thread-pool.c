@@ -332,6 +332,215 @@ test_thread_pool_full (gconstpointer shared_first)
     }
 }
 
+typedef struct
+{
+  GThreadPool *pool;  /* (unowned) */
+  guint n_processed;  /* (atomic) */
+} WorkStealingData;
+
+static void
+work_stealing_func (gpointer data,
+                    gpointer user_data)
+{
+  WorkStealingData *test_data = user_data;
+  guint depth = GPOINTER_TO_UINT (data);
+
+  /* Tasks pushed from within a worker go to its own deque, and have to be
+   * stolen by the other workers. */
+  if (depth > 1)
+    {
+      g_thread_pool_push (test_data->pool, GUINT_TO_POINTER (depth - 1), NULL);
+      g_thread_pool_push (test_data->pool, GUINT_TO_POINTER (depth - 1), NULL);
+    }
+
+  g_atomic_int_inc (&test_data->n_processed);
+}
+
+static void
+test_work_stealing (gconstpointer exclusive)
+{
+  WorkStealingData test_data = { NULL, 0 };
+  GError *local_error = NULL;
+  const guint n_roots = 16, depth = 6;
+  guint i;
+
+  g_test_summary ("Tests that all tasks pushed to a work-stealing pool, "
+                  "including from within its workers, are processed.");
+
+  test_data.pool = g_thread_pool_new_with_flags (work_stealing_func, &test_data, NULL,
+                                                 4, GPOINTER_TO_INT (exclusive),
+                                                 G_THREAD_POOL_FLAGS_WORK_STEALING,
+                                                 &local_error);
+  g_assert_no_error (local_error);
+  g_assert_nonnull (test_data.pool);
+
+  for (i = 0; i < n_roots; i++)
+    {
+      gboolean success;
+
+      success = g_thread_pool_push (test_data.pool, GUINT_TO_POINTER (depth), &local_error);
+      g_assert_no_error (local_error);
+      g_assert_true (success);
+    }
+
+  /* Each root task spawns a full binary tree of tasks. */
+  while (g_atomic_int_get (&test_data.n_processed) != n_roots * ((1u << depth) - 1))
+    g_usleep (1000);
+
+  g_assert_cmpuint (g_thread_pool_unprocessed (test_data.pool), ==, 0);
+  g_assert_cmpuint (g_thread_pool_get_num_threads (test_data.pool), <=, 4);
+
+  g_thread_pool_free (test_data.pool, FALSE, TRUE);
+}
+
+static void
+test_work_stealing_free (void)
+{
+  GThreadPool *pool;
+  TestThreadPoolFullData test_data;
+  GError *local_error = NULL;
+  guint i;
+
+  g_test_summary ("Tests that tasks left in a work-stealing pool are freed "
+                  "with the item free function.");
+
+  g_mutex_init (&test_data.mutex);
+  g_cond_init (&test_data.cond);
+  test_data.threads_should_block = TRUE;
+  test_data.n_jobs_started = 0;
+  test_data.n_jobs_completed = 0;
+  test_data.n_free_func_calls = 0;
+
+  pool = g_thread_pool_new_with_flags (full_thread_func, &test_data, free_func,
+                                       1, FALSE, G_THREAD_POOL_FLAGS_WORK_STEALING,
+                                       &local_error);
+  g_assert_no_error (local_error);
+  g_assert_nonnull (pool);
+
+  /* The first job blocks the only worker, the others stay queued. */
+  for (i = 0; i < 4; i++)
+    {
+      gboolean success;
+
+      success = g_thread_pool_push (pool, &test_data, &local_error);
+      g_assert_no_error (local_error);
+      g_assert_true (success);
+    }
+
+  while (g_atomic_int_get (&test_data.n_jobs_started) == 0);
+
+  g_assert_cmpuint (g_thread_pool_unprocessed (pool), ==, 3);
+  g_assert_true (g_thread_pool_move_to_front (pool, &test_data));
+
+  g_thread_pool_free (pool, TRUE, FALSE);
+
+  g_mutex_lock (&test_data.mutex);
+  test_data.threads_should_block = FALSE;
+  g_cond_signal (&test_data.cond);
+  g_mutex_unlock (&test_data.mutex);
+
+  while (g_atomic_int_get (&test_data.n_jobs_completed) != 1 ||
+         g_atomic_int_get (&test_data.n_free_func_calls) != 3);
+
+  g_assert_cmpuint (g_atomic_int_get (&test_data.n_jobs_started), ==, 1);
+
+  g_cond_clear (&test_data.cond);
+  g_mutex_clear (&test_data.mutex);
+}
+
+typedef struct
+{
+  GMutex mutex;
+  GCond cond;
+  gboolean started;
+  gboolean blocked;
+  GArray *order;  /* (element-type guint) */
+} WorkStealingOrderData;
+
+static void
+work_stealing_order_func (gpointer data,
+                          gpointer user_data)
+{
+  WorkStealingOrderData *test_data = user_data;
+  guint n = GPOINTER_TO_UINT (data);
+
+  g_mutex_lock (&test_data->mutex);
+  test_data->started = TRUE;
+  g_cond_broadcast (&test_data->cond);
+  while (test_data->blocked)
+    g_cond_wait (&test_data->cond, &test_data->mutex);
+  g_array_append_val (test_data->order, n);
+  g_mutex_unlock (&test_data->mutex);
+}
+
+static gint
+compare_uint (gconstpointer a,
+              gconstpointer b,
+              gpointer      user_data)
+{
+  guint ua = GPOINTER_TO_UINT (a), ub = GPOINTER_TO_UINT (b);
+
+  return (ua > ub) - (ua < ub);
+}
+
+static void
+test_work_stealing_order (gconstpointer sorted)
+{
+  WorkStealingOrderData test_data;
+  GThreadPool *pool;
+  GError *local_error = NULL;
+  const guint expected_lifo[] = { 1, 5, 4, 3, 2 };
+  const guint expected_sorted[] = { 1, 2, 3, 4, 5 };
+  guint i;
+
+  g_test_summary ("Tests that a work-stealing worker takes the newest task "
+                  "from its own queue, unless a sort function is set.");
+
+  g_mutex_init (&test_data.mutex);
+  g_cond_init (&test_data.cond);
+  test_data.started = FALSE;
+  test_data.blocked = TRUE;
+  test_data.order = g_array_new (FALSE, FALSE, sizeof (guint));
+
+  /* A single worker, so there is a single queue and nothing to steal */
+  pool = g_thread_pool_new_with_flags (work_stealing_order_func, &test_data, NULL,
+                                       1, TRUE, G_THREAD_POOL_FLAGS_WORK_STEALING,
+                                       &local_error);
+  g_assert_no_error (local_error);
+
+  if (GPOINTER_TO_INT (sorted))
+    g_thread_pool_set_sort_function (pool, compare_uint, NULL);
+
+  g_thread_pool_push (pool, GUINT_TO_POINTER (1), &local_error);
+  g_assert_no_error (local_error);
+
+  g_mutex_lock (&test_data.mutex);
+  while (!test_data.started)
+    g_cond_wait (&test_data.cond, &test_data.mutex);
+  g_mutex_unlock (&test_data.mutex);
+
+  for (i = 2; i <= 5; i++)
+    {
+      g_thread_pool_push (pool, GUINT_TO_POINTER (i), &local_error);
+      g_assert_no_error (local_error);
+    }
+
+  g_mutex_lock (&test_data.mutex);
+  test_data.blocked = FALSE;
+  g_cond_broadcast (&test_data.cond);
+  g_mutex_unlock (&test_data.mutex);
+
+  g_thread_pool_free (pool, FALSE, TRUE);
+
+  g_assert_cmpmem (test_data.order->data, test_data.order->len * sizeof (guint),
+                   GPOINTER_TO_INT (sorted) ? expected_sorted : expected_lifo,
+                   sizeof (expected_lifo));
+
+  g_array_unref (test_data.order);
+  g_cond_clear (&test_data.cond);
+  g_mutex_clear (&test_data.mutex);
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -347,6 +556,11 @@ main (int argc, char *argv[])
   g_test_add_data_func ("/thread_pool/create_shared_after_exclusive", GINT_TO_POINTER (FALSE), test_create_first_pool);
   g_test_add_data_func ("/thread_pool/create_full", NULL, test_thread_pool_full);
   g_test_add_data_func ("/thread_pool/create_exclusive_after_shared", GINT_TO_POINTER (TRUE), test_create_first_pool);
+  g_test_add_data_func ("/thread_pool/work_stealing/shared", GINT_TO_POINTER (FALSE), test_work_stealing);
+  g_test_add_data_func ("/thread_pool/work_stealing/exclusive", GINT_TO_POINTER (TRUE), test_work_stealing);
+  g_test_add_func ("/thread_pool/work_stealing/free", test_work_stealing_free);
+  g_test_add_data_func ("/thread_pool/work_stealing/order/lifo", GINT_TO_POINTER (FALSE), test_work_stealing_order);
+  g_test_add_data_func ("/thread_pool/work_stealing/order/sorted", GINT_TO_POINTER (TRUE), test_work_stealing_order);
 
   return g_test_run ();
 }
@@ -23,6 +23,8 @@
  * Author: Matthias Clasen
  */
 
+#include <string.h>
+
 #include "glib.h"
 
 static void
@@ -44,6 +46,88 @@ test_utf8_strlen (void)
   g_assert_cmpint (g_utf8_strlen (string, 10), ==, 6);
 }
 
+static void
+test_utf8_long_strings (void)
+{
+  const gchar *pieces[] = { "a", "bc", "\xc3\xa9", "\xe2\x82\xac", "\xf0\x9d\x84\x9e", "defghijk",
+                            "The quick brown fox jumps over the lazy dog" };
+  const gsize max_alignment = 32;
+  GString *builder = g_string_new (NULL);
+  gchar *buffer;
+  gsize i;
+
+  g_test_summary ("Test the vector and word-at-a-time paths of the functions "
+                  "which count or convert characters, at various alignments");
+
+  for (i = 0; i < 200; i++)
+    g_string_append (builder, pieces[g_test_rand_int_range (0, G_N_ELEMENTS (pieces))]);
+
+  buffer = g_malloc (builder->len + max_alignment + 1);
+
+  for (i = 0; i < max_alignment; i++)
+    {
+      gchar *str = buffer + i;
+      gsize n_bytes = builder->len;
+      const gchar **chars = g_new (const gchar *, n_bytes + 1);
+      glong n_chars, j;
+      gunichar *ucs4, *ucs4_fast;
+      gunichar2 *utf16, *utf16_expected;
+      glong n_ucs4, n_utf16, n_utf16_expected;
+      gsize max;
+
+      memcpy (str, builder->str, n_bytes + 1);
+
+      for (n_chars = 0, chars[0] = str; *chars[n_chars] != '\0'; n_chars++)
+        chars[n_chars + 1] = g_utf8_next_char (chars[n_chars]);
+
+      g_assert_cmpint (g_utf8_strlen (str, -1), ==, n_chars);
+
+      for (max = 0, j = 0; max <= n_bytes + 1; max++)
+        {
+          /* count only the characters which end within @max bytes */
+          while (j < n_chars && (gsize) (chars[j + 1] - str) <= max)
+            j++;
+          g_assert_cmpint (g_utf8_strlen (str, max), ==, j);
+        }
+
+      for (j = 0; j <= n_chars; j++)
+        {
+          g_assert_true (g_utf8_offset_to_pointer (str, j) == chars[j]);
+          g_assert_cmpint (g_utf8_pointer_to_offset (str, chars[j]), ==, j);
+          g_assert_true (g_utf8_offset_to_pointer (chars[j], -j) == str);
+        }
+
+      ucs4 = g_utf8_to_ucs4 (str, -1, NULL, &n_ucs4, NULL);
+      g_assert_cmpint (n_ucs4, ==, n_chars);
+      ucs4_fast = g_utf8_to_ucs4_fast (str, -1, &n_ucs4);
+      g_assert_cmpint (n_ucs4, ==, n_chars);
+      g_assert_cmpmem (ucs4, (n_chars + 1) * sizeof (gunichar), ucs4_fast, (n_ucs4 + 1) * sizeof (gunichar));
+      g_free (ucs4_fast);
+
+      ucs4_fast = g_utf8_to_ucs4_fast (str, n_bytes - 1, &n_ucs4);
+      g_assert_cmpint (n_ucs4, ==, g_utf8_pointer_to_offset (str, str + n_bytes - 1));
+      g_assert_cmpmem (ucs4, n_ucs4 * sizeof (gunichar), ucs4_fast, n_ucs4 * sizeof (gunichar));
+      g_free (ucs4_fast);
+
+      utf16_expected = g_ucs4_to_utf16 (ucs4, n_chars, NULL, &n_utf16_expected, NULL);
+      utf16 = g_utf8_to_utf16 (str, -1, NULL, &n_utf16, NULL);
+      g_assert_cmpmem (utf16, (n_utf16 + 1) * sizeof (gunichar2),
+                       utf16_expected, (n_utf16_expected + 1) * sizeof (gunichar2));
+      g_free (utf16);
+      utf16 = g_utf8_to_utf16 (str, n_bytes, NULL, &n_utf16, NULL);
+      g_assert_cmpmem (utf16, (n_utf16 + 1) * sizeof (gunichar2),
+                       utf16_expected, (n_utf16_expected + 1) * sizeof (gunichar2));
+      g_free (utf16);
+      g_free (utf16_expected);
+
+      g_free (ucs4);
+      g_free (chars);
+    }
+
+  g_free (buffer);
+  g_string_free (builder, TRUE);
+}
+
 static void
 test_utf8_strncpy (void)
 {
@@ -221,6 +305,7 @@ main (int   argc,
   g_test_init (&argc, &argv, NULL);
 
   g_test_add_func ("/utf8/strlen", test_utf8_strlen);
+  g_test_add_func ("/utf8/long-strings", test_utf8_long_strings);
   g_test_add_func ("/utf8/strncpy", test_utf8_strncpy);
   g_test_add_func ("/utf8/strrchr", test_utf8_strrchr);
   g_test_add_func ("/utf8/reverse", test_utf8_reverse);
@@ -40,6 +40,13 @@ static const char str_cyrillic[] =
 static const char str_han[] =
     "漢字，亦稱中文字、中国字，在台灣又被稱為國字，是漢字文化圈廣泛使用的一種文字，屬於表意文字的詞素音節文字";
 
+/* Mostly ASCII with occasional non-ASCII characters, like source code or
+ * markup with localised strings in it */
+static const char str_mixed[] =
+    "<property name=\"label\" translatable=\"yes\">Zwölf Boxkämpfer</property>\n"
+    "<property name=\"tooltip-text\">漢字文化圈 — “quoted” text</property>\n"
+    "<property name=\"title\">Широкая электрификация</property>\n";
+
 typedef int (* GrindFunc) (const char *, gsize);
 
 #define GRIND_LOOP_BEGIN                 \
@@ -154,6 +161,93 @@ grind_utf8_to_ucs4_fast_sized (const char *str, gsize len)
   return 0;
 }
 
+/* The following functions are pure, so the string is read through a
+ * volatile pointer to stop the calls from being hoisted out of the loop */
+
+static int
+grind_utf8_strlen (const char *str, gsize len)
+{
+  const char * volatile vstr = str;
+  glong acc = 0;
+  GRIND_LOOP_BEGIN
+    acc += g_utf8_strlen (vstr, -1);
+  GRIND_LOOP_END;
+  return acc;
+}
+
+static int
+grind_utf8_strlen_sized (const char *str, gsize len)
+{
+  const char * volatile vstr = str;
+  glong acc = 0;
+  GRIND_LOOP_BEGIN
+    acc += g_utf8_strlen (vstr, len);
+  GRIND_LOOP_END;
+  return acc;
+}
+
+static int
+grind_utf8_offset_to_pointer (const char *str, gsize len)
+{
+  const char * volatile vstr = str;
+  glong n_chars = g_utf8_strlen (str, len);
+  gsize acc = 0;
+  GRIND_LOOP_BEGIN
+    acc += g_utf8_offset_to_pointer (vstr, n_chars) - str;
+  GRIND_LOOP_END;
+  return acc;
+}
+
+static int
+grind_utf8_pointer_to_offset (const char *str, gsize len)
+{
+  const char * volatile vstr = str;
+  glong acc = 0;
+  GRIND_LOOP_BEGIN
+    acc += g_utf8_pointer_to_offset (vstr, str + len);
+  GRIND_LOOP_END;
+  return acc;
+}
+
+static int
+grind_utf8_to_utf16 (const char *str, gsize len)
+{
+  GRIND_LOOP_BEGIN
+    {
+      gunichar2 *ustr;
+      ustr = g_utf8_to_utf16 (str, -1, NULL, NULL, NULL);
+      g_free (ustr);
+    }
+  GRIND_LOOP_END;
+  return 0;
+}
+
+static int
+grind_utf8_to_utf16_sized (const char *str, gsize len)
+{
+  GRIND_LOOP_BEGIN
+    {
+      gunichar2 *ustr;
+      ustr = g_utf8_to_utf16 (str, len, NULL, NULL, NULL);
+      g_free (ustr);
+    }
+  GRIND_LOOP_END;
+  return 0;
+}
+
+static int
+grind_utf8_make_valid (const char *str, gsize len)
+{
+  GRIND_LOOP_BEGIN
+    {
+      gchar *valid;
+      valid = g_utf8_make_valid (str, len);
+      g_free (valid);
+    }
+  GRIND_LOOP_END;
+  return 0;
+}
+
 static int
 grind_utf8_validate (const char *str, gsize len)
 {
@@ -223,6 +317,7 @@ add_cases(const char *path, GrindFunc func)
   ADD_CASE(latin1);
   ADD_CASE(cyrillic);
   ADD_CASE(han);
+  ADD_CASE(mixed);
 
 #undef ADD_CASE
 }
@@ -243,6 +338,13 @@ main (int argc, char **argv)
   add_cases ("/utf8/perf/utf8_to_ucs4_fast-sized", grind_utf8_to_ucs4_fast_sized);
   add_cases ("/utf8/perf/utf8_validate", grind_utf8_validate);
   add_cases ("/utf8/perf/utf8_validate-sized", grind_utf8_validate_sized);
+  add_cases ("/utf8/perf/utf8_strlen", grind_utf8_strlen);
+  add_cases ("/utf8/perf/utf8_strlen-sized", grind_utf8_strlen_sized);
+  add_cases ("/utf8/perf/utf8_offset_to_pointer", grind_utf8_offset_to_pointer);
+  add_cases ("/utf8/perf/utf8_pointer_to_offset", grind_utf8_pointer_to_offset);
+  add_cases ("/utf8/perf/utf8_to_utf16", grind_utf8_to_utf16);
+  add_cases ("/utf8/perf/utf8_to_utf16-sized", grind_utf8_to_utf16_sized);
+  add_cases ("/utf8/perf/utf8_make_valid", grind_utf8_make_valid);
 
   return g_test_run ();
 }
@@ -203,11 +203,20 @@ typedef struct
   GParamSpec *pspecs[];
 } GObjectNotifyQueue;
 
+typedef struct
+{
+  guint depth;
+  guint n_coalesced;
+  GHashTable *objects_set;
+  GPtrArray *objects;
+} GObjectNotifyBatch;
+
 /* --- variables --- */
 static GQuark	            quark_closure_array = 0;
 static GQuark	            quark_weak_notifies = 0;
 static GQuark	            quark_toggle_refs = 0;
 static GQuark               quark_notify_queue;
+static GPrivate             notify_batch_private = G_PRIVATE_INIT (NULL);
 static GParamSpecPool      *pspec_pool = NULL; /* atomic */
 static gulong	            gobject_signals[LAST_SIGNAL] = { 0, };
 static guint (*floating_flag_handler) (GObject*, gint) = object_floating_flag_handler;
@@ -773,6 +782,7 @@ g_object_notify_queue_add_cb (gpointer *data,
 {
   GParamSpec *pspec = ((gpointer *) user_data)[0];
   gboolean in_init = GPOINTER_TO_INT (((gpointer *) user_data)[1]);
+  gboolean *coalesced = ((gpointer *) user_data)[2];
   GObjectNotifyQueue *nqueue = *data;
   guint16 i;
 
@@ -809,7 +819,10 @@ g_object_notify_queue_add_cb (gpointer *data,
       for (i = 0; i < nqueue->len; i++)
         {
           if (nqueue->pspecs[i] == pspec)
-            goto out;
+            {
+              *coalesced = TRUE;
+              goto out;
+            }
         }
 
       if (G_UNLIKELY (nqueue->len == nqueue->alloc))
@@ -836,17 +849,42 @@ out:
   return GINT_TO_POINTER (TRUE);
 }
 
+static void
+g_object_notify_batch_add_object (GObjectNotifyBatch *batch,
+                                  GObject *object)
+{
+  /* Objects being finalized can't be kept alive until the end of the
+   * batch, so they keep the unbatched behaviour. */
+  if (g_atomic_int_get (&object->ref_count) <= 0)
+    return;
+
+  if (!g_hash_table_add (batch->objects_set, object))
+    return;
+
+  g_ptr_array_add (batch->objects, g_object_ref (object));
+  g_object_notify_queue_freeze (object, TRUE);
+}
+
 static gboolean
 g_object_notify_queue_add (GObject *object,
                            GParamSpec *pspec,
                            gboolean in_init)
 {
+  GObjectNotifyBatch *batch;
+  gboolean coalesced = FALSE;
   gpointer result;
 
+  batch = g_private_get (&notify_batch_private);
+  if (G_UNLIKELY (batch != NULL))
+    g_object_notify_batch_add_object (batch, object);
+
   result = _g_datalist_id_update_atomic (&object->qdata,
                                          quark_notify_queue,
                                          g_object_notify_queue_add_cb,
-                                         ((gpointer[]){ pspec, GINT_TO_POINTER (!!in_init) }));
+                                         ((gpointer[]){ pspec, GINT_TO_POINTER (!!in_init), &coalesced }));
+
+  if (G_UNLIKELY (batch != NULL) && coalesced)
+    batch->n_coalesced++;
 
   return GPOINTER_TO_INT (result);
 }
@@ -2132,6 +2170,95 @@ g_object_thaw_notify (GObject *object)
   g_object_notify_queue_thaw (object, TRUE);
 }
 
+/**
+ * g_object_notify_batch_begin:
+ *
+ * Opens a property notification batch for the calling thread.
+ *
+ * Until the matching call to g_object_notify_batch_end(), every object
+ * whose properties are notified from this thread behaves as if
+ * g_object_freeze_notify() had been called on it: notifications are queued
+ * and duplicates for the same property are squashed. This makes it cheap
+ * to update many objects in one go, without having to track which of them
+ * need to be frozen and thawed. Objects stay referenced until the end of
+ * the batch.
+ *
+ * Notifications emitted by other threads on objects which are part of the
+ * batch are queued as well, as with g_object_freeze_notify().
+ *
+ * Batches can be nested, in which case notifications are only delivered
+ * when the outermost batch ends.
+ *
+ * Since: 2.86
+ */
+void
+g_object_notify_batch_begin (void)
+{
+  GObjectNotifyBatch *batch;
+
+  batch = g_private_get (&notify_batch_private);
+  if (batch == NULL)
+    {
+      batch = g_new0 (GObjectNotifyBatch, 1);
+      batch->objects_set = g_hash_table_new (NULL, NULL);
+      batch->objects = g_ptr_array_new ();
+      g_private_set (&notify_batch_private, batch);
+    }
+
+  batch->depth++;
+}
+
+/**
+ * g_object_notify_batch_end:
+ *
+ * Closes a batch opened with g_object_notify_batch_begin().
+ *
+ * When this closes the outermost batch of the calling thread, the queued
+ * #GObject::notify signals of all objects in the batch are emitted, object
+ * by object in the order in which they were first notified. Notifications
+ * caused by the handlers are no longer batched.
+ *
+ * It is an error to call this function without a matching call to
+ * g_object_notify_batch_begin().
+ *
+ * Returns: the number of #GObject::notify emissions which were saved by
+ *   squashing duplicate notifications in the batch, or 0 if this did not
+ *   close the outermost batch
+ *
+ * Since: 2.86
+ */
+guint
+g_object_notify_batch_end (void)
+{
+  GObjectNotifyBatch *batch;
+  guint n_coalesced;
+  guint i;
+
+  batch = g_private_get (&notify_batch_private);
+  g_return_val_if_fail (batch != NULL, 0);
+
+  if (--batch->depth > 0)
+    return 0;
+
+  g_private_set (&notify_batch_private, NULL);
+
+  for (i = 0; i < batch->objects->len; i++)
+    {
+      GObject *object = g_ptr_array_index (batch->objects, i);
+
+      g_object_notify_queue_thaw (object, FALSE);
+      g_object_unref (object);
+    }
+
+  n_coalesced = batch->n_coalesced;
+
+  g_hash_table_unref (batch->objects_set);
+  g_ptr_array_unref (batch->objects);
+  g_free (batch);
+
+  return n_coalesced;
+}
+
 static void
 maybe_issue_property_deprecation_warning (const GParamSpec *pspec)
 {
@@ -503,6 +503,10 @@ void        g_object_notify_by_pspec          (GObject        *object,
 					       GParamSpec     *pspec);
 GOBJECT_AVAILABLE_IN_ALL
 void        g_object_thaw_notify              (GObject        *object);
+GOBJECT_AVAILABLE_IN_2_86
+void        g_object_notify_batch_begin       (void);
+GOBJECT_AVAILABLE_IN_2_86
+guint       g_object_notify_batch_end         (void);
 GOBJECT_AVAILABLE_IN_ALL
 gboolean    g_object_is_floating    	      (gpointer        object);
 GOBJECT_AVAILABLE_IN_ALL
@@ -31,6 +31,7 @@
 
 #include "gsignal.h"
 #include "gtype-private.h"
+#include "glib-private.h"
 #include "gbsearcharray.h"
 #include "gvaluecollector.h"
 #include "gvaluetypes.h"
@@ -48,6 +49,7 @@ typedef struct _Emission     Emission;
 typedef struct _Handler      Handler;
 typedef struct _HandlerList  HandlerList;
 typedef struct _HandlerMatch HandlerMatch;
+typedef struct _HandlerSnapshot HandlerSnapshot;
 typedef enum
 {
   EMISSION_STOP,
@@ -89,6 +91,11 @@ static	      HandlerMatch*	handlers_find		(gpointer	  instance,
 							 gpointer	  data,
 							 gboolean	  one_and_only);
 static inline void		handler_ref		(Handler	 *handler);
+static	      void		handler_snapshot_unref_R (guint		  signal_id,
+							  gpointer	  instance,
+							  HandlerSnapshot *snapshot);
+static	      void		handler_list_invalidate_snapshot_R (guint    signal_id,
+								    gpointer instance);
 static inline void		handler_unref_R		(guint		  signal_id,
 							 gpointer	  instance,
 							 Handler	 *handler);
@@ -107,7 +114,8 @@ static	      gboolean		signal_emit_unlocked_R	(SignalNode	 *node,
 							 GQuark		  detail,
 							 gpointer	  instance,
 							 GValue		 *return_value,
-							 const GValue	 *instance_and_params);
+							 const GValue	 *instance_and_params,
+							 va_list	 *var_args);
 static       void               add_invalid_closure_notify    (Handler         *handler,
 							       gpointer         instance);
 static       void               remove_invalid_closure_notify (Handler         *handler,
@@ -145,6 +153,7 @@ struct _SignalNode
   guint              n_params : 8;
   guint              single_va_closure_is_valid : 1;
   guint              single_va_closure_is_after : 1;
+  guint              va_types_are_plain : 1;  /* valid with single_va_closure */
   GType		    *param_types; /* mangled with G_SIGNAL_TYPE_STATIC_SCOPE flag */
   GType		     return_type; /* mangled with G_SIGNAL_TYPE_STATIC_SCOPE flag */
   GBSearchArray     *class_closure_bsa;
@@ -154,6 +163,11 @@ struct _SignalNode
   GHookList         *emission_hooks;
 
   GClosure *single_va_closure;
+
+  /* Mirror of single_va_closure for emissions which return nothing, read
+   * without the signal lock by signal_emission_is_nop_unlocked(); %NULL
+   * whenever single_va_closure is invalid or unusable. */
+  GClosure *nop_closure;  /* (atomic) */
 };
 
 #define	SINGLE_VA_CLOSURE_EMPTY_MAGIC GINT_TO_POINTER(1)	/* indicates single_va_closure is valid but empty */
@@ -180,6 +194,7 @@ struct _HandlerList
   Handler *handlers;
   Handler *tail_before;  /* normal signal handlers are appended here  */
   Handler *tail_after;   /* CONNECT_AFTER handlers are appended here  */
+  HandlerSnapshot *snapshot;  /* (owned) (nullable) built by the next emission */
 };
 
 struct _Handler
@@ -197,6 +212,33 @@ struct _Handler
   GClosure     *closure;
   gpointer      instance;
 };
+
+/* An immutable copy of the connected handlers of a HandlerList, which
+ * emissions walk without holding the signal lock. It is only referenced and
+ * released under the lock, and holds a reference on each of its handlers.
+ * Any change to the handlers (connecting, disconnecting, blocking or
+ * unblocking one) drops the snapshot of the list, so that the next emission
+ * builds a new one, and marks the old one as stale: emissions still using it
+ * then check the live state of each handler under the lock before running it.
+ */
+typedef struct
+{
+  Handler  *handler;  /* (owned) */
+  GClosure *closure;
+  GQuark    detail;
+  gboolean  blocked;
+} HandlerSnapshotEntry;
+
+struct _HandlerSnapshot
+{
+  guint                ref_count;
+  gint                 stale;  /* (atomic) */
+  gboolean             supports_va;  /* all closures have va marshallers */
+  guint                n_handlers;
+  guint                n_before;  /* entries before the CONNECT_AFTER ones */
+  HandlerSnapshotEntry entries[1]; /* flexible array */
+};
+
 struct _HandlerMatch
 {
   Handler      *handler;
@@ -239,18 +281,82 @@ G_LOCK_DEFINE_STATIC (g_signal_mutex);
 
 
 /* --- signal nodes --- */
-static guint          g_n_signal_nodes = 0;
-static SignalNode   **g_signal_nodes = NULL;
+/* Signal nodes are read without the signal lock by
+ * LOOKUP_SIGNAL_NODE_UNLOCKED(), so they are kept in blocks which are never
+ * moved or freed once published: block k holds
+ * SIGNAL_NODES_BLOCK_SIZE << k nodes, so a fixed number of blocks covers
+ * every possible signal id. */
+#define SIGNAL_NODES_BLOCK_SIZE 256
+#define SIGNAL_NODES_N_BLOCKS   24
+static guint          g_n_signal_nodes = 0;  /* (atomic) */
+static SignalNode   **g_signal_node_blocks[SIGNAL_NODES_N_BLOCKS];  /* (atomic) */
+
+static inline guint
+signal_nodes_block (guint  signal_id,
+                    guint *offset)
+{
+  guint block;
+
+  if (G_LIKELY (signal_id < SIGNAL_NODES_BLOCK_SIZE))
+    {
+      *offset = signal_id;
+      return 0;
+    }
+
+  block = g_bit_storage (signal_id / SIGNAL_NODES_BLOCK_SIZE + 1) - 1;
+  *offset = signal_id - ((1u << block) - 1) * SIGNAL_NODES_BLOCK_SIZE;
+
+  return block;
+}
 
 static inline SignalNode*
 LOOKUP_SIGNAL_NODE (guint signal_id)
 {
   if (signal_id < g_n_signal_nodes)
-    return g_signal_nodes[signal_id];
+    {
+      guint offset;
+      guint block = signal_nodes_block (signal_id, &offset);
+
+      return g_signal_node_blocks[block][offset];
+    }
+  else
+    return NULL;
+}
+
+static inline SignalNode*
+LOOKUP_SIGNAL_NODE_UNLOCKED (guint signal_id)
+{
+  /* g_n_signal_nodes is only increased after the node has been stored, so
+   * this never reads an unpublished block */
+  if (signal_id < (guint) g_atomic_int_get (&g_n_signal_nodes))
+    {
+      guint offset;
+      guint block = signal_nodes_block (signal_id, &offset);
+      SignalNode **nodes = g_atomic_pointer_get (&g_signal_node_blocks[block]);
+
+      return g_atomic_pointer_get (&nodes[offset]);
+    }
   else
     return NULL;
 }
 
+static void
+signal_nodes_append (SignalNode *node)
+{
+  guint n_signal_nodes = g_n_signal_nodes;
+  guint offset;
+  guint block = signal_nodes_block (n_signal_nodes, &offset);
+
+  g_assert (block < SIGNAL_NODES_N_BLOCKS);
+
+  if (offset == 0)
+    g_atomic_pointer_set (&g_signal_node_blocks[block],
+                          g_new0 (SignalNode*, (gsize) SIGNAL_NODES_BLOCK_SIZE << block));
+
+  g_atomic_pointer_set (&g_signal_node_blocks[block][offset], node);
+  g_atomic_int_set (&g_n_signal_nodes, n_signal_nodes + 1);
+}
+
 
 /* --- functions --- */
 /* @key must have already been validated with is_valid()
@@ -391,6 +497,7 @@ handler_list_ensure (guint    signal_id,
   key.handlers    = NULL;
   key.tail_before = NULL;
   key.tail_after  = NULL;
+  key.snapshot    = NULL;
   if (!hlbsa)
     {
       hlbsa = g_bsearch_array_create (&g_signal_hlbsa_bconfig);
@@ -715,6 +822,165 @@ handler_insert (guint    signal_id,
 
   if (!handler->next)
     hlist->tail_after = handler;
+
+  handler_list_invalidate_snapshot_R (signal_id, instance);
+}
+
+static HandlerSnapshot*
+handler_snapshot_new (HandlerList *hlist)
+{
+  HandlerSnapshot *snapshot;
+  Handler *handler;
+  guint n_handlers = 0;
+  guint i = 0;
+  gboolean after;
+
+  for (handler = hlist->handlers; handler; handler = handler->next)
+    if (handler->sequential_number)
+      n_handlers++;
+
+  snapshot = g_malloc (G_STRUCT_OFFSET (HandlerSnapshot, entries) +
+                       MAX (n_handlers, 1) * sizeof (HandlerSnapshotEntry));
+  snapshot->ref_count = 1;
+  snapshot->stale = FALSE;
+  snapshot->supports_va = TRUE;
+  snapshot->n_handlers = n_handlers;
+  snapshot->n_before = 0;
+
+  /* Normal handlers first, then CONNECT_AFTER ones, each in the order in
+   * which they are called */
+  for (after = FALSE; after <= TRUE; after++)
+    for (handler = hlist->handlers; handler; handler = handler->next)
+      if (handler->sequential_number && handler->after == (guint) after)
+        {
+          HandlerSnapshotEntry *entry = &snapshot->entries[i++];
+
+          handler_ref (handler);
+          entry->handler = handler;
+          entry->closure = handler->closure;
+          entry->detail = handler->detail;
+          entry->blocked = handler->block_count != 0;
+          if (!_g_closure_supports_invoke_va (handler->closure))
+            snapshot->supports_va = FALSE;
+          if (!after)
+            snapshot->n_before = i;
+        }
+
+  return snapshot;
+}
+
+/* Returns a new reference to the snapshot of the handlers of @instance for
+ * @signal_id, or %NULL if there are none. */
+static HandlerSnapshot*
+handler_snapshot_get (guint    signal_id,
+                      gpointer instance)
+{
+  HandlerList *hlist = handler_list_lookup (signal_id, instance);
+
+  if (!hlist || !hlist->handlers)
+    return NULL;
+
+  if (!hlist->snapshot)
+    hlist->snapshot = handler_snapshot_new (hlist);
+
+  hlist->snapshot->ref_count++;
+
+  return hlist->snapshot;
+}
+
+static void
+handler_snapshot_unref_R (guint            signal_id,
+                          gpointer         instance,
+                          HandlerSnapshot *snapshot)
+{
+  guint i;
+
+  g_return_if_fail (snapshot->ref_count > 0);
+
+  if (--snapshot->ref_count > 0)
+    return;
+
+  for (i = 0; i < snapshot->n_handlers; i++)
+    handler_unref_R (signal_id, instance, snapshot->entries[i].handler);
+
+  g_free (snapshot);
+}
+
+/* Whether the handler at @index of @snapshot may run now. This is called
+ * without the signal lock: while @snapshot is current, the blocked state it
+ * recorded is still accurate. */
+static inline gboolean
+handler_snapshot_entry_is_active (HandlerSnapshot *snapshot,
+                                  guint            index)
+{
+  gboolean blocked;
+
+  if (G_LIKELY (!g_atomic_int_get (&snapshot->stale)))
+    return !snapshot->entries[index].blocked;
+
+  /* Disconnecting a handler also blocks it */
+  SIGNAL_LOCK ();
+  blocked = snapshot->entries[index].handler->block_count != 0;
+  SIGNAL_UNLOCK ();
+
+  return !blocked;
+}
+
+static void
+handler_list_invalidate_snapshot_R (guint    signal_id,
+                                    gpointer instance)
+{
+  HandlerList *hlist = handler_list_lookup (signal_id, instance);
+  HandlerSnapshot *snapshot;
+
+  if (!hlist || !hlist->snapshot)
+    return;
+
+  snapshot = g_steal_pointer (&hlist->snapshot);
+  g_atomic_int_set (&snapshot->stale, TRUE);
+  handler_snapshot_unref_R (signal_id, instance, snapshot);
+}
+
+/* Whether values of @type are passed on as they are by va marshallers,
+ * rather than copied or referenced for the duration of each call, and can
+ * be initialised with the signal lock held */
+static gboolean
+va_type_is_plain (GType type)
+{
+  switch (G_TYPE_FUNDAMENTAL (type))
+    {
+    case G_TYPE_CHAR:
+    case G_TYPE_UCHAR:
+    case G_TYPE_BOOLEAN:
+    case G_TYPE_INT:
+    case G_TYPE_UINT:
+    case G_TYPE_LONG:
+    case G_TYPE_ULONG:
+    case G_TYPE_INT64:
+    case G_TYPE_UINT64:
+    case G_TYPE_ENUM:
+    case G_TYPE_FLAGS:
+    case G_TYPE_FLOAT:
+    case G_TYPE_DOUBLE:
+    case G_TYPE_POINTER:
+      return TRUE;
+    default:
+      return FALSE;
+    }
+}
+
+static gboolean
+node_va_types_are_plain (SignalNode *node)
+{
+  GType rtype = node->return_type & ~G_SIGNAL_TYPE_STATIC_SCOPE;
+  guint i;
+
+  for (i = 0; i < node->n_params; i++)
+    if (!(node->param_types[i] & G_SIGNAL_TYPE_STATIC_SCOPE) &&
+        !va_type_is_plain (node->param_types[i]))
+      return FALSE;
+
+  return rtype == G_TYPE_NONE || va_type_is_plain (rtype);
 }
 
 static void
@@ -756,6 +1022,17 @@ node_update_single_va_closure (SignalNode *node)
   node->single_va_closure_is_valid = TRUE;
   node->single_va_closure = closure;
   node->single_va_closure_is_after = (guint) is_after;
+  node->va_types_are_plain = node_va_types_are_plain (node);
+
+  if (node->return_type == G_TYPE_NONE)
+    g_atomic_pointer_set (&node->nop_closure, closure);
+}
+
+static inline void
+node_invalidate_single_va_closure (SignalNode *node)
+{
+  node->single_va_closure_is_valid = FALSE;
+  g_atomic_pointer_set (&node->nop_closure, NULL);
 }
 
 static inline void
@@ -832,9 +1109,7 @@ _g_signal_init (void)
       g_signal_key_bsa = g_bsearch_array_create (&g_signal_key_bconfig);
       
       /* invalid (0) signal_id */
-      g_n_signal_nodes = 1;
-      g_signal_nodes = g_renew (SignalNode*, g_signal_nodes, g_n_signal_nodes);
-      g_signal_nodes[0] = NULL;
+      signal_nodes_append (NULL);
       g_handlers = g_hash_table_new (handler_hash, handler_equal);
     }
   SIGNAL_UNLOCK ();
@@ -848,7 +1123,7 @@ _g_signals_destroy (GType itype)
   SIGNAL_LOCK ();
   for (i = 1; i < g_n_signal_nodes; i++)
     {
-      SignalNode *node = g_signal_nodes[i];
+      SignalNode *node = LOOKUP_SIGNAL_NODE (i);
       
       if (node->itype == itype)
         {
@@ -980,7 +1255,7 @@ g_signal_add_emission_hook (guint               signal_id,
       SIGNAL_UNLOCK ();
       return 0;
     }
-    node->single_va_closure_is_valid = FALSE;
+    node_invalidate_single_va_closure (node);
   if (!node->emission_hooks)
     {
       node->emission_hooks = g_new (GHookList, 1);
@@ -1032,7 +1307,7 @@ g_signal_remove_emission_hook (guint  signal_id,
   else if (!node->emission_hooks || !g_hook_destroy (node->emission_hooks, hook_id))
     g_critical ("%s: signal \"%s\" had no hook (%lu) to remove", G_STRLOC, node->name, hook_id);
 
-  node->single_va_closure_is_valid = FALSE;
+  node_invalidate_single_va_closure (node);
 
  out:
   SIGNAL_UNLOCK ();
@@ -1544,7 +1819,7 @@ signal_add_class_closure (SignalNode *node,
 {
   ClassClosure key;
 
-  node->single_va_closure_is_valid = FALSE;
+  node_invalidate_single_va_closure (node);
 
   if (!node->class_closure_bsa)
     node->class_closure_bsa = g_bsearch_array_create (&g_class_closure_bconfig);
@@ -1682,12 +1957,12 @@ g_signal_newv (const gchar       *signal_name,
     {
       SignalKey key;
       
-      signal_id = g_n_signal_nodes++;
+      signal_id = g_n_signal_nodes;
       node = g_new (SignalNode, 1);
       node->signal_id = signal_id;
-      g_signal_nodes = g_renew (SignalNode*, g_signal_nodes, g_n_signal_nodes);
-      g_signal_nodes[signal_id] = node;
       node->itype = itype;
+      node->nop_closure = NULL;
+      signal_nodes_append (node);
       key.itype = itype;
       key.signal_id = signal_id;
       node->name = g_intern_string (name);
@@ -1699,7 +1974,7 @@ g_signal_newv (const gchar       *signal_name,
   node->destroyed = FALSE;
 
   /* setup reinitializable portion */
-  node->single_va_closure_is_valid = FALSE;
+  node_invalidate_single_va_closure (node);
   node->flags = signal_flags & G_SIGNAL_FLAGS_MASK;
   node->n_params = n_params;
   node->param_types = g_memdup2 (param_types, sizeof (GType) * n_params);
@@ -1817,7 +2092,7 @@ g_signal_set_va_marshaller (guint              signal_id,
 	    _g_closure_set_va_marshal (cc->closure, va_marshaller);
 	}
 
-      node->single_va_closure_is_valid = FALSE;
+      node_invalidate_single_va_closure (node);
     }
 
   SIGNAL_UNLOCK ();
@@ -1901,7 +2176,7 @@ signal_destroy_R (SignalNode *signal_node)
   signal_node->destroyed = TRUE;
   
   /* reentrancy caution, zero out real contents first */
-  signal_node->single_va_closure_is_valid = FALSE;
+  node_invalidate_single_va_closure (signal_node);
   signal_node->n_params = 0;
   signal_node->param_types = NULL;
   signal_node->return_type = 0;
@@ -2594,6 +2869,7 @@ signal_handler_block_unlocked (gpointer instance,
         g_error (G_STRLOC ": handler block_count overflow, %s", REPORT_BUG);
 #endif
       handler->block_count += 1;
+      handler_list_invalidate_snapshot_R (handler->signal_id, instance);
     }
   else
     g_critical ("%s: instance '%p' has no handler with id '%lu'", G_STRLOC, instance, handler_id);
@@ -2644,7 +2920,10 @@ signal_handler_unblock_unlocked (gpointer instance,
   if (handler)
     {
       if (handler->block_count)
-        handler->block_count -= 1;
+        {
+          handler->block_count -= 1;
+          handler_list_invalidate_snapshot_R (handler->signal_id, instance);
+        }
       else
         g_critical (G_STRLOC ": handler '%lu' of instance '%p' is not blocked", handler_id, instance);
     }
@@ -2693,6 +2972,7 @@ signal_handler_disconnect_unlocked (gpointer instance,
       handler->sequential_number = 0;
       handler->block_count = 1;
       remove_invalid_closure_notify (handler, instance);
+      handler_list_invalidate_snapshot_R (handler->signal_id, instance);
       handler_unref_R (handler->signal_id, instance, handler);
     }
   else
@@ -2753,6 +3033,14 @@ g_signal_handlers_destroy (gpointer instance)
         {
           HandlerList *hlist = g_bsearch_array_get_nth (hlbsa, &g_signal_hlbsa_bconfig, i);
           Handler *handler = hlist->handlers;
+
+          if (hlist->snapshot)
+            {
+              HandlerSnapshot *snapshot = g_steal_pointer (&hlist->snapshot);
+
+              g_atomic_int_set (&snapshot->stale, TRUE);
+              handler_snapshot_unref_R (hlist->signal_id, instance, snapshot);
+            }
 	  
           while (handler)
             {
@@ -3099,6 +3387,51 @@ signal_emitv_unlocked (const GValue *instance_and_params,
                        GQuark        detail,
                        GValue       *return_value);
 
+/*<private>
+ * signal_emission_is_nop_unlocked:
+ * @instance: The instance to emit from
+ * @signal_id: Signal id to emit
+ * @detail: Signal detail
+ *
+ * Checks, without taking the signal lock, whether emitting @signal_id on
+ * @instance would do nothing at all: the signal returns nothing, has no
+ * emission hooks, its class closure (if any) is void for @instance and no
+ * handler has ever been connected to @instance.
+ *
+ * This only relies on state which is either immutable once published or
+ * read atomically. Emissions which this returns %FALSE for (including
+ * invalid ones, which need to be reported) go through the locked path.
+ *
+ * Returns: %TRUE if the emission can be skipped
+ */
+static inline gboolean
+signal_emission_is_nop_unlocked (gpointer instance,
+                                 guint    signal_id,
+                                 GQuark   detail)
+{
+  SignalNode *node;
+  GClosure *closure;
+
+  /* Detailed emissions need node->flags to be validated; invalid instances
+   * are left to the locked path so that they are only warned about once */
+  if (detail != 0 || instance == NULL || ((GTypeInstance *) instance)->g_class == NULL)
+    return FALSE;
+
+  node = LOOKUP_SIGNAL_NODE_UNLOCKED (signal_id);
+  if (!node)
+    return FALSE;
+
+  /* nop_closure is only set for GObject signals */
+  closure = g_atomic_pointer_get (&node->nop_closure);
+  if (closure == NULL ||
+      !g_type_is_a (G_TYPE_FROM_INSTANCE (instance), node->itype) ||
+      _g_object_has_signal_handler ((GObject *) instance))
+    return FALSE;
+
+  return closure == SINGLE_VA_CLOSURE_EMPTY_MAGIC ||
+         _g_closure_is_void (closure, instance);
+}
+
 /**
  * g_signal_emitv:
  * @instance_and_params: (array): argument list for the signal emission.
@@ -3122,6 +3455,12 @@ g_signal_emitv (const GValue *instance_and_params,
 		GQuark	      detail,
 		GValue       *return_value)
 {
+  if (instance_and_params != NULL &&
+      G_VALUE_HOLDS_OBJECT (instance_and_params) &&
+      signal_emission_is_nop_unlocked (g_value_peek_pointer (instance_and_params),
+                                       signal_id, detail))
+    return;
+
   SIGNAL_LOCK ();
   signal_emitv_unlocked (instance_and_params, signal_id, detail, return_value);
   SIGNAL_UNLOCK ();
@@ -3223,7 +3562,7 @@ signal_emitv_unlocked (const GValue *instance_and_params,
   /* Pass a stable node pointer, whose address can't change even if the
    * g_signal_nodes array gets reallocated. */
   SignalNode node_copy = *node;
-  signal_emit_unlocked_R (&node_copy, detail, instance, return_value, instance_and_params);
+  signal_emit_unlocked_R (&node_copy, detail, instance, return_value, instance_and_params, NULL);
 }
 
 static inline gboolean
@@ -3245,6 +3584,48 @@ accumulate (GSignalInvocationHint *ihint,
   return continue_emission;
 }
 
+/*<private>
+ * signal_emission_supports_va_unlocked:
+ * @node: The signal node
+ * @instance: The instance to emit from
+ *
+ * Checks whether signal_emit_unlocked_R() can marshal an emission of @node
+ * on @instance straight from a va_list to every closure it runs: the
+ * emission has no hooks and cannot be restarted, its argument and return
+ * types are plain values, and the class closure and all the handlers have
+ * va marshallers. Handlers connected during the emission are not run by
+ * it, so this stays true for the whole emission once it has started.
+ *
+ * Returns: %TRUE if the arguments don't need to be collected into #GValues
+ */
+static gboolean
+signal_emission_supports_va_unlocked (SignalNode *node,
+                                      gpointer    instance)
+{
+  HandlerList *hlist;
+
+  if (!node->single_va_closure_is_valid)
+    node_update_single_va_closure (node);
+
+  if (node->single_va_closure == NULL ||
+      !node->va_types_are_plain ||
+      (node->flags & G_SIGNAL_NO_RECURSE) != 0)
+    return FALSE;
+
+  if (node->single_va_closure != SINGLE_VA_CLOSURE_EMPTY_MAGIC &&
+      !_g_closure_supports_invoke_va (node->single_va_closure))
+    return FALSE;
+
+  hlist = handler_list_lookup (node->signal_id, instance);
+  if (!hlist || !hlist->handlers)
+    return TRUE;
+
+  if (!hlist->snapshot)
+    hlist->snapshot = handler_snapshot_new (hlist);
+
+  return hlist->snapshot->supports_va;
+}
+
 static gboolean
 signal_emit_valist_unlocked (gpointer instance,
                              guint    signal_id,
@@ -3273,6 +3654,9 @@ g_signal_emit_valist (gpointer instance,
 		      GQuark   detail,
 		      va_list  var_args)
 {
+  if (signal_emission_is_nop_unlocked (instance, signal_id, detail))
+    return;
+
   SIGNAL_LOCK ();
   if (signal_emit_valist_unlocked (instance, signal_id, detail, var_args))
     SIGNAL_UNLOCK ();
@@ -3497,7 +3881,69 @@ signal_emit_valist_unlocked (gpointer instance,
 	}
     }
 
-  SIGNAL_UNLOCK ();
+  /* Several closures to run, but all of them can take the arguments
+   * straight from the va_list */
+  if (signal_emission_supports_va_unlocked (node, instance))
+    {
+      /* Keep the instance alive as the collected GValue would; this is only
+       * done for GObjects */
+      SIGNAL_UNLOCK ();
+      g_object_ref (instance);
+      SIGNAL_LOCK ();
+
+      /* The signal and its handlers may have changed meanwhile */
+      node_copy = *node;
+      if (signal_emission_supports_va_unlocked (node, instance))
+        {
+          GValue return_value = G_VALUE_INIT;
+          GType rtype = node_copy.return_type & ~G_SIGNAL_TYPE_STATIC_SCOPE;
+          gboolean static_scope = node_copy.return_type & G_SIGNAL_TYPE_STATIC_SCOPE;
+          va_list args;
+
+          /* A plain type, so this can't call back into the signal system */
+          if (rtype != G_TYPE_NONE)
+            g_value_init (&return_value, rtype);
+
+          va_copy (args, var_args);
+          signal_emit_unlocked_R (&node_copy, detail, instance,
+                                  rtype != G_TYPE_NONE ? &return_value : NULL,
+                                  NULL, &args);
+          va_end (args);
+          SIGNAL_UNLOCK ();
+
+          if (rtype != G_TYPE_NONE)
+            {
+              gchar *error = NULL;
+
+              for (i = 0; i < node_copy.n_params; i++)
+                {
+                  GType ptype = node_copy.param_types[i] & ~G_SIGNAL_TYPE_STATIC_SCOPE;
+                  G_VALUE_COLLECT_SKIP (ptype, var_args);
+                }
+
+              G_VALUE_LCOPY (&return_value,
+                             var_args,
+                             static_scope ? G_VALUE_NOCOPY_CONTENTS : 0,
+                             &error);
+              if (!error)
+                g_value_unset (&return_value);
+              else
+                {
+                  g_critical ("%s: %s", G_STRLOC, error);
+                  g_free (error);
+                }
+            }
+
+          g_object_unref (instance);
+
+          return FALSE;
+        }
+
+      SIGNAL_UNLOCK ();
+      g_object_unref (instance);
+    }
+  else
+    SIGNAL_UNLOCK ();
 
   instance_and_params = g_newa0 (GValue, node_copy.n_params + 1);
   param_values = instance_and_params + 1;
@@ -3531,7 +3977,7 @@ signal_emit_valist_unlocked (gpointer instance,
   if (node_copy.return_type == G_TYPE_NONE)
     {
       SIGNAL_LOCK ();
-      signal_emit_unlocked_R (&node_copy, detail, instance, NULL, instance_and_params);
+      signal_emit_unlocked_R (&node_copy, detail, instance, NULL, instance_and_params, NULL);
       SIGNAL_UNLOCK ();
     }
   else
@@ -3544,7 +3990,7 @@ signal_emit_valist_unlocked (gpointer instance,
       g_value_init (&return_value, rtype);
 
       SIGNAL_LOCK ();
-      signal_emit_unlocked_R (&node_copy, detail, instance, &return_value, instance_and_params);
+      signal_emit_unlocked_R (&node_copy, detail, instance, &return_value, instance_and_params, NULL);
       SIGNAL_UNLOCK ();
 
       G_VALUE_LCOPY (&return_value,
@@ -3666,23 +4112,68 @@ maybe_init_accumulator_unlocked (SignalNode *node,
   return emission_return;
 }
 
+/* Invokes @closure for @emission, either with the collected
+ * @instance_and_params or straight from @var_args if that is set */
+static inline void
+emission_invoke_closure (Emission     *emission,
+                         SignalNode   *node,
+                         GClosure     *closure,
+                         GValue       *return_value,
+                         const GValue *instance_and_params,
+                         va_list      *var_args)
+{
+  if (var_args)
+    {
+      va_list args;
+
+      /* The marshaller may consume the arguments, and there may be several
+       * closures to invoke */
+      va_copy (args, *var_args);
+      _g_closure_invoke_va (closure,
+                            return_value,
+                            emission->instance,
+                            args,
+                            node->n_params,
+                            node->param_types);
+      va_end (args);
+    }
+  else
+    g_closure_invoke (closure,
+                      return_value,
+                      node->n_params + 1,
+                      instance_and_params,
+                      &emission->ihint);
+}
+
+/*<private>
+ * signal_emit_unlocked_R:
+ * @node: Stable copy of the signal node
+ * @detail: Signal detail
+ * @instance: The instance to emit from
+ * @emission_return: (nullable): Return value of the emission
+ * @instance_and_params: (nullable): Collected instance and arguments
+ * @var_args: (nullable): Arguments to marshal from instead of
+ *   @instance_and_params, if signal_emission_supports_va_unlocked()
+ *
+ * Returns: whether @emission_return has been set
+ */
 static gboolean
 signal_emit_unlocked_R (SignalNode   *node,
 			GQuark	      detail,
 			gpointer      instance,
 			GValue	     *emission_return,
-			const GValue *instance_and_params)
+			const GValue *instance_and_params,
+			va_list      *var_args)
 {
   SignalAccumulator *accumulator;
   Emission emission;
   GClosure *class_closure;
-  HandlerList *hlist;
-  Handler *handler_list = NULL;
+  HandlerSnapshot *snapshot = NULL;
   GValue *return_accu, accu = G_VALUE_INIT;
   guint signal_id;
-  gulong max_sequential_handler_number;
   gboolean return_value_altered = FALSE;
   guint n_params;
+  guint i;
 
   TRACE(GOBJECT_SIGNAL_EMIT(node->signal_id, detail, instance, G_TYPE_FROM_INSTANCE (instance)));
 
@@ -3715,13 +4206,10 @@ signal_emit_unlocked_R (SignalNode   *node,
   
  EMIT_RESTART:
   
-  if (handler_list)
-    handler_unref_R (signal_id, instance, handler_list);
-  max_sequential_handler_number = g_handler_sequential_number;
-  hlist = handler_list_lookup (signal_id, instance);
-  handler_list = hlist ? hlist->handlers : NULL;
-  if (handler_list)
-    handler_ref (handler_list);
+  /* Handlers connected from now on are not part of this emission */
+  if (snapshot)
+    handler_snapshot_unref_R (signal_id, instance, snapshot);
+  snapshot = handler_snapshot_get (signal_id, instance);
   
   emission.ihint.run_type = G_SIGNAL_RUN_FIRST | G_SIGNAL_ACCUMULATOR_FIRST_RUN;
   
@@ -3732,11 +4220,8 @@ signal_emit_unlocked_R (SignalNode   *node,
       emission.chain_type = G_TYPE_FROM_INSTANCE (instance);
       SIGNAL_UNLOCK ();
       return_accu = maybe_init_accumulator_unlocked (node, emission_return, &accu);
-      g_closure_invoke (class_closure,
-			return_accu,
-                        n_params,
-			instance_and_params,
-			&emission.ihint);
+      emission_invoke_closure (&emission, node, class_closure, return_accu,
+                               instance_and_params, var_args);
       if (!accumulate (&emission.ihint, emission_return, &accu, accumulator) &&
 	  emission.state == EMISSION_RUN)
 	emission.state = EMISSION_STOP;
@@ -3750,13 +4235,15 @@ signal_emit_unlocked_R (SignalNode   *node,
 	goto EMIT_RESTART;
     }
 
-  if (node->emission_hooks)
+  /* Emissions from a va_list are only made when there are no emission hooks
+   * and, like the single closure fast path, do not run hooks added during
+   * the emission, as they would need the collected arguments */
+  if (node->emission_hooks && !var_args)
     {
       GHook *hook;
       GHook *static_emission_hooks[3];
       size_t n_emission_hooks = 0;
       const gboolean may_recurse = TRUE;
-      guint i;
 
       emission.state = EMISSION_HOOK;
 
@@ -3878,50 +4365,27 @@ signal_emit_unlocked_R (SignalNode   *node,
 	goto EMIT_RESTART;
     }
   
-  if (handler_list)
+  if (snapshot && snapshot->n_before > 0)
     {
-      Handler *handler = handler_list;
-      
       emission.state = EMISSION_RUN;
-      handler_ref (handler);
-      do
-	{
-	  Handler *tmp;
-	  
-	  if (handler->after)
-	    {
-	      handler_unref_R (signal_id, instance, handler_list);
-	      handler_list = handler;
-	      break;
-	    }
-	  else if (!handler->block_count && (!handler->detail || handler->detail == detail) &&
-		   handler->sequential_number < max_sequential_handler_number)
-	    {
-	      SIGNAL_UNLOCK ();
-	      return_accu = maybe_init_accumulator_unlocked (node, emission_return, &accu);
-	      g_closure_invoke (handler->closure,
-				return_accu,
-                                n_params,
-				instance_and_params,
-				&emission.ihint);
-	      if (!accumulate (&emission.ihint, emission_return, &accu, accumulator) &&
-		  emission.state == EMISSION_RUN)
-		emission.state = EMISSION_STOP;
-	      SIGNAL_LOCK ();
-	      return_value_altered = TRUE;
-	      
-	      tmp = emission.state == EMISSION_RUN ? handler->next : NULL;
-	    }
-	  else
-	    tmp = handler->next;
-	  
-	  if (tmp)
-	    handler_ref (tmp);
-	  handler_unref_R (signal_id, instance, handler_list);
-	  handler_list = handler;
-	  handler = tmp;
-	}
-      while (handler);
+      SIGNAL_UNLOCK ();
+      for (i = 0; i < snapshot->n_before && emission.state == EMISSION_RUN; i++)
+        {
+          HandlerSnapshotEntry *entry = &snapshot->entries[i];
+
+          if ((!entry->detail || entry->detail == detail) &&
+              handler_snapshot_entry_is_active (snapshot, i))
+            {
+              return_accu = maybe_init_accumulator_unlocked (node, emission_return, &accu);
+              emission_invoke_closure (&emission, node, entry->closure, return_accu,
+                                       instance_and_params, var_args);
+              if (!accumulate (&emission.ihint, emission_return, &accu, accumulator) &&
+                  emission.state == EMISSION_RUN)
+                emission.state = EMISSION_STOP;
+              return_value_altered = TRUE;
+            }
+        }
+      SIGNAL_LOCK ();
       
       if (emission.state == EMISSION_STOP)
 	goto EMIT_CLEANUP;
@@ -3939,11 +4403,8 @@ signal_emit_unlocked_R (SignalNode   *node,
       emission.chain_type = G_TYPE_FROM_INSTANCE (instance);
       SIGNAL_UNLOCK ();
       return_accu = maybe_init_accumulator_unlocked (node, emission_return, &accu);
-      g_closure_invoke (class_closure,
-			return_accu,
-                        n_params,
-			instance_and_params,
-			&emission.ihint);
+      emission_invoke_closure (&emission, node, class_closure, return_accu,
+                               instance_and_params, var_args);
       if (!accumulate (&emission.ihint, emission_return, &accu, accumulator) &&
 	  emission.state == EMISSION_RUN)
 	emission.state = EMISSION_STOP;
@@ -3957,43 +4418,27 @@ signal_emit_unlocked_R (SignalNode   *node,
 	goto EMIT_RESTART;
     }
   
-  if (handler_list)
+  if (snapshot && snapshot->n_before < snapshot->n_handlers)
     {
-      Handler *handler = handler_list;
-      
       emission.state = EMISSION_RUN;
-      handler_ref (handler);
-      do
-	{
-	  Handler *tmp;
-	  
-	  if (handler->after && !handler->block_count && (!handler->detail || handler->detail == detail) &&
-	      handler->sequential_number < max_sequential_handler_number)
-	    {
-	      SIGNAL_UNLOCK ();
-	      return_accu = maybe_init_accumulator_unlocked (node, emission_return, &accu);
-	      g_closure_invoke (handler->closure,
-				return_accu,
-                                n_params,
-				instance_and_params,
-				&emission.ihint);
-	      if (!accumulate (&emission.ihint, emission_return, &accu, accumulator) &&
-		  emission.state == EMISSION_RUN)
-		emission.state = EMISSION_STOP;
-	      SIGNAL_LOCK ();
-	      return_value_altered = TRUE;
-	      
-	      tmp = emission.state == EMISSION_RUN ? handler->next : NULL;
-	    }
-	  else
-	    tmp = handler->next;
-	  
-	  if (tmp)
-	    handler_ref (tmp);
-	  handler_unref_R (signal_id, instance, handler);
-	  handler = tmp;
-	}
-      while (handler);
+      SIGNAL_UNLOCK ();
+      for (i = snapshot->n_before; i < snapshot->n_handlers && emission.state == EMISSION_RUN; i++)
+        {
+          HandlerSnapshotEntry *entry = &snapshot->entries[i];
+
+          if ((!entry->detail || entry->detail == detail) &&
+              handler_snapshot_entry_is_active (snapshot, i))
+            {
+              return_accu = maybe_init_accumulator_unlocked (node, emission_return, &accu);
+              emission_invoke_closure (&emission, node, entry->closure, return_accu,
+                                       instance_and_params, var_args);
+              if (!accumulate (&emission.ihint, emission_return, &accu, accumulator) &&
+                  emission.state == EMISSION_RUN)
+                emission.state = EMISSION_STOP;
+              return_value_altered = TRUE;
+            }
+        }
+      SIGNAL_LOCK ();
       
       if (emission.state == EMISSION_STOP)
 	goto EMIT_CLEANUP;
@@ -4019,11 +4464,9 @@ signal_emit_unlocked_R (SignalNode   *node,
 	  g_value_init (&accu, node->return_type & ~G_SIGNAL_TYPE_STATIC_SCOPE);
 	  need_unset = TRUE;
 	}
-      g_closure_invoke (class_closure,
-			node->return_type != G_TYPE_NONE ? &accu : NULL,
-                        n_params,
-			instance_and_params,
-			&emission.ihint);
+      emission_invoke_closure (&emission, node, class_closure,
+                               node->return_type != G_TYPE_NONE ? &accu : NULL,
+                               instance_and_params, var_args);
       if (!accumulate (&emission.ihint, emission_return, &accu, accumulator) &&
           emission.state == EMISSION_RUN)
         emission.state = EMISSION_STOP;
@@ -4038,8 +4481,8 @@ signal_emit_unlocked_R (SignalNode   *node,
 	goto EMIT_RESTART;
     }
   
-  if (handler_list)
-    handler_unref_R (signal_id, instance, handler_list);
+  if (snapshot)
+    handler_snapshot_unref_R (signal_id, instance, snapshot);
   
   emission_pop (&emission);
   if (accumulator)
@@ -4086,6 +4529,7 @@ invalid_closure_notify (gpointer  instance,
   g_hash_table_remove (g_handlers, handler);
   handler->sequential_number = 0;
   handler->block_count = 1;
+  handler_list_invalidate_snapshot_R (signal_id, instance);
   handler_unref_R (signal_id, instance, handler);
 
   SIGNAL_UNLOCK ();
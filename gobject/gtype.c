@@ -210,7 +210,8 @@ struct _TypeNode
     GAtomicArray iface_entries;		/* for !iface types */
     GAtomicArray offsets;
   } _prot;
-  GType       *prerequisites;
+  GAtomicArray prerequisites;		/* for iface types */
+  GType        value_prerequisite; /* (atomic) first instantiatable prerequisite */
   GType        supers[1]; /* flexible array */
 };
 
@@ -228,7 +229,7 @@ struct _TypeNode
 #define	CLASSED_NODE_IFACES_ENTRIES(node)	(&(node)->_prot.iface_entries)
 #define	CLASSED_NODE_IFACES_ENTRIES_LOCKED(node)(G_ATOMIC_ARRAY_GET_LOCKED(CLASSED_NODE_IFACES_ENTRIES((node)), IFaceEntries))
 #define	IFACE_NODE_N_PREREQUISITES(node)	((node)->n_prerequisites)
-#define	IFACE_NODE_PREREQUISITES(node)		((node)->prerequisites)
+#define	IFACE_NODE_PREREQUISITES(node)		(G_ATOMIC_ARRAY_GET_LOCKED (&(node)->prerequisites, GType))
 #define	iface_node_get_holders_L(node)		((IFaceHolder*) type_get_qdata_L ((node), static_quark_iface_holder))
 #define	iface_node_set_holders_W(node, holders)	(type_set_qdata_W ((node), static_quark_iface_holder, (holders)))
 #define	iface_node_get_dependants_array_L(n)	((GType*) type_get_qdata_L ((n), static_quark_dependants_array))
@@ -434,7 +435,8 @@ type_node_any_new_W (TypeNode             *pnode,
       if (NODE_IS_IFACE (node))
 	{
           IFACE_NODE_N_PREREQUISITES (node) = 0;
-	  IFACE_NODE_PREREQUISITES (node) = NULL;
+	  _g_atomic_array_init (&node->prerequisites);
+	  node->value_prerequisite = 0;
 	}
       else
 	_g_atomic_array_init (CLASSED_NODE_IFACES_ENTRIES (node));
@@ -454,7 +456,8 @@ type_node_any_new_W (TypeNode             *pnode,
       if (NODE_IS_IFACE (node))
 	{
 	  IFACE_NODE_N_PREREQUISITES (node) = 0;
-	  IFACE_NODE_PREREQUISITES (node) = NULL;
+	  _g_atomic_array_init (&node->prerequisites);
+	  node->value_prerequisite = 0;
 	}
       else
 	{
@@ -629,35 +632,53 @@ type_lookup_iface_vtable_I (TypeNode *node,
   return res;
 }
 
+/* The prerequisites array is replaced rather than modified when it grows,
+ * so it can be searched without holding the lock. Its size is taken from
+ * the array itself, as the count in the node may already be newer.
+ */
 static inline gboolean
-type_lookup_prerequisite_L (TypeNode *iface,
+type_lookup_prerequisite_I (TypeNode *iface,
 			    GType     prerequisite_type)
 {
-  if (NODE_IS_IFACE (iface) && IFACE_NODE_N_PREREQUISITES (iface))
-    {
-      GType *prerequisites = IFACE_NODE_PREREQUISITES (iface) - 1;
-      guint n_prerequisites = IFACE_NODE_N_PREREQUISITES (iface);
-      
-      do
-	{
-	  guint i;
-	  GType *check;
-	  
-	  i = (n_prerequisites + 1) >> 1;
-	  check = prerequisites + i;
-	  if (prerequisite_type == *check)
-	    return TRUE;
-	  else if (prerequisite_type > *check)
-	    {
-	      n_prerequisites -= i;
-	      prerequisites = check;
-	    }
-	  else /* if (prerequisite_type < *check) */
-	    n_prerequisites = i - 1;
-	}
-      while (n_prerequisites);
-    }
-  return FALSE;
+  gboolean found;
+
+  if (!NODE_IS_IFACE (iface))
+    return FALSE;
+
+  G_ATOMIC_ARRAY_DO_TRANSACTION
+    (&iface->prerequisites, GType,
+
+     found = FALSE;
+     if (transaction_data != NULL)
+       {
+	 GType *prerequisites = transaction_data - 1;
+	 guint n_prerequisites = G_ATOMIC_ARRAY_DATA_SIZE (transaction_data) / sizeof (GType);
+
+	 do
+	   {
+	     guint i;
+	     GType *check;
+
+	     i = (n_prerequisites + 1) >> 1;
+	     check = prerequisites + i;
+	     if (prerequisite_type == *check)
+	       {
+		 found = TRUE;
+		 break;
+	       }
+	     else if (prerequisite_type > *check)
+	       {
+		 n_prerequisites -= i;
+		 prerequisites = check;
+	       }
+	     else /* if (prerequisite_type < *check) */
+	       n_prerequisites = i - 1;
+	   }
+	 while (n_prerequisites);
+       }
+     );
+
+  return found;
 }
 
 static const gchar*
@@ -1464,27 +1485,33 @@ type_iface_add_prerequisite_W (TypeNode *iface,
 			       TypeNode *prerequisite_node)
 {
   GType prerequisite_type = NODE_TYPE (prerequisite_node);
-  GType *prerequisites, *dependants;
-  guint n_dependants, i;
+  GType *old_prerequisites, *prerequisites, *dependants;
+  guint n_prerequisites, n_dependants, i;
   
   g_assert (NODE_IS_IFACE (iface) &&
 	    IFACE_NODE_N_PREREQUISITES (iface) < MAX_N_PREREQUISITES &&
 	    (prerequisite_node->is_instantiatable || NODE_IS_IFACE (prerequisite_node)));
   
-  prerequisites = IFACE_NODE_PREREQUISITES (iface);
-  for (i = 0; i < IFACE_NODE_N_PREREQUISITES (iface); i++)
-    if (prerequisites[i] == prerequisite_type)
+  old_prerequisites = IFACE_NODE_PREREQUISITES (iface);
+  n_prerequisites = IFACE_NODE_N_PREREQUISITES (iface);
+  for (i = 0; i < n_prerequisites; i++)
+    if (old_prerequisites[i] == prerequisite_type)
       return;			/* we already have that prerequisiste */
-    else if (prerequisites[i] > prerequisite_type)
+    else if (old_prerequisites[i] > prerequisite_type)
       break;
-  IFACE_NODE_N_PREREQUISITES (iface) += 1;
-  IFACE_NODE_PREREQUISITES (iface) = g_renew (GType,
-					      IFACE_NODE_PREREQUISITES (iface),
-					      IFACE_NODE_N_PREREQUISITES (iface));
-  prerequisites = IFACE_NODE_PREREQUISITES (iface);
+
+  /* Lock-free readers may still be looking at the old array, so insert
+   * into a copy; the old one is recycled for later arrays of its size. */
+  prerequisites = _g_atomic_array_copy (&iface->prerequisites, 0, sizeof (GType));
   memmove (prerequisites + i + 1, prerequisites + i,
-           sizeof (prerequisites[0]) * (IFACE_NODE_N_PREREQUISITES (iface) - i - 1));
+           sizeof (GType) * (n_prerequisites - i));
   prerequisites[i] = prerequisite_type;
+  _g_atomic_array_update (&iface->prerequisites, prerequisites);
+  IFACE_NODE_N_PREREQUISITES (iface) = n_prerequisites + 1;
+
+  if (prerequisite_node->is_instantiatable &&
+      (iface->value_prerequisite == 0 || prerequisite_type < iface->value_prerequisite))
+    g_atomic_pointer_set (&iface->value_prerequisite, prerequisite_type);
   
   /* we want to get notified when prerequisites get added to prerequisite_node */
   if (NODE_IS_IFACE (prerequisite_node))
@@ -3324,12 +3351,8 @@ type_node_check_conformities_UorL (TypeNode *node,
   if (!match &&
       support_prerequisites)
     {
-      if (!have_lock)
-	G_READ_LOCK (&type_rw_lock);
-      if (support_prerequisites && type_lookup_prerequisite_L (node, NODE_TYPE (iface_node)))
+      if (type_lookup_prerequisite_I (node, NODE_TYPE (iface_node)))
 	match = TRUE;
-      if (!have_lock)
-	G_READ_UNLOCK (&type_rw_lock);
     }
   return match;
 }
@@ -4037,6 +4060,28 @@ g_type_check_instance (GTypeInstance *type_instance)
   return FALSE;
 }
 
+/* Values of an interface type without a value table of its own use the
+ * value table of the interface's instantiatable prerequisite. The data of
+ * static types is never freed, so for static interfaces this can be worked
+ * out without the lock, letting e.g. values of type GListModel hit the
+ * mutatable_check_cache fast paths below.
+ */
+static inline TypeNode *
+iface_node_get_value_node_I (TypeNode *node)
+{
+  GType prerequisite;
+
+  if (!NODE_IS_IFACE (node) || node->plugin != NULL || node->data == NULL ||
+      node->data->common.value_table->value_init != NULL)
+    return node;
+
+  prerequisite = (GType) g_atomic_pointer_get (&node->value_prerequisite);
+  if (prerequisite != 0)
+    return lookup_type_node_I (prerequisite);
+
+  return node;
+}
+
 static inline gboolean
 type_check_is_value_type_U (GType type)
 {
@@ -4045,6 +4090,8 @@ type_check_is_value_type_U (GType type)
   
   /* common path speed up */
   node = lookup_type_node_I (type);
+  if (node)
+    node = iface_node_get_value_node_I (node);
   if (node && node->mutatable_check_cache)
     return TRUE;
   
@@ -4118,6 +4165,11 @@ g_type_value_table_peek (GType type)
   TypeNode *node = lookup_type_node_I (type);
   gboolean has_data, has_table;
 
+  if (node != NULL)
+    {
+      node = iface_node_get_value_node_I (node);
+      type = NODE_TYPE (node);
+    }
   if (node != NULL && node->mutatable_check_cache)
     return node->data->common.value_table;
 
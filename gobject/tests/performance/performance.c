@@ -367,6 +367,7 @@ enum {
   COMPLEX_SIGNAL_GENERIC,
   COMPLEX_SIGNAL_GENERIC_EMPTY,
   COMPLEX_SIGNAL_ARGS,
+  COMPLEX_SIGNAL_OBJECT_ARGS,
   COMPLEX_LAST_SIGNAL
 };
 
@@ -487,6 +488,15 @@ complex_object_class_init (ComplexObjectClass *class)
                   g_cclosure_marshal_VOID__UINT_POINTER,
                   G_TYPE_NONE, 2, G_TYPE_UINT, G_TYPE_POINTER);
 
+  complex_signals[COMPLEX_SIGNAL_OBJECT_ARGS] =
+    g_signal_new ("signal-object-args",
+                  G_TYPE_FROM_CLASS (object_class),
+                  G_SIGNAL_RUN_FIRST,
+                  G_STRUCT_OFFSET (ComplexObjectClass, signal),
+                  NULL, NULL,
+                  NULL,
+                  G_TYPE_NONE, 2, G_TYPE_OBJECT, G_TYPE_STRING);
+
   pspecs[PROP_VAL1] = g_param_spec_int ("val1", "val1", "val1",
                                         0, G_MAXINT, 42,
                                         G_PARAM_STATIC_STRINGS | G_PARAM_CONSTRUCT | G_PARAM_READWRITE);
@@ -813,6 +823,96 @@ test_type_check_teardown (PerformanceTest *test,
   g_free (data);
 }
 
+/*************************************************************
+ * Test type check performance on values of an interface type
+ *************************************************************/
+
+typedef struct _TestIfaceClass TestValueIfaceInterface;
+
+static GType test_value_iface_get_type (void);
+#define TEST_TYPE_VALUE_IFACE (test_value_iface_get_type ())
+
+G_DEFINE_INTERFACE (TestValueIface, test_value_iface, G_TYPE_OBJECT)
+
+static void
+test_value_iface_default_init (TestValueIfaceInterface *iface)
+{
+}
+
+/* Work around g_type_check_value_holds being marked "pure",
+ * and thus only called once for the loop. */
+static gboolean (*my_type_check_value_holds) (const GValue *value,
+                                              GType type);
+
+struct ValueTypeCheckTest {
+  GValue value;
+  unsigned int n_checks;
+};
+
+static gpointer
+test_value_type_check_setup (PerformanceTest *test)
+{
+  struct ValueTypeCheckTest *data;
+
+  my_type_check_value_holds = &g_type_check_value_holds;
+
+  data = g_new0 (struct ValueTypeCheckTest, 1);
+  g_value_init (&data->value, TEST_TYPE_VALUE_IFACE);
+
+  return data;
+}
+
+static void
+test_value_type_check_init (PerformanceTest *test,
+			    gpointer _data,
+			    double factor)
+{
+  struct ValueTypeCheckTest *data = _data;
+
+  data->n_checks = (unsigned int) (test->base_factor * factor);
+}
+
+static void
+test_value_type_check_run (PerformanceTest *test,
+			   gpointer _data)
+{
+  struct ValueTypeCheckTest *data = _data;
+
+  for (unsigned int i = 0; i < data->n_checks; i++)
+    {
+      for (unsigned int j = 0; j < 1000; j++)
+	{
+	  my_type_check_value_holds (&data->value, G_TYPE_OBJECT);
+	}
+    }
+}
+
+static void
+test_value_type_check_finish (PerformanceTest *test,
+			      gpointer data)
+{
+}
+
+static void
+test_value_type_check_print_result (PerformanceTest *test,
+				    gpointer _data,
+				    double time)
+{
+  struct ValueTypeCheckTest *data = _data;
+  g_print ("Million value type checks per second: %.2f\n",
+	   data->n_checks / (1000*time));
+}
+
+static void
+test_value_type_check_teardown (PerformanceTest *test,
+				gpointer _data)
+{
+  struct ValueTypeCheckTest *data = _data;
+
+  g_value_unset (&data->value);
+  g_free (data);
+}
+
 /*************************************************************
  * Test signal emissions performance (common code)
  *************************************************************/
@@ -845,6 +945,17 @@ test_emission_run_args (PerformanceTest *test,
     g_signal_emit (object, data->signal_id, 0, 0, NULL);
 }
 
+static void
+test_emission_run_object_args (PerformanceTest *test,
+                               gpointer _data)
+{
+  struct EmissionTest *data = _data;
+  GObject *object = data->object;
+
+  for (unsigned int i = 0; i < data->n_checks; i++)
+    g_signal_emit (object, data->signal_id, 0, object, "argument");
+}
+
 /*************************************************************
  * Test signal unhandled emissions performance
  *************************************************************/
@@ -929,6 +1040,9 @@ test_emission_handled_setup (PerformanceTest *test)
   g_signal_connect (data->object, "signal-args",
                     G_CALLBACK (test_emission_handled_handler),
                     NULL);
+  g_signal_connect (data->object, "signal-object-args",
+                    G_CALLBACK (test_emission_handled_handler),
+                    NULL);
 
   return data;
 }
@@ -970,6 +1084,29 @@ test_emission_handled_teardown (PerformanceTest *test,
   g_free (data);
 }
 
+/*************************************************************
+ * Test signal emissions performance with many handlers
+ *************************************************************/
+
+#define N_EMISSION_HANDLERS 10
+
+static gpointer
+test_emission_handled_many_setup (PerformanceTest *test)
+{
+  struct EmissionTest *data;
+
+  data = g_new0 (struct EmissionTest, 1);
+  data->object = g_object_new (COMPLEX_TYPE_OBJECT, NULL);
+  data->signal_id = complex_signals[GPOINTER_TO_UINT (test->extra_data)];
+
+  for (unsigned int i = 0; i < N_EMISSION_HANDLERS; i++)
+    g_signal_connect (data->object, g_signal_name (data->signal_id),
+                      G_CALLBACK (test_emission_handled_handler),
+                      NULL);
+
+  return data;
+}
+
 /*************************************************************
  * Test object notify performance (common code)
  *************************************************************/
@@ -1001,6 +1138,28 @@ test_notify_by_pspec_run (PerformanceTest *test,
     g_object_notify_by_pspec (object, pspecs[PROP_VAL1]);
 }
 
+/* Notifies in batches of 100, as when updating a model in transactions */
+static void
+test_notify_by_pspec_batched_run (PerformanceTest *test,
+                                  void *_data)
+{
+  struct NotifyTest *data = _data;
+  GObject *object = data->object;
+
+  g_object_notify_batch_begin ();
+  for (unsigned int i = 0; i < data->n_checks; i++)
+    {
+      g_object_notify_by_pspec (object, pspecs[PROP_VAL1]);
+
+      if (i % 100 == 99)
+        {
+          g_object_notify_batch_end ();
+          g_object_notify_batch_begin ();
+        }
+    }
+  g_object_notify_batch_end ();
+}
+
 /*************************************************************
  * Test notify unhandled performance
  *************************************************************/
@@ -1471,6 +1630,17 @@ static PerformanceTest tests[] = {
     test_type_check_teardown,
     test_type_check_print_result
   },
+  {
+    "type-check-iface-value",
+    NULL,
+    1887,
+    test_value_type_check_setup,
+    test_value_type_check_init,
+    test_value_type_check_run,
+    test_value_type_check_finish,
+    test_value_type_check_teardown,
+    test_value_type_check_print_result
+  },
   {
     "emit-unhandled",
     GUINT_TO_POINTER (COMPLEX_SIGNAL),
@@ -1526,6 +1696,17 @@ static PerformanceTest tests[] = {
     test_emission_unhandled_teardown,
     test_emission_unhandled_print_result
   },
+  {
+    "emit-unhandled-object-args",
+    GUINT_TO_POINTER (COMPLEX_SIGNAL_OBJECT_ARGS),
+    40000,
+    test_emission_unhandled_setup,
+    test_emission_unhandled_init,
+    test_emission_run_object_args,
+    test_emission_unhandled_finish,
+    test_emission_unhandled_teardown,
+    test_emission_unhandled_print_result
+  },
   {
     "emit-handled",
     GUINT_TO_POINTER (COMPLEX_SIGNAL),
@@ -1581,6 +1762,83 @@ static PerformanceTest tests[] = {
     test_emission_handled_teardown,
     test_emission_handled_print_result
   },
+  {
+    "emit-handled-object-args",
+    GUINT_TO_POINTER (COMPLEX_SIGNAL_OBJECT_ARGS),
+    30000,
+    test_emission_handled_setup,
+    test_emission_handled_init,
+    test_emission_run_object_args,
+    test_emission_handled_finish,
+    test_emission_handled_teardown,
+    test_emission_handled_print_result
+  },
+  {
+    "emit-handled-many",
+    GUINT_TO_POINTER (COMPLEX_SIGNAL),
+    15000,
+    test_emission_handled_many_setup,
+    test_emission_handled_init,
+    test_emission_run,
+    test_emission_handled_finish,
+    test_emission_handled_teardown,
+    test_emission_handled_print_result
+  },
+  {
+    "emit-handled-many-empty",
+    GUINT_TO_POINTER (COMPLEX_SIGNAL_EMPTY),
+    14300,
+    test_emission_handled_many_setup,
+    test_emission_handled_init,
+    test_emission_run,
+    test_emission_handled_finish,
+    test_emission_handled_teardown,
+    test_emission_handled_print_result
+  },
+  {
+    "emit-handled-many-generic",
+    GUINT_TO_POINTER (COMPLEX_SIGNAL_GENERIC),
+    13100,
+    test_emission_handled_many_setup,
+    test_emission_handled_init,
+    test_emission_run,
+    test_emission_handled_finish,
+    test_emission_handled_teardown,
+    test_emission_handled_print_result
+  },
+  {
+    "emit-handled-many-generic-empty",
+    GUINT_TO_POINTER (COMPLEX_SIGNAL_GENERIC_EMPTY),
+    15000,
+    test_emission_handled_many_setup,
+    test_emission_handled_init,
+    test_emission_run,
+    test_emission_handled_finish,
+    test_emission_handled_teardown,
+    test_emission_handled_print_result
+  },
+  {
+    "emit-handled-many-args",
+    GUINT_TO_POINTER (COMPLEX_SIGNAL_ARGS),
+    15300,
+    test_emission_handled_many_setup,
+    test_emission_handled_init,
+    test_emission_run_args,
+    test_emission_handled_finish,
+    test_emission_handled_teardown,
+    test_emission_handled_print_result
+  },
+  {
+    "emit-handled-many-object-args",
+    GUINT_TO_POINTER (COMPLEX_SIGNAL_OBJECT_ARGS),
+    10000,
+    test_emission_handled_many_setup,
+    test_emission_handled_init,
+    test_emission_run_object_args,
+    test_emission_handled_finish,
+    test_emission_handled_teardown,
+    test_emission_handled_print_result
+  },
   {
     "notify-unhandled",
     complex_object_get_type,
@@ -1625,6 +1883,17 @@ static PerformanceTest tests[] = {
     test_notify_handled_teardown,
     test_notify_handled_print_result
   },
+  {
+    "notify-by-pspec-handled-batched",
+    complex_object_get_type,
+    26600,
+    test_notify_handled_setup,
+    test_notify_handled_init,
+    test_notify_by_pspec_batched_run,
+    test_notify_handled_finish,
+    test_notify_handled_teardown,
+    test_notify_handled_print_result
+  },
   {
     "property-set",
     complex_object_get_type,
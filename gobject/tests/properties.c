@@ -474,6 +474,67 @@ properties_notify_queue (void)
   g_object_unref (obj);
 }
 
+static void
+on_notify_log (GObject    *gobject,
+               GParamSpec *pspec,
+               GString    *log)
+{
+  g_string_append_printf (log, "%s:%s;",
+                          (const char *) g_object_get_data (gobject, "name"),
+                          pspec->name);
+}
+
+static void
+properties_notify_batch (void)
+{
+  TestObject *obj1 = g_object_new (test_object_get_type (), NULL);
+  TestObject *obj2 = g_object_new (test_object_get_type (), NULL);
+  TestObject *obj3 = g_object_new (test_object_get_type (), NULL);
+  GString *log = g_string_new (NULL);
+
+  g_object_set_data (G_OBJECT (obj1), "name", "obj1");
+  g_object_set_data (G_OBJECT (obj2), "name", "obj2");
+  g_object_set_data (G_OBJECT (obj3), "name", "obj3");
+  g_signal_connect (obj1, "notify", G_CALLBACK (on_notify_log), log);
+  g_signal_connect (obj2, "notify", G_CALLBACK (on_notify_log), log);
+  g_signal_connect (obj3, "notify", G_CALLBACK (on_notify_log), log);
+
+  g_object_notify_batch_begin ();
+
+  test_object_set_foo (obj2, 1);
+  test_object_set_foo (obj1, 1);
+  test_object_set_foo (obj1, 2);
+  test_object_set_bar (obj1, FALSE);
+  test_object_set_foo (obj1, 3);
+
+  /* Nested batches only deliver when the outermost one ends */
+  g_object_notify_batch_begin ();
+  test_object_set_foo (obj2, 2);
+  g_assert_cmpuint (g_object_notify_batch_end (), ==, 0);
+  g_assert_cmpstr (log->str, ==, "");
+
+  /* Objects which are frozen anyway stay frozen after the batch */
+  g_object_freeze_notify (G_OBJECT (obj3));
+  test_object_set_foo (obj3, 1);
+
+  g_assert_cmpuint (g_object_notify_batch_end (), ==, 3);
+  g_assert_cmpstr (log->str, ==, "obj2:foo;obj1:bar;obj1:foo;");
+
+  g_string_truncate (log, 0);
+  g_object_thaw_notify (G_OBJECT (obj3));
+  g_assert_cmpstr (log->str, ==, "obj3:foo;");
+
+  /* Outside of a batch, notifications are delivered right away */
+  g_string_truncate (log, 0);
+  test_object_set_foo (obj1, 4);
+  g_assert_cmpstr (log->str, ==, "obj1:foo;");
+
+  g_object_unref (obj1);
+  g_object_unref (obj2);
+  g_object_unref (obj3);
+  g_string_free (log, TRUE);
+}
+
 static void
 test_properties_notify_too_frozen (void)
 {
@@ -849,6 +910,7 @@ main (int argc, char *argv[])
   g_test_add_func ("/properties/notify", properties_notify);
   g_test_add_func ("/properties/notify-queue", properties_notify_queue);
   g_test_add_func ("/properties/notify/too-many-freezes", test_properties_notify_too_frozen);
+  g_test_add_func ("/properties/notify/batch", properties_notify_batch);
   g_test_add_func ("/properties/construct", properties_construct);
   g_test_add_func ("/properties/get-property", properties_get_property);
   g_test_add_func ("/properties/set-property/variant/floating", properties_set_property_variant_floating);
@@ -624,6 +624,44 @@ test_generic_marshaller_signal_1 (void)
   g_object_unref (test);
 }
 
+static void
+on_generic_marshaller_1_count (Test *obj,
+                               gint8 v_schar,
+                               guint8 v_uchar,
+                               gint v_int,
+                               glong v_long,
+                               gpointer v_pointer,
+                               gdouble v_double,
+                               gfloat v_float,
+                               gpointer user_data)
+{
+  guint *n_calls = user_data;
+
+  on_generic_marshaller_1 (obj, v_schar, v_uchar, v_int, v_long, v_pointer,
+                           v_double, v_float, NULL);
+  *n_calls += 1;
+}
+
+/* Every handler gets all the arguments when they are marshalled to several
+ * handlers straight from the va_list */
+static void
+test_generic_marshaller_signal_1_many (void)
+{
+  Test *test;
+  guint n_calls = 0;
+
+  test = g_object_new (test_get_type (), NULL);
+
+  g_signal_connect (test, "generic-marshaller-1", G_CALLBACK (on_generic_marshaller_1_count), &n_calls);
+  g_signal_connect (test, "generic-marshaller-1", G_CALLBACK (on_generic_marshaller_1_count), &n_calls);
+  g_signal_connect_after (test, "generic-marshaller-1", G_CALLBACK (on_generic_marshaller_1_count), &n_calls);
+
+  g_signal_emit_by_name (test, "generic-marshaller-1", 42, 43, 4096, 8192, NULL, 0.5, 5.5);
+  g_assert_cmpuint (n_calls, ==, 3);
+
+  g_object_unref (test);
+}
+
 static void
 on_generic_marshaller_2 (Test *obj,
 			 gint        v_int1,
@@ -1244,6 +1282,98 @@ test_emission_hook (void)
   g_object_unref (test2);
 }
 
+typedef struct
+{
+  GObject *object;
+  guint signal_id;
+  gint stop;  /* (atomic) */
+} UnhandledEmitData;
+
+static gpointer
+emit_unhandled_thread (gpointer user_data)
+{
+  UnhandledEmitData *data = user_data;
+
+  while (!g_atomic_int_get (&data->stop))
+    g_signal_emit (data->object, data->signal_id, 0);
+
+  return NULL;
+}
+
+static void
+count_handler (GObject *object, gpointer data)
+{
+  gint *count = data;
+
+  (*count)++;
+}
+
+/* Unhandled emissions skip the signal lock, so check that they see
+ * handlers and hooks added afterwards, and that registering more signals
+ * from another thread is safe while they are running */
+static void
+test_emit_unhandled (void)
+{
+  GType type;
+  UnhandledEmitData data[4];
+  GThread *threads[G_N_ELEMENTS (data)];
+  GObject *object;
+  guint signal_id;
+  gint count = 0;
+  gulong hook, handler;
+  gsize i;
+
+  type = g_type_register_static_simple (G_TYPE_OBJECT,
+                                        "EmitUnhandledTest",
+                                        sizeof (GObjectClass), NULL,
+                                        sizeof (GObject), NULL, 0);
+  signal_id = g_signal_new ("unhandled", type, G_SIGNAL_RUN_LAST,
+                            0, NULL, NULL, NULL, G_TYPE_NONE, 0);
+
+  object = g_object_new (type, NULL);
+  g_signal_emit (object, signal_id, 0);
+
+  hook = g_signal_add_emission_hook (signal_id, 0, hook_func, &count, NULL);
+  g_signal_emit (object, signal_id, 0);
+  g_assert_cmpint (count, ==, 1);
+  g_signal_remove_emission_hook (signal_id, hook);
+  g_signal_emit (object, signal_id, 0);
+  g_assert_cmpint (count, ==, 1);
+
+  handler = g_signal_connect (object, "unhandled", G_CALLBACK (count_handler), &count);
+  g_signal_emit (object, signal_id, 0);
+  g_assert_cmpint (count, ==, 2);
+  g_clear_signal_handler (&handler, object);
+  g_object_unref (object);
+
+  for (i = 0; i < G_N_ELEMENTS (data); i++)
+    {
+      data[i].object = g_object_new (type, NULL);
+      data[i].signal_id = signal_id;
+      data[i].stop = FALSE;
+      threads[i] = g_thread_new ("emit-unhandled", emit_unhandled_thread, &data[i]);
+    }
+
+  /* Grow the signal node table while the threads look signals up in it */
+  for (i = 0; i < 300; i++)
+    {
+      gchar *name = g_strdup_printf ("unhandled-%" G_GSIZE_FORMAT, i);
+      guint id;
+
+      id = g_signal_new (name, type, G_SIGNAL_RUN_LAST,
+                         0, NULL, NULL, NULL, G_TYPE_NONE, 0);
+      g_assert_cmpuint (g_signal_lookup (name, type), ==, id);
+      g_free (name);
+    }
+
+  for (i = 0; i < G_N_ELEMENTS (data); i++)
+    {
+      g_atomic_int_set (&data[i].stop, TRUE);
+      g_thread_join (threads[i]);
+      g_object_unref (data[i].object);
+    }
+}
+
 static void
 simple_cb (gpointer instance, gpointer data)
 {
@@ -1649,6 +1779,124 @@ test_stop_emission (void)
   g_object_unref (test1);
 }
 
+typedef struct
+{
+  GString *log;
+  gulong unblock;
+  gulong disconnect;
+} ChangeHandlersData;
+
+static void
+change_handlers_first (GObject *object, gpointer user_data)
+{
+  ChangeHandlersData *data = user_data;
+
+  g_string_append_c (data->log, 'a');
+  g_signal_handler_unblock (object, data->unblock);
+  g_signal_handler_disconnect (object, data->disconnect);
+  g_signal_connect (object, "simple", G_CALLBACK (dont_reach), NULL);
+}
+
+static void
+change_handlers_log (GObject *object, gpointer user_data)
+{
+  ChangeHandlersData *data = user_data;
+
+  g_string_append_c (data->log, 'b');
+}
+
+static void
+change_handlers_after (GObject *object, gpointer user_data)
+{
+  ChangeHandlersData *data = user_data;
+
+  g_string_append_c (data->log, 'c');
+}
+
+/* Handlers changing the handler list while several of them are run */
+static void
+test_change_handlers_in_emission (void)
+{
+  GObject *test;
+  ChangeHandlersData data;
+
+  test = g_object_new (test_get_type (), NULL);
+  data.log = g_string_new (NULL);
+
+  g_signal_connect_after (test, "simple", G_CALLBACK (change_handlers_after), &data);
+  g_signal_connect (test, "simple", G_CALLBACK (change_handlers_first), &data);
+  data.disconnect = g_signal_connect (test, "simple", G_CALLBACK (dont_reach), NULL);
+  data.unblock = g_signal_connect (test, "simple", G_CALLBACK (change_handlers_log), &data);
+  g_signal_handler_block (test, data.unblock);
+
+  g_signal_emit (test, simple_id, 0);
+  g_assert_cmpstr (data.log->str, ==, "abc");
+
+  g_signal_handlers_disconnect_by_func (test, dont_reach, NULL);
+  g_signal_handlers_disconnect_by_func (test, change_handlers_first, &data);
+  g_string_truncate (data.log, 0);
+  g_signal_emit (test, simple_id, 0);
+  g_assert_cmpstr (data.log->str, ==, "bc");
+
+  g_string_free (data.log, TRUE);
+  g_object_unref (test);
+}
+
+static void
+block_next_handler (GObject *object, gpointer user_data)
+{
+  ChangeHandlersData *data = user_data;
+
+  g_string_append_c (data->log, 'a');
+  g_signal_handler_block (object, data->unblock);
+}
+
+static void
+destroy_handlers (GObject *object, gpointer user_data)
+{
+  ChangeHandlersData *data = user_data;
+
+  g_string_append_c (data->log, 'a');
+  g_signal_handlers_destroy (object);
+}
+
+/* Handlers blocked or destroyed by an earlier handler of the same emission
+ * are not run */
+static void
+test_block_handlers_in_emission (void)
+{
+  GObject *test;
+  ChangeHandlersData data;
+  gulong handler;
+
+  test = g_object_new (test_get_type (), NULL);
+  data.log = g_string_new (NULL);
+
+  handler = g_signal_connect (test, "simple", G_CALLBACK (block_next_handler), &data);
+  data.unblock = g_signal_connect (test, "simple", G_CALLBACK (change_handlers_log), &data);
+  g_signal_connect_after (test, "simple", G_CALLBACK (change_handlers_after), &data);
+
+  g_signal_emit (test, simple_id, 0);
+  g_assert_cmpstr (data.log->str, ==, "ac");
+
+  g_signal_handler_disconnect (test, handler);
+  g_signal_handler_unblock (test, data.unblock);
+  g_string_truncate (data.log, 0);
+  g_signal_emit (test, simple_id, 0);
+  g_assert_cmpstr (data.log->str, ==, "bc");
+
+  g_signal_handlers_disconnect_by_data (test, &data);
+  g_signal_connect (test, "simple", G_CALLBACK (destroy_handlers), &data);
+  g_signal_connect (test, "simple", G_CALLBACK (dont_reach), NULL);
+  g_signal_connect_after (test, "simple", G_CALLBACK (dont_reach), NULL);
+  g_string_truncate (data.log, 0);
+  g_signal_emit (test, simple_id, 0);
+  g_assert_cmpstr (data.log->str, ==, "a");
+
+  g_string_free (data.log, TRUE);
+  g_object_unref (test);
+}
+
 static void
 test_signal_disconnect_wrong_object (void)
 {
@@ -2095,6 +2343,7 @@ main (int argc,
   g_test_add_func ("/gobject/signals/variant", test_variant_signal);
   g_test_add_func ("/gobject/signals/destroy-target-object", test_destroy_target_object);
   g_test_add_func ("/gobject/signals/generic-marshaller-1", test_generic_marshaller_signal_1);
+  g_test_add_func ("/gobject/signals/generic-marshaller-1-many", test_generic_marshaller_signal_1_many);
   g_test_add_func ("/gobject/signals/generic-marshaller-2", test_generic_marshaller_signal_2);
   g_test_add_func ("/gobject/signals/generic-marshaller-enum-return-signed", test_generic_marshaller_signal_enum_return_signed);
   g_test_add_func ("/gobject/signals/generic-marshaller-enum-return-unsigned", test_generic_marshaller_signal_enum_return_unsigned);
@@ -2105,11 +2354,14 @@ main (int argc,
   g_test_add_func ("/gobject/signals/connect", test_connect);
   g_test_add_func ("/gobject/signals/emission-hook", test_emission_hook);
   g_test_add_func ("/gobject/signals/emitv", test_emitv);
+  g_test_add_func ("/gobject/signals/emit-unhandled", test_emit_unhandled);
   g_test_add_func ("/gobject/signals/accumulator", test_accumulator);
   g_test_add_func ("/gobject/signals/accumulator-class", test_accumulator_class);
   g_test_add_func ("/gobject/signals/introspection", test_introspection);
   g_test_add_func ("/gobject/signals/block-handler", test_block_handler);
   g_test_add_func ("/gobject/signals/stop-emission", test_stop_emission);
+  g_test_add_func ("/gobject/signals/change-handlers-in-emission", test_change_handlers_in_emission);
+  g_test_add_func ("/gobject/signals/block-handlers-in-emission", test_block_handlers_in_emission);
   g_test_add_func ("/gobject/signals/invocation-hint", test_invocation_hint);
   g_test_add_func ("/gobject/signals/test-disconnection-wrong-object", test_signal_disconnect_wrong_object);
   g_test_add_func ("/gobject/signals/clear-signal-handler", test_clear_signal_handler);
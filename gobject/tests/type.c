@@ -124,6 +124,33 @@ test_interface_prerequisite (void)
   g_assert_cmpuint (g_type_interface_instantiatable_prerequisite (bozo_get_type ()), ==, G_TYPE_INITIALLY_UNOWNED);
 }
 
+static void
+test_interface_value_type (void)
+{
+  GValue value = G_VALUE_INIT;
+
+  /* Interfaces use the value table of their instantiatable prerequisite,
+   * including ones they only get through other interfaces */
+  g_assert_true (g_type_check_is_value_type (foo_get_type ()));
+  g_assert_true (g_type_check_is_value_type (bozo_get_type ()));
+  g_assert_false (g_type_check_is_value_type (baa_get_type ()));
+  g_assert_false (g_type_check_is_value_type (boo_get_type ()));
+  g_assert_true (g_type_value_table_peek (foo_get_type ()) ==
+                 g_type_value_table_peek (G_TYPE_OBJECT));
+
+  g_assert_true (g_type_is_a (bozo_get_type (), bar_get_type ()));
+  g_assert_true (g_type_is_a (bozo_get_type (), G_TYPE_INITIALLY_UNOWNED));
+  g_assert_false (g_type_is_a (foo_get_type (), G_TYPE_INITIALLY_UNOWNED));
+  g_assert_false (g_type_is_a (boo_get_type (), G_TYPE_OBJECT));
+
+  g_value_init (&value, foo_get_type ());
+  g_assert_true (G_VALUE_HOLDS_OBJECT (&value));
+  g_assert_true (G_VALUE_HOLDS (&value, bar_get_type ()));
+  g_assert_false (G_VALUE_HOLDS (&value, baa_get_type ()));
+  g_assert_null (g_value_get_object (&value));
+  g_value_unset (&value);
+}
+
 typedef struct {
   GTypeInterface g_iface;
 } BazInterface;
@@ -236,6 +263,7 @@ main (int argc, char *argv[])
 
   g_test_add_func ("/type/registration-serial", test_registration_serial);
   g_test_add_func ("/type/interface-prerequisite", test_interface_prerequisite);
+  g_test_add_func ("/type/interface-value-type", test_interface_value_type);
   g_test_add_func ("/type/interface-check", test_interface_check);
   g_test_add_func ("/type/next-base", test_next_base);
   g_test_add_func ("/type/is-a", test_is_a);